@@ -1,3 +1,5 @@
+include(config.pri)
+
 TEMPLATE = subdirs
 CONFIG += ordered qt thread
 
@@ -12,6 +14,11 @@ SUBDIRS += \
 !macx:SUBDIRS += \
     src/d2asc \
     src/plugins \
-    tests
+    tests \
+    tests/benchmark \
+    tests/benchmark/asciifilegenerator
 
 !win32-msvc*:SUBDIRS += tests/dirfile_maker
+
+# what kstbench replays a dirfile with
+unix:!macx:LibExists(getdata):SUBDIRS += tests/benchmark/dirfile_replay
@@ -15,20 +15,25 @@ def b2str(val):
   else:
     return str(val)
 
+def quoted(val):
+  """ val as a quoted argument of a script command, which may then hold commas. """
+  return '"'+b2str(val).replace('\\','\\\\').replace('"','\\"')+'"'
+
 class Client:
   """ This class is an interface to a running kst session. Every convenience class inside pykst accepts an instance of Client which it
   uses to interact with a kst session. In addition, it holds functions which effect the entire kst session.
       
   If serverName is specified, creates a connection to either a running kst session with serverName, or if none exists, a new one.
-  If serverName is not specified, creates a connection to either the kst session with the name "kstScript", or if none exists, a new one. """
+  If serverName is not specified, creates a connection to either the kst session with the name "kstScript", or if none exists, a new one.
+  If headless is True, a new session is started as a render server (kst2 --render-server), with no window, for renderTab(). """
   
-  def __init__(self,serverName="kstScript"):
+  def __init__(self,serverName="kstScript",headless=False):
     self.ls=QtNetwork.QLocalSocket()
     self.ls.connectToServer(serverName)
     self.ls.waitForConnected(300)
     self.serverName=serverName
     if self.ls.state()==QtNetwork.QLocalSocket.UnconnectedState:
-      os.system("kst2 --serverName="+str(serverName)+"&")
+      os.system("kst2 --serverName="+str(serverName)+(" --render-server" if headless else "")+"&")
       while self.ls.state()==QtNetwork.QLocalSocket.UnconnectedState:
         self.ls.connectToServer(serverName)
         self.ls.waitForConnected(300)
@@ -79,6 +84,33 @@ class Client:
   def readToEnd(self):
     """ Equivalent to "Range>Read To End" from the menubar inside kst. """
     self.send("readToEnd()")
+  def exportVectors(self, vectors, filename, format="text"):
+    """ Writes vectors (a list of vectors or their names) to filename in the background, in the format "text", "binary", "dirfile"
+        or "columnar", as "File>Export Vectors" does.  Use exportProgress() to follow it. """
+    names=[v.handle if hasattr(v,"handle") else v for v in vectors]
+    return self.send("exportVectors("+b2str(format)+","+quoted(filename)+","+",".join([quoted(n) for n in names])+")")
+  def exportProgress(self):
+    """ Returns the percentage written by the running export, or "Done" or what went wrong once it is over. """
+    return self.send("exportProgress()")
+  def cancelExport(self):
+    """ Stops the running export. """
+    self.send("cancelExport()")
+  def startRecording(self, vectors, dirfile):
+    """ Appends vectors (a list of vectors or their names) to the dirfile dirfile as they grow, one field each, until
+        stopRecording().  The dirfile can then be read back with the dirfile data source. """
+    names=[v.handle if hasattr(v,"handle") else v for v in vectors]
+    return self.send("startRecording("+quoted(dirfile)+","+",".join([quoted(n) for n in names])+")")
+  def stopRecording(self):
+    """ Finishes the recording and returns the number of samples written, or what went wrong. """
+    return self.send("stopRecording()")
+  def renderTab(self, filename, tab=0, width=1280, height=1024, session=""):
+    """ Renders tab (counting from 0) of the session file session, or of what is open if session is "", at width x height into
+        filename, as png, svg, pdf or any image format named by its suffix.  The session stays open, so its other tabs render
+        without loading it again.  Images are written in the background: call finishRendering() before using them. """
+    return self.send("renderTab("+str(tab)+","+str(width)+","+str(height)+","+quoted(filename)+","+quoted(session)+")")
+  def finishRendering(self):
+    """ Waits for the images from renderTab() to be written, and returns "Done" or what went wrong. """
+    return self.send("finishRendering()")
   def setPaused(self):
     """ Equivalent to checking "Range>Pause" from the menubar inside kst if "Range>Pause" is unchecked, otherwise no action. """
     self.send("setPaused()")
@@ -23,6 +23,7 @@
 #include "coredocument.h"
 #include "objectstore.h"
 #include "datasourcepluginmanager.h"
+#include "vectorexport.h"
 
 static Kst::CoreDocument _document;
 
@@ -31,6 +32,9 @@ void Usage() {
   fprintf(stderr, "             [-n <numframes>] [-s skip [-a]] \n");
   fprintf(stderr, "             [-x] col1 [[-x] col2 ... [-x] coln]\n");
   fprintf(stderr, "   -x specifies that the field should be printed in hex\n");
+  fprintf(stderr, "   -o <file> writes to file instead of standard output\n");
+  fprintf(stderr, "   -F <format> writes text (the default), binary, dirfile\n");
+  fprintf(stderr, "      or columnar data; dirfile and columnar need -o\n");
 }
 
 
@@ -52,7 +56,8 @@ int main(int argc, char *argv[]) {
   int start_frame=0, n_frames=2000000;
   bool do_ave = false, do_skip = false;
   int n_skip = 0;
-  int NS=0, i_S;
+  QString out_file = "-";
+  Kst::VectorExport::Format format = Kst::VectorExport::Text;
 
   if (argc < 3 || argv[1][0] == '-') {
     Usage();
@@ -77,6 +82,17 @@ int main(int argc, char *argv[]) {
         if (n_skip>0) do_skip = true;
       } else if (argv[i][1] == 'a') {
         do_ave = true;
+      } else if (argv[i][1] == 'o') {
+        i++;
+        out_file = QString::fromLocal8Bit(argv[i]);
+      } else if (argv[i][1] == 'F') {
+        i++;
+        bool ok;
+        format = Kst::VectorExport::formatFromName(QString::fromLocal8Bit(argv[i]), &ok);
+        if (!ok) {
+          Usage();
+          return -1;
+        }
       } else if (argv[i][1] == 'x') {
         i++;
         field_list[n_field] = QString::fromLocal8Bit(argv[i]);
@@ -93,6 +109,11 @@ int main(int argc, char *argv[]) {
 
   if (!do_skip) do_ave = false;
 
+  if (out_file == "-" && (format == Kst::VectorExport::Dirfile || format == Kst::VectorExport::Columnar)) {
+    Usage();
+    return -1;
+  }
+
   file = Kst::DataSourcePluginManager::loadSource(_document.objectStore(), filename);
   if (!file || !file->isValid() || file->isEmpty()) {
     fprintf(stderr, "d2asc error: file %s has no data\n", qPrintable(filename));
@@ -113,25 +134,19 @@ int main(int argc, char *argv[]) {
     vlist.append(v);
   }
 
-  /* find NS */
+  Kst::VectorExport exporter(out_file, format);
+  exporter.setHeader(false);
   for (i = 0; i < n_field; i++) {
     // FIXME: need to learn to wait...
     //while (vlist.at(i)->update() != Kst::Object::NO_CHANGE)
     //  ; // read vector
 
-    if (vlist.at(i)->length() > NS)
-      NS = vlist.at(i)->length();
+    exporter.addVector(vlist.at(i), field_list[i], do_hex[i]);
   }
 
-  for (i_S = 0; i_S < NS; i_S++) {
-    for (i = 0; i < n_field; i++) {
-      if (do_hex[i]) {
-        printf("%4x ",  (int)vlist.at(i)->interpolate(i_S, NS));
-      } else {
-        printf("%.16g ", vlist.at(i)->interpolate(i_S, NS));
-      }
-    }
-    printf("\n");
+  if (!exporter.exportNow()) {
+    fprintf(stderr, "d2asc error: %s\n", qPrintable(exporter.errorString()));
+    return -4;
   }
   return 0;
 }
@@ -68,6 +68,9 @@ class AsciiPlugin : public QObject, public Kst::DataSourcePluginInterface
     virtual QStringList provides() const;
 
     virtual Kst::DataSourceConfigWidget *configWidget(QSettings *cfg, const QString& filename) const;
+
+    // each source keeps its own reader and buffers
+    virtual bool isThreadSafe() const { return true; }
 };
 
 
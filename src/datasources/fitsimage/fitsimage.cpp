@@ -256,6 +256,42 @@ QMap<QString, QString> DataInterfaceFitsImageMatrix::metaStrings(const QString &
   return M;
 }
 
+// Decimates the skip x skip blocks of the requested region of the image in
+// buffer, which is width pixels wide.  The output is in the order read()
+// returns pixels: x major, each axis reversed if its flip flag is set.
+static int readDecimated(const double *buffer, long width, bool flipX, bool flipY, DataMatrix::ReadInfo& p) {
+  const int block = p.skip;
+  const int x1 = p.xStart + p.xNumSteps * block;
+  const int y1 = p.yStart + p.yNumSteps * block;
+  double* z = p.data->z;
+
+  int i = 0;
+  for (int bx = 0; bx < p.xNumSteps; bx++) {
+    for (int by = 0; by < p.yNumSteps; by++) {
+      if (p.doAve) {
+        double sum = 0.0;
+        for (int a = 0; a < block; a++) {
+          const int ox = bx * block + a;
+          const long px = flipX ? x1 - 1 - ox : p.xStart + ox;
+          for (int b = 0; b < block; b++) {
+            const int oy = by * block + b;
+            const long py = flipY ? y1 - 1 - oy : p.yStart + oy;
+            sum += buffer[px + py*width];
+          }
+        }
+        z[i] = sum / (double(block) * double(block));
+      } else {
+        const long px = flipX ? x1 - 1 - bx * block : p.xStart + bx * block;
+        const long py = flipY ? y1 - 1 - by * block : p.yStart + by * block;
+        z[i] = buffer[px + py*width];
+      }
+      i++;
+    }
+  }
+  return i;
+}
+
+
 int DataInterfaceFitsImageMatrix::read(const QString& field, DataMatrix::ReadInfo& p) {
   long n_axes[2],  fpixel[2] = {1, 1};
   double nullval = NAN;
@@ -324,7 +360,13 @@ int DataInterfaceFitsImageMatrix::read(const QString& field, DataMatrix::ReadInf
 
   int i = 0;
 
-  if ((dx<0) && (dy>0)) {
+  if (p.skip > 1) {
+    // Decimated read: one value per skip x skip block, in the same order
+    // as the full read below would return the pixels.
+    if (dx != 0 && dy != 0) {
+      i = readDecimated(buffer, n_axes[0], dx < 0, dy < 0, p);
+    }
+  } else if ((dx<0) && (dy>0)) {
     for (px = p.xStart; px < x1; px++) {
       for (py = y1-1; py >= p.yStart; py--) {
         z[ni - i] = buffer[px + py*n_axes[0]];
@@ -355,16 +397,17 @@ int DataInterfaceFitsImageMatrix::read(const QString& field, DataMatrix::ReadInf
   }
   free(buffer);
 
+  const int block = (p.skip > 1) ? p.skip : 1;
   if (status) {
     p.data->xMin = x0;
     p.data->yMin = y0;
-    p.data->xStepSize = 1;
-    p.data->yStepSize = 1;
+    p.data->xStepSize = block;
+    p.data->yStepSize = block;
   } else {
     dx = fabs(dx);
     dy = fabs(dy);
-    p.data->xStepSize = dx;
-    p.data->yStepSize = dy;
+    p.data->xStepSize = dx * block;
+    p.data->yStepSize = dy * block;
     p.data->xMin = x - cx*dx;
     p.data->yMin = y - cy*dy;
   }
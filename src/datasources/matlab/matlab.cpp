@@ -284,6 +284,10 @@ const DataMatrix::DataInfo DataInterfaceMatlabMatrix::dataInfo(const QString& ma
 
 int DataInterfaceMatlabMatrix::read(const QString& field, DataMatrix::ReadInfo& p)
 {
+  if (p.skip > 1) {
+    return -9999; // no decimating read: let DataMatrix do it
+  }
+
   int count = matlab.readMatrix(p.data->z, field);
 
   p.data->xMin = 0;
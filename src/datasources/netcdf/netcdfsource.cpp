@@ -290,12 +290,13 @@ const DataMatrix::DataInfo DataInterfaceNetCdfMatrix::dataInfo(const QString& ma
 
 int DataInterfaceNetCdfMatrix::read(const QString& field, DataMatrix::ReadInfo& p)
 {
-  int count = netcdf.readMatrix(p.data->z, field);
+  int count = netcdf.readMatrix(p.data->z, field, p.xStart, p.yStart, p.xNumSteps, p.yNumSteps, p.skip, p.doAve);
 
-  p.data->xMin = 0;
-  p.data->yMin = 0;
-  p.data->xStepSize = 1;
-  p.data->yStepSize = 1;
+  const int block = (p.skip > 1) ? p.skip : 1;
+  p.data->xMin = p.xStart;
+  p.data->yMin = p.yStart;
+  p.data->xStepSize = block;
+  p.data->yStepSize = block;
 
   return count;
 }
@@ -602,7 +603,7 @@ int NetcdfSource::readField(double *v, const QString& field, int s, int n) {
 
 
 
-int NetcdfSource::readMatrix(double *v, const QString& field) 
+int NetcdfSource::readMatrix(double *v, const QString& field, int xStart, int yStart, int nX, int nY, int skip, bool doAve)
 {
   /* For a variable from the netCDF file */
   QByteArray bytes = field.toLatin1();
@@ -612,13 +613,52 @@ int NetcdfSource::readMatrix(double *v, const QString& field)
     return -1;
   }
 
-  int xSize = var->get_dim(0)->size();
-  int ySize = var->get_dim(1)->size();
+  // -1 steps means one sample
+  nX = qMax(nX, 1);
+  nY = qMax(nY, 1);
 
-  var->get(v, xSize, ySize);
+  if (skip <= 1) {
+    var->set_cur(xStart, yStart);
+    if (!var->get(v, nX, nY)) {
+      return 0;
+    }
+    return nX * nY;
+  }
+
+  if (!doAve) {
+    // the C API reads with a stride in one call
+    size_t start[2] = { size_t(xStart), size_t(yStart) };
+    size_t count[2] = { size_t(nX), size_t(nY) };
+    ptrdiff_t stride[2] = { skip, skip };
+    if (nc_get_vars_double(_ncfile->id(), var->id(), start, count, stride, v) != NC_NOERR) {
+      return 0;
+    }
+    return nX * nY;
+  }
+
+  // Box average: read skip rows of x at a time and reduce them.
+  const int columnLength = nY * skip;
+  double *buffer = new double[skip * columnLength];
+  int i = 0;
+  for (int bx = 0; bx < nX; ++bx) {
+    var->set_cur(xStart + bx * skip, yStart);
+    if (!var->get(buffer, skip, columnLength)) {
+      break;
+    }
+    for (int by = 0; by < nY; ++by) {
+      double sum = 0.0;
+      for (int a = 0; a < skip; ++a) {
+        const double *row = buffer + a * columnLength + by * skip;
+        for (int b = 0; b < skip; ++b) {
+          sum += row[b];
+        }
+      }
+      v[i++] = sum / (double(skip) * double(skip));
+    }
+  }
+  delete[] buffer;
 
- 
-  return  xSize * ySize;
+  return i;
 }
 
 
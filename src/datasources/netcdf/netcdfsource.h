@@ -53,7 +53,9 @@ class NetcdfSource : public Kst::DataSource {
 
     int readField(double *v, const QString& field, int s, int n);
 
-    int readMatrix(double *v, const QString& field);
+    // Reads nX x nY samples from (xStart, yStart); with skip > 1, one value
+    // per skip x skip block: its first sample, or its mean if doAve.
+    int readMatrix(double *v, const QString& field, int xStart, int yStart, int nX, int nY, int skip = 1, bool doAve = false);
 
     int samplesPerFrame(const QString& field);
 
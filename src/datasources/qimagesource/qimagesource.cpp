@@ -225,12 +225,71 @@ const DataMatrix::DataInfo DataInterfaceQImageMatrix::dataInfo(const QString& ma
 }
 
 
+static int grayChannel(QRgb rgb) { return qGray(rgb); }
+static int redChannel(QRgb rgb) { return qRed(rgb); }
+static int greenChannel(QRgb rgb) { return qGreen(rgb); }
+static int blueChannel(QRgb rgb) { return qBlue(rgb); }
+
+
+// Decimated read: one value per skip x skip block of pixels, in the order
+// read() returns pixels (columns left to right, each bottom to top).
+static int readDecimated(const QImage& image, int (*channel)(QRgb), DataMatrix::ReadInfo& p)
+{
+  const int block = p.skip;
+  const int y1 = p.yStart + p.yNumSteps * block;
+  double* z = p.data->z;
+
+  int i = 0;
+  for (int bx = 0; bx < p.xNumSteps; bx++) {
+    const int px0 = p.xStart + bx * block;
+    for (int by = 0; by < p.yNumSteps; by++) {
+      const int py0 = y1 - 1 - by * block;
+      if (p.doAve) {
+        double sum = 0.0;
+        for (int py = py0; py > py0 - block; py--) {
+          for (int px = px0; px < px0 + block; px++) {
+            sum += channel( image.pixel( px, py ) );
+          }
+        }
+        z[i] = sum / (double(block) * double(block));
+      } else {
+        z[i] = channel( image.pixel( px0, py0 ) );
+      }
+      i++;
+    }
+  }
+
+  p.data->xMin = p.xStart;
+  p.data->yMin = p.yStart;
+  p.data->xStepSize = block;
+  p.data->yStepSize = block;
+
+  return i;
+}
+
+
 int DataInterfaceQImageMatrix::read(const QString& field, DataMatrix::ReadInfo& p)
 {
   if ( _image->isNull() ) {
     return 0;
   }
 
+  if ( p.skip > 1 ) {
+    int (*channel)(QRgb) = 0;
+    if ( field=="GRAY" ) {
+      channel = grayChannel;
+    } else if ( field=="RED" ) {
+      channel = redChannel;
+    } else if ( field=="GREEN" ) {
+      channel = greenChannel;
+    } else if ( field=="BLUE" ) {
+      channel = blueChannel;
+    } else {
+      return 0;
+    }
+    return readDecimated( *_image, channel, p );
+  }
+
   int y0 = p.yStart;
   int y1 = p.yStart + p.yNumSteps;
   int x0 = p.xStart;
@@ -12,13 +12,34 @@
 
 #include <application.h>
 
+// --render-server: stay up without a window, rendering tabs for scripts
+static bool isRenderServer(int argc, char *argv[]) {
+  for (int i = 1; i < argc; ++i) {
+    if (qstrcmp(argv[i], "--render-server") == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 #ifdef Q_CC_MSVC
 __declspec(dllexport)
 #endif
 int main(int argc, char *argv[]) {
+  const bool renderServer = isRenderServer(argc, argv);
+#ifdef QT5
+  // no display is needed to paint offscreen
+  if (renderServer && qgetenv("QT_QPA_PLATFORM").isEmpty()) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+#endif
+
   Kst::Application app(argc, argv);
-  if (app.mainWindow()->initFromCommandLine()) {
-    app.mainWindow()->show();
+  app.mainWindow()->setRenderServer(renderServer);
+  if (app.mainWindow()->initFromCommandLine() || renderServer) {
+    if (!renderServer) {
+      app.mainWindow()->show();
+    }
     return app.exec();
   }
   return 0;
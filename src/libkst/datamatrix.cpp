@@ -27,6 +27,7 @@
 #include "datacollection.h"
 #include "debug.h"
 #include "objectstore.h"
+#include "parallel.h"
 
 
 // xStart, yStart < 0             count from end
@@ -86,6 +87,7 @@ void DataMatrix::save(QXmlStreamWriter &xml) {
 }
 
 DataMatrix::~DataMatrix() {
+  free(_aveReadBuffer);
 }
 
 
@@ -206,6 +208,50 @@ bool DataMatrix::checkValidity(const DataSourcePtr& ds) const {
 }
 
 
+// Full resolution samples read at once when the datasource can't decimate.
+static const qint64 MaxDecimationRead = 8 * 1024 * 1024;
+
+// Reduces full resolution columns to one value per block x block square:
+// its first sample, or its mean.  Chunks are output columns.
+class DecimateJob : public ParallelJob {
+  public:
+    DecimateJob(const double *in, double *out, int nY, int block, bool average)
+      : _in(in), _out(out), _nY(nY), _block(block), _average(average) {}
+
+    void processChunk(int, qint64 begin, qint64 end) {
+      const qint64 inColumn = qint64(_nY) * _block;
+      const double scale = 1.0 / (double(_block) * double(_block));
+      for (qint64 i = begin; i < end; ++i) {
+        const double *in = _in + i * _block * inColumn;
+        double *out = _out + i * _nY;
+        if (!_average) {
+          for (int j = 0; j < _nY; ++j) {
+            out[j] = in[qint64(j) * _block];
+          }
+          continue;
+        }
+        for (int j = 0; j < _nY; ++j) {
+          double sum = 0.0;
+          for (int a = 0; a < _block; ++a) {
+            const double *column = in + a * inColumn + qint64(j) * _block;
+            for (int b = 0; b < _block; ++b) {
+              sum += column[b];
+            }
+          }
+          out[j] = sum * scale;
+        }
+      }
+    }
+
+  private:
+    const double *_in;
+    double *_out;
+    int _nY;
+    int _block;
+    bool _average;
+};
+
+
 void DataMatrix::doUpdateSkip(int realXStart, int realYStart) {
 
   // since we are skipping, we don't need all the pixels
@@ -227,77 +273,54 @@ void DataMatrix::doUpdateSkip(int realXStart, int realYStart) {
   // return data from readMatrix
   MatrixData matData;
 
-  if (!_doAve) {
-    // try to use the datasource's read with skip function - it will automatically
-    // enlarge each pixel to correct for the skipping
-    matData.z=_z;
-    _NS = readMatrix(&matData, _field, realXStart, realYStart, _nX, _nY, _skip);
+  // try to use the datasource's decimating read - it will automatically
+  // enlarge each pixel to correct for the skipping
+  matData.z = _z;
+  _NS = readMatrix(&matData, _field, realXStart, realYStart, _nX, _nY, _skip, _doAve);
+
+  // -9999 means decimation is not supported by the datasource
+  if (_NS != -9999) {
+    // set the recommended translate and scaling, and return
+    _minX = matData.xMin;
+    _minY = matData.yMin;
+    _stepX = matData.xStepSize;
+    _stepY = matData.yStepSize;
+    return;
+  }
 
-    // -9999 means the skipping function is not supported by datasource
-    if (_NS != -9999) {
-      // set the recommended translate and scaling, and return
-      _minX = matData.xMin;
-      _minY = matData.yMin;
-      _stepX = matData.xStepSize;
-      _stepY = matData.yStepSize;
+  // Read the full resolution data and decimate it here, as many columns of
+  // blocks at a time as fit in MaxDecimationRead samples.
+  const int block = _skip * _samplesPerFrameCache;
+  const qint64 blockColumn = qint64(_nY) * block * block;
+  const int columnsPerRead = int(qBound(qint64(1), MaxDecimationRead / qMax(blockColumn, qint64(1)), qint64(qMax(_nX, 1))));
+  const qint64 bufferSize = columnsPerRead * blockColumn;
+  if (_aveReadBufferSize < bufferSize) {
+    if (!kstrealloc(_aveReadBuffer, bufferSize*sizeof(double))) {
+      qCritical() << "Matrix resize failed";
+      _NS = 0;
+      return;
     }
+    _aveReadBufferSize = bufferSize;
   }
 
-  // the skipping function is not supported by datasource; we need to manually skip
-  if (_doAve) {
-    // boxcar filtering is not supported by datasources currently; need to manually average
-    if (_aveReadBufferSize < _samplesPerFrameCache*_skip*_samplesPerFrameCache*_skip) {
-      _aveReadBufferSize = _samplesPerFrameCache*_skip*_samplesPerFrameCache*_skip;
-      if (!kstrealloc(_aveReadBuffer, _aveReadBufferSize*sizeof(double))) {
-        qCritical() << "Matrix resize failed";
-      }
-    }
-    _NS = 0;
-    bool first = true;
+  _NS = 0;
+  for (int i = 0; i < _nX; i += columnsPerRead) {
+    const int columns = qMin(columnsPerRead, _nX - i);
     matData.z = _aveReadBuffer;
-    double* zPos = _z;
-    for (int i = 0; i < _nX; i++) {
-      for (int j = 0; j < _nY; j++) {
-        // read one buffer size in
-        readMatrix(&matData, _field, realXStart + _skip*i, realYStart + _skip*j, _skip, _skip, -1);
-        // take average of the buffer
-        double bufferAverage = 0;
-        for (int k = 0; k < _samplesPerFrameCache*_skip*_samplesPerFrameCache*_skip; k++) {
-          bufferAverage += _aveReadBuffer[k];
-        }
-        bufferAverage = bufferAverage / _aveReadBufferSize;
-        // insert the average into the matrix
-        *zPos = bufferAverage;
-        zPos++;
-        _NS++;
-        if (first) {
-          _minX = matData.xMin;
-          _minY = matData.yMin;
-          _stepX = matData.xStepSize * _skip * _samplesPerFrameCache;
-          _stepY = matData.yStepSize * _skip * _samplesPerFrameCache;
-          first = false;
-        }
-      }
+    const int samples = readMatrix(&matData, _field, realXStart + _skip*i, realYStart, _skip*columns, _skip*_nY, -1);
+    if (samples < columns * blockColumn) {
+      break;
     }
-
-  } else {
-    _NS = 0;
-    bool first = true;
-    for (int i = 0; i < _nX; i++) {
-      for (int j = 0; j < _nY; j++) {
-        // read one sample
-        int samples = readMatrix(&matData, _field, realXStart + _skip*i, realYStart + _skip*j, -1, -1, -1);
-        matData.z += samples;
-        _NS += samples;
-        if (first) {
-          _minX = matData.xMin;
-          _minY = matData.yMin;
-          _stepX = matData.xStepSize * _skip * _samplesPerFrameCache;
-          _stepY = matData.yStepSize * _skip * _samplesPerFrameCache;
-          first = false;
-        }
-      }
+    if (i == 0) {
+      _minX = matData.xMin;
+      _minY = matData.yMin;
+      _stepX = matData.xStepSize * block;
+      _stepY = matData.yStepSize * block;
     }
+
+    DecimateJob job(_aveReadBuffer, _z + qint64(i) * _nY, _nY, block, _doAve);
+    runParallel(&job, columns, qMax(qint64(1), qint64(65536) / qMax(blockColumn, qint64(1))));
+    _NS += columns * _nY;
   }
 }
 
@@ -521,6 +544,7 @@ void DataMatrix::internalUpdate() {
   } else {
     doUpdateNoSkip(realXStart, realYStart);
   }
+  _pyramid.invalidate();
 
   // remember these as the last updated range
   _lastXStart = realXStart;
@@ -684,9 +708,9 @@ QString DataMatrix::propertyString() const {
 }
 
 
-int DataMatrix::readMatrix(MatrixData* data, const QString& matrix, int xStart, int yStart, int xNumSteps, int yNumSteps, int skip)
+int DataMatrix::readMatrix(MatrixData* data, const QString& matrix, int xStart, int yStart, int xNumSteps, int yNumSteps, int skip, bool doAve)
 {
-  ReadInfo p = { data, xStart, yStart, xNumSteps, yNumSteps, skip};
+  ReadInfo p = { data, xStart, yStart, xNumSteps, yNumSteps, skip, doAve };
   return dataSource()->matrix().read(matrix, p);
 }
 
@@ -41,9 +41,12 @@ class KSTCORE_EXPORT DataMatrix : public Matrix, public DataPrimitive
         yStart - starting y *frame*
         xNumSteps - number of *frames* to read in x direction; -1 to read 1 *sample* from xStart
         yNumSteps - number of *frames* to read in y direction; -1 to read 1 *sample* from yStart
-        Will skip according to the parameter, but it may not be implemented.  If return value is -9999,
-        use the non-skip version instead.
+        skip - if > 1, decimate: xNumSteps and yNumSteps then count skip x skip blocks of frames, and
+        one value is returned per block, in the order a full read of the blocks would have returned
+        them: the first sample of the block, or the mean of the block if doAve is set.
+        Decimation may not be implemented.  If return value is -9999, use the non-skip version instead.
         The suggested scaling and translation is returned in xMin, yMin, xStepSize, and yStepSize
+        (for a decimated read, the step between blocks)
         Returns the number of *samples* read 
     **/
     struct KSTCORE_EXPORT ReadInfo {
@@ -53,6 +56,7 @@ class KSTCORE_EXPORT DataMatrix : public Matrix, public DataPrimitive
       int xNumSteps;
       int yNumSteps;
       int skip;
+      bool doAve;
     };
 
 
@@ -159,8 +163,8 @@ class KSTCORE_EXPORT DataMatrix : public Matrix, public DataPrimitive
     bool _lastDoSkip : 1;
     int _lastSkip;
 
-    double* _aveReadBuffer; // buffer used when performing boxcar filter
-    int _aveReadBufferSize;
+    double* _aveReadBuffer; // full resolution data, when we have to decimate it ourselves
+    qint64 _aveReadBufferSize;
 
     DataSourcePtr _file;
     QString _field; // field to read from _file
@@ -169,7 +173,7 @@ class KSTCORE_EXPORT DataMatrix : public Matrix, public DataPrimitive
     int _skip;
     int _samplesPerFrameCache; // cache the samples per frame of the field in datasource
 
-    int readMatrix(MatrixData* data, const QString& matrix, int xStart, int yStart, int xNumSteps, int yNumSteps, int skip);
+    int readMatrix(MatrixData* data, const QString& matrix, int xStart, int yStart, int xNumSteps, int yNumSteps, int skip, bool doAve = false);
 
     QHash<QString, ScalarPtr> _fieldScalars;
     QHash<QString, StringPtr> _fieldStrings;
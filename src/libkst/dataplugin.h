@@ -89,6 +89,13 @@ class DataSourcePluginInterface : public PluginInterface {
     bool provides(const QString& type) const { return provides().contains(type); }
 
     virtual DataSourceConfigWidget *configWidget(QSettings *cfg, const QString& filename) const = 0;
+
+    /** Whether understands() and create() may be called from any thread,
+        for different files at once, and a source made in one thread may
+        read its data there until it is moved to the main one.  The sources
+        of such plugins are made, and read their index, in parallel when a
+        session is loaded. */
+    virtual bool isThreadSafe() const { return false; }
 };
 
 
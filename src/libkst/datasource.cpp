@@ -29,6 +29,7 @@
 #include <QTextDocument>
 #include <QUrl>
 #include <QXmlStreamWriter>
+#include <QThread>
 #include <QTimer>
 #include <QFileSystemWatcher>
 
@@ -71,6 +72,26 @@ struct NotSupportedImp : public DataSource::DataInterface<T>
 };
 
 
+static bool isMainThread() {
+  return !QCoreApplication::instance() || QThread::currentThread() == QCoreApplication::instance()->thread();
+}
+
+// only read and written in the main thread
+static bool s_madeInAdvance = false;
+
+// sources made by thread safe plugins for a preload wait for adopt()
+static bool madeInAdvance() {
+  return !isMainThread() || s_madeInAdvance;
+}
+
+
+void DataSource::setMadeInAdvance(bool inAdvance) {
+  if (isMainThread()) {
+    s_madeInAdvance = inAdvance;
+  }
+}
+
+
 const QString DataSource::staticTypeString = I18N_NOOP("Data Source");
 const QString DataSource::staticTypeTag = I18N_NOOP("source");
 
@@ -142,7 +163,7 @@ DataSource::DataSource(ObjectStore *store, QSettings *cfg, const QString& filena
   interf_vector(new NotSupportedImp<DataVector>),
   interf_matrix(new NotSupportedImp<DataMatrix>),
   _watcher(0),
-  _color(NextColor::self().next())
+  _color(madeInAdvance() ? QColor() : NextColor::self().next())
 {
   Q_UNUSED(type)
   Q_UNUSED(store)
@@ -152,9 +173,12 @@ DataSource::DataSource(ObjectStore *store, QSettings *cfg, const QString& filena
   _writable = false;
   _watcher = 0L;
 
-  _initializeShortName();
-
-  setDescriptiveName(QFileInfo(_filename).fileName() + " (" + shortName() + ')');
+  // the short names and colors are numbered in the order the sources are
+  // loaded: one made in advance gets them in adopt()
+  if (!madeInAdvance()) {
+    _initializeShortName();
+    setDescriptiveName(QFileInfo(_filename).fileName() + " (" + shortName() + ')');
+  }
 
   // TODO What is the better default?
   setUpdateType(File);
@@ -221,7 +245,11 @@ DataSource::UpdateCheckType DataSource::updateType() const
 void DataSource::setUpdateType(UpdateCheckType updateType, const QString& file)
 {
   _updateCheckType = updateType;
+  _updateCheckFile = file;
   resetFileWatcher();
+  if (madeInAdvance()) {
+    return; // the timer or watcher might belong to the wrong thread
+  }
   if (_updateCheckType == Timer) {
     QTimer::singleShot(UpdateManager::self()->minimumUpdatePeriod()-1, this, SLOT(checkUpdate()));
   } else if (_updateCheckType == File) {
@@ -237,6 +265,17 @@ void DataSource::setUpdateType(UpdateCheckType updateType, const QString& file)
 }
 
 
+void DataSource::adopt(QSettings *cfg) {
+  Q_ASSERT(!madeInAdvance() && thread() == QThread::currentThread());
+  _cfg = cfg;
+  _initial_dsnum = _dsnum;
+  _initializeShortName();
+  setDescriptiveName(QFileInfo(_filename).fileName() + " (" + shortName() + ')');
+  _color = NextColor::self().next();
+  setUpdateType(_updateCheckType, _updateCheckFile);
+}
+
+
 void DataSource::checkUpdate() {
   if (!UpdateManager::self()->paused()) {
     UpdateManager::self()->doUpdates(false);
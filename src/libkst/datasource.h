@@ -103,9 +103,22 @@ class KSTCORE_EXPORT DataSource : public Object
     /************************************************************/
 
     enum UpdateCheckType { Timer, File, None };
+    /** For a source made in advance, the checking only starts when it is
+        adopted. */
     void setUpdateType(UpdateCheckType updateType, const QString& file = QString());
     UpdateCheckType updateType() const;
 
+    /** Finishes, in the main thread, a source made in advance by a thread
+        safe plugin (see DataSourcePluginInterface::isThreadSafe()) and moved
+        here: gives it cfg, and the name, color and update checking it would
+        have got had it been made now. */
+    void adopt(QSettings *cfg);
+
+    /** Sources made on a thread other than the main one are made in
+        advance; while this is set, so are those made in the main thread.
+        Set by DataSourcePluginManager::preloadSources(). */
+    static void setMadeInAdvance(bool inAdvance);
+
     virtual UpdateType objectUpdate(qint64 newSerial);
 
     void internalUpdate() {return;}
@@ -271,6 +284,7 @@ class KSTCORE_EXPORT DataSource : public Object
     DataInterface<DataMatrix>* interf_matrix;
 
     QFileSystemWatcher *_watcher;
+    QString _updateCheckFile; // kept for adopt()
 
     QColor _color;
     // NOTE: You must bump the version key if you add new member variables
@@ -29,6 +29,7 @@
 #include <QXmlStreamWriter>
 #include <QTimer>
 #include <QFileSystemWatcher>
+#include <QMutex>
 
 #include "kst_i18n.h"
 #include "datacollection.h"
@@ -39,6 +40,10 @@
 #include "updatemanager.h"
 #include "settings.h"
 #include "dataplugin.h"
+#include "parallel.h"
+#ifndef Q_OS_WIN32
+#include "stdinsource.h"
+#endif
 
 #define DATASOURCE_UPDATE_TIMER_LENGTH 1000
 
@@ -82,6 +87,11 @@ QSettings& DataSourcePluginManager::settingsObject()
 }
 
 QMap<QString,QString> DataSourcePluginManager::url_map;
+QHash<QString, DataSourcePluginManager::Probe> DataSourcePluginManager::probes;
+qint64 DataSourcePluginManager::probeClock = 0;
+QMutex DataSourcePluginManager::probeMutex;
+QHash<QString, DataSourcePtr> DataSourcePluginManager::preloaded;
+QMutex DataSourcePluginManager::preloadedMutex;
 
 
 const QMap<QString,QString> DataSourcePluginManager::urlMap() {
@@ -112,6 +122,7 @@ static PluginList _pluginList;
 
 
 void DataSourcePluginManager::cleanupForExit() {
+  clearProbeCache();
   _pluginList.clear();
   qDebug() << "cleaning up for exit in datasource";
 //   for (QMap<QString,QString>::Iterator i = urlMap.begin(); i != urlMap.end(); ++i) {
@@ -259,10 +270,29 @@ QList<DataSourcePluginManager::PluginSortContainer> DataSourcePluginManager::bes
     }
   }
 
-  for (PluginList::Iterator it = info.begin(); it != info.end(); ++it) {
+  Probe probe;
+  if (findProbe(filename, &probe) && probe.havePlugins) {
+    return probe.plugins;
+  }
+
+  Probe found(filename);
+  found.havePlugins = true;
+  found.plugins = probePlugins(&settingsObject(), filename);
+  storeProbe(filename, found);
+
+  return found.plugins;
+}
+
+
+QList<DataSourcePluginManager::PluginSortContainer> DataSourcePluginManager::probePlugins(QSettings *settings, const QString& filename, QMutex *unsafe) {
+
+  QList<PluginSortContainer> bestPlugins;
+
+  for (PluginList::ConstIterator it = _pluginList.begin(); it != _pluginList.end(); ++it) {
     PluginSortContainer psc;
     if (DataSourcePluginInterface *p = (*it).plugin.data()) {
-      if ((psc.match = p->understands(&settingsObject(), filename)) > 0) {
+      QMutexLocker locker(p->isThreadSafe() ? 0L : unsafe);
+      if ((psc.match = p->understands(settings, filename)) > 0) {
         psc.plugin = p;
         bestPlugins.append(psc);
       }
@@ -275,43 +305,347 @@ QList<DataSourcePluginManager::PluginSortContainer> DataSourcePluginManager::bes
 }
 
 
-DataSourcePtr DataSourcePluginManager::findPluginFor(ObjectStore *store, const QString& filename, const QString& type, const QDomElement& e) {
+namespace Kst {
 
-  QList<PluginSortContainer> bestPlugins = bestPluginsForSource(filename, type);
+// Probes the plugins for a stretch of the files of a preload, and has those
+// which are thread safe make their sources.  Plugins which aren't call into
+// libraries (netCDF, CFITSIO, ...) which can't be used from two threads at
+// once: they are probed one at a time, and their sources are made later, in
+// the main thread.
+class PreloadJob : public ParallelJob {
+  public:
+    // what is read ahead of a file before the probes which must wait their
+    // turn: the headers and first lines understands() looks at
+    enum { ProbeBytes = 64 * 1024 };
 
-  // we don't actually iterate here, unless the first plugin fails.  (Not sure this helps at all.)
-  for (QList<PluginSortContainer>::Iterator i = bestPlugins.begin(); i != bestPlugins.end(); ++i) {
-    DataSourcePtr plugin = (*i).plugin->create(store, &settingsObject(), filename, QString(), e);
-    if (plugin) {
+    PreloadJob(ObjectStore *store, const QStringList& filenames, const QStringList& types,
+               const QList<QXmlStreamAttributes>& properties)
+      : _store(store), _filenames(filenames), _types(types), _properties(properties) {
+    }
+
+    void processChunk(int, qint64 begin, qint64 end) {
+      // plugins keep state in their settings group: one object per thread
+      QSettings settings("kst", "data");
+      for (qint64 i = begin; i < end; ++i) {
+        const QString& filename = _filenames.at(i);
+#ifndef Q_OS_WIN32
+        // probing a pipe would wait for its writer; only StdinSource reads it
+        if (StdinSource::isStream(filename)) {
+          continue;
+        }
+#endif
+        if (!QFileInfo(filename).exists()) {
+          continue;
+        }
+
+        DataSourcePluginInterface *plugin = provider(_types.value(i));
+        if (!plugin) {
+          DataSourcePluginManager::Probe probe;
+          if (!DataSourcePluginManager::findProbe(filename, &probe) || !probe.havePlugins) {
+            readAhead(filename);
+            probe = DataSourcePluginManager::Probe(filename);
+            probe.havePlugins = true;
+            probe.plugins = DataSourcePluginManager::probePlugins(&settings, filename, &_probeMutex);
+            DataSourcePluginManager::storeProbe(filename, probe);
+          }
+          // as findPluginFor(), which takes the best
+          if (!probe.plugins.isEmpty()) {
+            plugin = probe.plugins.first().plugin.data();
+          }
+        }
 
-      // add strings
-      const QStringList strings = plugin->string().list();
-      if (!strings.isEmpty()) {
-        foreach(const QString& key, strings) {
-          QString value;
-          DataString::ReadInfo readInfo(&value);
-          plugin->string().read(key, readInfo);
-          StringPtr s = store->createObject<String>();
-          s->setProvider(plugin);
-          s->setSlaveName(key);
-          s->setValue(value);
+        if (plugin && plugin->isThreadSafe()) {
+          create(plugin, &settings, filename, _types.value(i), _properties.value(i));
         }
       }
+    }
+
+  private:
+    // makes the source as DataSourcePluginFactory would, reading its index,
+    // and hands it to the main thread
+    void create(DataSourcePluginInterface *plugin, QSettings *settings, const QString& filename,
+                const QString& type, QXmlStreamAttributes properties) {
+      const QString key = DataSourcePluginManager::preloadKey(filename, type, properties);
+
+      DataSource::setMadeInAdvance(true);
+      DataSourcePtr source = plugin->create(_store, settings, filename, QString(), QDomElement());
+      if (source) {
+        source->parseProperties(properties);
+      }
+      DataSource::setMadeInAdvance(false);
+      if (!source) {
+        return;
+      }
+      if (QCoreApplication::instance()) {
+        source->moveToThread(QCoreApplication::instance()->thread());
+      }
+
+      QMutexLocker locker(&DataSourcePluginManager::preloadedMutex);
+      DataSourcePluginManager::preloaded.insert(key, source);
+    }
+
+    static void readAhead(const QString& filename) {
+      QFile file(filename);
+      if (QFileInfo(filename).isFile() && file.open(QIODevice::ReadOnly)) {
+        file.read(ProbeBytes);
+      }
+    }
+
+    // a plugin providing the type is taken without probing
+    static DataSourcePluginInterface *provider(const QString& type) {
+      if (type.isEmpty()) {
+        return 0L;
+      }
+      for (PluginList::ConstIterator it = _pluginList.begin(); it != _pluginList.end(); ++it) {
+        if ((*it).plugin.data() && (*it).plugin->provides(type)) {
+          return (*it).plugin.data();
+        }
+      }
+      return 0L;
+    }
+
+    ObjectStore *_store;
+    const QStringList _filenames;
+    const QStringList _types;
+    const QList<QXmlStreamAttributes> _properties;
+    QMutex _probeMutex;
+};
+
+}
+
+
+void DataSourcePluginManager::preloadSources(ObjectStore *store, const QStringList& filenames, const QStringList& types,
+                                             const QList<QXmlStreamAttributes>& properties) {
+  clearPreloadedSources();
+  if (filenames.isEmpty()) {
+    return;
+  }
+  init();
+
+  PreloadJob job(store, filenames, types, properties);
+  runParallel(&job, filenames.count(), 1);
+}
+
+
+QString DataSourcePluginManager::preloadKey(const QString& filename, const QString& type, const QXmlStreamAttributes& properties) {
+  QString key = filename + '\n' + type;
+  foreach (const QXmlStreamAttribute& attr, properties) {
+    key += '\n' + attr.name().toString() + '=' + attr.value().toString();
+  }
+  return key;
+}
 
-      // add scalars
-      const QStringList scalars = plugin->scalar().list();
-      if (!scalars.isEmpty()) {
-        foreach(const QString& key, scalars) {
-          double value;
-          DataScalar::ReadInfo readInfo(&value);
-          plugin->scalar().read(key, readInfo);
-          ScalarPtr s = store->createObject<Scalar>();
-          s->setProvider(plugin);
-          s->setSlaveName(key);
-          s->setValue(value);
+
+DataSourcePtr DataSourcePluginManager::loadPreloadedSource(ObjectStore *store, const QString& filename, const QString& type,
+                                                           const QXmlStreamAttributes& properties) {
+  DataSourcePtr source;
+  {
+    QMutexLocker locker(&preloadedMutex);
+    source = preloaded.take(preloadKey(filename, type, properties));
+  }
+  if (source) {
+    source->adopt(&settingsObject());
+    addSlaves(store, source);
+    store->addObject<DataSource>(source);
+  }
+  return source;
+}
+
+
+void DataSourcePluginManager::clearPreloadedSources() {
+  QMutexLocker locker(&preloadedMutex);
+  preloaded.clear();
+}
+
+
+DataSourcePluginManager::Probe::Probe(const QString& filename)
+  : size(-1), havePlugins(false), used(0) {
+  if (!filename.isEmpty()) {
+    const QFileInfo info(filename);
+    if (info.exists()) {
+      size = info.size();
+      modified = modificationTime(info);
+    }
+  }
+}
+
+
+QDateTime DataSourcePluginManager::Probe::modificationTime(const QFileInfo& info) {
+  const QDateTime modified = info.lastModified();
+  if (info.isDir()) {
+    const QFileInfo format(QDir(info.filePath()).filePath("format"));
+    if (format.exists() && format.lastModified() > modified) {
+      return format.lastModified();
+    }
+  }
+  return modified;
+}
+
+
+bool DataSourcePluginManager::findProbe(const QString& filename, Probe *probe) {
+  const QFileInfo info(filename);
+
+  QMutexLocker locker(&probeMutex);
+  QHash<QString, Probe>::Iterator it = probes.find(filename);
+  if (it == probes.end()) {
+    return false;
+  }
+  if (!info.exists() || (*it).size != info.size() || (*it).modified != Probe::modificationTime(info)) {
+    probes.erase(it);
+    return false;
+  }
+  (*it).used = ++probeClock;
+  *probe = *it;
+  return true;
+}
+
+
+void DataSourcePluginManager::storeProbe(const QString& filename, const Probe& probe) {
+  if (probe.size < 0) {
+    return;
+  }
+
+  QString evicted;
+  {
+    QMutexLocker locker(&probeMutex);
+    QHash<QString, Probe>::Iterator it = probes.find(filename);
+    if (it != probes.end() && (*it).size == probe.size && (*it).modified == probe.modified) {
+      // add to what is known of the file
+      if (probe.havePlugins) {
+        (*it).havePlugins = true;
+        (*it).plugins = probe.plugins;
+      }
+      (*it).used = ++probeClock;
+      return;
+    }
+    if (it == probes.end() && probes.count() >= MaxProbes) {
+      QHash<QString, Probe>::Iterator oldest = probes.begin();
+      for (QHash<QString, Probe>::Iterator i = probes.begin(); i != probes.end(); ++i) {
+        if ((*i).used < (*oldest).used) {
+          oldest = i;
         }
       }
+      evicted = oldest.key();
+      probes.erase(oldest);
+    }
+    Probe &stored = probes[filename];
+    stored = probe;
+    stored.used = ++probeClock;
+  }
+
+  if (!evicted.isEmpty()) {
+    QMetaObject::invokeMethod(ProbeWatcher::self(), "unwatch", Qt::QueuedConnection, Q_ARG(QString, evicted));
+  }
+  QMetaObject::invokeMethod(ProbeWatcher::self(), "watch", Qt::QueuedConnection, Q_ARG(QString, filename));
+}
+
 
+void DataSourcePluginManager::forgetProbe(const QString& filename) {
+  QMutexLocker locker(&probeMutex);
+  probes.remove(filename);
+}
+
+
+void DataSourcePluginManager::clearProbeCache() {
+  QMutexLocker locker(&probeMutex);
+  probes.clear();
+}
+
+
+bool DataSourcePluginManager::hasCachedProbe(const QString& filename) {
+  Probe probe;
+  return findProbe(filename, &probe);
+}
+
+
+static QMutex probeWatcherMutex;
+
+ProbeWatcher *ProbeWatcher::self() {
+  static ProbeWatcher *watcher = 0L;
+
+  QMutexLocker locker(&probeWatcherMutex);
+  if (!watcher) {
+    watcher = new ProbeWatcher;
+    if (QCoreApplication::instance()) {
+      watcher->moveToThread(QCoreApplication::instance()->thread());
+    }
+  }
+  return watcher;
+}
+
+
+ProbeWatcher::ProbeWatcher()
+  : QObject(), _watcher(0L) {
+}
+
+
+void ProbeWatcher::watch(const QString& filename) {
+  // made here, in the main thread, rather than in self()
+  if (!_watcher) {
+    _watcher = new QFileSystemWatcher(this);
+    connect(_watcher, SIGNAL(fileChanged(QString)), this, SLOT(changed(QString)));
+    connect(_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(changed(QString)));
+  }
+  if (!_watcher->files().contains(filename) && !_watcher->directories().contains(filename)) {
+    _watcher->addPath(filename);
+  }
+}
+
+
+void ProbeWatcher::unwatch(const QString& filename) {
+  if (_watcher) {
+    _watcher->removePath(filename);
+  }
+}
+
+
+void ProbeWatcher::changed(const QString& filename) {
+  DataSourcePluginManager::forgetProbe(filename);
+  // watched again when it's probed again
+  _watcher->removePath(filename);
+}
+
+
+void DataSourcePluginManager::addSlaves(ObjectStore *store, DataSourcePtr source) {
+  // add strings
+  const QStringList strings = source->string().list();
+  if (!strings.isEmpty()) {
+    foreach(const QString& key, strings) {
+      QString value;
+      DataString::ReadInfo readInfo(&value);
+      source->string().read(key, readInfo);
+      StringPtr s = store->createObject<String>();
+      s->setProvider(source);
+      s->setSlaveName(key);
+      s->setValue(value);
+    }
+  }
+
+  // add scalars
+  const QStringList scalars = source->scalar().list();
+  if (!scalars.isEmpty()) {
+    foreach(const QString& key, scalars) {
+      double value;
+      DataScalar::ReadInfo readInfo(&value);
+      source->scalar().read(key, readInfo);
+      ScalarPtr s = store->createObject<Scalar>();
+      s->setProvider(source);
+      s->setSlaveName(key);
+      s->setValue(value);
+    }
+  }
+}
+
+
+DataSourcePtr DataSourcePluginManager::findPluginFor(ObjectStore *store, const QString& filename, const QString& type, const QDomElement& e) {
+
+  QList<PluginSortContainer> bestPlugins = bestPluginsForSource(filename, type);
+
+  // we don't actually iterate here, unless the first plugin fails.  (Not sure this helps at all.)
+  for (QList<PluginSortContainer>::Iterator i = bestPlugins.begin(); i != bestPlugins.end(); ++i) {
+    DataSourcePtr plugin = (*i).plugin->create(store, &settingsObject(), filename, QString(), e);
+    if (plugin) {
+      addSlaves(store, plugin);
       return plugin;
     }
   }
@@ -322,10 +656,11 @@ DataSourcePtr DataSourcePluginManager::findPluginFor(ObjectStore *store, const Q
 DataSourcePtr DataSourcePluginManager::loadSource(ObjectStore *store, const QString& filename, const QString& type) {
 
 #ifndef Q_OS_WIN32
-  //if (filename == "stdin" || filename == "-") {
-    // FIXME: what store do we put this in?
-  //  return new StdinSource(0, settingsObject());
-  //}
+  if (StdinSource::isStream(filename)) {
+    DataSourcePtr dataSource = new StdinSource(store, &settingsObject(), filename);
+    store->addObject<DataSource>(dataSource);
+    return dataSource;
+  }
 #endif
   QString fn = obtainFile(filename);
   if (fn.isEmpty()) {
@@ -361,28 +696,16 @@ DataSourcePtr DataSourcePluginManager::findOrLoadSource(ObjectStore *store, cons
 
 bool DataSourcePluginManager::validSource(const QString& filename) {
 #ifndef Q_OS_WIN32
-//  if (filename == "stdin" || filename == "-") {
-//    return true;
-//  }
+  if (StdinSource::isStream(filename)) {
+    return true;
+  }
 #endif
   QString fn = obtainFile(filename);
   if (fn.isEmpty()) {
     return false;
   }
 
-  DataSourcePluginManager::init();
-
-  PluginList info = _pluginList;
-
-  for (PluginList::Iterator it = info.begin(); it != info.end(); ++it) {
-    if (DataSourcePluginInterface *p = (*it).plugin.data()) {
-      if ((p->understands(&settingsObject(), filename)) > 0) {
-        return true;
-      }
-    }
-  }
-
-  return false;
+  return !bestPluginsForSource(fn, QString()).isEmpty();
 }
 
 
@@ -459,133 +782,3 @@ DataSourceConfigWidget* DataSourcePluginManager::configWidgetForSource(const QSt
   Debug::self()->log(i18n("Could not find a datasource for '%1'(%2), but we found one just prior.  Something is wrong with Kst.", filename, type), Debug::Error);
   return 0L;
 }
-
-
-
-
-/*
-QStringList DataSourcePluginManager::fieldListForSource(const QString& filename, const QString& type, QString *outType, bool *complete) {
-  if (filename == "stdin" || filename == "-") {
-    return QStringList();
-  }
-
-  QString fn = obtainFile(filename);
-  if (fn.isEmpty()) {
-    return QStringList();
-  }
-
-  QList<PluginSortContainer> bestPlugins = bestPluginsForSource(fn, type);
-  QStringList rc;
-  for (QList<PluginSortContainer>::Iterator i = bestPlugins.begin(); i != bestPlugins.end(); ++i) {
-    QString typeSuggestion;
-    rc = (*i).plugin->fieldList(settingsObject(), fn, QString(), &typeSuggestion, complete);
-    if (!rc.isEmpty()) {
-      if (outType) {
-        if (typeSuggestion.isEmpty()) {
-          *outType = (*i).plugin->provides()[0];
-        } else {
-          *outType = typeSuggestion;
-        }
-      }
-      break;
-    }
-  }
-
-  return rc;
-}
-*/
-
-# if 0
-QStringList DataSourcePluginManager::matrixListForSource(const QString& filename, const QString& type, QString *outType, bool *complete) {
-  if (filename == "stdin" || filename == "-") {
-    return QStringList();
-  }
-
-  QString fn = obtainFile(filename);
-  if (fn.isEmpty()) {
-    return QStringList();
-  }
-
-  QList<PluginSortContainer> bestPlugins = bestPluginsForSource(fn, type);
-  QStringList rc;
-  for (QList<PluginSortContainer>::Iterator i = bestPlugins.begin(); i != bestPlugins.end(); ++i) {
-    QString typeSuggestion;
-    rc = (*i).plugin->matrixList(settingsObject(), fn, QString(), &typeSuggestion, complete);
-    if (!rc.isEmpty()) {
-      if (outType) {
-        if (typeSuggestion.isEmpty()) {
-          *outType = (*i).plugin->provides()[0];
-        } else {
-          *outType = typeSuggestion;
-        }
-      }
-      break;
-    }
-  }
-
-  return rc;
-}
-#endif
-
-
-QStringList DataSourcePluginManager::scalarListForSource(const QString& filename, const QString& type, QString *outType, bool *complete) {
-  if (filename == "stdin" || filename == "-") {
-    return QStringList();
-  }
-
-  QString fn = obtainFile(filename);
-  if (fn.isEmpty()) {
-    return QStringList();
-  }
-
-  QList<PluginSortContainer> bestPlugins = bestPluginsForSource(fn, type);
-  QStringList rc;
-  for (QList<PluginSortContainer>::Iterator i = bestPlugins.begin(); i != bestPlugins.end(); ++i) {
-    QString typeSuggestion;
-    rc = (*i).plugin->scalarList(&settingsObject(), fn, QString(), &typeSuggestion, complete);
-    if (!rc.isEmpty()) {
-      if (outType) {
-        if (typeSuggestion.isEmpty()) {
-          *outType = (*i).plugin->provides()[0];
-        } else {
-          *outType = typeSuggestion;
-        }
-      }
-      break;
-    }
-  }
-
-  return rc;
-}
-
-
-QStringList DataSourcePluginManager::stringListForSource(const QString& filename, const QString& type, QString *outType, bool *complete) {
-  if (filename == "stdin" || filename == "-") {
-    return QStringList();
-  }
-
-  QString fn = obtainFile(filename);
-  if (fn.isEmpty()) {
-    return QStringList();
-  }
-
-  QList<PluginSortContainer> bestPlugins = bestPluginsForSource(fn, type);
-  QStringList rc;
-  for (QList<PluginSortContainer>::Iterator i = bestPlugins.begin(); i != bestPlugins.end(); ++i) {
-    QString typeSuggestion;
-    rc = (*i).plugin->stringList(&settingsObject(), fn, QString(), &typeSuggestion, complete);
-    if (!rc.isEmpty()) {
-      if (outType) {
-        if (typeSuggestion.isEmpty()) {
-          *outType = (*i).plugin->provides()[0];
-        } else {
-          *outType = typeSuggestion;
-        }
-      }
-      break;
-    }
-  }
-
-  return rc;
-}
-
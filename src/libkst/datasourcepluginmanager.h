@@ -19,7 +19,14 @@
 #include "datasource.h"
 
 #include <QSettings>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
 #include <QMap>
+#include <QMutex>
+#include <QXmlStreamAttributes>
+
+class QFileSystemWatcher;
 
 
 namespace Kst {
@@ -46,6 +53,32 @@ class KSTCORE_EXPORT DataSourcePluginManager
     static SharedPtr<DataSource> loadSource(ObjectStore *store, const QString& filename, const QString& type = QString());
     static SharedPtr<DataSource> loadSource(ObjectStore *store, QDomElement& e);
     static SharedPtr<DataSource> findOrLoadSource(ObjectStore *store, const QString& filename);
+
+    /** Gets ready to load a batch of files, filenames[i] with reader types[i]
+        (which may be empty) and properties[i], on the compute thread pool:
+        probes the plugins for each file, so that loading them finds the
+        probes done.  The plugins which are thread safe make their sources
+        there and then, so that these read their index in parallel too;
+        loadPreloadedSource() hands them out.  Returns once every file is
+        done. */
+    static void preloadSources(ObjectStore *store, const QStringList& filenames, const QStringList& types,
+                               const QList<QXmlStreamAttributes>& properties);
+
+    /** The source preloadSources() made of filename with reader type and
+        properties, added to store; null if it made none.  Each is handed
+        out once. */
+    static SharedPtr<DataSource> loadPreloadedSource(ObjectStore *store, const QString& filename, const QString& type,
+                                                     const QXmlStreamAttributes& properties);
+
+    /** Drops the preloaded sources which were never loaded. */
+    static void clearPreloadedSources();
+
+    /** Forgets every cached probe. */
+    static void clearProbeCache();
+
+    /** Whether a probe of the file is cached, and still good for it. */
+    static bool hasCachedProbe(const QString& filename);
+
     static bool validSource(const QString& filename);
 
     static bool sourceHasConfigWidget(const QString& filename, const QString& type = QString());
@@ -54,10 +87,6 @@ class KSTCORE_EXPORT DataSourcePluginManager
     static bool pluginHasConfigWidget(const QString& plugin);
     static DataSourceConfigWidget *configWidgetForPlugin(const QString& plugin);
 
-    //static QStringList matrixListForSource(const QString& filename, const QString& type = QString(), QString *outType = 0L, bool *complete = 0L);
-    static QStringList scalarListForSource(const QString& filename, const QString& type = QString(), QString *outType = 0L, bool *complete = 0L);
-    static QStringList stringListForSource(const QString& filename, const QString& type = QString(), QString *outType = 0L, bool *complete = 0L);
-
 
   private:
     static QSettings& settingsObject();
@@ -71,9 +100,75 @@ class KSTCORE_EXPORT DataSourcePluginManager
       int operator==(const PluginSortContainer& x) const;
     };
     static QList<PluginSortContainer> bestPluginsForSource(const QString& filename, const QString& type);
+    // probes the plugins which aren't thread safe with unsafe locked, if given
+    static QList<PluginSortContainer> probePlugins(QSettings *settings, const QString& filename, QMutex *unsafe = 0L);
+    friend class PreloadJob;
+
+    // What probing a file found: the plugins understanding it, best first.
+    // Good while the file keeps its size and modification time, and until
+    // the watcher sees it change.
+    struct Probe {
+      // stamped with the size and modification time filename has now
+      explicit Probe(const QString& filename = QString());
+
+      // the modification time a probe of filename is stamped with: for a
+      // directory holding a dirfile, the later of its own and its format
+      // file's, as editing the format doesn't touch the directory
+      static QDateTime modificationTime(const QFileInfo& info);
+
+      qint64 size; // -1 if the file doesn't exist
+      QDateTime modified;
+      bool havePlugins;
+      QList<PluginSortContainer> plugins;
+      qint64 used; // probeClock when last stored or found
+    };
+    // past this, the least recently used probe goes
+    enum { MaxProbes = 256 };
+
+    static bool findProbe(const QString& filename, Probe *probe);
+    static void storeProbe(const QString& filename, const Probe& probe);
+    static void forgetProbe(const QString& filename);
+    friend class ProbeWatcher;
+
+    // the probes by file name, shared by every thread
+    static QHash<QString, Probe> probes;
+    static qint64 probeClock;
+    static QMutex probeMutex;
+
+    // the sources made by preloadSources(), by preloadKey()
+    static QHash<QString, DataSourcePtr> preloaded;
+    static QMutex preloadedMutex;
+    static QString preloadKey(const QString& filename, const QString& type, const QXmlStreamAttributes& properties);
+
+    // makes the strings and scalars a new source provides
+    static void addSlaves(ObjectStore *store, DataSourcePtr source);
+
     static DataSourcePtr findPluginFor(ObjectStore *store, const QString& filename, const QString& type, const QDomElement& e = QDomElement());
 };
 
+
+/** Drops the cached probe of a file when it changes.  Lives in the main
+    thread; files probed in other threads are handed to it with queued
+    calls. */
+class ProbeWatcher : public QObject
+{
+  Q_OBJECT
+  public:
+    static ProbeWatcher *self();
+
+  public Q_SLOTS:
+    void watch(const QString& filename);
+    void unwatch(const QString& filename);
+
+  private Q_SLOTS:
+    void changed(const QString& filename);
+
+  private:
+    ProbeWatcher();
+
+    QFileSystemWatcher *_watcher;
+};
+
 }
 
 
@@ -70,8 +70,8 @@ DataVector::DataVector(ObjectStore *store)
   _saveable = true;
   //_dontUseSkipAccel = false;
   _numSamples = 0;
-  _scalars["sum"]->setValue(0.0);
-  _scalars["sumsquared"]->setValue(0.0);
+  _stats.setValue("sum", 0.0);
+  _stats.setValue("sumsquared", 0.0);
   F0 = NF = 0; // nothing read yet
 
   N_AveReadBuf = 0;
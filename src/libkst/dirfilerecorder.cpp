@@ -0,0 +1,376 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "dirfilerecorder.h"
+
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QQueue>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "datavector.h"
+#include "debug.h"
+#include "math_kst.h"
+#include "updatemanager.h"
+#include "vectorexport.h"
+
+namespace Kst {
+
+// Appends the batches queued by the recorder to the field files, in order.
+// The queue is bounded, so a slow disk holds the recorder up rather than
+// letting the batches pile up in memory.
+class DirfileWriter : public QThread {
+  public:
+    enum { MaxQueuedBytes = 64 << 20 };
+
+    DirfileWriter(const QStringList& files) : _files(files), _queued(0), _finishing(false) {}
+
+    void queue(int field, const QByteArray& data) {
+      QMutexLocker locker(&_mutex);
+      while (_queued > MaxQueuedBytes && _error.isEmpty()) {
+        _written.wait(&_mutex);
+      }
+      if (_error.isEmpty()) {
+        _queue.enqueue(qMakePair(field, data));
+        _queued += data.size();
+        _ready.wakeOne();
+      }
+    }
+
+    // writes what is queued, then ends the thread
+    void finish() {
+      {
+        QMutexLocker locker(&_mutex);
+        _finishing = true;
+        _ready.wakeOne();
+      }
+      wait();
+    }
+
+    QString error() const {
+      QMutexLocker locker(&_mutex);
+      return _error;
+    }
+
+  protected:
+    void run() {
+      QList<QFile*> files;
+      foreach (const QString& name, _files) {
+        QFile *file = new QFile(name);
+        if (!file->open(QIODevice::WriteOnly | QIODevice::Append)) {
+          fail(QObject::tr("Could not open %1 for writing: %2").arg(name).arg(file->errorString()));
+        }
+        files.append(file);
+      }
+
+      QMutexLocker locker(&_mutex);
+      forever {
+        while (_queue.isEmpty() && !_finishing) {
+          _ready.wait(&_mutex);
+        }
+        if (_queue.isEmpty()) {
+          break;
+        }
+        const QPair<int, QByteArray> batch = _queue.dequeue();
+        locker.unlock();
+
+        QFile *file = files.at(batch.first);
+        if (file->isOpen() && file->write(batch.second) != batch.second.size()) {
+          fail(QObject::tr("Could not write to %1: %2").arg(file->fileName()).arg(file->errorString()));
+        }
+
+        locker.relock();
+        _queued -= batch.second.size();
+        _written.wakeAll();
+      }
+      locker.unlock();
+
+      qDeleteAll(files);
+    }
+
+  private:
+    void fail(const QString& error) {
+      QMutexLocker locker(&_mutex);
+      if (_error.isEmpty()) {
+        _error = error;
+        _queue.clear();
+        _queued = 0;
+        _written.wakeAll();
+      }
+    }
+
+    QStringList _files;
+    QQueue<QPair<int, QByteArray> > _queue;
+    qint64 _queued;
+    bool _finishing;
+    QString _error;
+    mutable QMutex _mutex;
+    QWaitCondition _ready;
+    QWaitCondition _written;
+};
+
+
+DirfileRecorder::DirfileRecorder(const QString& dirfile, QObject *parent)
+  : QObject(parent), _dirfile(dirfile), _writer(0L), _firstFrame(0), _recorded(0) {
+}
+
+
+DirfileRecorder::~DirfileRecorder() {
+  stop();
+}
+
+
+void DirfileRecorder::addVector(VectorPtr vector, const QString& field, int samplesPerFrame, DataVectorPtr frames) {
+  if (!vector || _writer) {
+    return;
+  }
+
+  if (DataVectorPtr dv = kst_cast<DataVector>(vector)) {
+    frames = dv;
+  }
+  if (samplesPerFrame <= 0) {
+    samplesPerFrame = 1;
+    if (frames) {
+      frames->readLock();
+      if (!frames->doSkip()) {
+        samplesPerFrame = qMax(frames->samplesPerFrame(), 1);
+      }
+      frames->unlock();
+    }
+  }
+
+  Field f;
+  f.vector = vector;
+  f.frames = frames;
+  f.name = field.isEmpty() ? vector->descriptiveName() : field;
+  f.samplesPerFrame = samplesPerFrame;
+  f.written = 0;
+  f.changed = 0;
+  f.held = 0;
+  _fields.append(f);
+}
+
+
+QStringList DirfileRecorder::fields() const {
+  QStringList names;
+  for (int i = 0; i < _fields.size(); ++i) {
+    names << _fields.at(i).name;
+  }
+  return VectorExport::dirfileFieldNames(names);
+}
+
+
+QString DirfileRecorder::errorString() const {
+  return _writer ? _writer->error() : _error;
+}
+
+
+bool DirfileRecorder::start() {
+  if (_writer) {
+    return true;
+  }
+  _error.clear();
+
+  QDir dir(_dirfile);
+  if (!dir.exists() && !QDir().mkpath(_dirfile)) {
+    _error = tr("Could not make the directory %1.").arg(_dirfile);
+    return false;
+  }
+
+  // the fields start at the first frame any data vector holds now
+  _firstFrame = -1;
+  for (int i = 0; i < _fields.size(); ++i) {
+    if (DataVectorPtr dv = _fields.at(i).frames) {
+      dv->readLock();
+      _firstFrame = _firstFrame < 0 ? dv->startFrame() : qMin(_firstFrame, qint64(dv->startFrame()));
+      dv->unlock();
+    }
+  }
+  _firstFrame = qMax(_firstFrame, qint64(0));
+
+  const QStringList names = fields();
+  QList<int> samplesPerFrame;
+  QStringList files;
+  for (int i = 0; i < _fields.size(); ++i) {
+    samplesPerFrame << _fields.at(i).samplesPerFrame;
+    files << dir.filePath(names.at(i));
+
+    QFile file(files.last());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      _error = tr("Could not open %1 for writing: %2").arg(file.fileName()).arg(file.errorString());
+      return false;
+    }
+    _fields[i].written = 0;
+    _fields[i].changed = _fields.at(i).vector->serialOfLastChange();
+    _fields[i].held = 0;
+    _fields[i].pending.clear();
+  }
+
+  QFile format(dir.filePath("format"));
+  const QByteArray spec = VectorExport::dirfileFormat(names, samplesPerFrame);
+  if (!format.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text) || format.write(spec) != spec.size()) {
+    _error = tr("Could not write %1: %2").arg(format.fileName()).arg(format.errorString());
+    return false;
+  }
+  format.close();
+
+  _recorded = 0;
+  _writer = new DirfileWriter(files);
+  _writer->start();
+  _lastFlush.start();
+
+  // the vectors are recorded whether or not anything shows them
+  QList<Object*> vectors;
+  for (int i = 0; i < _fields.size(); ++i) {
+    vectors << _fields.at(i).vector;
+  }
+  UpdateManager::self()->setInterest(this, vectors);
+
+  record();
+  connect(UpdateManager::self(), SIGNAL(objectsUpdated(qint64)), this, SLOT(record()));
+  return true;
+}
+
+
+void DirfileRecorder::stop() {
+  if (!_writer) {
+    return;
+  }
+  disconnect(UpdateManager::self(), SIGNAL(objectsUpdated(qint64)), this, SLOT(record()));
+  UpdateManager::self()->removeInterest(this);
+
+  record();
+  flush(true);
+  _writer->finish();
+  _error = _writer->error();
+  if (!_error.isEmpty()) {
+    Debug::self()->log(_error, Debug::Warning);
+  }
+  delete _writer;
+  _writer = 0L;
+}
+
+
+void DirfileRecorder::record() {
+  if (!_writer) {
+    return;
+  }
+
+  for (int i = 0; i < _fields.size(); ++i) {
+    Field& f = _fields[i];
+    f.vector->readLock();
+    const bool lockFrames = f.frames && f.frames.data() != f.vector.data();
+    if (lockFrames) {
+      f.frames->readLock();
+    }
+
+    // an equation over a data vector follows its frames only while it holds
+    // a sample for each of them
+    if (f.frames && f.frames->length() == f.vector->length()) {
+      recordByFrame(f);
+    } else {
+      recordGrowth(f);
+    }
+
+    if (lockFrames) {
+      f.frames->unlock();
+    }
+    f.vector->unlock();
+  }
+
+  flush(_lastFlush.elapsed() >= FlushInterval);
+}
+
+
+void DirfileRecorder::recordByFrame(Field& f) {
+  const DataVectorPtr dv = f.frames;
+  const qint64 frame = qMax(qint64(dv->startFrame()) - _firstFrame, qint64(0));
+  const double *v = f.vector->value();
+  const int length = f.vector->length();
+
+  if (dv->doSkip()) {
+    // sample k is frame + k * skip: the frames skipped over are NaN
+    const int skip = qMax(dv->skip(), 1);
+    const qint64 next = (f.written + f.samplesPerFrame - 1) / f.samplesPerFrame;
+    for (qint64 k = next > frame ? (next - frame + skip - 1) / skip : 0; k < length; ++k) {
+      pad(f, (frame + k * skip) * f.samplesPerFrame);
+      append(f, v + k, 1);
+    }
+  } else {
+    const qint64 first = frame * f.samplesPerFrame;
+    if (first + length > f.written) {
+      pad(f, first);
+      const int from = int(f.written - first);
+      append(f, v + from, length - from);
+    }
+  }
+  f.held = length;
+}
+
+
+void DirfileRecorder::recordGrowth(Field& f) {
+  const int length = f.vector->length();
+
+  if (f.vector->serialOfLastChange() != f.changed) {
+    f.changed = f.vector->serialOfLastChange();
+    // samples shifted out of the front were recorded; a vector rewritten
+    // without growing or shifting is recorded again from its start
+    const int shift = f.vector->numShift();
+    if (shift > 0) {
+      f.held = qMax(f.held - shift, 0);
+    } else if (length <= f.held) {
+      f.held = 0;
+    }
+  }
+
+  if (length > f.held) {
+    append(f, f.vector->value() + f.held, length - f.held);
+    f.held = length;
+  }
+}
+
+
+void DirfileRecorder::append(Field& f, const double *v, int count) {
+  f.pending.append(reinterpret_cast<const char*>(v), count * int(sizeof(double)));
+  f.written += count;
+  _recorded += count;
+}
+
+
+void DirfileRecorder::pad(Field& f, qint64 to) {
+  if (to > f.written) {
+    const QVector<double> gap(int(to - f.written), NOPOINT);
+    append(f, gap.constData(), gap.size());
+  }
+}
+
+
+void DirfileRecorder::flush(bool all) {
+  for (int i = 0; i < _fields.size(); ++i) {
+    Field& f = _fields[i];
+    if (!f.pending.isEmpty() && (all || f.pending.size() >= BatchBytes)) {
+      _writer->queue(i, f.pending);
+      f.pending.clear();
+    }
+  }
+  if (all) {
+    _lastFlush.restart();
+  }
+}
+
+}
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,112 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef DIRFILERECORDER_H
+#define DIRFILERECORDER_H
+
+#include <QObject>
+#include <QTime>
+#include <QVector>
+
+#include "kst_export.h"
+#include "datavector.h"
+
+namespace Kst {
+
+class DirfileWriter;
+
+/** Records vectors, as they grow, into the FLOAT64 fields of a dirfile, so
+    that a live session (stdin, a growing ASCII file, vectors pushed by a
+    script) can be read back later through the dirfile source.
+
+    After every update the samples each vector gained are gathered into
+    batches, which a writer thread appends to the field files.  A data
+    vector, or a vector whose samples line up with those of a data vector
+    (the output of an equation over it), is placed in its field by its
+    frames: frame 0 of the dirfile is the first frame any of them held at
+    start(), and frames which were never recorded, or which a skipping
+    vector skips over, are written as NaN, so every field lines up frame
+    for frame.  Other vectors are recorded from their start; when they are
+    rewritten rather than grown, what they hold past the samples they
+    shifted out is appended again. */
+class KSTCORE_EXPORT DirfileRecorder : public QObject
+{
+  Q_OBJECT
+  public:
+    DirfileRecorder(const QString& dirfile, QObject *parent = 0L);
+    ~DirfileRecorder();
+
+    /** Records vector into field, named after the vector if empty, with
+        samplesPerFrame samples per frame: if 0, a data vector's own when it
+        doesn't skip, else 1.  If vector isn't a data vector, frames is the
+        data vector its samples line up with, if any.  Only before start(). */
+    void addVector(VectorPtr vector, const QString& field = QString(), int samplesPerFrame = 0,
+                   DataVectorPtr frames = DataVectorPtr());
+
+    /** Writes the format file, replacing any dirfile there, records what
+        the vectors hold now and then follows every update.  Returns false,
+        with errorString() saying why, if the dirfile can't be written. */
+    bool start();
+
+    /** Records what is left, waits for it to be written and closes the
+        files. */
+    void stop();
+
+    bool isRecording() const { return _writer != 0L; }
+    const QString& dirfile() const { return _dirfile; }
+    QStringList fields() const;
+
+    /** Samples handed to the writer so far, over all fields */
+    qint64 samplesRecorded() const { return _recorded; }
+
+    /** Why start() failed or the writer stopped */
+    QString errorString() const;
+
+  public Q_SLOTS:
+    /** Picks up the samples gained since the last call.  Called after each
+        update once recording. */
+    void record();
+
+  private:
+    enum { BatchBytes = 1 << 20, FlushInterval = 1000 };
+
+    struct Field {
+      VectorPtr vector;
+      DataVectorPtr frames; // places the vector by frame, if set
+      QString name;
+      int samplesPerFrame;
+      qint64 written; // samples recorded, counted from the start of the field
+      qint64 changed; // the vector's serialOfLastChange() when last recorded
+      int held; // samples of the vector as it is now which were recorded
+      QByteArray pending;
+    };
+
+    void recordByFrame(Field& f);
+    void recordGrowth(Field& f);
+    void append(Field& f, const double *v, int count);
+    void pad(Field& f, qint64 to);
+    void flush(bool all);
+
+    QString _dirfile;
+    QVector<Field> _fields;
+    DirfileWriter *_writer;
+    QTime _lastFlush;
+    qint64 _firstFrame;
+    qint64 _recorded;
+    QString _error;
+};
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
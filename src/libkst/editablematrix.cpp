@@ -20,6 +20,8 @@
 #include <qbytearray.h>
 #include <QXmlStreamWriter>
 #include "kst_i18n.h"
+#include "objectstore.h"
+#include "sessiondata.h"
 
 namespace Kst {
 
@@ -40,14 +42,6 @@ const QString& EditableMatrix::typeString() const {
 
 
 void EditableMatrix::save(QXmlStreamWriter &xml) {
-
-  QByteArray qba(_zSize*sizeof(double), '\0');
-  QDataStream qds(&qba, QIODevice::WriteOnly);
-
-  for (int i = 0; i < _zSize; i++) {
-    qds << _z[i];
-  }
-
   xml.writeStartElement(staticTypeTag);
   saveNameInfo(xml, VNUM|MNUM|XNUM);
   xml.writeAttribute("xmin", QString::number(minX()));
@@ -56,7 +50,18 @@ void EditableMatrix::save(QXmlStreamWriter &xml) {
   xml.writeAttribute("ny", QString::number(yNumSteps()));
   xml.writeAttribute("xstep", QString::number(xStepSize()));
   xml.writeAttribute("ystep", QString::number(yStepSize()));
-  xml.writeTextElement("data", qCompress(qba).toBase64());
+
+  SessionData *sidecar = store() ? store()->sessionData : 0L;
+  if (!sidecar || !sidecar->writeArray(xml, _z, _zSize)) {
+    QByteArray qba(_zSize*sizeof(double), '\0');
+    QDataStream qds(&qba, QIODevice::WriteOnly);
+
+    for (int i = 0; i < _zSize; i++) {
+      qds << _z[i];
+    }
+
+    xml.writeTextElement("data", qCompress(qba).toBase64());
+  }
   xml.writeEndElement();
 }
 
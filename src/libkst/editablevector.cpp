@@ -21,6 +21,8 @@
 
 #include "debug.h"
 #include "kst_i18n.h"
+#include "objectstore.h"
+#include "sessiondata.h"
 
 namespace Kst {
 
@@ -50,16 +52,17 @@ void EditableVector::setValue(const int &i, const double &val) { //sa Vector::ch
     if(i>_size) {
         resize(i,1);
     }
-    _scalars["sum"]->setValue(_sum+val-_v[i]);
-    _scalars["sumsquared"]->setValue(_sum*_sum);
-    _scalars["max"]->setValue(qMax(_max,val));
-    _scalars["min"]->setValue(qMin(_min,_min));
+    _stats.setValue("sum", _sum+val-_v[i]);
+    _stats.setValue("sumsquared", _sum*_sum);
+    _stats.setValue("max", qMax(_max,val));
+    _stats.setValue("min", qMin(_min,_min));
     double b=(float)(qMax((float)0.0f,(float)_minPos));
-    _scalars["minpos"]->setValue(qMin(_min,b));
-    _scalars["last"]->setValue(_v[_size-1]);
-    _scalars["first"]->setValue(_v[0]);
+    _stats.setValue("minpos", qMin(_min,b));
+    _stats.setValue("last", _v[_size-1]);
+    _stats.setValue("first", _v[0]);
     _v[i]=val;
     unlock();
+    touchDescriptiveNames();
 }
 
 /** Save vector information */
@@ -68,14 +71,17 @@ void EditableVector::save(QXmlStreamWriter &s) {
   saveNameInfo(s, VNUM|XNUM);
 
   if (_saveData) {
-    QByteArray qba(length()*sizeof(double), '\0');
-    QDataStream qds(&qba, QIODevice::WriteOnly);
+    SessionData *sidecar = store() ? store()->sessionData : 0L;
+    if (!sidecar || !sidecar->writeArray(s, _v, length())) {
+      QByteArray qba(length()*sizeof(double), '\0');
+      QDataStream qds(&qba, QIODevice::WriteOnly);
 
-    for (int i = 0; i < length(); i++) {
-      qds << _v[i];
-    }
+      for (int i = 0; i < length(); i++) {
+        qds << _v[i];
+      }
 
-    s.writeTextElement("data", qCompress(qba).toBase64());
+      s.writeTextElement("data", qCompress(qba).toBase64());
+    }
   }
   s.writeEndElement();
 }
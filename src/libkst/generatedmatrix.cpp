@@ -114,6 +114,7 @@ void GeneratedMatrix::change(uint nX, uint nY, double minX, double minY,
       }
     }
   }
+  _pyramid.invalidate();
 }
 
 }
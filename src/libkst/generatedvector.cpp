@@ -73,8 +73,8 @@ void GeneratedVector::changeRange(double x0, double x1, int n) {
   _min = x0;
   _max = x1;
 
-  _scalars["min"]->setValue(x0);
-  _scalars["max"]->setValue(x1);
+  _stats.setValue("min", x0);
+  _stats.setValue("max", x1);
 
   registerChange();
 }
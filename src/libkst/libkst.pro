@@ -33,6 +33,7 @@ SOURCES += builtindatasources.cpp \
     datastring.cpp \
     dateparser.cpp \
     debug.cpp \
+    dirfilerecorder.cpp \
     editablematrix.cpp \
     editablevector.cpp \
     extension.cpp \
@@ -41,6 +42,7 @@ SOURCES += builtindatasources.cpp \
 	labelinfo.cpp \
     math_kst.cpp \
     matrix.cpp \
+    matrixpyramid.cpp \
     matrixfactory.cpp \
     measuretime.cpp \
     namedobject.cpp \
@@ -49,22 +51,27 @@ SOURCES += builtindatasources.cpp \
     objectlist.cpp \
     objectmap.cpp \
     objectstore.cpp \
+    parallel.cpp \
     plotiteminterface.cpp \
     primitive.cpp \
     primitivefactory.cpp \
     rwlock.cpp \
     scalar.cpp \
+    sessiondata.cpp \
     scalarfactory.cpp \
     shortnameindex.cpp \
+    statscalars.cpp \
     string_kst.cpp \
     stringfactory.cpp \
     updatemanager.cpp \
     vector.cpp \
+    vectorexport.cpp \
     vectorfactory.cpp \
     vscalar.cpp \
     ksttimezone.cpp
 	
-#!win32:SOURCES += stdinsource.cpp
+!win32:SOURCES += stdinsource.cpp
+!win32:HEADERS += stdinsource.h
 !macx:!win32:SOURCES += sysinfo.c \
     psversion.c
 	
@@ -84,6 +91,7 @@ HEADERS += builtindatasources.h \
     datastring.h \
     dateparser.h \
     debug.h \
+    dirfilerecorder.h \
     editablematrix.h \
     editablevector.h \
     events.h \
@@ -98,6 +106,7 @@ HEADERS += builtindatasources.h \
     logevents.h \
     math_kst.h \
     matrix.h \
+    matrixpyramid.h \
     matrixfactory.h \
     measuretime.h \
     namedobject.h \
@@ -105,6 +114,7 @@ HEADERS += builtindatasources.h \
     objectlist.h \
     objectmap.h \
     objectstore.h \
+    parallel.h \
     plotiteminterface.h \
     primitive.h \
     primitivefactory.h \
@@ -112,15 +122,17 @@ HEADERS += builtindatasources.h \
     psversion.h \
     rwlock.h \
     scalar.h \
+    sessiondata.h \
     scalarfactory.h \
     sharedptr.h \
-#    stdinsource.h \
+    statscalars.h \
     string_kst.h \
     stringfactory.h \
     sysinfo.h \
     timezones.h \
     updatemanager.h \
     vector.h \
+    vectorexport.h \
     vectorfactory.h \
     vscalar.h \
     ksttimezone.h
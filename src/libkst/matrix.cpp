@@ -40,7 +40,8 @@ const QString Matrix::staticTypeString = I18N_NOOP("Matrix");
 
 Matrix::Matrix(ObjectStore *store)
     : Primitive(store, 0L), _NS(0), _NRealS(0), _nX(1), _nY(0), _minX(0), _minY(0), _stepX(1), _stepY(1),
-      _invertXHint(false), _invertYHint(false), _editable(false), _saveable(false), _z(0L), _zSize(0) {
+      _invertXHint(false), _invertYHint(false), _editable(false), _saveable(false), _z(0L), _zSize(0),
+      _snapshotsWanted(false) {
 
   _initializeShortName();
 
@@ -164,16 +165,17 @@ bool Matrix::setValueRaw(int x, int y, double z) {
     return false;
   }
   _z[index] = z;
+  _pyramid.invalidate(x, y);
   return true;
 }
 
 double Matrix::minValue() const {
-  return _scalars["min"]->value();
+  return _stats.value("min");
 }
 
 
 double Matrix::maxValue() const {
-  return _scalars["max"]->value();
+  return _stats.value("max");
 }
 
 double Matrix::minValueNoSpike() const {
@@ -196,103 +198,39 @@ double Matrix::maxValueNoSpike() const {
 }
 
 void Matrix::calcNoSpikeRange(double per) {
-  double *min_list, *max_list, min_of_max, max_of_min;
-  int n_list;
-  int max_n = 50000; // the most samples we will look at...
-  double n_skip;
-  double x=0;
-  int n_notnan;
-
-  int i,j, k;
-
-  // count number of points which aren't nans.
-  for (i=n_notnan=0; i<_NS; i++) {
-    if (!KST_ISNAN(_z[i])) {
-      n_notnan++;
-    }
-  }
-
-  if (n_notnan==0) {
+  // The per * N lowest and the per * N highest of the N samples which aren't
+  // NaNs are taken to be spikes.  The ranked values come from the pyramid's tile histograms, so
+  // only the samples near the cut get looked at.
+  int nX, nY;
+  const double *z = zLevel(0, &nX, &nY);
+  _pyramid.update(z, nX, nY);
+  const qint64 n = _pyramid.numberCount();
+  const qint64 k = qint64(double(n) * qMax(per, 0.0));
+
+  if (n == 0 || k == 0) {
     _minNoSpike = 0;
     _maxNoSpike = 0;
-
     return;
   }
 
-  if (per < 0) {
-    per = 0;
-  }
-  per *= (double)n_notnan/(double)_NS;
-  max_n *= int((double)_NS/(double)n_notnan);
-
-  n_skip = (double)_NS/max_n;
-  if (n_skip<1.0) n_skip = 1.0;
-
-  n_list = int(double(_NS)*per/n_skip);
-
-  min_list = (double *)malloc(n_list * sizeof(double));
-  max_list = (double *)malloc(n_list * sizeof(double));
-
-
-  // prefill the list
-  for (i=0; i<n_list; i++) {
-    min_list[i] = 1E+300;
-    max_list[i] = -1E+300;
-  }
-  min_of_max = -1E+300;
-  max_of_min = 1E+300;
-
-  i = n_list;
-  for (j=0; j<_NS; j=int(i*n_skip), i++) {
-    if (_z[j] < max_of_min) { // member for the min list
-      // replace max of min with the new value
-      for (k=0; k<n_list; k++) {
-        if (min_list[k]==max_of_min) {
-          x = min_list[k] = _z[j];
-          break;
-        }
-      }
-      max_of_min = x;
-      // find the new max_of_min
-      for (k=0; k<n_list; k++) {
-        if (min_list[k] > max_of_min) {
-          max_of_min = min_list[k];
-        }
-      }
-    }
-    if (_z[j] > min_of_max) { // member for the max list
-      //printf("******** z: %g  min_of_max: %g\n", _z[j], min_of_max);
-      // replace min of max with the new value
-      for (k=0; k<n_list; k++) {
-        if (max_list[k]==min_of_max) {
-          x = max_list[k] = _z[j];
-          break;
-        }
-      }
-      // find the new min_of_max
-      min_of_max = x;
-      for (k=0; k<n_list; k++) {
-        if (max_list[k] < min_of_max) {
-          min_of_max = max_list[k];
-        }
-      }
-    }
+  double low, high;
+  if (k - 1 > n - k || !_pyramid.rankedValues(z, k - 1, &low, &high)) {
+    // nothing is left between the cuts
+    _minNoSpike = 1E+300;
+    _maxNoSpike = -1E+300;
+    return;
   }
 
-  // FIXME: this needs a z spike insensitive algorithm...
-  _minNoSpike = max_of_min;
-  _maxNoSpike = min_of_max;
-
-  free(min_list);
-  free(max_list);
+  _minNoSpike = low;
+  _maxNoSpike = high;
 }
 
 double Matrix::meanValue() const {
-  return _scalars["mean"]->value();
+  return _stats.value("mean");
 }
 
 double Matrix::minValuePositive() const {
-  return _scalars["minpos"]->value();
+  return _stats.value("minpos");
 }
 
 int Matrix::numNew() const {
@@ -309,6 +247,7 @@ void Matrix::zero() {
   for (int i = 0; i < _zSize; i++) {
     _z[i] = 0.0;
   }
+  _pyramid.invalidate();
   updateScalars();
 }
 
@@ -317,6 +256,7 @@ void Matrix::blank() {
   for (int i = 0; i < _zSize; ++i) {
     _z[i] = NOPOINT;
   }
+  _pyramid.invalidate();
   updateScalars();
 }
 
@@ -335,47 +275,130 @@ void Matrix::internalUpdate() {
   _NS = _nX * _nY;
 
   if (_zSize > 0) {
-    double min = NAN;
-    double max = NAN;
-    double minpos = NAN;
-    double sum = 0.0, sumsquared = 0.0;
-    bool initialized = false;
-
-    _NRealS = 0;
-
-    for (int i = 0; i < _zSize; i++) {
-      if (isfinite(_z[i]) && !KST_ISNAN(_z[i])) {
-        if (!initialized) {
-          min = _z[i];
-          max = _z[i];
-          minpos = (_z[0] > 0) ? _z[0] : 1.0E300;
-          initialized = true;
-          _NRealS++;
-        } else {
-          if (min > _z[i]) {
-            min = _z[i];
-          }
-          if (max < _z[i]) {
-            max = _z[i];
-          }
-          if (minpos > _z[i] && _z[i] > 0) {
-            minpos = _z[i];
-          }
-          sum += _z[i];
-          sumsquared += _z[i] * _z[i];
-
-          _NRealS++;
-        }
-      }
-    }
-    _scalars["sum"]->setValue(sum);
-    _scalars["sumsquared"]->setValue(sumsquared);
-    _scalars["max"]->setValue(max);
-    _scalars["min"]->setValue(min);
-    _scalars["minpos"]->setValue(minpos);
+    // only the tiles written to since the last update are scanned again
+    int nX, nY;
+    const MatrixPyramid::Stats stats = _pyramid.update(zLevel(0, &nX, &nY), nX, nY);
+
+    _NRealS = int(stats.count);
+    _stats.setValue("sum", stats.sum);
+    _stats.setValue("sumsquared", stats.sumSquared);
+    _stats.setValue("max", stats.max);
+    _stats.setValue("min", stats.min);
+    _stats.setValue("minpos", stats.minPos);
 
     updateScalars();
   }
+
+  publishSnapshot();
+}
+
+
+const double *Matrix::zLevel(int level, int *nX, int *nY) const {
+  // _z may be shorter than _nX x _nY while a data matrix is being read
+  *nY = qMax(_nY, 0);
+  *nX = *nY > 0 ? qMin(qMax(_nX, 0), _zSize / *nY) : 0;
+  if (level <= 0 || *nX == 0) {
+    return _z;
+  }
+
+  const double *z = _pyramid.level(_z, level);
+  *nX = MatrixPyramid::levelSize(*nX, level);
+  *nY = MatrixPyramid::levelSize(*nY, level);
+  return z;
+}
+
+
+MatrixSnapshot::MatrixSnapshot()
+  : _version(0), _nX(0), _nY(0), _minX(0.0), _minY(0.0), _stepX(1.0), _stepY(1.0),
+    _minValue(0.0), _maxValue(0.0) {
+}
+
+
+double MatrixSnapshot::valueRaw(int x, int y, bool *ok) const {
+  const int index = x * _nY + y;
+  if (x >= _nX || x < 0 || y >= _nY || y < 0 || index >= _z.size() || index < 0 ||
+      !isfinite(_z.at(index)) || KST_ISNAN(_z.at(index))) {
+    if (ok) {
+      (*ok) = false;
+    }
+    return 0.0;
+  }
+  if (ok) {
+    (*ok) = true;
+  }
+  return _z.at(index);
+}
+
+
+double MatrixSnapshot::value(double x, double y, bool *ok) const {
+  int x_index = (int)((x - _minX) / (double)_stepX);
+  int y_index = (int)((y - _minY) / (double)_stepY);
+  return valueRaw(x_index, y_index, ok);
+}
+
+
+MatrixSnapshot Matrix::makeSnapshot() const {
+  MatrixSnapshot s;
+  const int n = qMax(0, qMin(_zSize, _nX * _nY));
+  s._z = QVector<double>(n);
+  if (n > 0) {
+    memcpy(s._z.data(), _z, n * sizeof(double));
+  }
+  s._nX = _nX;
+  s._nY = _nY;
+  s._minX = _minX;
+  s._minY = _minY;
+  s._stepX = _stepX;
+  s._stepY = _stepY;
+  s._minValue = minValue();
+  s._maxValue = maxValue();
+  return s;
+}
+
+
+MatrixSnapshot Matrix::snapshot() const {
+  {
+    QMutexLocker locker(&_snapshotMutex);
+    if (_snapshotsWanted) {
+      return _snapshot;
+    }
+  }
+
+  readLock();
+  MatrixSnapshot s = makeSnapshot();
+  {
+    QMutexLocker locker(&_snapshotMutex);
+    if (_snapshotsWanted) {
+      s = _snapshot;
+    } else {
+      s._version = _snapshot._version + 1;
+      _snapshot = s;
+      _snapshotsWanted = true;
+    }
+  }
+  unlock();
+  return s;
+}
+
+
+void Matrix::publishSnapshot() {
+  {
+    QMutexLocker locker(&_snapshotMutex);
+    if (!_snapshotsWanted) {
+      return;
+    }
+    // as Vector::publishSnapshot(): stop once the last reader let go
+    if (_snapshot._z.isEmpty() || _snapshot._z.isDetached()) {
+      _snapshot._z = QVector<double>();
+      _snapshotsWanted = false;
+      return;
+    }
+  }
+
+  MatrixSnapshot s = makeSnapshot();
+  QMutexLocker locker(&_snapshotMutex);
+  s._version = _snapshot._version + 1;
+  _snapshot = s;
 }
 
 void Matrix::setXLabelInfo(const LabelInfo &label_info) {
@@ -413,46 +436,24 @@ void Matrix::setEditable(bool editable) {
 }
 
 
+static const StatScalars::Stat matrixStats[] = {
+  { "max", "Max" },
+  { "min", "Min" },
+  { "mean", "Mean" },
+  { "sigma", "Sigma" },
+  { "rms", "Rms" },
+  { "ns", "NS" },
+  { "sum", "Sum" },
+  { "sumsquared", "SumSquared" },
+  { "minpos", "MinPos" }
+};
+
+
 void Matrix::createScalars(ObjectStore *store) {
   Q_ASSERT(store);
-  ScalarPtr sp;
   VectorPtr vp;
 
-  _scalars.insert("max", sp=store->createObject<Scalar>());
-  sp->setProvider(this);
-  sp->setSlaveName("Max");
-
-  _scalars.insert("min", sp=store->createObject<Scalar>());
-  sp->setProvider(this);
-  sp->setSlaveName("Min");
-
-  _scalars.insert("mean", sp=store->createObject<Scalar>());
-  sp->setProvider(this);
-  sp->setSlaveName("Mean");
-
-  _scalars.insert("sigma", sp=store->createObject<Scalar>());
-  sp->setProvider(this);
-  sp->setSlaveName("Sigma");
-
-  _scalars.insert("rms", sp=store->createObject<Scalar>());
-  sp->setProvider(this);
-  sp->setSlaveName("Rms");
-
-  _scalars.insert("ns", sp=store->createObject<Scalar>());
-  sp->setProvider(this);
-  sp->setSlaveName("NS");
-
-  _scalars.insert("sum", sp=store->createObject<Scalar>());
-  sp->setProvider(this);
-  sp->setSlaveName("Sum");
-
-  _scalars.insert("sumsquared", sp=store->createObject<Scalar>());
-  sp->setProvider(this);
-  sp->setSlaveName("SumSquared");
-
-  _scalars.insert("minpos", sp=store->createObject<Scalar>());
-  sp->setProvider(this);
-  sp->setSlaveName("MinPos");
+  _stats.init(this, &_scalars, matrixStats, sizeof(matrixStats)/sizeof(matrixStats[0]));
 
   _vectors.insert("z", vp = store->createObject<Vector>());
   vp->setProvider(this);
@@ -462,16 +463,17 @@ void Matrix::createScalars(ObjectStore *store) {
 
 
 void Matrix::updateScalars() {
-  _scalars["ns"]->setValue(_NS);
+  _stats.setValue("ns", _NS);
   if (_NRealS >= 2) {
-    _scalars["mean"]->setValue(_scalars["sum"]->value()/double(_NRealS));
-    _scalars["sigma"]->setValue( sqrt(
-        (_scalars["sumsquared"]->value() - _scalars["sum"]->value()*_scalars["sum"]->value()/double(_NRealS))/ double(_NRealS-1) ) );
-    _scalars["rms"]->setValue(sqrt(_scalars["sumsquared"]->value()/double(_NRealS)));
+    const double sum = _stats.value("sum");
+    const double sumsquared = _stats.value("sumsquared");
+    _stats.setValue("mean", sum/double(_NRealS));
+    _stats.setValue("sigma", sqrt((sumsquared - sum*sum/double(_NRealS))/ double(_NRealS-1)));
+    _stats.setValue("rms", sqrt(sumsquared/double(_NRealS)));
   } else {
-    _scalars["sigma"]->setValue(_scalars["max"]->value() - _scalars["min"]->value());
-    _scalars["rms"]->setValue(sqrt(_scalars["sumsquared"]->value()));
-    _scalars["mean"]->setValue(0);
+    _stats.setValue("sigma", _stats.value("max") - _stats.value("min"));
+    _stats.setValue("rms", sqrt(_stats.value("sumsquared")));
+    _stats.setValue("mean", 0);
   }
 }
 
@@ -501,6 +503,7 @@ bool Matrix::resizeZ(int sz, bool reinit) {
     return false;
 #endif
     _zSize = sz;
+    _pyramid.invalidate();
     updateScalars();
   }
   return true;
@@ -590,6 +593,7 @@ bool Matrix::resize(int xSize, int ySize, bool reinit) {
   _NS = _nX * _nY;
   _zSize = sz;
 
+  _pyramid.invalidate();
   updateScalars();
 
   return true;
@@ -642,6 +646,29 @@ void Matrix::change(QByteArray &data, uint nX, uint nY, double minX, double minY
   internalUpdate();
 }
 
+
+void Matrix::change(const double *data, qint64 count, uint nX, uint nY, double minX, double minY, double stepX, double stepY) {
+  _nX = nX;
+  _nY = nY;
+  _minX = minX;
+  _minY = minY;
+  _stepX = stepX;
+  _stepY = stepY;
+
+  _saveable = true;
+  resizeZ(nX*nY, true);
+
+  const qint64 n = qMin(count, qint64(nX)*nY);
+  if (n > 0 && _zSize >= n) {
+    memcpy(_z, data, n*sizeof(double));
+  }
+  if (n < qint64(nX)*nY) {
+    Debug::self()->log(i18n("Saved matrix contains less data than it claims."), Debug::Warning);
+    resizeZ(int(n), false);
+  }
+  internalUpdate();
+}
+
 QString Matrix::descriptionTip() const {
   return i18n("Matrix: %1\n %2 x %3").arg(Name()).arg(_nX).arg(_nY);
 }
@@ -674,6 +701,16 @@ ObjectList<Primitive> Matrix::outputPrimitives() const {
   return primitive_list;
 }
 
+PrimitivePtr Matrix::materializeSlave(const QString &shortName) {
+  return kst_cast<Primitive>(_stats.materialize(shortName));
+}
+
+
+QStringList Matrix::unmaterializedSlaveNames() const {
+  return _stats.unmaterializedNames();
+}
+
+
 PrimitiveMap Matrix::metas() const
 {
   PrimitiveMap meta;
@@ -690,18 +727,17 @@ PrimitiveMap Matrix::metas() const
 }
 
 QByteArray Matrix::getBinaryArray() const {
-    readLock();
+    const MatrixSnapshot snap = snapshot();
     QByteArray ret;
     QDataStream ds(&ret, QIODevice::WriteOnly);
-    ds<<(qint32)_nX<<(qint32)_nY<<_minX<<_minY<<_stepX<<_stepY; //fixme: this makes it not compatible w/ change(...)
+    ds<<(qint32)snap.xNumSteps()<<(qint32)snap.yNumSteps()<<snap.minX()<<snap.minY()<<snap.xStepSize()<<snap.yStepSize(); //fixme: this makes it not compatible w/ change(...)
 
-    uint i;
-    uint n = _nX*_nY;
     // fill in the raw array with the data
-    for (i = 0; i < n; i++) {
-      ds << _z[i];
+    const double *z = snap.z();
+    const int n = snap.xNumSteps()*snap.yNumSteps();
+    for (int i = 0; i < n; i++) {
+      ds << (i < snap._z.size() ? z[i] : 0.0);
     }
-    unlock();
     return ret;
 }
 
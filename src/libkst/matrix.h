@@ -18,6 +18,7 @@
 #include "scalar.h"
 #include "vector.h"
 #include "primitive.h"
+#include "matrixpyramid.h"
 
 class QXmlStreamWriter;
 
@@ -26,6 +27,42 @@ namespace Kst {
 class Matrix;
 typedef SharedPtr<Matrix> MatrixPtr;
 
+/** An immutable copy of a matrix's data and geometry as of one of its
+    updates; see VectorSnapshot. */
+class KSTCORE_EXPORT MatrixSnapshot {
+  public:
+    MatrixSnapshot();
+
+    int version() const { return _version; }
+    bool isNull() const { return _version == 0; }
+
+    int xNumSteps() const { return _nX; }
+    int yNumSteps() const { return _nY; }
+    double xStepSize() const { return _stepX; }
+    double yStepSize() const { return _stepY; }
+    double minX() const { return _minX; }
+    double minY() const { return _minY; }
+
+    double minValue() const { return _minValue; }
+    double maxValue() const { return _maxValue; }
+
+    /** the flat-packed z values, column by column as in Matrix */
+    const double *z() const { return _z.constData(); }
+
+    // as the Matrix functions of the same names
+    double value(double x, double y, bool *ok = 0L) const;
+    double valueRaw(int x, int y, bool *ok = 0L) const;
+
+  private:
+    friend class Matrix;
+
+    QVector<double> _z;
+    int _version;
+    int _nX, _nY;
+    double _minX, _minY, _stepX, _stepY;
+    double _minValue, _maxValue;
+};
+
 class KSTCORE_EXPORT Matrix : public Primitive
 {
   Q_OBJECT
@@ -50,6 +87,10 @@ class KSTCORE_EXPORT Matrix : public Primitive
     void change(QByteArray& data, uint nX, uint nY, double minX=0, double minY=0,
         double stepX=1, double stepY=1);
 
+    // count values, in the order of Z()
+    void change(const double *data, qint64 count, uint nX, uint nY, double minX=0, double minY=0,
+        double stepX=1, double stepY=1);
+
     // Return the sample count (x times y) of the matrix
     virtual int sampleCount() const;
 
@@ -142,17 +183,29 @@ class KSTCORE_EXPORT Matrix : public Primitive
 
     double Z(int i) const {return _z[i];}
 
+    // the z values averaged over 2^level x 2^level blocks, *nX x *nY of
+    // them in the same order as Z(); level 0 is the matrix itself.  Valid
+    // until the next update.  Lock the matrix for reading.
+    const double *zLevel(int level, int *nX, int *nY) const;
+
     // output primitives: statistics scalars, etc.
     VectorMap vectors() const {return _vectors;}
     ScalarMap scalars() const {return _scalars;}
+    ScalarPtr scalar(const QString &key) { return _stats.scalar(key); }
     StringMap strings() const {return _strings;}
 
     virtual PrimitiveMap metas() const;
 
     virtual ObjectList<Primitive> outputPrimitives() const;
 
+    virtual SharedPtr<Primitive> materializeSlave(const QString &shortName);
+    virtual QStringList unmaterializedSlaveNames() const;
+
     QByteArray getBinaryArray() const;
 
+    /** The data as of the last update; see Vector::snapshot(). */
+    MatrixSnapshot snapshot() const;
+
   protected:
     int _NS;
     int _NRealS; // number of samples with real values
@@ -196,7 +249,22 @@ class KSTCORE_EXPORT Matrix : public Primitive
     ObjectMap<Vector> _vectors;
     ObjectMap<String> _strings;
 
+    // the statistics, created as scalars only when asked for
+    StatScalars _stats;
+
+    // per tile statistics and reduced resolution copies of _z.  Whatever
+    // writes to _z other than through setValueRaw() must invalidate() it.
+    mutable MatrixPyramid _pyramid;
+
+    // called with the matrix write locked at the end of each update
+    void publishSnapshot();
+
+  private:
+    MatrixSnapshot makeSnapshot() const;
 
+    mutable QMutex _snapshotMutex;
+    mutable MatrixSnapshot _snapshot;
+    mutable bool _snapshotsWanted;
 };
 
 typedef ObjectList<Matrix> MatrixList;
@@ -18,6 +18,7 @@
 #include "editablematrix.h"
 #include "datamatrix.h"
 #include "objectstore.h"
+#include "sessiondata.h"
 #include "datasourcepluginmanager.h"
 
 namespace Kst {
@@ -102,6 +103,8 @@ EditableMatrixFactory::~EditableMatrixFactory() {
 
 PrimitivePtr EditableMatrixFactory::generatePrimitive(ObjectStore *store, QXmlStreamReader& xml) {
   QByteArray data;
+  QVector<double> array;
+  bool inSidecar = false;
   QString descriptiveName;
 
   Q_ASSERT(store);
@@ -129,6 +132,12 @@ PrimitivePtr EditableMatrixFactory::generatePrimitive(ObjectStore *store, QXmlSt
         QByteArray qbca = QByteArray::fromBase64(qcs.toLatin1());
         data = qUncompress(qbca);
 
+      } else if (n == "data_sidecar") {
+        if (!store->sessionData || !store->sessionData->readArray(xml.attributes(), &array)) {
+          Debug::self()->log(QObject::tr("Matrix data missing from the session's data file."), Debug::Warning);
+        }
+        inSidecar = true;
+        xml.readElementText();
       } else {
         return 0;
       }
@@ -148,7 +157,11 @@ PrimitivePtr EditableMatrixFactory::generatePrimitive(ObjectStore *store, QXmlSt
   }
 
   EditableMatrixPtr matrix = store->createObject<EditableMatrix>();
-  matrix->change(data, uint(nX), uint(nY), minX, minY, stepX, stepY);
+  if (inSidecar) {
+    matrix->change(array.constData(), array.size(), uint(nX), uint(nY), minX, minY, stepX, stepY);
+  } else {
+    matrix->change(data, uint(nX), uint(nY), minX, minY, stepX, stepY);
+  }
   matrix->setDescriptiveName(descriptiveName);
 
   matrix->writeLock();
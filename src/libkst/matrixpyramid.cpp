@@ -0,0 +1,567 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "matrixpyramid.h"
+
+#include <math.h>
+#include <algorithm>
+
+#include "math_kst.h"
+#include "parallel.h"
+
+namespace Kst {
+
+// tiles per chunk when running over tiles in parallel
+static const qint64 MinTileChunk = 16;
+
+// a ranked value is picked out of the samples once the histogram bin it
+// falls in holds no more than this many...
+static const qint64 GatherLimit = 1 << 20;
+
+// ...or once the bins are as narrow as doubles allow.
+static const int MaxRefinements = 8;
+
+
+MatrixPyramid::Stats::Stats()
+  : count(0), min(NAN), max(NAN), minPos(1.0E300), sum(0.0), sumSquared(0.0) {
+}
+
+
+MatrixPyramid::Tile::Tile()
+  : negInf(0), posInf(0), dirty(true), histogramDirty(true) {
+}
+
+
+MatrixPyramid::MatrixPyramid()
+  : _nX(0), _nY(0), _tilesX(0), _tilesY(0), _allDirty(true), _negInf(0), _posInf(0),
+    _histogramLo(0.0), _histogramHi(0.0), _histogramsValid(false) {
+}
+
+
+void MatrixPyramid::tileRange(int tile, int *x0, int *x1, int *y0, int *y1) const {
+  *x0 = (tile / _tilesY) * TileSize;
+  *y0 = (tile % _tilesY) * TileSize;
+  *x1 = qMin(*x0 + int(TileSize), _nX);
+  *y1 = qMin(*y0 + int(TileSize), _nY);
+}
+
+
+int MatrixPyramid::binOf(double v, double lo, double hi) {
+  if (!(hi > lo) || v <= lo) {
+    return 0;
+  }
+  if (v >= hi) {
+    return HistogramBins - 1;
+  }
+  return qBound(0, int((v - lo) / (hi - lo) * HistogramBins), HistogramBins - 1);
+}
+
+
+// Whether v fell in the chosen bin at every step of the search so far.  The
+// bins are always recomputed with binOf() rather than compared against their
+// edges, so that a sample is counted in the same bin at every step.
+bool MatrixPyramid::inFrames(double v, const QVector<Frame> &frames) {
+  for (int i = 0; i < frames.size(); ++i) {
+    if (binOf(v, frames[i].lo, frames[i].hi) != frames[i].bin) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+class TileStatsJob : public ParallelJob {
+  public:
+    TileStatsJob(MatrixPyramid *p, const double *z, const QVector<int> &tiles)
+      : _p(p), _data(p->_tiles.data()), _z(z), _tiles(tiles) {
+    }
+
+    void processChunk(int, qint64 begin, qint64 end) {
+      for (qint64 i = begin; i < end; ++i) {
+        MatrixPyramid::Tile &tile = _data[_tiles[i]];
+        MatrixPyramid::Stats s;
+        qint64 negInf = 0, posInf = 0;
+
+        int x0, x1, y0, y1;
+        _p->tileRange(_tiles[i], &x0, &x1, &y0, &y1);
+        for (int x = x0; x < x1; ++x) {
+          const double *column = _z + qint64(x) * _p->_nY;
+          for (int y = y0; y < y1; ++y) {
+            const double v = column[y];
+            if (KST_ISNAN(v)) {
+              continue;
+            }
+            if (!isfinite(v)) {
+              if (v < 0) {
+                ++negInf;
+              } else {
+                ++posInf;
+              }
+              continue;
+            }
+            if (s.count == 0) {
+              s.min = s.max = v;
+            } else if (v < s.min) {
+              s.min = v;
+            } else if (v > s.max) {
+              s.max = v;
+            }
+            if (v > 0 && v < s.minPos) {
+              s.minPos = v;
+            }
+            s.sum += v;
+            s.sumSquared += v * v;
+            ++s.count;
+          }
+        }
+
+        tile.stats = s;
+        tile.negInf = negInf;
+        tile.posInf = posInf;
+        tile.dirty = false;
+        tile.histogramDirty = true;
+      }
+    }
+
+  private:
+    MatrixPyramid *_p;
+    MatrixPyramid::Tile *_data;
+    const double *_z;
+    const QVector<int> &_tiles;
+};
+
+
+class TileHistogramJob : public ParallelJob {
+  public:
+    TileHistogramJob(MatrixPyramid *p, const double *z, const QVector<int> &tiles)
+      : _p(p), _data(p->_tiles.data()), _z(z), _tiles(tiles) {
+    }
+
+    void processChunk(int, qint64 begin, qint64 end) {
+      const double lo = _p->_histogramLo;
+      const double hi = _p->_histogramHi;
+      for (qint64 i = begin; i < end; ++i) {
+        MatrixPyramid::Tile &tile = _data[_tiles[i]];
+        tile.histogram.fill(0, MatrixPyramid::HistogramBins);
+        tile.histogramDirty = false;
+        if (tile.stats.count == 0) {
+          continue;
+        }
+
+        quint32 *h = tile.histogram.data();
+        int x0, x1, y0, y1;
+        _p->tileRange(_tiles[i], &x0, &x1, &y0, &y1);
+        for (int x = x0; x < x1; ++x) {
+          const double *column = _z + qint64(x) * _p->_nY;
+          for (int y = y0; y < y1; ++y) {
+            const double v = column[y];
+            if (!KST_ISNAN(v) && isfinite(v)) {
+              ++h[MatrixPyramid::binOf(v, lo, hi)];
+            }
+          }
+        }
+      }
+    }
+
+  private:
+    MatrixPyramid *_p;
+    MatrixPyramid::Tile *_data;
+    const double *_z;
+    const QVector<int> &_tiles;
+};
+
+
+// Histograms, over [lo, hi], the samples of tiles which are still in the
+// search, or with gather set, collects them.  Tiles left with no such sample
+// are dropped from the search.
+class RefineJob : public ParallelJob {
+  public:
+    RefineJob(MatrixPyramid *p, const double *z, const QVector<int> &tiles, const QVector<MatrixPyramid::Frame> &frames,
+              double lo, double hi, bool gather, int chunks)
+      : _p(p), _z(z), _tiles(tiles), _frames(frames), _lo(lo), _hi(hi), _gather(gather), _chunks(chunks),
+        _counts(gather ? 0 : chunks * MatrixPyramid::HistogramBins, 0), _values(gather ? chunks : 0),
+        _keep(tiles.size(), false) {
+      // written from the chunks: don't let them detach
+      _countData = _counts.data();
+      _valueData = _values.data();
+      _keepData = _keep.data();
+    }
+
+    void processChunk(int chunk, qint64 begin, qint64 end) {
+      qint64 *counts = _gather ? 0L : _countData + chunk * MatrixPyramid::HistogramBins;
+      for (qint64 i = begin; i < end; ++i) {
+        int x0, x1, y0, y1;
+        _p->tileRange(_tiles[i], &x0, &x1, &y0, &y1);
+        bool found = false;
+        for (int x = x0; x < x1; ++x) {
+          const double *column = _z + qint64(x) * _p->_nY;
+          for (int y = y0; y < y1; ++y) {
+            const double v = column[y];
+            if (KST_ISNAN(v) || !isfinite(v) || !MatrixPyramid::inFrames(v, _frames)) {
+              continue;
+            }
+            found = true;
+            if (_gather) {
+              _valueData[chunk].append(v);
+            } else {
+              ++counts[MatrixPyramid::binOf(v, _lo, _hi)];
+            }
+          }
+        }
+        _keepData[i] = found;
+      }
+    }
+
+    void mergeCounts(QVector<qint64> *counts) const {
+      counts->fill(0, MatrixPyramid::HistogramBins);
+      for (int c = 0; c < _chunks; ++c) {
+        const qint64 *b = _counts.constData() + c * MatrixPyramid::HistogramBins;
+        for (int i = 0; i < MatrixPyramid::HistogramBins; ++i) {
+          (*counts)[i] += b[i];
+        }
+      }
+    }
+
+    void mergeValues(QVector<double> *values) const {
+      values->clear();
+      for (int c = 0; c < _chunks; ++c) {
+        *values += _values[c];
+      }
+    }
+
+    QVector<int> keptTiles() const {
+      QVector<int> kept;
+      for (int i = 0; i < _tiles.size(); ++i) {
+        if (_keep[i]) {
+          kept.append(_tiles[i]);
+        }
+      }
+      return kept;
+    }
+
+  private:
+    MatrixPyramid *_p;
+    const double *_z;
+    const QVector<int> &_tiles;
+    const QVector<MatrixPyramid::Frame> &_frames;
+    double _lo;
+    double _hi;
+    bool _gather;
+    int _chunks;
+    QVector<qint64> _counts;
+    QVector<QVector<double> > _values;
+    QVector<bool> _keep;
+    qint64 *_countData;
+    QVector<double> *_valueData;
+    bool *_keepData;
+};
+
+
+// Averages level n-1 (src) down to level n (dst), either all of it, one
+// dst column per item, or (with tiles) only the cells covering those tiles.
+class LevelJob : public ParallelJob {
+  public:
+    LevelJob(MatrixPyramid *p, int n, const double *src, double *dst, const QVector<int> *tiles)
+      : _p(p), _n(n), _src(src), _dst(dst), _tiles(tiles),
+        _srcNX(MatrixPyramid::levelSize(p->_nX, n - 1)), _srcNY(MatrixPyramid::levelSize(p->_nY, n - 1)),
+        _dstNY(MatrixPyramid::levelSize(p->_nY, n)) {
+    }
+
+    void processChunk(int, qint64 begin, qint64 end) {
+      if (!_tiles) {
+        reduce(int(begin), int(end), 0, _dstNY);
+        return;
+      }
+      for (qint64 i = begin; i < end; ++i) {
+        int x0, x1, y0, y1;
+        _p->tileRange((*_tiles)[i], &x0, &x1, &y0, &y1);
+        reduce(x0 >> _n, ((x1 - 1) >> _n) + 1, y0 >> _n, ((y1 - 1) >> _n) + 1);
+      }
+    }
+
+  private:
+    void reduce(int i0, int i1, int j0, int j1) {
+      for (int i = i0; i < i1; ++i) {
+        const int a1 = qMin(2 * i + 2, _srcNX);
+        for (int j = j0; j < j1; ++j) {
+          const int b1 = qMin(2 * j + 2, _srcNY);
+          double sum = 0.0;
+          int count = 0;
+          for (int a = 2 * i; a < a1; ++a) {
+            for (int b = 2 * j; b < b1; ++b) {
+              const double v = _src[qint64(a) * _srcNY + b];
+              if (!KST_ISNAN(v)) {
+                sum += v;
+                ++count;
+              }
+            }
+          }
+          _dst[qint64(i) * _dstNY + j] = count > 0 ? sum / count : NAN;
+        }
+      }
+    }
+
+    MatrixPyramid *_p;
+    int _n;
+    const double *_src;
+    double *_dst;
+    const QVector<int> *_tiles;
+    int _srcNX;
+    int _srcNY;
+    int _dstNY;
+};
+
+
+void MatrixPyramid::invalidate() {
+  QMutexLocker locker(&_mutex);
+  _allDirty = true;
+}
+
+
+void MatrixPyramid::invalidate(int x, int y) {
+  QMutexLocker locker(&_mutex);
+  if (x < 0 || y < 0 || x >= _nX || y >= _nY) {
+    _allDirty = true;
+  } else {
+    _tiles[(x / TileSize) * _tilesY + y / TileSize].dirty = true;
+  }
+}
+
+
+MatrixPyramid::Stats MatrixPyramid::update(const double *z, int nX, int nY) {
+  QMutexLocker locker(&_mutex);
+
+  if (nX != _nX || nY != _nY) {
+    _nX = qMax(0, nX);
+    _nY = qMax(0, nY);
+    _tilesX = (_nX + TileSize - 1) / TileSize;
+    _tilesY = (_nY + TileSize - 1) / TileSize;
+    _tiles.clear();
+    _tiles.resize(_tilesX * _tilesY);
+    _levels.clear();
+    _histogramsValid = false;
+    _allDirty = true;
+  }
+
+  QVector<int> changed;
+  for (int t = 0; t < _tiles.size(); ++t) {
+    if (_allDirty || _tiles[t].dirty) {
+      changed.append(t);
+    }
+  }
+
+  if (!changed.isEmpty()) {
+    TileStatsJob job(this, z, changed);
+    runParallel(&job, changed.size(), MinTileChunk);
+    updateLevels(z, changed);
+  }
+  _allDirty = false;
+
+  Stats total;
+  _negInf = _posInf = 0;
+  for (int t = 0; t < _tiles.size(); ++t) {
+    const Tile &tile = _tiles[t];
+    _negInf += tile.negInf;
+    _posInf += tile.posInf;
+    if (tile.stats.count == 0) {
+      continue;
+    }
+    if (total.count == 0) {
+      total.min = tile.stats.min;
+      total.max = tile.stats.max;
+    } else {
+      total.min = qMin(total.min, tile.stats.min);
+      total.max = qMax(total.max, tile.stats.max);
+    }
+    total.minPos = qMin(total.minPos, tile.stats.minPos);
+    total.sum += tile.stats.sum;
+    total.sumSquared += tile.stats.sumSquared;
+    total.count += tile.stats.count;
+  }
+  if (total.count == 0) {
+    total.minPos = NAN;
+  }
+
+  _stats = total;
+  if (_histogramsValid && (total.min != _histogramLo || total.max != _histogramHi)) {
+    _histogramsValid = false;
+  }
+  return total;
+}
+
+
+qint64 MatrixPyramid::numberCount() const {
+  QMutexLocker locker(&_mutex);
+  return _stats.count + _negInf + _posInf;
+}
+
+
+void MatrixPyramid::updateHistograms(const double *z) {
+  QVector<int> stale;
+  for (int t = 0; t < _tiles.size(); ++t) {
+    if (!_histogramsValid || _tiles[t].histogramDirty) {
+      stale.append(t);
+    }
+  }
+
+  _histogramLo = _stats.min;
+  _histogramHi = _stats.max;
+  _histogramsValid = true;
+
+  if (!stale.isEmpty()) {
+    TileHistogramJob job(this, z, stale);
+    runParallel(&job, stale.size(), MinTileChunk);
+  }
+}
+
+
+double MatrixPyramid::valueAtRank(const double *z, qint64 rank) {
+  if (rank < _negInf) {
+    return -HUGE_VAL;
+  }
+  rank -= _negInf;
+  if (rank >= _stats.count) {
+    return HUGE_VAL;
+  }
+  if (_stats.min == _stats.max) {
+    return _stats.min;
+  }
+
+  updateHistograms(z);
+
+  // The first histogram comes from the tiles.  Each further step histograms
+  // the samples in the bin holding the rank, only looking at the tiles which
+  // have samples in it, until few enough are left to sort.
+  QVector<qint64> counts(HistogramBins, 0);
+  for (int t = 0; t < _tiles.size(); ++t) {
+    if (_tiles[t].stats.count > 0) {
+      const quint32 *h = _tiles[t].histogram.constData();
+      for (int b = 0; b < HistogramBins; ++b) {
+        counts[b] += h[b];
+      }
+    }
+  }
+
+  QVector<Frame> frames;
+  QVector<int> tiles;
+  double lo = _histogramLo;
+  double hi = _histogramHi;
+  for (;;) {
+    int bin = 0;
+    while (bin < HistogramBins - 1 && rank >= counts[bin]) {
+      rank -= counts[bin];
+      ++bin;
+    }
+
+    if (frames.isEmpty()) {
+      for (int t = 0; t < _tiles.size(); ++t) {
+        if (_tiles[t].stats.count > 0 && _tiles[t].histogram[bin] > 0) {
+          tiles.append(t);
+        }
+      }
+    }
+    Frame frame = { lo, hi, bin };
+    frames.append(frame);
+
+    const double width = (hi - lo) / HistogramBins;
+    const double binLo = lo + bin * width;
+    const double binHi = bin == HistogramBins - 1 ? hi : lo + (bin + 1) * width;
+
+    if (counts[bin] <= GatherLimit) {
+      const int chunks = parallelChunks(tiles.size(), MinTileChunk);
+      RefineJob job(this, z, tiles, frames, 0.0, 0.0, true, chunks);
+      runParallel(&job, tiles.size(), MinTileChunk);
+      QVector<double> values;
+      job.mergeValues(&values);
+      if (values.isEmpty()) {
+        break;
+      }
+      rank = qMin(rank, qint64(values.size() - 1));
+      std::nth_element(values.begin(), values.begin() + rank, values.end());
+      return values[rank];
+    }
+
+    if (frames.size() >= MaxRefinements || !(binLo < binHi) || binLo + width == binLo) {
+      break;
+    }
+
+    const int chunks = parallelChunks(tiles.size(), MinTileChunk);
+    RefineJob job(this, z, tiles, frames, binLo, binHi, false, chunks);
+    runParallel(&job, tiles.size(), MinTileChunk);
+    job.mergeCounts(&counts);
+    tiles = job.keptTiles();
+    lo = binLo;
+    hi = binHi;
+  }
+
+  // the bin can't be split any further: its samples all but equal its edge.
+  const Frame &last = frames.last();
+  const double width = (last.hi - last.lo) / HistogramBins;
+  return qBound(_stats.min, last.lo + last.bin * width, _stats.max);
+}
+
+
+bool MatrixPyramid::rankedValues(const double *z, qint64 rank, double *low, double *high) {
+  QMutexLocker locker(&_mutex);
+  const qint64 n = _stats.count + _negInf + _posInf;
+  if (rank < 0 || rank >= n) {
+    return false;
+  }
+  *low = valueAtRank(z, rank);
+  *high = valueAtRank(z, n - 1 - rank);
+  return true;
+}
+
+
+void MatrixPyramid::buildLevel(const double *z, int n) {
+  const double *src = n == 1 ? z : _levels[n - 1].constData();
+  _levels[n].resize(qint64(levelSize(_nX, n)) * levelSize(_nY, n));
+  LevelJob job(this, n, src, _levels[n].data(), 0L);
+  runParallel(&job, levelSize(_nX, n), qMax(1, (1 << 16) / qMax(1, levelSize(_nY, n))));
+}
+
+
+void MatrixPyramid::updateLevels(const double *z, const QVector<int> &changed) {
+  for (int n = 1; n < _levels.size() && !_levels[n].isEmpty(); ++n) {
+    if (_allDirty || (1 << n) > TileSize) {
+      // above the tile size the cells of neighbouring tiles overlap, but
+      // these levels are small.
+      buildLevel(z, n);
+    } else {
+      const double *src = n == 1 ? z : _levels[n - 1].constData();
+      LevelJob job(this, n, src, _levels[n].data(), &changed);
+      runParallel(&job, changed.size(), MinTileChunk);
+    }
+  }
+}
+
+
+const double *MatrixPyramid::level(const double *z, int n) {
+  QMutexLocker locker(&_mutex);
+  n = qMin(n, int(MaxLevel));
+  if (n <= 0 || _nX == 0 || _nY == 0) {
+    return z;
+  }
+  if (_levels.size() <= n) {
+    _levels.resize(n + 1);
+  }
+  for (int m = 1; m <= n; ++m) {
+    if (_levels[m].isEmpty()) {
+      buildLevel(z, m);
+    }
+  }
+  return _levels[n].constData();
+}
+
+}
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,142 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef MATRIXPYRAMID_H
+#define MATRIXPYRAMID_H
+
+#include <QMutex>
+#include <QVector>
+
+#include "kst_export.h"
+
+namespace Kst {
+
+/*
+ *  Per tile statistics and reduced resolution copies of a Matrix.
+ *
+ *  The matrix is cut into TileSize x TileSize tiles.  Each tile keeps the
+ *  min, max, sum, ... of its samples and, once spike insensitive ranges have
+ *  been asked for, a histogram of them.  After the first update only the
+ *  tiles marked as changed are scanned again, in parallel, and the matrix
+ *  statistics and histograms are merged from the tiles.
+ *
+ *  Level n of the pyramid is the matrix averaged over 2^n x 2^n blocks, for
+ *  drawing it at about the resolution of the screen.  A level is made the
+ *  first time it's asked for, from the level below, and from then on only
+ *  the blocks covering changed tiles are recomputed.
+ *
+ *  The pyramid doesn't hold the samples: the matrix passes its z array
+ *  (x major, as in Matrix) to every call.
+ */
+class KSTCORE_EXPORT MatrixPyramid {
+  public:
+    enum { TileSize = 64, HistogramBins = 256, MaxLevel = 16 };
+
+    struct KSTCORE_EXPORT Stats {
+      Stats();
+
+      qint64 count;      // finite samples
+      double min;        // NaN if there are no finite samples
+      double max;
+      double minPos;     // least positive sample, 1.0E300 if there is none
+      double sum;
+      double sumSquared;
+    };
+
+    MatrixPyramid();
+
+    // Every sample changed.
+    void invalidate();
+
+    // Sample (x, y) changed.
+    void invalidate(int x, int y);
+
+    // Brings the tiles up to date with the nX x nY samples of z and returns
+    // the statistics of the whole matrix.
+    Stats update(const double *z, int nX, int nY);
+
+    // The samples with rank samples below them and rank samples above them,
+    // in sorted order, NaNs left out: sorted[rank] and sorted[N - 1 - rank].
+    // Returns false if there are fewer than rank + 1 samples.  Call after
+    // update().
+    bool rankedValues(const double *z, qint64 rank, double *low, double *high);
+
+    // Number of samples which aren't NaN.  Call after update().
+    qint64 numberCount() const;
+
+    // Level n of the pyramid, levelSize(nX, n) x levelSize(nY, n) values in
+    // the same order as z; z itself for level 0.  NaN samples are left out of
+    // the averages.  The array is valid until the next update().  Call after
+    // update().
+    const double *level(const double *z, int n);
+
+    static int levelSize(int samples, int level) { return (samples + (1 << level) - 1) >> level; }
+
+  private:
+    Q_DISABLE_COPY(MatrixPyramid)
+
+    struct Tile {
+      Tile();
+
+      Stats stats;
+      qint64 negInf;
+      qint64 posInf;
+      bool dirty;
+      bool histogramDirty;
+      QVector<quint32> histogram;
+    };
+
+    // A refinement step in the search for a ranked value: the samples in
+    // [lo, hi] were put into HistogramBins bins and bin was chosen.
+    struct Frame {
+      double lo;
+      double hi;
+      int bin;
+    };
+
+    friend class TileStatsJob;
+    friend class TileHistogramJob;
+    friend class RefineJob;
+    friend class LevelJob;
+
+    void tileRange(int tile, int *x0, int *x1, int *y0, int *y1) const;
+    void updateHistograms(const double *z);
+    double valueAtRank(const double *z, qint64 rank);
+    void updateLevels(const double *z, const QVector<int> &changed);
+    void buildLevel(const double *z, int n);
+
+    static int binOf(double v, double lo, double hi);
+    static bool inFrames(double v, const QVector<Frame> &frames);
+
+    mutable QMutex _mutex;
+
+    int _nX, _nY;
+    int _tilesX, _tilesY;
+    QVector<Tile> _tiles;
+    bool _allDirty;
+
+    Stats _stats;
+    qint64 _negInf, _posInf;
+
+    // the range the tile histograms were made over
+    double _histogramLo, _histogramHi;
+    bool _histogramsValid;
+
+    // _levels[n] is level n, or empty if it hasn't been asked for
+    QVector<QVector<double> > _levels;
+};
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
@@ -16,6 +16,7 @@
  ***************************************************************************/
 #include "namedobject.h"
 
+#include <QAtomicInt>
 #include <QFontMetrics>
 #include <QWidget>
 #include <QDebug>
@@ -142,8 +143,23 @@ QString NamedObject::shortName() const {
 }
 
 
+static QAtomicInt _descriptiveNameEpoch;
+
 void NamedObject::setDescriptiveName(QString new_name) {
   _manualDescriptiveName = new_name;
+  _descriptiveNameEpoch.ref();
+}
+
+void NamedObject::touchDescriptiveNames() {
+  _descriptiveNameEpoch.ref();
+}
+
+int NamedObject::descriptiveNameEpoch() {
+#if QT_VERSION >= 0x050000
+  return _descriptiveNameEpoch.load();
+#else
+  return _descriptiveNameEpoch;
+#endif
 }
 
 bool NamedObject::descriptiveNameIsManual() const {
@@ -101,12 +101,18 @@ public:
     virtual QString descriptionTip() const = 0; // description for tooltips
     void setDescriptiveName(QString new_name); // auto if new_name.isEmpty()
     bool descriptiveNameIsManual() const;
+    // bumped by every setDescriptiveName() and touchDescriptiveNames(), so
+    // that name lookups can tell when their index may be out of date
+    static int descriptiveNameEpoch();
     static void processShortNameIndexAttributes(QXmlStreamAttributes &attrs);
 
     // Reset all name indexes.  Should only be used by ObjectStore when clearing the store entirely.
     static void resetNameIndex();
 
   protected:
+    // automatic names may have changed (new inputs, values or slaves)
+    static void touchDescriptiveNames();
+
     virtual QString _automaticDescriptiveName() const= 0;
     virtual void _initializeShortName() = 0;
     QString _manualDescriptiveName;
@@ -57,7 +57,7 @@ int Object::getUsage() const {
 
 void Object::deleteDependents() {
   QList<ObjectPtr> Objects = _store->objectList();
-  foreach (ObjectPtr object, Objects) {
+  foreach (const ObjectPtr &object, Objects) {
     if (object->uses(this)) {
       _store->removeObject(object);
     }
@@ -72,6 +72,11 @@ bool Object::uses(ObjectPtr p) const {
 }
 
 
+QList<ObjectPtr> Object::inputObjects() const {
+  return QList<ObjectPtr>();
+}
+
+
 ObjectStore* Object::store() const {
   return _store;
 }
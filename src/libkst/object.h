@@ -52,7 +52,8 @@ class KSTCORE_EXPORT Object : public QObject, public Shared, public KstRWLock, p
     enum UpdateType { NoChange = 0, Updated, Deferred };
 
     virtual UpdateType objectUpdate(qint64 newSerial);
-    virtual void registerChange() {_serial = Forced; emit dirty();}
+    // an edit: automatic names following the inputs or values may change
+    virtual void registerChange() {registerNewValue(); touchDescriptiveNames();}
 
     virtual void reset();
 
@@ -77,6 +78,9 @@ class KSTCORE_EXPORT Object : public QObject, public Shared, public KstRWLock, p
 
     virtual bool uses(ObjectPtr p) const;
 
+    // The objects this one is computed from, for demand driven updates
+    virtual QList<ObjectPtr> inputObjects() const;
+
   protected:
     Object();
     virtual ~Object();
@@ -84,6 +88,9 @@ class KSTCORE_EXPORT Object : public QObject, public Shared, public KstRWLock, p
     friend class ObjectStore;
     ObjectStore *_store;  // set by ObjectStore
 
+    // a new value from an update, which leaves every name as it was
+    void registerNewValue() {_serial = Forced; emit dirty();}
+
     virtual qint64 minInputSerial() const = 0;
     virtual qint64 maxInputSerialOfLastChange() const = 0;
 
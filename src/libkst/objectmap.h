@@ -38,10 +38,16 @@ public:
     return HashMap::operator[](key);
   }
 
-  const SharedPtr<T> operator[](const QString& key) const
+  // returns a reference so that lookups don't touch the reference count
+  const SharedPtr<T>& operator[](const QString& key) const
   {
     addKey(key);
-    return HashMap::operator[](key);
+    typename HashMap::const_iterator it = HashMap::find(key);
+    if (it == HashMap::constEnd()) {
+      static const SharedPtr<T> null;
+      return null;
+    }
+    return it.value();
   }
 
   void addKey(const QString& key) const
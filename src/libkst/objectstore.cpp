@@ -32,6 +32,7 @@
 namespace Kst {
 
 ObjectStore::ObjectStore()
+  : sessionData(0L), _nextSequence(0), _shortNameClashes(0), _descriptiveNamesValid(false), _descriptiveNamesEpoch(0)
 {
   override.fileName.clear();
   override.f0 = override.N = override.skip = override.doAve = -5;
@@ -62,7 +63,7 @@ bool ObjectStore::removeObject(Object *o) {
 #endif
       return false;
     }
-  } else if (!_list.contains(o)) {
+  } else if (!_sequence.contains(o)) {
 #if NAMEDEBUG > 1
     qDebug() << "Trying to delete a non-existent object from the store: " << o->tag().tagString();
 #endif
@@ -75,6 +76,7 @@ bool ObjectStore::removeObject(Object *o) {
   } else {
     o->deleteDependents();
     _list.removeAll(o);
+    unindexObject(o);
   }
 
   o->_store = 0;
@@ -82,48 +84,233 @@ bool ObjectStore::removeObject(Object *o) {
   return true;
 }
 
-ObjectPtr ObjectStore::retrieveObject(const QString& name) const {
+// The short name in name: either all of it, or the part in parentheses at
+// its end, eg "GYRO1 (V1)".  A capital letter followed by digits.
+static QString shortNameIn(const QString& name) {
+  int end = name.length();
+  if (name.endsWith(')')) {
+    --end;
+  }
+  int begin = end;
+  while (begin > 0 && name.at(begin - 1).isDigit()) {
+    --begin;
+  }
+  if (begin == end || begin == 0) {
+    return QString();
+  }
+  --begin;
+  const QChar c = name.at(begin);
+  if (c < QChar('A') || c > QChar('Z')) {
+    return QString();
+  }
+  if (begin > 0 && name.at(begin - 1) != '(') {
+    return QString();
+  }
+  return name.mid(begin, end - begin);
+}
 
-  int match = -1;
+
+ObjectPtr ObjectStore::retrieveObject(const QString& name) const {
 
   if (name.isEmpty()) {
     return NULL;
   }
 
-  QString shortName;
-  QRegExp rx("(\\(|^)([A-Z]\\d+)(\\)$|$)");
-  rx.indexIn(name);
-  shortName = rx.cap(2);
+  const QString shortName = shortNameIn(name);
+  PrimitivePtr provider;
+  QString slaveShortName;
 
-  // 1) search for short names
-  int size = _list.size();
-  for (int i = 0; i < size; ++i) {
-    if (_list.at(i)->shortName()==shortName)
-      return _list.at(i);
-  }
-  // 3) search for descriptive names: must be unique
-  for (int i = 0; i < size; ++i) {
-    if (_list.at(i)->descriptiveName() == name) {
-      if (match != -1) 
-        return NULL; // not unique, so... no match
-      match = i;
+  {
+    KstReadLocker l(&_lock);
+
+    // 1) search for short names
+    if (!shortName.isEmpty()) {
+      Object *o = _shortNames.value(shortName);
+      if (o) {
+        return ObjectPtr(o);
+      }
+    }
+
+    QMutexLocker locker(&_descriptiveNamesMutex);
+    if (!_descriptiveNamesValid || _descriptiveNamesEpoch != NamedObject::descriptiveNameEpoch()) {
+      rebuildDescriptiveNames();
+    }
+
+    // 3) search for descriptive names: must be unique.  A miss is trusted,
+    //    but a hit is checked, in case a name changed without an edit.
+    QList<Object*> matches = _descriptiveNames.values(name);
+    foreach (Object *o, matches) {
+      if (o->descriptiveName() != name) {
+        rebuildDescriptiveNames();
+        matches = _descriptiveNames.values(name);
+        break;
+      }
+    }
+    if (matches.count() > 1) {
+      return NULL; // not unique, so... no match
+    } else if (matches.count() == 1) {
+      return ObjectPtr(matches.first());
+    }
+
+    // 4) slaves (vector and matrix statistics) nobody has asked for yet,
+    //    by their reserved short name or their (again unique) descriptive name.
+    if (!shortName.isEmpty()) {
+      provider = _slaveShortNames.value(shortName);
+      slaveShortName = shortName;
+    } else {
+      QList<ReservedSlave> slaves = _slaveNames.values(name);
+      if (slaves.count() > 1) {
+        return NULL;
+      } else if (slaves.count() == 1) {
+        provider = slaves.first().provider;
+        slaveShortName = slaves.first().shortName;
+      }
     }
   }
 
-  if (match >-1) 
-    return _list.at(match);
+  // The provider creates the slave, and adds it to the store, so this is
+  // done without holding the lock.
+  if (provider) {
+    return provider->materializeSlave(slaveShortName);
+  }
 
   return NULL;
 }
 
+
+void ObjectStore::indexObject(Object *o) {
+  const qint64 sequence = _nextSequence++;
+  _sequence.insert(o, sequence);
+
+  TypeIndex &index = _types[o->metaObject()];
+  index.sequence.append(sequence);
+  index.objects.append(o);
+
+  const QString shortName = o->shortName();
+  if (_shortNames.contains(shortName)) {
+    ++_shortNameClashes;
+  } else {
+    _shortNames.insert(shortName, o);
+  }
+
+  QMutexLocker locker(&_descriptiveNamesMutex);
+  _descriptiveNamesValid = false;
+}
+
+
+void ObjectStore::unindexObject(Object *o) {
+  _sequence.remove(o);
+
+  QHash<const QMetaObject*, TypeIndex>::Iterator it = _types.find(o->metaObject());
+  if (it != _types.end()) {
+    TypeIndex &index = it.value();
+    const int i = index.objects.indexOf(o);
+    if (i >= 0) {
+      index.sequence.remove(i);
+      index.objects.remove(i);
+    }
+    if (index.objects.isEmpty()) {
+      _types.erase(it);
+    }
+  }
+
+  const QString shortName = o->shortName();
+  if (_shortNames.value(shortName) == o) {
+    _shortNames.remove(shortName);
+    if (_shortNameClashes > 0) {
+      // another object may have the same short name: it takes over.
+      foreach (const ObjectPtr &other, _list) {
+        if (other->shortName() == shortName) {
+          _shortNames.insert(shortName, other.data());
+          --_shortNameClashes;
+          break;
+        }
+      }
+    }
+  } else if (_shortNames.contains(shortName) && _shortNameClashes > 0) {
+    --_shortNameClashes; // o was one of the clashes
+  }
+
+  QMutexLocker locker(&_descriptiveNamesMutex);
+  _descriptiveNamesValid = false;
+}
+
+
+void ObjectStore::rebuildDescriptiveNames() const {
+  _descriptiveNames.clear();
+  _descriptiveNames.reserve(_list.size());
+  _slaveShortNames.clear();
+  _slaveNames.clear();
+  foreach (const ObjectPtr &o, _list) {
+    _descriptiveNames.insert(o->descriptiveName(), o.data());
+  }
+  // unmaterialized slaves are listed as "descriptive name (short name)"
+  foreach (Object *o, objectsOfType(&Primitive::staticMetaObject)) {
+    Primitive *p = static_cast<Primitive*>(o);
+    foreach (const QString &slaveName, p->unmaterializedSlaveNames()) {
+      const int paren = slaveName.lastIndexOf(" (");
+      if (paren < 0 || !slaveName.endsWith(')')) {
+        continue;
+      }
+      ReservedSlave slave;
+      slave.provider = p;
+      slave.shortName = slaveName.mid(paren + 2, slaveName.length() - paren - 3);
+      _slaveShortNames.insert(slave.shortName, p);
+      _slaveNames.insert(slaveName.left(paren), slave);
+    }
+  }
+  _descriptiveNamesValid = true;
+  _descriptiveNamesEpoch = NamedObject::descriptiveNameEpoch();
+}
+
+
+QList<Object*> ObjectStore::objectsOfType(const QMetaObject *type) const {
+  QList<const TypeIndex*> indexes;
+  for (QHash<const QMetaObject*, TypeIndex>::ConstIterator it = _types.begin(); it != _types.end(); ++it) {
+    for (const QMetaObject *m = it.key(); m; m = m->superClass()) {
+      if (m == type) {
+        indexes.append(&it.value());
+        break;
+      }
+    }
+  }
+
+  QList<Object*> objects;
+  if (indexes.count() == 1) {
+    const TypeIndex *index = indexes.first();
+    objects.reserve(index->objects.size());
+    for (int i = 0; i < index->objects.size(); ++i) {
+      objects.append(index->objects.at(i));
+    }
+  } else if (indexes.count() > 1) {
+    // merge the per class lists back into the order the objects were added
+    QVector<int> next(indexes.count(), 0);
+    forever {
+      int best = -1;
+      for (int j = 0; j < indexes.count(); ++j) {
+        if (next[j] < indexes[j]->sequence.size() &&
+            (best < 0 || indexes[j]->sequence.at(next[j]) < indexes[best]->sequence.at(next[best]))) {
+          best = j;
+        }
+      }
+      if (best < 0) {
+        break;
+      }
+      objects.append(indexes[best]->objects.at(next[best]++));
+    }
+  }
+  return objects;
+}
+
+
 void ObjectStore::rebuildDataSourceList() {
   cleanUpDataSourceList();
-  foreach (DataSourcePtr ds, _dataSourceList) {
+  foreach (const DataSourcePtr &ds, _dataSourceList) {
     ds->writeLock();
     ds->reset();
     ds->unlock();
   }
-  foreach (ObjectPtr object, _list) {
+  foreach (const ObjectPtr &object, _list) {
     object->writeLock();
     object->reset();
     object->unlock();
@@ -178,7 +365,7 @@ QList<ObjectPtr> ObjectStore::objectList() {
 }
 
 void ObjectStore::clearUsedFlags() {
-  foreach (ObjectPtr p, _list) {
+  foreach (const ObjectPtr &p, _list) {
     p->setUsed(false);
   }
 }
@@ -186,7 +373,7 @@ void ObjectStore::clearUsedFlags() {
 bool ObjectStore::deleteUnsetUsedFlags() {
   QList<ObjectPtr> list = _list;
   bool some_deleted = false;
-  foreach (ObjectPtr p, list) {
+  foreach (const ObjectPtr &p, list) {
     if (!p->used()) {
       removeObject(p);
       some_deleted = true;
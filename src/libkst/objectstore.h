@@ -19,6 +19,10 @@
 #define OBJECTSTORE_H
 
 #include <QDebug>
+#include <QHash>
+#include <QMultiHash>
+#include <QMutex>
+#include <QVector>
 
 #include "kst_export.h"
 #include "kst_i18n.h"
@@ -30,6 +34,8 @@
 namespace Kst {
 
 class ObjectNameIndex;
+class Primitive;
+class SessionData;
 
 
 // The ObjectStore is responsible for storing all the Objects in an
@@ -90,29 +96,65 @@ class KSTCORE_EXPORT ObjectStore
       int doAve;
     } override;
 
+    // the binary file holding large arrays while a session is being saved
+    // or loaded, or 0L
+    SessionData *sessionData;
+
   private:
     Q_DISABLE_COPY(ObjectStore)
 
+    void indexObject(Object *o);
+    void unindexObject(Object *o);
+    void rebuildDescriptiveNames() const;
+
+    // objects of type, or inheriting from type, in the order they were added
+    QList<Object*> objectsOfType(const QMetaObject *type) const;
+
     mutable KstRWLock _lock;
 
     // objects are stored in these lists
     DataSourceList _dataSourceList;
     QList<ObjectPtr> _list;
 
+    // Indexes into _list, kept up to date by addObject() and removeObject().
+    // Objects are numbered in the order they are added; the type index is
+    // keyed by the exact class of the objects.
+    struct TypeIndex {
+      QVector<qint64> sequence;
+      QVector<Object*> objects;
+    };
+    QHash<Object*, qint64> _sequence;
+    qint64 _nextSequence;
+    QHash<const QMetaObject*, TypeIndex> _types;
+    // the first object added with a given short name; short names never change
+    QHash<QString, Object*> _shortNames;
+    int _shortNameClashes;
+
+    // Descriptive names, and the names reserved for slaves nobody has asked
+    // for yet.  Automatic names follow the object's inputs and values, so the
+    // index is rebuilt when objects are added, removed, renamed or edited
+    // (NamedObject::descriptiveNameEpoch()), and hits are checked.
+    struct ReservedSlave {
+      Primitive *provider;
+      QString shortName;
+    };
+    mutable QMutex _descriptiveNamesMutex;
+    mutable QMultiHash<QString, Object*> _descriptiveNames;
+    mutable QHash<QString, Primitive*> _slaveShortNames;
+    mutable QMultiHash<QString, ReservedSlave> _slaveNames;
+    mutable bool _descriptiveNamesValid;
+    mutable int _descriptiveNamesEpoch;
 };
 
 
-// this is an inefficient implementation for now
 template<class T>
 const ObjectList<T> ObjectStore::getObjects() const {
   KstReadLocker l(&(this->_lock));
   ObjectList<T> rc;
 
-  for (QList<ObjectPtr>::ConstIterator it = _list.begin(); it != _list.end(); ++it) {
-    SharedPtr<T> x = kst_cast<T>(*it);
-    if (x != 0) {
-      rc.append(x);
-    }
+  const QList<Object*> objects = objectsOfType(&T::staticMetaObject);
+  for (QList<Object*>::ConstIterator it = objects.begin(); it != objects.end(); ++it) {
+    rc.append(SharedPtr<T>(static_cast<T*>(*it)));
   }
 
   return rc;
@@ -144,6 +186,7 @@ bool ObjectStore::addObject(T *o) {
     _dataSourceList.append(ds);
   } else {
     _list.append(o);
+    indexObject(o);
   }
   return true;
 }
@@ -0,0 +1,143 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "parallel.h"
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+namespace Kst {
+
+namespace {
+
+// Shared between the caller and the helper runnables.  Chunks are claimed
+// through an atomic counter, so whoever gets there first does the work and
+// the caller never waits on a runnable that the pool hasn't started yet.
+// The state is reference counted because helpers may only get to run after
+// the caller has already returned.
+class ParallelState {
+  public:
+    ParallelState(ParallelJob *job, qint64 count, int chunks, int refs)
+      : job(job), count(count), chunks(chunks), next(0), done(0), refs(refs) {}
+
+    void work() {
+      int chunk;
+      while ((chunk = next.fetchAndAddOrdered(1)) < chunks) {
+        const qint64 begin = count * chunk / chunks;
+        const qint64 end = count * (chunk + 1) / chunks;
+        job->processChunk(chunk, begin, end);
+
+        QMutexLocker locker(&mutex);
+        if (++done == chunks) {
+          finished.wakeAll();
+        }
+      }
+    }
+
+    void wait() {
+      QMutexLocker locker(&mutex);
+      while (done < chunks) {
+        finished.wait(&mutex);
+      }
+    }
+
+    void release() {
+      if (!refs.deref()) {
+        delete this;
+      }
+    }
+
+  private:
+    ParallelJob *job;
+    const qint64 count;
+    const int chunks;
+    QAtomicInt next;
+    int done;
+    QAtomicInt refs;
+    QMutex mutex;
+    QWaitCondition finished;
+};
+
+
+class ParallelRunnable : public QRunnable {
+  public:
+    explicit ParallelRunnable(ParallelState *state) : _state(state) {
+      setAutoDelete(true);
+    }
+
+    void run() {
+      _state->work();
+      _state->release();
+    }
+
+  private:
+    ParallelState *_state;
+};
+
+
+QThreadPool *computePool() {
+  static QThreadPool *pool = 0L;
+  static QMutex poolMutex;
+  QMutexLocker locker(&poolMutex);
+  if (!pool) {
+    pool = new QThreadPool;
+    pool->setMaxThreadCount(QThread::idealThreadCount());
+  }
+  return pool;
+}
+
+}
+
+
+int parallelChunks(qint64 count, qint64 minChunk) {
+  const int cores = qMax(1, QThread::idealThreadCount());
+  if (minChunk < 1) {
+    minChunk = 1;
+  }
+  const qint64 chunks = qMin(qint64(cores), count / minChunk);
+  return chunks > 1 ? int(chunks) : 1;
+}
+
+
+int runParallel(ParallelJob *job, qint64 count, qint64 minChunk) {
+  if (count <= 0) {
+    return 0;
+  }
+
+  const int chunks = parallelChunks(count, minChunk);
+  if (chunks == 1) {
+    job->processChunk(0, 0, count);
+    return 1;
+  }
+
+  const int helpers = chunks - 1;
+  ParallelState *state = new ParallelState(job, count, chunks, helpers + 1);
+  QThreadPool *pool = computePool();
+  for (int i = 0; i < helpers; ++i) {
+    pool->start(new ParallelRunnable(state));
+  }
+
+  state->work();
+  state->wait();
+  state->release();
+
+  return chunks;
+}
+
+}
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,50 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "kst_export.h"
+
+#include <QtGlobal>
+
+namespace Kst {
+
+/** A piece of work over the index range [0, count) which can be split into
+    independent chunks.  Subclasses hold their own per-chunk state (private
+    accumulators etc.) and merge it after runParallel() returns. */
+class KSTCORE_EXPORT ParallelJob {
+  public:
+    virtual ~ParallelJob() {}
+
+    /** Process indices [begin, end).  chunk is in [0, chunks) as returned by
+        parallelChunks() and identifies the slot for per-chunk state. */
+    virtual void processChunk(int chunk, qint64 begin, qint64 end) = 0;
+};
+
+/** Number of chunks runParallel() will split count items into, never more
+    than the number of cores and never less than minChunk items per chunk
+    (except when count itself is smaller).  Always at least 1. */
+KSTCORE_EXPORT int parallelChunks(qint64 count, qint64 minChunk = 65536);
+
+/** Split [0, count) into parallelChunks(count, minChunk) contiguous chunks
+    and run them on Kst's compute thread pool.  The calling thread takes part
+    in the work and the call returns once every chunk is done, so it is safe
+    to call from any thread, including from inside another job.  Returns the
+    number of chunks used. */
+KSTCORE_EXPORT int runParallel(ParallelJob *job, qint64 count, qint64 minChunk = 65536);
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
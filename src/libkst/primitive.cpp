@@ -50,10 +50,21 @@ const QString& Primitive::typeString() const {
 
 void Primitive::setProvider(Object* obj) {
   _provider = obj;
+  touchDescriptiveNames();
+}
+
+
+QList<ObjectPtr> Primitive::inputObjects() const {
+  QList<ObjectPtr> inputs;
+  if (_provider) {
+    inputs.append(provider());
+  }
+  return inputs;
 }
 
 void Primitive::setSlaveName(QString slaveName) {
   _slaveName=slaveName;
+  touchDescriptiveNames();
 }
 
 QString Primitive::_automaticDescriptiveName() const {
@@ -66,6 +77,15 @@ QString Primitive::_automaticDescriptiveName() const {
   return name;
 }
 
+SharedPtr<Primitive> Primitive::materializeSlave(const QString &shortName) {
+  Q_UNUSED(shortName)
+  return 0L;
+}
+
+QStringList Primitive::unmaterializedSlaveNames() const {
+  return QStringList();
+}
+
 qint64 Primitive::minInputSerial() const {
   if (_provider) {
     return (_provider->serial());
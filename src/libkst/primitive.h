@@ -19,6 +19,7 @@
 #define PRIMITIVE_H
 
 #include <QPointer>
+#include <QStringList>
 
 #include "kst_export.h"
 #include "object.h"
@@ -47,6 +48,8 @@ class KSTCORE_EXPORT Primitive : public Object
 
     inline ObjectPtr provider() const { return ObjectPtr(_provider); }
 
+    virtual QList<ObjectPtr> inputObjects() const;
+
     void setSlaveName(QString slaveName);
     QString slaveName() const { return _slaveName; }
     virtual QString propertyString() const;
@@ -59,6 +62,13 @@ class KSTCORE_EXPORT Primitive : public Object
 
     virtual PrimitiveMap metas() const = 0;
 
+    // Slaves that are only created when first asked for (eg, the statistics
+    // of vectors and matrices).  materializeSlave() creates and returns the
+    // one with the given short name; unmaterializedSlaveNames() lists the
+    // Name()s of those not created yet.
+    virtual SharedPtr<Primitive> materializeSlave(const QString &shortName);
+    virtual QStringList unmaterializedSlaveNames() const;
+
     // used for sorting dataobjects by Document::sortedDataObjectList()
     virtual bool flagSet() const { return _flag; }
     virtual void setFlag(bool f) { _flag = f;}
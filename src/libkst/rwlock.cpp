@@ -34,6 +34,16 @@ KstRWLock::~KstRWLock() {
 }
 
 
+int KstRWLock::readLockerIndex(Qt::HANDLE thread) const {
+  for (int i = 0; i < _readLockers.size(); ++i) {
+    if (_readLockers[i].thread == thread) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+
 void KstRWLock::readLock() const {
 #ifndef ONE_LOCK_TO_RULE_THEM_ALL
   QMutexLocker lock(&_mutex);
@@ -50,20 +60,25 @@ void KstRWLock::readLock() const {
 #ifdef LOCKTRACE
     qDebug() << "Thread " << (int)QThread::currentThreadId() << " has a write lock on KstRWLock " << (void*)this << ", getting a read lock" << endl;
 #endif
+  } else if (readLockerIndex(me) >= 0) {
+    // thread already has another read lock
   } else {
-    QMap<Qt::HANDLE, int>::Iterator it = _readLockers.find(me);
-    if (it != _readLockers.end() && it.value() > 0) {
-      // thread already has another read lock
-    } else {
-      while (_writeCount > 0 || _waitingWriters) {  // writer priority otherwise
-        ++_waitingReaders;
-        _readerWait.wait(&_mutex);
-        --_waitingReaders;
-      }
+    while (_writeCount > 0 || _waitingWriters) {  // writer priority otherwise
+      ++_waitingReaders;
+      _readerWait.wait(&_mutex);
+      --_waitingReaders;
     }
   }
 
-  _readLockers[me] = _readLockers[me] + 1;
+  const int idx = readLockerIndex(me);
+  if (idx >= 0) {
+    ++_readLockers[idx].count;
+  } else {
+    ReadLocker r;
+    r.thread = me;
+    r.count = 1;
+    _readLockers.append(r);
+  }
   ++_readCount;
 
 #ifdef LOCKTRACE
@@ -87,8 +102,7 @@ void KstRWLock::writeLock() const {
   Qt::HANDLE me = QThread::currentThreadId();
 
   if (_readCount > 0) {
-    QMap<Qt::HANDLE, int>::Iterator it = _readLockers.find(me);
-    if (it != _readLockers.end() && it.value() > 0) {
+    if (readLockerIndex(me) >= 0) {
       // cannot acquire a write lock if I already have a read lock -- ERROR
       qDebug() << "Thread " << QThread::currentThread() << " tried to write lock KstRWLock " << (void*)this << " while holding a read lock" << endl;
       return;
@@ -123,17 +137,17 @@ void KstRWLock::unlock() const {
   Qt::HANDLE me = QThread::currentThreadId();
 
   if (_readCount > 0) {
-    QMap<Qt::HANDLE, int>::Iterator it = _readLockers.find(me);
-    if (it == _readLockers.end()) {
+    const int idx = readLockerIndex(me);
+    if (idx < 0) {
       // read locked but not by me -- ERROR
       qDebug() << "Thread " << QThread::currentThread() << " tried to unlock KstRWLock " << (void*)this << " (read locked) without holding the lock" << endl;
       return;
     } else {
       --_readCount;
-      if (it.value() == 1) {
-        _readLockers.remove(it.key());
-      } else {
-        --(it.value());
+      if (--_readLockers[idx].count == 0) {
+        // order doesn't matter, so fill the hole with the last entry
+        _readLockers[idx] = _readLockers[_readLockers.size() - 1];
+        _readLockers.resize(_readLockers.size() - 1);
       }
     }
   } else if (_writeCount > 0) {
@@ -194,7 +208,7 @@ KstRWLock::LockStatus KstRWLock::myLockStatus() const {
 
   if (_writeCount > 0 && _writeLocker == me) {
     return WRITELOCKED;
-  } else if (_readCount > 0 && _readLockers.find(me) != _readLockers.end()) {
+  } else if (_readCount > 0 && readLockerIndex(me) >= 0) {
     return READLOCKED;
   } else {
     return UNLOCKED;
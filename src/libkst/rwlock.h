@@ -19,8 +19,8 @@
 #define RWLOCK_H
 
 #include <qmutex.h>
-#include <qmap.h>
 #include <qthread.h>
+#include <qvarlengtharray.h>
 #include <qwaitcondition.h>
 
 #include <config.h>
@@ -59,7 +59,17 @@ class KSTCORE_EXPORT KstRWLock {
     mutable int _waitingReaders, _waitingWriters;
 
     mutable Qt::HANDLE _writeLocker;
-    mutable QMap<Qt::HANDLE, int> _readLockers;
+
+    // read lock counts per thread.  There are rarely more than one or two
+    // readers at a time, so a short inline array beats a map: no allocation
+    // and no tree walk while holding _mutex.
+    struct ReadLocker {
+      Qt::HANDLE thread;
+      int count;
+    };
+    mutable QVarLengthArray<ReadLocker, 4> _readLockers;
+
+    int readLockerIndex(Qt::HANDLE thread) const;
 };
 
 
@@ -38,6 +38,15 @@ Scalar::Scalar(ObjectStore *store)
   _initializeShortName();
 }
 
+
+Scalar::Scalar(ObjectStore *store, int shortNameIndex)
+    : Primitive(store, 0L), _value(0.0), _orphan(false), _displayable(true), _editable(false) {
+
+  setFlag(true);
+  _shortName = 'X'+QString::number(shortNameIndex);
+  _initial_xnum = shortNameIndex;
+}
+
 void Scalar::_initializeShortName() {
   _shortName = 'X'+QString::number(_xnum);
   if (_xnum>max_xnum)
@@ -90,7 +99,12 @@ void Scalar::setValue(double inV) {
   writeLock();
   if (_value != inV) {
     _value = inV;
-    registerChange();
+    // statistics change on every update, but only an orphan is named by its value
+    if (_orphan) {
+      registerChange();
+    } else {
+      registerNewValue();
+    }
   }
   unlock();
 }
@@ -113,6 +127,7 @@ bool Scalar::orphan() const {
 
 void Scalar::setOrphan(bool orphan) {
   _orphan = orphan;
+  touchDescriptiveNames();
 }
 
 
@@ -34,8 +34,12 @@ class KSTCORE_EXPORT Scalar : public Primitive
 
   protected:
     Scalar(ObjectStore *store);
+    // takes the short name X<shortNameIndex> reserved by StatScalars,
+    // rather than the next free one
+    Scalar(ObjectStore *store, int shortNameIndex);
 
     friend class ObjectStore;
+    friend class StatScalars;
 
     virtual QString _automaticDescriptiveName() const;
 
@@ -0,0 +1,262 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "sessiondata.h"
+
+#include <string.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QUuid>
+#include <QXmlStreamAttributes>
+#include <QXmlStreamWriter>
+#include <QtEndian>
+
+#include "debug.h"
+
+namespace Kst {
+
+// The file starts with the magic, a byte order mark and the id the session
+// refers to the file by, padded out to Alignment.  Arrays start on
+// Alignment boundaries.
+static const char Magic[8] = { 'K', 'S', 'T', 'D', 'A', 'T', 'A', '1' };
+static const quint32 ByteOrderMark = 0x01020304;
+static const int IdLength = 48;
+static const qint64 Alignment = 64;
+
+// compress an array when the start of it shrinks to less than half
+static const int ProbeBytes = 1 << 16;
+
+
+SessionData::SessionData()
+  : _position(0), _writing(false), _swap(false), _map(0L), _mapSize(0) {
+}
+
+
+SessionData::~SessionData() {
+  finishRead();
+  if (_file.isOpen()) {
+    _file.close();
+  }
+}
+
+
+QString SessionData::fileNameFor(const QString &sessionFile) {
+  return sessionFile + "data";
+}
+
+
+void SessionData::beginWrite(const QString &sessionFile) {
+  _file.setFileName(fileNameFor(sessionFile));
+  _id = QUuid::createUuid().toString();
+  _position = 0;
+  _writing = true;
+}
+
+
+bool SessionData::openForWrite() {
+  if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    // the arrays stay in the XML
+    Debug::self()->log(QObject::tr("Could not write to %1.").arg(_file.fileName()), Debug::Warning);
+    _writing = false;
+    return false;
+  }
+
+  QByteArray header(int(Alignment), '\0');
+  memcpy(header.data(), Magic, sizeof(Magic));
+  memcpy(header.data() + sizeof(Magic), &ByteOrderMark, sizeof(ByteOrderMark));
+  const QByteArray id = _id.toLatin1().left(IdLength);
+  memcpy(header.data() + 16, id.constData(), id.size());
+  _position = _file.write(header);
+  if (_position != Alignment) {
+    Debug::self()->log(QObject::tr("Could not write to %1.").arg(_file.fileName()), Debug::Warning);
+    _writing = false;
+    return false;
+  }
+  return true;
+}
+
+
+bool SessionData::finishWrite() {
+  _writing = false;
+  if (!_file.isOpen()) {
+    // Nothing went into it: the sidecar of an earlier save of the session
+    // is no longer used, so it goes.
+    if (_file.open(QIODevice::ReadOnly)) {
+      const bool stale = _file.read(sizeof(Magic)) == QByteArray(Magic, sizeof(Magic));
+      _file.close();
+      if (stale) {
+        _file.remove();
+      }
+    }
+    return true;
+  }
+  const bool ok = _file.error() == QFile::NoError;
+  _file.close();
+  return ok;
+}
+
+
+void SessionData::writeAttributes(QXmlStreamWriter &xml) const {
+  xml.writeAttribute("dataFile", QFileInfo(_file.fileName()).fileName());
+  xml.writeAttribute("dataId", _id);
+}
+
+
+bool SessionData::writeArray(QXmlStreamWriter &xml, const double *data, qint64 count) {
+  if (!_writing || !data || count < MinSamples) {
+    return false;
+  }
+  if (!_file.isOpen() && !openForWrite()) {
+    return false;
+  }
+
+  const qint64 bytes = count * qint64(sizeof(double));
+  const uchar *raw = reinterpret_cast<const uchar*>(data);
+
+  QByteArray packed;
+  if (bytes <= 0x7fffffff && qCompress(raw, qMin(int(bytes), ProbeBytes), 1).size() < ProbeBytes / 2) {
+    packed = qCompress(raw, int(bytes), 1);
+  }
+
+  const qint64 padding = (Alignment - _position % Alignment) % Alignment;
+  if (padding > 0 && _file.write(QByteArray(int(padding), '\0')) != padding) {
+    _position = _file.pos();
+    Debug::self()->log(QObject::tr("Could not write to %1.").arg(_file.fileName()), Debug::Warning);
+    return false;
+  }
+  _position += padding;
+
+  const qint64 offset = _position;
+  const qint64 stored = packed.isEmpty() ? bytes : packed.size();
+  const qint64 written = packed.isEmpty() ? _file.write(reinterpret_cast<const char*>(raw), bytes) : _file.write(packed);
+  if (written != stored) {
+    // whatever part of the array did go out is left as dead space
+    _position = _file.pos();
+    Debug::self()->log(QObject::tr("Could not write to %1.").arg(_file.fileName()), Debug::Warning);
+    return false;
+  }
+  _position += stored;
+
+  xml.writeEmptyElement("data_sidecar");
+  xml.writeAttribute("offset", QString::number(offset));
+  xml.writeAttribute("bytes", QString::number(stored));
+  xml.writeAttribute("count", QString::number(count));
+  xml.writeAttribute("codec", packed.isEmpty() ? "raw" : "zlib");
+  return true;
+}
+
+
+bool SessionData::beginRead(const QString &sessionFile, const QXmlStreamAttributes &attrs) {
+  const QString name = attrs.value("dataFile").toString();
+  if (name.isEmpty()) {
+    return false;
+  }
+
+  _file.setFileName(QFileInfo(sessionFile).dir().filePath(name));
+  if (!_file.open(QIODevice::ReadOnly)) {
+    // not an error unless an array is in it: there may have been none
+    _readError = QObject::tr("The data file %1 of the session could not be opened.").arg(_file.fileName());
+    return false;
+  }
+
+  _mapSize = _file.size();
+  _map = _mapSize >= Alignment ? _file.map(0, _mapSize) : 0L;
+  if (!_map) {
+    _readError = QObject::tr("The data file %1 of the session could not be read.").arg(_file.fileName());
+    _file.close();
+    return false;
+  }
+
+  quint32 mark;
+  memcpy(&mark, _map + sizeof(Magic), sizeof(mark));
+  const QByteArray id = attrs.value("dataId").toString().toLatin1().left(IdLength);
+  if (memcmp(_map, Magic, sizeof(Magic)) != 0 ||
+      (mark != ByteOrderMark && mark != qbswap(ByteOrderMark)) ||
+      memcmp(_map + 16, id.constData(), id.size()) != 0) {
+    _readError = QObject::tr("The data file %1 does not belong to this session.").arg(_file.fileName());
+    finishRead();
+    return false;
+  }
+  _swap = mark != ByteOrderMark;
+  return true;
+}
+
+
+void SessionData::finishRead() {
+  if (_map) {
+    _file.unmap(const_cast<uchar*>(_map));
+    _map = 0L;
+    _mapSize = 0;
+    _file.close();
+  }
+}
+
+
+bool SessionData::readArray(const QXmlStreamAttributes &attrs, QVector<double> *data) {
+  const qint64 offset = attrs.value("offset").toString().toLongLong();
+  const qint64 stored = attrs.value("bytes").toString().toLongLong();
+  const qint64 count = attrs.value("count").toString().toLongLong();
+  const QString codec = attrs.value("codec").toString();
+  const qint64 bytes = count * qint64(sizeof(double));
+
+  if (!_map) {
+    addError(_readError.isEmpty() ? QObject::tr("The session refers to a data file it does not name.") : _readError);
+    return false;
+  }
+  if (offset < Alignment || stored < 0 || count < 0 || offset + stored > _mapSize || count > 0x7fffffff) {
+    addError(QObject::tr("Session data missing from %1.").arg(_file.fileName()));
+    return false;
+  }
+
+  data->resize(int(count));
+  if (codec == "raw" && stored == bytes) {
+    memcpy(data->data(), _map + offset, bytes);
+  } else if (codec == "zlib") {
+    const QByteArray unpacked = qUncompress(_map + offset, int(qMin(stored, qint64(0x7fffffff))));
+    if (unpacked.size() != bytes) {
+      addError(QObject::tr("Session data in %1 is corrupt.").arg(_file.fileName()));
+      data->clear();
+      return false;
+    }
+    memcpy(data->data(), unpacked.constData(), bytes);
+  } else {
+    addError(QObject::tr("Session data in %1 is corrupt.").arg(_file.fileName()));
+    data->clear();
+    return false;
+  }
+
+  if (_swap) {
+    quint64 *words = reinterpret_cast<quint64*>(data->data());
+    for (qint64 i = 0; i < count; ++i) {
+      words[i] = qbswap(words[i]);
+    }
+  }
+  return true;
+}
+
+
+QStringList SessionData::errors() const {
+  return _errors;
+}
+
+
+void SessionData::addError(const QString &error) {
+  Debug::self()->log(error, Debug::Warning);
+  if (!_errors.contains(error)) {
+    _errors.append(error);
+  }
+}
+
+}
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,100 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SESSIONDATA_H
+#define SESSIONDATA_H
+
+#include <QFile>
+#include <QStringList>
+#include <QVector>
+
+#include "kst_export.h"
+
+class QXmlStreamAttributes;
+class QXmlStreamWriter;
+
+namespace Kst {
+
+/*
+ *  The binary file saved next to a .kst session (session.kst gets
+ *  session.kstdata) holding the large arrays embedded in the session: the
+ *  data of editable vectors and matrices.  The XML only keeps a
+ *  <data_sidecar> element giving where the array is.
+ *
+ *  Arrays are stored as raw doubles in the byte order of the machine which
+ *  saved them, aligned so that they can be used straight from the mapped
+ *  file, or compressed with zlib at its fastest level when a probe of the
+ *  data shows that pays off.  Small arrays are left in the XML, and the
+ *  sidecar is only created once an array goes into it.
+ *
+ *  While a session is saved or loaded, ObjectStore::sessionData points at
+ *  the sidecar.
+ */
+class KSTCORE_EXPORT SessionData {
+  public:
+    enum { MinSamples = 16384 };
+
+    SessionData();
+    ~SessionData();
+
+    static QString fileNameFor(const QString &sessionFile);
+
+    // Starts the sidecar of sessionFile.  Call writeAttributes() on the
+    // session's root element.  The file is only created by the first
+    // writeArray() which needs it.
+    void beginWrite(const QString &sessionFile);
+
+    // Finishes the sidecar.  If no array went into it, there is none, and
+    // the one an earlier save of the session left behind is removed.
+    bool finishWrite();
+
+    void writeAttributes(QXmlStreamWriter &xml) const;
+
+    // Saves the count values of data into the sidecar and writes a
+    // <data_sidecar> element referring to them.  Returns false, writing
+    // nothing, if there is no sidecar being written or the array is too
+    // small to be worth it: the caller saves it in the XML as before.
+    bool writeArray(QXmlStreamWriter &xml, const double *data, qint64 count);
+
+    // Maps the sidecar named by the attributes of a session's root element.
+    // Returns false if the session has none, or it is missing or doesn't
+    // belong to the session: which is only an error if an array is read.
+    bool beginRead(const QString &sessionFile, const QXmlStreamAttributes &attrs);
+    void finishRead();
+
+    // Reads the array a <data_sidecar> element refers to.  Failures are
+    // also kept in errors(), for the session's load errors.
+    bool readArray(const QXmlStreamAttributes &attrs, QVector<double> *data);
+    QStringList errors() const;
+
+  private:
+    Q_DISABLE_COPY(SessionData)
+
+    bool openForWrite();
+    void addError(const QString &error);
+
+    QFile _file;
+    QString _id;
+    QString _readError;
+    QStringList _errors;
+    qint64 _position;
+    bool _writing;
+    bool _swap;
+    const uchar *_map;
+    qint64 _mapSize;
+};
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
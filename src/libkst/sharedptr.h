@@ -14,7 +14,7 @@
 #ifndef SharedPTR_H
 #define SharedPTR_H
 
-#include <QSemaphore>
+#include <QAtomicInt>
 #include <QDebug>
 
 //#define KST_DEBUG_SHARED
@@ -32,21 +32,19 @@
 
 namespace Kst {
 
-#define SEMAPHORE_COUNT 999999
-
 class Shared {
 public:
    /**
     * Standard constructor.  This will initialize the reference count
     * on this object to 0.
     */
-   Shared() : sem(SEMAPHORE_COUNT) { }
+   Shared() : refs(0) { }
 
    /**
     * Copy constructor.  This will @em not actually copy the objects
     * but it will initialize the reference count on this object to 0.
     */
-   Shared( const Shared & ) : sem(SEMAPHORE_COUNT) { }
+   Shared( const Shared & ) : refs(0) { }
 
    /**
     * Overloaded assignment operator.
@@ -57,7 +55,7 @@ public:
     * Increases the reference count by one.
     */
    void _KShared_ref() const {
-     sem.acquire(1);
+     refs.ref();
      KST_DBG qDebug() << "KShared_ref: " << (void*)this << " -> " << _KShared_count() << endl;
    }
 
@@ -66,9 +64,8 @@ public:
     * the count goes to 0, this object will delete itself.
     */
    void _KShared_unref() const {
-     sem.release(1);
-     KST_DBG qDebug() << "KShared_unref: " << (void*)this << " -> " << _KShared_count() << endl;
-     if (SEMAPHORE_COUNT == sem.available()) delete this;
+     KST_DBG qDebug() << "KShared_unref: " << (void*)this << " -> " << _KShared_count() - 1 << endl;
+     if (!refs.deref()) delete this;
    }
 
    /**
@@ -76,13 +73,18 @@ public:
     *
     * @return Number of references
     */
-   int _KShared_count() const { return SEMAPHORE_COUNT - sem.available(); }
+#if QT_VERSION >= 0x050000
+   int _KShared_count() const { return refs.load(); }
+#else
+   int _KShared_count() const { return refs; }
+#endif
 
 protected:
    virtual ~Shared() { }
 
 private:
-   mutable QSemaphore sem;
+   // Only the last deref() sees zero, so exactly one unref deletes.
+   mutable QAtomicInt refs;
 };
 
 
@@ -108,8 +110,25 @@ public:
   SharedPtr( const SharedPtr& p )
     : ptr(p.ptr) { if (isPtrValid()) ptr->_KShared_ref(); }
 
-  template<class Y> SharedPtr(SharedPtr<Y>& p)
-    : ptr(p.data()) { if (isPtrValid()) ptr->_KShared_ref(); }
+  template<class Y> SharedPtr(const SharedPtr<Y>& p)
+    : ptr(static_cast<Y*>(p)) { if (isPtrValid()) ptr->_KShared_ref(); }
+
+#ifdef Q_COMPILER_RVALUE_REFS
+  /**
+   * Takes over the reference held by p, which becomes null.
+   */
+  SharedPtr( SharedPtr&& p ) : ptr(p.ptr) { p.ptr = 0; }
+
+  SharedPtr<T>& operator= ( SharedPtr<T>&& p ) {
+    if (this != &p) {
+      T *old = ptr;
+      ptr = p.ptr;
+      p.ptr = 0;
+      if (old) old->_KShared_unref();
+    }
+    return *this;
+  }
+#endif
 
   /**
    * Unreferences the object that this pointer points to. If it was
@@ -120,28 +139,34 @@ public:
   SharedPtr<T>& operator= ( const SharedPtr<T>& p ) {
     isPtrValid();
     if ( ptr == p.ptr ) return *this;
-    if (isPtrValid()) ptr->_KShared_unref();
+    // take the new reference before dropping the old one: p may only be
+    // kept alive by the object we are about to release.
+    T *old = ptr;
     ptr = p.ptr;
     if (isPtrValid()) ptr->_KShared_ref();
+    if (old) old->_KShared_unref();
     return *this;
   }
 
   template<class Y>
-  SharedPtr<T>& operator=(SharedPtr<Y>& p) {
+  SharedPtr<T>& operator=(const SharedPtr<Y>& p) {
     isPtrValid();
-    if (ptr == p.data()) return *this;
-    if (isPtrValid()) ptr->_KShared_unref();
-    ptr = p.data();
+    Y *y = p;
+    if (ptr == y) return *this;
+    T *old = ptr;
+    ptr = y;
     if (isPtrValid()) ptr->_KShared_ref();
+    if (old) old->_KShared_unref();
     return *this;
   }
 
   SharedPtr<T>& operator= ( T* p ) {
     isPtrValid();
     if (ptr == p) return *this;
-    if (isPtrValid()) ptr->_KShared_unref();
+    T *old = ptr;
     ptr = p;
     if (isPtrValid()) ptr->_KShared_ref();
+    if (old) old->_KShared_unref();
     return *this;
   }
 
@@ -164,10 +189,10 @@ public:
    */
   const T* data() const { isPtrValid(); return ptr; }
 
-  const T& operator*() const  { Q_ASSERT(isPtrValid()); return *ptr; }
-  T& operator*()              { Q_ASSERT(isPtrValid()); return *ptr; }
-  const T* operator->() const { Q_ASSERT(isPtrValid()); return ptr; }
-  T* operator->()             { Q_ASSERT(isPtrValid()); return ptr; }
+  // constness is shallow, as for a plain pointer, so that const references
+  // to SharedPtrs (foreach, const containers) can be used without copying.
+  T& operator*() const  { Q_ASSERT(isPtrValid()); return *ptr; }
+  T* operator->() const { Q_ASSERT(isPtrValid()); return ptr; }
 
   /**
    * Returns the number of references.
@@ -184,8 +209,8 @@ private:
 
 
 template <typename T, typename U>
-inline SharedPtr<T> kst_cast(SharedPtr<U> object) {
-  return qobject_cast<T*>(object.data());
+inline SharedPtr<T> kst_cast(const SharedPtr<U>& object) {
+  return qobject_cast<T*>(static_cast<U*>(object));
 }
 
 // FIXME: make this safe
@@ -0,0 +1,160 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "statscalars.h"
+
+#include <string.h>
+
+#include "objectstore.h"
+
+namespace Kst {
+
+StatScalars::StatScalars()
+  : _provider(0L), _scalars(0L), _stats(0L), _count(0), _firstXNum(0) {
+  for (int i = 0; i < MaxStats; ++i) {
+    _values[i] = 0.0;
+  }
+}
+
+
+void StatScalars::init(Primitive *provider, ObjectMap<Scalar> *scalars, const Stat *stats, int count) {
+  Q_ASSERT(count <= MaxStats);
+  _provider = provider;
+  _scalars = scalars;
+  _stats = stats;
+  _count = qMin(count, int(MaxStats));
+
+  // hand out the X numbers the scalars would have taken if they were
+  // created now.
+  _firstXNum = _xnum;
+  _xnum += _count;
+  if (_xnum - 1 > max_xnum) {
+    max_xnum = _xnum - 1;
+  }
+}
+
+
+int StatScalars::indexOf(const char *key) const {
+  for (int i = 0; i < _count; ++i) {
+    if (strcmp(_stats[i].key, key) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+
+double StatScalars::value(const char *key) const {
+  const int i = indexOf(key);
+  if (i < 0) {
+    return 0.0;
+  }
+  QMutexLocker locker(&_mutex);
+  return _values[i];
+}
+
+
+void StatScalars::setValue(const char *key, double value) {
+  const int i = indexOf(key);
+  if (i < 0) {
+    return;
+  }
+  QMutexLocker locker(&_mutex);
+  _values[i] = value;
+  if (_materialized[i]) {
+    _materialized[i]->setValue(value);
+  }
+}
+
+
+ScalarPtr StatScalars::scalar(const QString &key) {
+  const int i = indexOf(key.toLatin1().constData());
+  if (i < 0) {
+    return 0L;
+  }
+  return materialize(i);
+}
+
+
+ScalarPtr StatScalars::materialize(const QString &shortName) {
+  if (_count == 0 || !_provider || !shortName.startsWith('X')) {
+    return 0L;
+  }
+
+  bool ok;
+  const int i = shortName.mid(1).toInt(&ok) - _firstXNum;
+  if (!ok || i < 0 || i >= _count) {
+    return 0L;
+  }
+  return materialize(i);
+}
+
+
+ScalarPtr StatScalars::materialize(int i) {
+  {
+    QMutexLocker locker(&_mutex);
+    if (_materialized[i]) {
+      return _materialized[i];
+    }
+  }
+
+  ObjectStore *store = _provider->store();
+  if (!store) {
+    return 0L;
+  }
+
+  // Not under _mutex: adding the scalar locks the store, and the provider's
+  // update may be waiting in setValue() while something holds the store lock.
+  ScalarPtr sp = new Scalar(store, _firstXNum + i);
+  store->addObject(sp.data());
+
+  sp->setProvider(_provider);
+  sp->setSlaveName(_stats[i].slaveName);
+
+  ScalarPtr existing;
+  {
+    QMutexLocker locker(&_mutex);
+    if (_materialized[i]) {
+      existing = _materialized[i];
+    } else {
+      sp->setValue(_values[i]);
+      _scalars->insert(_stats[i].key, sp);
+      _materialized[i] = sp;
+    }
+  }
+
+  if (existing) { // lost a race with another thread
+    store->removeObject(sp);
+    return existing;
+  }
+  return sp;
+}
+
+
+QStringList StatScalars::unmaterializedNames() const {
+  QStringList names;
+  if (!_provider) {
+    return names;
+  }
+  const QString prefix = _provider->descriptiveName() + ':';
+  QMutexLocker locker(&_mutex);
+  for (int i = 0; i < _count; ++i) {
+    if (!_materialized[i]) {
+      names << prefix + _stats[i].slaveName + " (X" + QString::number(_firstXNum + i) + ')';
+    }
+  }
+  return names;
+}
+
+}
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,86 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef STATSCALARS_H
+#define STATSCALARS_H
+
+#include <QMutex>
+#include <QStringList>
+
+#include "scalar.h"
+#include "kst_export.h"
+
+namespace Kst {
+
+/*
+ *  The statistics (min, max, mean, ...) a Vector or Matrix offers as slave
+ *  scalars.
+ *
+ *  The values are kept here, and a real Scalar is only created in the object
+ *  store the first time something refers to one: an equation, a label, a
+ *  plugin or a dialog, through scalar() or ObjectStore::retrieveObject().
+ *  A short name (X number) is reserved for every statistic when the provider
+ *  is created, so a statistic gets the same short name it would have had if
+ *  it had been created up front.  That keeps the names saved in old sessions
+ *  valid.
+ */
+class KSTCORE_EXPORT StatScalars {
+  public:
+    struct Stat {
+      const char *key;
+      const char *slaveName;
+    };
+    enum { MaxStats = 12 };
+
+    StatScalars();
+
+    // Declares the statistics of provider and reserves their short names.
+    // Materialized scalars are inserted into scalars under their key.
+    void init(Primitive *provider, ObjectMap<Scalar> *scalars, const Stat *stats, int count);
+
+    bool isEmpty() const { return _count == 0; }
+
+    double value(const char *key) const;
+    void setValue(const char *key, double value);
+
+    // The scalar for key, created if it doesn't exist yet.  Null if there is
+    // no such statistic.
+    ScalarPtr scalar(const QString &key);
+
+    // The statistic whose short name is shortName, created if need be.
+    // Null if it isn't one of ours.
+    ScalarPtr materialize(const QString &shortName);
+
+    // The names (as in Name()) the statistics that don't exist yet would have.
+    QStringList unmaterializedNames() const;
+
+  private:
+    Q_DISABLE_COPY(StatScalars)
+
+    int indexOf(const char *key) const;
+    ScalarPtr materialize(int i);
+
+    Primitive *_provider;
+    ObjectMap<Scalar> *_scalars;
+    const Stat *_stats;
+    int _count;
+    int _firstXNum;
+
+    double _values[MaxStats];
+    ScalarPtr _materialized[MaxStats];
+    mutable QMutex _mutex;
+};
+
+}
+
+#endif
+// vim: ts=2 sw=2 et
@@ -19,162 +19,423 @@
 #include "config.h"
 #include "stdinsource.h"
 
-#include <QTemporaryFile>
-#include <QXmlStreamWriter>
-
+#include <QAtomicInt>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSettings>
+#include <QThread>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <locale.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <sys/stat.h>
+#include <sys/time.h>
 #include <unistd.h>
 
-#ifdef TIME_WITH_SYS_TIME
-# include <sys/time.h>
-# include <time.h>
-#else
-# ifdef HAVE_SYS_TIME_H
-#  include <sys/time.h>
-# else
-#  include <time.h>
-# endif
-#endif
+#include "datavector.h"
+#include "debug.h"
+#include "math_kst.h"
 
 namespace Kst {
 
 const QString StdinSource::staticTypeString = I18N_NOOP("Stdin Data Source");
 
-StdinSource::StdinSource(ObjectStore *store, QSettings *cfg)
-: DataSource(store, cfg, "stdin", "stdin") {
-  _file = new QTemporaryFile;
-  _filename = _file->fileName();
-  // Unfortunately we have to update here.  stdin is a special case.
-  update();
-  _src = DataSource::loadSource(this->store(), _filename, "ASCII");
-  if (_src && _src->isValid()) {
-    _valid = true;
-  }
-}
+// Reads the stream in blocks and parses the complete lines of each block
+// into the column rings.  Only run() touches the parse state; the rings are
+// shared with the source under _mutex.
+class StdinReader : public QThread {
+  public:
+    enum { BlockBytes = 1 << 20, PollInterval = 100 };
+
+    // reads fd, which it closes when done unless it is standard input
+    StdinReader(int fd, int capacity)
+      : _fd(fd), _capacity(capacity), _columnCount(0), _rows(0) {
+      _decimalPoint = *localeconv()->decimal_point;
+    }
 
+    ~StdinReader() {
+      _stopping.store(1);
+      wait();
+    }
 
-StdinSource::~StdinSource() {
-  _file->close();
-  delete _file;
-  _file = 0L;
-}
+    QStringList columns() const {
+      QMutexLocker locker(&_mutex);
+      return _names;
+    }
+
+    qint64 rows() const {
+      QMutexLocker locker(&_mutex);
+      return _rows;
+    }
 
+    // Copies rows [s, s + n) of column to v, NaN where they have been
+    // dropped from the ring, and returns the number of rows copied.
+    int read(int column, double *v, qint64 s, int n) const {
+      QMutexLocker locker(&_mutex);
+      if (column < 0 || column >= _rings.size()) {
+        return 0;
+      }
+      const QVector<double>& ring = _rings.at(column);
+      const qint64 oldest = qMax(_rows - _capacity, qint64(0));
+      int i = 0;
+      for (; i < n && s + i < _rows; ++i) {
+        v[i] = s + i < oldest ? NOPOINT : ring.at(int((s + i) % _capacity));
+      }
+      return i;
+    }
 
-const QString& StdinSource::typeString() const {
-  return staticTypeString;
-}
+  protected:
+    void run() {
+      const int fd = _fd;
+      const bool standardInput = fd == 0;
+
+      QByteArray block(BlockBytes, 0);
+      QByteArray pending;
+      QVector<double> rows;
+      while (fd >= 0 && !_stopping.load()) {
+        fd_set rfds;
+        FD_ZERO(&rfds);
+        FD_SET(fd, &rfds);
+        struct timeval tv;
+        tv.tv_sec = 0;
+        tv.tv_usec = PollInterval * 1000;
+        const int ready = select(fd + 1, &rfds, NULL, NULL, &tv);
+        if (ready < 0 && errno != EINTR) {
+          break;
+        }
+        if (ready <= 0) {
+          continue;
+        }
+
+        const ssize_t got = ::read(fd, block.data(), BlockBytes);
+        if (got < 0) {
+          if (errno == EINTR || errno == EAGAIN) {
+            continue;
+          }
+          break;
+        }
+        if (got == 0) {
+          if (standardInput) {
+            break;
+          }
+          // no writer on the pipe for now; another may open it
+          msleep(PollInterval);
+          continue;
+        }
+
+        pending.append(block.constData(), int(got));
+        const int end = pending.lastIndexOf('\n') + 1;
+        if (end > 0) {
+          rows.clear();
+          parseLines(pending.constData(), pending.constData() + end, rows);
+          pending.remove(0, end);
+          append(rows);
+        }
+      }
 
+      // an unterminated last line still counts
+      rows.clear();
+      parseLines(pending.constData(), pending.constData() + pending.size(), rows);
+      append(rows);
 
-Object::UpdateType StdinSource::internalDataSourceUpdate() {
-  if (!_valid) {
-    _src = DataSource::loadSource(store(), _filename, "ASCII");
-    if (_src && _src->isValid()) {
-      _valid = true;
-    } else {
-      return NoChange;
+      if (fd > 0) {
+        ::close(fd);
+      }
     }
-  }
 
-  fd_set rfds;
-  struct timeval tv;
-  int retval;
-  char instr[4097];
-  int i = 0;
-  bool new_data = false;
-  bool got_some = false;
+  private:
+    static bool isBlank(char c) {
+      return c == ' ' || c == '\t' || c == '\r' || c == ',';
+    }
 
-  int handle = _file->handle();
-  FILE *fp = fdopen(handle, "w+");
+    // Splits [p, end) into tokens at blanks and commas.
+    static QList<QByteArray> tokens(const char *p, const char *end) {
+      QList<QByteArray> list;
+      while (p < end) {
+        while (p < end && isBlank(*p)) {
+          ++p;
+        }
+        const char *start = p;
+        while (p < end && !isBlank(*p)) {
+          ++p;
+        }
+        if (p > start) {
+          list << QByteArray(start, int(p - start));
+        }
+      }
+      return list;
+    }
 
-  if (!fp) {
-    return Object::NO_CHANGE;
-  }
+    double toDouble(const char *p, const char *end) const {
+      char text[64];
+      const int length = qMin(int(end - p), int(sizeof(text)) - 1);
+      memcpy(text, p, length);
+      text[length] = 0;
+      if (_decimalPoint != '.') {
+        char *point = strchr(text, '.');
+        if (point) {
+          *point = _decimalPoint;
+        }
+      }
+      char *parsed;
+      const double value = strtod(text, &parsed);
+      return parsed == text ? NOPOINT : value;
+    }
+
+    void parseLines(const char *p, const char *end, QVector<double>& rows) {
+      while (p < end) {
+        const char *eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol) {
+          eol = end;
+        }
+        parseLine(p, eol, rows);
+        p = eol + 1;
+      }
+    }
+
+    void parseLine(const char *p, const char *end, QVector<double>& rows) {
+      while (p < end && isBlank(*p)) {
+        ++p;
+      }
+      if (p == end) {
+        return;
+      }
+      if (strchr("#!/;%", *p)) {
+        if (_columnCount == 0) {
+          _lastComment = tokens(p + 1, end);
+        }
+        return;
+      }
+
+      if (_columnCount == 0) {
+        _columnCount = tokens(p, end).size();
+        QStringList names;
+        for (int i = 0; i < _columnCount; ++i) {
+          names << (_lastComment.size() == _columnCount ? QString::fromUtf8(_lastComment.at(i)) : i18n("Column %1").arg(i + 1));
+        }
+        QMutexLocker locker(&_mutex);
+        _names = names;
+        _rings.resize(_columnCount);
+      }
 
-  do {
-    /* Watch stdin (fd 0) to see when it has input. */
-    FD_ZERO(&rfds);
-    FD_SET(0, &rfds);
-    /* Wait up to 0 seconds. */
-    tv.tv_sec = 0;
-    tv.tv_usec = 0;
-
-    retval = select(1, &rfds, NULL, NULL, &tv);
-
-    new_data = false;
-    if (retval > 0) {
-      char *fgs = fgets(instr, 4096, stdin);
-      if (fgs && fp) {
-        got_some = true;
-        fputs(instr, fp);
-        new_data = true;
+      // missing values are NaN, extra ones are dropped
+      int column = 0;
+      while (p < end && column < _columnCount) {
+        const char *start = p;
+        while (p < end && !isBlank(*p)) {
+          ++p;
+        }
+        rows.append(toDouble(start, p));
+        ++column;
+        while (p < end && isBlank(*p)) {
+          ++p;
+        }
+      }
+      for (; column < _columnCount; ++column) {
+        rows.append(NOPOINT);
       }
     }
-  } while (++i < 100000 && new_data);
 
-  fclose(fp);
+    void append(const QVector<double>& rows) {
+      if (_columnCount == 0 || rows.isEmpty()) {
+        return;
+      }
+      const int count = rows.size() / _columnCount;
+
+      QMutexLocker locker(&_mutex);
+      // rows which the rest of this batch would overwrite are only counted
+      const int skipped = qMax(count - _capacity, 0);
+      _rows += skipped;
+      for (int r = skipped; r < count; ++r) {
+        const double *row = rows.constData() + r * _columnCount;
+        const int slot = int(_rows % _capacity);
+        for (int c = 0; c < _columnCount; ++c) {
+          // the rings grow as the rows come, up to the capacity
+          if (slot >= _rings.at(c).size()) {
+            _rings[c].resize(slot + 1);
+          }
+          _rings[c][slot] = row[c];
+        }
+        ++_rows;
+      }
+    }
+
+    const int _fd;
+    const int _capacity;
+    QAtomicInt _stopping;
+    char _decimalPoint;
+
+    // parse state, reader thread only
+    int _columnCount;
+    QList<QByteArray> _lastComment;
+
+    mutable QMutex _mutex;
+    QStringList _names;
+    QVector<QVector<double> > _rings;
+    qint64 _rows;
+};
 
-  if (got_some && _src) {
-    return _src->update();
+
+class DataInterfaceStdinVector : public DataSource::DataInterface<DataVector>
+{
+public:
+  DataInterfaceStdinVector(StdinSource& s) : source(s) {}
+
+  int read(const QString& field, DataVector::ReadInfo& p) { return source.readField(p.data, field, p.startingFrame, p.numberOfFrames); }
+
+  QStringList list() const { return source.fieldList(); }
+  bool isListComplete() const { return !source.fieldList().isEmpty(); }
+  bool isValid(const QString& field) const { return source.isValidField(field); }
+
+  const DataVector::DataInfo dataInfo(const QString& field) const {
+    if (!source.isValidField(field)) {
+      return DataVector::DataInfo();
+    }
+    return DataVector::DataInfo(source.frameCount(), 1);
   }
-  return NoChange;
-}
+  void setDataInfo(const QString&, const DataVector::DataInfo&) {}
 
+  QMap<QString, double> metaScalars(const QString&) {
+    QMap<QString, double> m;
+    m["FRAMES"] = source.frameCount();
+    return m;
+  }
+  QMap<QString, QString> metaStrings(const QString&) { return QMap<QString, QString>(); }
 
-int StdinSource::readField(double *v, const QString& field, int s, int n) {
-  if (isValid()) {
-    return _src->readField(v, field, s, n);
+private:
+  StdinSource& source;
+};
+
+
+StdinSource::StdinSource(ObjectStore *store, QSettings *cfg, const QString& filename)
+: DataSource(store, cfg, filename, "stdin"), _reader(0L), _frameCount(0) {
+  setUpdateType(Timer);
+  setInterface(new DataInterfaceStdinVector(*this));
+
+  int capacity = 1 << 20;
+  if (cfg) {
+    cfg->beginGroup(staticTypeString);
+    capacity = qMax(cfg->value("Buffer Frames", capacity).toInt(), 1);
+    cfg->endGroup();
   }
-  return -1;
+
+  // A pipe is opened without blocking, so neither this nor stopping the
+  // reader waits on a writer.  The fields show up at the first update after
+  // the first line of data: vectors of them made before that start reading
+  // then.
+  const bool standardInput = (filename == "stdin" || filename == "-");
+  const int fd = standardInput ? 0 : ::open(QFile::encodeName(filename).constData(), O_RDONLY | O_NONBLOCK);
+  if (fd < 0) {
+    Debug::self()->log(i18n("Could not open %1 for reading: %2").arg(filename).arg(QString::fromLocal8Bit(strerror(errno))), Debug::Warning);
+    _valid = false;
+    return;
+  }
+
+  _reader = new StdinReader(fd, capacity);
+  _reader->start();
+  _valid = true;
 }
 
 
-bool StdinSource::isValidField(const QString& field) const {
-  if (isValid()) {
-    return _src->isValidField(field);
+StdinSource::~StdinSource() {
+  delete _reader;
+  _reader = 0L;
+}
+
+
+bool StdinSource::isStream(const QString& filename) {
+  if (filename == "stdin" || filename == "-") {
+    return true;
   }
+#ifndef Q_OS_WIN32
+  struct stat info;
+  return stat(QFile::encodeName(filename).constData(), &info) == 0 && S_ISFIFO(info.st_mode);
+#else
   return false;
+#endif
 }
 
 
-int StdinSource::samplesPerFrame(const QString& field) {
-  if (isValid()) {
-    return _src->samplesPerFrame(field);
-  }
-  return 0;
+const QString& StdinSource::typeString() const {
+  return staticTypeString;
 }
 
 
-int StdinSource::frameCount(const QString& field) const {
-  if (isValid()) {
-    return _src->frameCount(field);
+Object::UpdateType StdinSource::internalDataSourceUpdate() {
+  if (!_reader) {
+    return NoChange;
+  }
+
+  if (_fields.isEmpty()) {
+    const QStringList columns = _reader->columns();
+    if (!columns.isEmpty()) {
+      _fields = QStringList("INDEX") + columns;
+    }
   }
-  return 0;
+
+  const int frames = int(qMin(_reader->rows(), qint64(INT_MAX)));
+  if (frames == _frameCount) {
+    return NoChange;
+  }
+  _frameCount = frames;
+  return Updated;
 }
 
 
-QString StdinSource::fileType() const {
-  if (isValid()) {
-    return _src->fileType();
+int StdinSource::readField(double *v, const QString& field, int s, int n) {
+  if (n < 0) {
+    n = 1; /* n < 0 means read one sample, not frame - irrelevent here */
+  }
+  // only what had arrived at the last update
+  n = qMin(n, _frameCount - s);
+  if (s < 0 || n <= 0) {
+    return 0;
   }
-  return QString::null;
+
+  if (field == "INDEX") {
+    for (int i = 0; i < n; i++) {
+      v[i] = double(s + i);
+    }
+    return n;
+  }
+
+  const int column = columnOfField(field);
+  if (column < 0 || !_reader) {
+    return -2;
+  }
+  return _reader->read(column, v, s, n);
 }
 
 
-void StdinSource::save(QXmlStreamWriter &s) {
-  if (isValid()) {
-    return _src->save(s);
+int StdinSource::columnOfField(const QString& field) const {
+  const int column = _fields.indexOf(field) - 1;
+  if (column >= 0) {
+    return column;
   }
-  DataSource::save(s);
+  // columns can also be given by number, as for ASCII files
+  bool ok;
+  const int number = field.toInt(&ok);
+  return ok && number >= 1 && number < _fields.size() ? number - 1 : -1;
 }
 
 
-bool StdinSource::isValid() const {
-  return _valid && _src && _src->isValid();
+bool StdinSource::isValidField(const QString& field) const {
+  return field == "INDEX" || columnOfField(field) >= 0;
+}
+
+
+QString StdinSource::fileType() const {
+  return "stdin";
 }
 
 
 bool StdinSource::isEmpty() const {
-  return !isValid() || _src->isEmpty();
+  return _frameCount == 0;
 }
 
 }
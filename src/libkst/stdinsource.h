@@ -22,42 +22,57 @@
 
 #include "kst_export.h"
 
-class QTemporaryFile;
-
 namespace Kst {
 
-class KST_EXPORT StdinSource : public DataSource {
+class StdinReader;
+
+/** Columns of numbers streamed through standard input ("-" or "stdin") or
+    a named pipe, as in "producer | kst -".
+
+    A reader thread reads the stream in large blocks and parses the lines
+    straight into one ring buffer per column, so memory stays bounded: only
+    the last "Buffer Frames" rows (the "Stdin Data Source" settings group,
+    a million by default) are kept, and older frames read back as NaN.  The
+    columns are fixed by the first line of data; they are named by the last
+    comment line before it if that has one name per column, else
+    "Column 1", "Column 2", ... and can also be given by number.  There
+    is also an INDEX field.  New rows show up at the next update. */
+class KSTCORE_EXPORT StdinSource : public DataSource {
   Q_OBJECT
 
   public:
-    StdinSource(ObjectStore *store, QSettings *cfg);
+    StdinSource(ObjectStore *store, QSettings *cfg, const QString& filename = "stdin");
 
     virtual ~StdinSource();
 
+    /** Whether filename is standard input or a named pipe, which only this
+        source can read. */
+    static bool isStream(const QString& filename);
+
     virtual const QString& typeString() const;
     static const QString staticTypeString;
 
     virtual Object::UpdateType internalDataSourceUpdate();
 
-    virtual int readField(double *v, const QString &field, int s, int n);
+    int readField(double *v, const QString &field, int s, int n);
 
-    virtual bool isValidField(const QString &field) const;
+    bool isValidField(const QString &field) const;
 
-    virtual int samplesPerFrame(const QString &field);
+    int frameCount() const { return _frameCount; }
 
-    virtual int frameCount(const QString& field = QString::null) const;
+    const QStringList& fieldList() const { return _fields; }
 
     virtual QString fileType() const;
 
-    virtual void save(QXmlStreamWriter& s);
-
-    virtual bool isValid() const;
-
     virtual bool isEmpty() const;
 
   private:
-    DataSourcePtr _src;
-    QTemporaryFile *_file;
+    // the ring of field, by name or by its number counting from 1; -1 if none
+    int columnOfField(const QString& field) const;
+
+    StdinReader *_reader;
+    QStringList _fields;
+    int _frameCount; // rows seen at the last update
 };
 
 }
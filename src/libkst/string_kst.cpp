@@ -90,6 +90,9 @@ String& String::operator=(const char *v) {
 
 void String::setValue(const QString& inV) {
   _value = inV;
+  if (_orphan) {
+    touchDescriptiveNames();
+  }
 }
 
 
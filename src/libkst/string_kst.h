@@ -67,7 +67,7 @@ class KSTCORE_EXPORT String : public Primitive
     void setValue(const QString& inV);
 
     bool orphan() const { return _orphan; }
-    void setOrphan(bool orphan) { _orphan = orphan; }
+    void setOrphan(bool orphan) { _orphan = orphan; touchDescriptiveNames(); }
 
     bool editable() const { return _editable; }
     void setEditable(bool editable) { _editable = editable; }
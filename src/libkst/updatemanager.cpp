@@ -47,6 +47,9 @@ UpdateManager::UpdateManager() {
   _store = 0;
   _delayedUpdateScheduled = false;
   _updateInProgress = false;
+  _demandDriven = true;
+  _catchUpScheduled = false;
+  _caughtUpSerial = 0;
   _time.start();
 }
 
@@ -90,17 +93,26 @@ void UpdateManager::doUpdates(bool forceImmediate) {
 
   _serial++;
 
+  updateObjects(forceImmediate ? 0L : wantedObjects(), true);
+
+  emit objectsUpdated(_serial);
+}
+
+
+void UpdateManager::updateObjects(const QSet<Object*> *wanted, bool updateSources) {
   int n_updated=0, n_deferred=0, n_unchanged = 0;
-  qint64 retval;
+  qint64 retval = 0;
 
   // update the datasources
-  foreach (DataSourcePtr ds, _store->dataSourceList()) {
-    ds->writeLock();
-    retval = ds->objectUpdate(_serial);
-    ds->unlock();
-    if (retval == Object::Updated) n_updated++;
-    else if (retval == Object::Deferred) n_deferred++;
-    else if (retval == Object::NoChange) n_unchanged++;
+  if (updateSources) {
+    foreach (const DataSourcePtr &ds, _store->dataSourceList()) {
+      ds->writeLock();
+      retval = ds->objectUpdate(_serial);
+      ds->unlock();
+      if (retval == Object::Updated) n_updated++;
+      else if (retval == Object::Deferred) n_deferred++;
+      else if (retval == Object::NoChange) n_unchanged++;
+    }
   }
 
   //qDebug() << "ds up: " << n_updated << "  ds def: " << n_deferred << " n_no: " << n_unchanged;
@@ -112,7 +124,10 @@ void UpdateManager::doUpdates(bool forceImmediate) {
   do {
     n_updated = n_unchanged = n_deferred = 0;
     // update data objects
-    foreach (ObjectPtr p, _store->objectList()) {
+    foreach (const ObjectPtr &p, _store->objectList()) {
+      if (wanted && !wanted->contains(p.data())) {
+        continue;
+      }
       p->writeLock();
       retval = p->objectUpdate(_serial);
       p->unlock();
@@ -125,6 +140,201 @@ void UpdateManager::doUpdates(bool forceImmediate) {
     //qDebug() << "loop: " << i_loop << " obj up: " << n_updated << "  obj def: " << n_deferred << " obj_no: " << n_unchanged << "dt:" << double(_time.elapsed())/1000.0;
     i_loop++;
   } while ((n_deferred + n_updated > 0) && (i_loop<=maxloop));
+}
+
+
+void UpdateManager::setDemandDriven(bool demandDriven) {
+  _demandDriven = demandDriven;
+  // the objects nobody wanted are behind
+  if (!_demandDriven && !_wanted.isEmpty()) {
+    queueCatchUp();
+  }
+  _wanted.clear();
+}
+
+
+void UpdateManager::setInterest(QObject *consumer, const QList<Object*>& objects) {
+  if (!consumer) {
+    return;
+  }
+  watchConsumer(consumer);
+
+  QList<QPointer<Object> >& interest = _interest[consumer];
+  bool changed = interest.size() != objects.size();
+  for (int i = 0; i < objects.size() && !changed; ++i) {
+    changed = interest.at(i) != objects.at(i);
+  }
+  if (changed) {
+    interest.clear();
+    foreach (Object *object, objects) {
+      interest.append(object);
+    }
+  }
+  scheduleCatchUp(objects, changed);
+}
+
+
+void UpdateManager::addInterest(QObject *consumer, Object *object) {
+  if (!consumer || !object) {
+    return;
+  }
+  watchConsumer(consumer);
+
+  QList<QPointer<Object> >& interest = _interest[consumer];
+  const bool changed = !interest.contains(object);
+  if (changed) {
+    interest.append(object);
+  }
+  scheduleCatchUp(QList<Object*>() << object, changed);
+}
+
+
+void UpdateManager::setInterestInAll(QObject *consumer) {
+  if (!consumer || _interestInAll.contains(consumer)) {
+    return;
+  }
+  watchConsumer(consumer);
+
+  _interestInAll.insert(consumer);
+  // the last update may have left out what the consumer shows
+  if (_demandDriven && !_wanted.isEmpty()) {
+    queueCatchUp();
+  }
+}
+
+
+void UpdateManager::removeInterest(QObject *consumer) {
+  if (consumer) {
+    disconnect(consumer, SIGNAL(destroyed(QObject*)), this, SLOT(consumerDestroyed(QObject*)));
+    consumerDestroyed(consumer);
+  }
+}
+
+
+void UpdateManager::consumerDestroyed(QObject *consumer) {
+  _interest.remove(consumer);
+  _interestInAll.remove(consumer);
+}
+
+
+void UpdateManager::watchConsumer(QObject *consumer) {
+  connect(consumer, SIGNAL(destroyed(QObject*)), this, SLOT(consumerDestroyed(QObject*)), Qt::UniqueConnection);
+}
+
+
+QSet<Object*> UpdateManager::upstreamOf(const QList<Object*>& roots) {
+  QSet<Object*> upstream;
+  QList<ObjectPtr> todo;
+  foreach (Object *object, roots) {
+    todo.append(ObjectPtr(object));
+  }
+  while (!todo.isEmpty()) {
+    ObjectPtr object = todo.takeLast();
+    if (object && !upstream.contains(object.data())) {
+      upstream.insert(object.data());
+      todo += object->inputObjects();
+    }
+  }
+  return upstream;
+}
+
+
+const QSet<Object*> *UpdateManager::wantedObjects() {
+  // nobody has said what they need, so everything might be
+  if (!_demandDriven || _interest.isEmpty() || !_interestInAll.isEmpty()) {
+    _wanted.clear();
+    return 0L;
+  }
+
+  QList<Object*> roots;
+  foreach (const QList<QPointer<Object> >& interest, _interest) {
+    foreach (const QPointer<Object>& object, interest) {
+      if (object) {
+        roots.append(object.data());
+      }
+    }
+  }
+  _wanted = upstreamOf(roots);
+  return &_wanted;
+}
+
+
+// Objects not among those updated by the last periodic update may be out
+// of date: update them right away rather than at the next one.  Consumers
+// keep saying what they need after every update, so only objects they
+// didn't need before, or which have missed an update since the last catch
+// up, are worth one: anything else is as up to date as it can get.
+void UpdateManager::scheduleCatchUp(const QList<Object*>& objects, bool changed) {
+  if (!_demandDriven || _catchUpScheduled || (!changed && _caughtUpSerial == _serial)) {
+    return;
+  }
+  foreach (Object *object, objects) {
+    if (object && object->serial() != _serial) {
+      queueCatchUp();
+      return;
+    }
+  }
+}
+
+
+void UpdateManager::queueCatchUp() {
+  if (!_catchUpScheduled) {
+    _catchUpScheduled = true;
+    QTimer::singleShot(0, this, SLOT(catchUp()));
+  }
+}
+
+
+void UpdateManager::catchUp() {
+  _catchUpScheduled = false;
+  // a delayed update will do what we would
+  if (!_store || (_delayedUpdateScheduled && !_paused)) {
+    return;
+  }
+
+  // throttled like the periodic updates: not while the views are still
+  // taking in the last update, nor more often than the minimum period
+  const int dT = _time.elapsed();
+  if (_updateInProgress || dT < _minUpdatePeriod) {
+    _catchUpScheduled = true;
+    QTimer::singleShot(_updateInProgress ? 20 : _minUpdatePeriod - dT, this, SLOT(catchUp()));
+    return;
+  }
+  _updateInProgress = true;
+  _time.restart();
+
+  // while paused, only bring the objects up to the data already read
+  if (!_paused) {
+    _serial++;
+  }
+  updateObjects(wantedObjects(), !_paused);
+  _caughtUpSerial = _serial;
+
+  emit objectsUpdated(_serial);
+}
+
+
+void UpdateManager::bringUpToDate(Object *object) {
+  if (!_store || !object) {
+    return;
+  }
+
+  const QSet<Object*> upstream = upstreamOf(QList<Object*>() << object);
+  updateObjects(&upstream, false);
+}
+
+
+void UpdateManager::updateNow(const QList<Object*>& objects) {
+  if (!_store) {
+    return;
+  }
+
+  _updateInProgress = true;
+  _time.restart();
+  _serial++;
+
+  const QSet<Object*> upstream = upstreamOf(objects);
+  updateObjects(&upstream, true);
 
   emit objectsUpdated(_serial);
 }
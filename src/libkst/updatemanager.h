@@ -16,6 +16,9 @@
 #include "object.h"
 
 #include <QGraphicsRectItem>
+#include <QHash>
+#include <QPointer>
+#include <QSet>
 #include <QTime>
 
 namespace Kst {
@@ -35,6 +38,30 @@ class KSTCORE_EXPORT UpdateManager : public QObject
 
     void setStore(ObjectStore *store) {_store = store;}
 
+    /** Demand driven updates: once any consumer (a view, an open dialog, a
+        script connection, an event monitor...) has said which objects it
+        needs, the periodic updates only go through those and the objects
+        they are computed from.  The others are brought up to date when a
+        consumer takes an interest in them.  Forced updates still do
+        everything.  A consumer's interest goes when it is destroyed.  On by
+        default. */
+    void setDemandDriven(bool demandDriven);
+    bool demandDriven() const { return _demandDriven; }
+
+    void setInterest(QObject *consumer, const QList<Object*>& objects);
+    void addInterest(QObject *consumer, Object *object);
+    /** For consumers which may show any object, like the value dialogs */
+    void setInterestInAll(QObject *consumer);
+    void removeInterest(QObject *consumer);
+
+    /** Updates object, and what it is computed from, to the last update:
+        for reading an object no consumer may be interested in. */
+    void bringUpToDate(Object *object);
+
+    /** Reads new data and updates objects, and what they are computed from,
+        right away: for rendering what no consumer may be interested in. */
+    void updateNow(const QList<Object*>& objects);
+
 
   public Q_SLOTS:
     void doUpdates(bool forceImmediate = false);
@@ -44,12 +71,28 @@ class KSTCORE_EXPORT UpdateManager : public QObject
   Q_SIGNALS:
     void objectsUpdated(qint64 serial);
 
+  private Q_SLOTS:
+    void catchUp();
+    void consumerDestroyed(QObject *consumer);
+
   private:
     UpdateManager();
     ~UpdateManager();
     static void cleanup();
     QTime _time;
 
+    // all of roots and what they are computed from
+    static QSet<Object*> upstreamOf(const QList<Object*>& roots);
+    // the objects the consumers need, or 0L to update everything
+    const QSet<Object*> *wantedObjects();
+    void watchConsumer(QObject *consumer);
+    // catches up with objects if changed says they weren't wanted before
+    // or they are behind
+    void scheduleCatchUp(const QList<Object*>& objects, bool changed);
+    void queueCatchUp();
+    // updates the data sources, then the objects in wanted (all if 0L)
+    void updateObjects(const QSet<Object*> *wanted, bool updateSources);
+
   private:
     bool _delayedUpdate;
     int _minUpdatePeriod;
@@ -58,6 +101,13 @@ class KSTCORE_EXPORT UpdateManager : public QObject
     bool _updateInProgress;
     qint64 _serial;
     ObjectStore *_store;
+
+    bool _demandDriven;
+    bool _catchUpScheduled;
+    qint64 _caughtUpSerial;
+    QHash<QObject*, QList<QPointer<Object> > > _interest;
+    QSet<QObject*> _interestInAll;
+    QSet<Object*> _wanted;
 };
 
 }
@@ -21,6 +21,7 @@
 #include <assert.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <QDebug>
 #include <QApplication>
@@ -32,6 +33,7 @@
 #include "math_kst.h"
 #include "debug.h"
 #include "objectstore.h"
+#include "sessiondata.h"
 #include "updatemanager.h"
 
 namespace Kst {
@@ -48,6 +50,7 @@ Vector::Vector(ObjectStore *store)
   _initializeShortName();
 
   _editable = false;
+  _snapshotsWanted = false;
   NumShifted = 0;
   NumNew = 0;
   _saveData = false;
@@ -137,7 +140,7 @@ const QString& Vector::typeString() const {
     return NOPOINT;                    \
   }                                         \
                                             \
-  double fdj = fj - float(j); /* fdj is fraction between _v[j] and _v[j+1] */ \
+  double fdj = fj - double(j); /* fdj is fraction between _v[j] and _v[j+1] */ \
                                             \
   return _v[j + 1] * fdj + _v[j] * (1.0 - fdj);
 
@@ -224,7 +227,7 @@ double kstInterpolate(double *_v, int _size, int in_i, int ns_i) {
     return NOPOINT;                    \
   }                                         \
                                             \
-  double fdj = fj - float(j); /* fdj is fraction between _v[j] and _v[j+1] */ \
+  double fdj = fj - double(j); /* fdj is fraction between _v[j] and _v[j+1] */ \
                                             \
   return _v[j + 1] * fdj + _v[j] * (1.0 - fdj);
 
@@ -246,81 +249,157 @@ double kstInterpolateNoHoles(double *_v, int _size, int in_i, int ns_i) {
 #undef RETURN_FIRST_NON_HOLE
 #undef GENERATE_INTERPOLATION
 
-double Vector::value(int i) const {
-  if (i < 0 || i >= _size) { // can't look before beginning or past end
-    return 0.0;
+
+void kstInterpolateRange(const double *_v, int _size, int ns_i, int from, int to, double *out) {
+  assert(_size > 0);
+  int i = from;
+
+  if (_size == 1) {
+    for (; i < to; ++i) {
+      *out++ = _v[0];
+    }
+    return;
+  }
+
+  for (; i < to && i < 0; ++i) {
+    *out++ = _v[0];
+  }
+
+  const int last = qMin(to, ns_i - 1);
+  if (ns_i == _size) {
+    if (i < last) {
+      memcpy(out, _v + i, (last - i) * sizeof(double));
+      out += last - i;
+      i = last;
+    }
+  } else {
+    // Same arithmetic as interpolate(), so the results agree to the bit.
+    // There is no need to test for holes: they propagate through the sum.
+    const double num = double(_size - 1);
+    const double den = double(ns_i - 1);
+    for (; i < last; ++i) {
+      const double fj = i * num / den;
+      const int j = int(fj);
+      const double fdj = fj - double(j);
+      *out++ = _v[j + 1] * fdj + _v[j] * (1.0 - fdj);
+    }
+  }
+
+  for (; i < to; ++i) {
+    *out++ = _v[_size - 1];
   }
-  return _v[i];
 }
 
-void Vector::CreateScalars(ObjectStore *store) {
-  if (!_isScalarList) {
-    _min = _max = _mean = _minPos = 0.0;
 
-    Q_ASSERT(store);
-    ScalarPtr sp;
-    _scalars.insert("max", sp = store->createObject<Scalar>());
-    sp->setProvider(this);
-    sp->setSlaveName("Max");
+int kstFillHoles(const double *_v, int _size, double *out) {
+  int holes = 0;
+  int left = -1;
 
-    _scalars.insert("min", sp = store->createObject<Scalar>());
-    sp->setProvider(this);
-    sp->setSlaveName("Min");
+  for (int i = 0; i < _size; ++i) {
+    if (_v[i] != _v[i]) {
+      ++holes;
+      continue;
+    }
+    const double right = _v[i];
+    if (left < i - 1) {
+      if (left < 0) {
+        for (int k = 0; k < i; ++k) {
+          out[k] = right;
+        }
+      } else {
+        const double l = _v[left];
+        for (int k = left + 1; k < i; ++k) {
+          out[k] = l + (right - l) * double(k - left) / double(i - left);
+        }
+      }
+    }
+    out[i] = right;
+    left = i;
+  }
 
-    _scalars.insert("last", sp = store->createObject<Scalar>());
-    sp->setProvider(this);
-    sp->setSlaveName("Last");
+  const double fill = left < 0 ? 0. : _v[left];
+  for (int k = left + 1; k < _size; ++k) {
+    out[k] = fill;
+  }
 
-    _scalars.insert("first", sp = store->createObject<Scalar>());
-    sp->setProvider(this);
-    sp->setSlaveName("First");
+  return holes;
+}
 
-    _scalars.insert("mean", sp = store->createObject<Scalar>());
-    sp->setProvider(this);
-    sp->setSlaveName("Mean");
 
-    _scalars.insert("sigma", sp = store->createObject<Scalar>());
-    sp->setProvider(this);
-    sp->setSlaveName("Sigma");
+ResampledVector::ResampledVector(const Vector *v, int ns_i, int from, int to)
+  : _vector(v), _data(0L), _ns(ns_i), _from(0), _to(0) {
+  if (!v || v->length() < 1) {
+    return;
+  }
+  if (to < 0 || to > ns_i) {
+    to = ns_i;
+  }
+  if (from < 0) {
+    from = 0;
+  }
+  if (from >= to) {
+    return;
+  }
+
+  _from = from;
+  _to = to;
+  if (ns_i == v->length()) {
+    _data = v->value() + from;
+  } else {
+    _resampled.resize(to - from);
+    kstInterpolateRange(v->value(), v->length(), ns_i, from, to, _resampled.data());
+    _data = _resampled.constData();
+  }
+}
 
-    _scalars.insert("rms", sp = store->createObject<Scalar>());
-    sp->setProvider(this);
-    sp->setSlaveName("Rms");
 
-    _scalars.insert("ns", sp = store->createObject<Scalar>());
-    sp->setProvider(this);
-    sp->setSlaveName("NS");
+double Vector::value(int i) const {
+  if (i < 0 || i >= _size) { // can't look before beginning or past end
+    return 0.0;
+  }
+  return _v[i];
+}
 
-    _scalars.insert("sum", sp = store->createObject<Scalar>());
-    sp->setProvider(this);
-    sp->setSlaveName("Sum");
+static const StatScalars::Stat vectorStats[] = {
+  { "max", "Max" },
+  { "min", "Min" },
+  { "last", "Last" },
+  { "first", "First" },
+  { "mean", "Mean" },
+  { "sigma", "Sigma" },
+  { "rms", "Rms" },
+  { "ns", "NS" },
+  { "sum", "Sum" },
+  { "sumsquared", "SumSquared" },
+  { "minpos", "MinPos" }
+};
 
-    _scalars.insert("sumsquared", sp = store->createObject<Scalar>());
-    sp->setProvider(this);
-    sp->setSlaveName("SumSquared");
 
-    _scalars.insert("minpos", sp = store->createObject<Scalar>());
-    sp->setProvider(this);
-    sp->setSlaveName("MinPos");
+void Vector::CreateScalars(ObjectStore *store) {
+  if (!_isScalarList) {
+    _min = _max = _mean = _minPos = 0.0;
 
+    Q_ASSERT(store);
+    Q_UNUSED(store);
+    _stats.init(this, &_scalars, vectorStats, sizeof(vectorStats)/sizeof(vectorStats[0]));
   }
 }
 
 
 void Vector::updateScalars() {
   if (!_isScalarList) {
-    _scalars["ns"]->setValue(_size);
+    _stats.setValue("ns", _size);
 
     if (_nsum >= 2) {
-      double sum = _scalars["sum"]->value();
-      double sumsq = _scalars["sumsquared"]->value();
-      _scalars["mean"]->setValue(_mean = sum/double(_nsum));
-      _scalars["sigma"]->setValue(sqrt((sumsq - sum * sum / double(_nsum)) / double(_nsum-1)));
-      _scalars["rms"]->setValue(sqrt(sumsq/double(_nsum)));
+      double sum = _stats.value("sum");
+      double sumsq = _stats.value("sumsquared");
+      _stats.setValue("mean", _mean = sum/double(_nsum));
+      _stats.setValue("sigma", sqrt((sumsq - sum * sum / double(_nsum)) / double(_nsum-1)));
+      _stats.setValue("rms", sqrt(sumsq/double(_nsum)));
     } else {
-      _scalars["sigma"]->setValue(_max - _min);
-      _scalars["rms"]->setValue(sqrt(_scalars["sumsquared"]->value()));
-      _scalars["mean"]->setValue(_mean = NOPOINT);
+      _stats.setValue("sigma", _max - _min);
+      _stats.setValue("rms", sqrt(_stats.value("sumsquared")));
+      _stats.setValue("mean", _mean = NOPOINT);
     }
   }
 }
@@ -400,18 +479,19 @@ void Vector::internalUpdate() {
 
     if (i == _size) { // there were no finite points:
       if (!_isScalarList) {
-        _scalars["sum"]->setValue(sum);
-        _scalars["sumsquared"]->setValue(sum2);
-        _scalars["max"]->setValue(_max);
-        _scalars["min"]->setValue(_min);
-        _scalars["minpos"]->setValue(_minPos);
-        _scalars["last"]->setValue(last);
-        _scalars["first"]->setValue(first);
+        _stats.setValue("sum", sum);
+        _stats.setValue("sumsquared", sum2);
+        _stats.setValue("max", _max);
+        _stats.setValue("min", _min);
+        _stats.setValue("minpos", _minPos);
+        _stats.setValue("last", last);
+        _stats.setValue("first", first);
       }
       _ns_max = _ns_min = 0;
 
       updateScalars();
 
+      publishSnapshot();
       return;
     }
 
@@ -494,18 +574,20 @@ void Vector::internalUpdate() {
     if (_isScalarList) {
       _max = _min = _minPos = 0.0;
     } else {
-      _scalars["sum"]->setValue(sum);
-      _scalars["sumsquared"]->setValue(sum2);
-      _scalars["max"]->setValue(_max);
-      _scalars["min"]->setValue(_min);
-      _scalars["minpos"]->setValue(_minPos);
-      _scalars["last"]->setValue(last);
-      _scalars["first"]->setValue(first);
+      _stats.setValue("sum", sum);
+      _stats.setValue("sumsquared", sum2);
+      _stats.setValue("max", _max);
+      _stats.setValue("min", _min);
+      _stats.setValue("minpos", _minPos);
+      _stats.setValue("last", last);
+      _stats.setValue("first", first);
     }
 
     updateScalars();
 
   }
+
+  publishSnapshot();
 }
 
 void Vector::save(QXmlStreamWriter &s) {
@@ -513,17 +595,21 @@ void Vector::save(QXmlStreamWriter &s) {
     return;
   }
   s.writeStartElement("vector");
+  saveNameInfo(s, VNUM|XNUM);
   if (_saveData) {
-    QByteArray qba(length()*sizeof(double), '\0');
-    QDataStream qds(&qba, QIODevice::WriteOnly);
+    SessionData *sidecar = store() ? store()->sessionData : 0L;
+    if (!sidecar || !sidecar->writeArray(s, _v, length())) {
+      QByteArray qba(sizeof(qint64) + length()*sizeof(double), '\0');
+      QDataStream qds(&qba, QIODevice::WriteOnly);
+
+      qds << qint64(length());
+      for (int i = 0; i < length(); i++) {
+        qds << _v[i];
+      }
 
-    for (int i = 0; i < length(); i++) {
-      qds << _v[i];
+      s.writeTextElement("data_v2", qCompress(qba).toBase64());
     }
-
-    s.writeTextElement("data_v2", qCompress(qba).toBase64());
   }
-  saveNameInfo(s, VNUM|XNUM);
   s.writeEndElement();
 }
 
@@ -537,6 +623,75 @@ double *Vector::value() const {
 }
 
 
+VectorSnapshot::VectorSnapshot()
+  : _version(0), _min(0.0), _max(0.0), _ns_min(0.0), _ns_max(0.0),
+    _mean(0.0), _minPos(0.0), _isRising(false) {
+}
+
+
+VectorSnapshot Vector::makeSnapshot() const {
+  VectorSnapshot s;
+  s._data = QVector<double>(_size);
+  memcpy(s._data.data(), _v, _size * sizeof(double));
+  s._min = _min;
+  s._max = _max;
+  s._ns_min = _ns_min;
+  s._ns_max = _ns_max;
+  s._mean = _mean;
+  s._minPos = _minPos;
+  s._isRising = _is_rising;
+  return s;
+}
+
+
+VectorSnapshot Vector::snapshot() const {
+  {
+    QMutexLocker locker(&_snapshotMutex);
+    if (_snapshotsWanted) {
+      return _snapshot;
+    }
+  }
+
+  readLock();
+  VectorSnapshot s = makeSnapshot();
+  {
+    QMutexLocker locker(&_snapshotMutex);
+    if (_snapshotsWanted) {
+      s = _snapshot; // someone beat us to it
+    } else {
+      s._version = _snapshot._version + 1;
+      _snapshot = s;
+      _snapshotsWanted = true;
+    }
+  }
+  unlock();
+  return s;
+}
+
+
+void Vector::publishSnapshot() {
+  {
+    QMutexLocker locker(&_snapshotMutex);
+    if (!_snapshotsWanted) {
+      return;
+    }
+    // If no reader still holds the last snapshot, nobody is following the
+    // vector any more: stop copying until the next snapshot() call.
+    if (_snapshot._data.isEmpty() || _snapshot._data.isDetached()) {
+      _snapshot._data = QVector<double>();
+      _snapshotsWanted = false;
+      return;
+    }
+  }
+
+  // only our writer changes the data, so it can be copied outside the mutex
+  VectorSnapshot s = makeSnapshot();
+  QMutexLocker locker(&_snapshotMutex);
+  s._version = _snapshot._version + 1;
+  _snapshot = s;
+}
+
+
 void Vector::newSync() {
   NumNew = NumShifted = 0;
 }
@@ -632,6 +787,20 @@ void Vector::change(QByteArray &data) {
   }
   updateScalars();
   internalUpdate();
+  touchDescriptiveNames(); // editable vectors are named by their values
+}
+
+void Vector::change(const double *data, int count) {
+  if (count > 0) {
+    _saveable = true;
+    _saveData = true;
+
+    resize(qMax(int(INITSIZE), count), true);
+    memcpy(_v, data, count*sizeof(double));
+  }
+  updateScalars();
+  internalUpdate();
+  touchDescriptiveNames(); // editable vectors are named by their values
 }
 
 QString Vector::propertyString() const {
@@ -666,6 +835,16 @@ ObjectList<Primitive> Vector::outputPrimitives() const {
   return primitive_list;
 }
 
+PrimitivePtr Vector::materializeSlave(const QString &shortName) {
+  return kst_cast<Primitive>(_stats.materialize(shortName));
+}
+
+
+QStringList Vector::unmaterializedSlaveNames() const {
+  return _stats.unmaterializedNames();
+}
+
+
 PrimitiveMap Vector::metas() const
 {
   PrimitiveMap meta;
@@ -716,10 +895,11 @@ QByteArray Vector::scriptInterface(QList<QByteArray> &c) {
         if(c.size()!=2) {
             return "value takes 1 arg";
         }
+        // one value: read it under the lock rather than copy the vector
         readLock();
-        QByteArray ret = QByteArray::number(value(c[1].toDouble()));
+        const double v=value(c[1].toInt());
         unlock();
-        return ret;
+        return QByteArray::number(v);
     } else if(c[0]=="min") {
         return QByteArray::number(min());
     } else if(c[0]=="max") {
@@ -764,14 +944,14 @@ QByteArray Vector::scriptInterface(QList<QByteArray> &c) {
 }
 
 QByteArray Vector::getBinaryArray() const {
-    readLock();
+    const VectorSnapshot snap = snapshot();
+    const double *v = snap.value();
     QByteArray ret;
     QDataStream ds(&ret,QIODevice::WriteOnly);
-    ds<<(qint64)_size;
-    for(int i=0;i<_size;i++) {
-        ds<<(double)_v[i];
+    ds<<(qint64)snap.length();
+    for(int i=0;i<snap.length();i++) {
+        ds<<(double)v[i];
     }
-    unlock();
     return ret;
 }
 
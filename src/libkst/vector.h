@@ -20,10 +20,13 @@
 
 #include <math.h>
 
+#include <QMutex>
 #include <QPointer>
+#include <QVector>
 
 #include "primitive.h"
 #include "scalar.h"
+#include "statscalars.h"
 #include "string_kst.h"
 #include "labelinfo.h"
 #include "kst_export.h"
@@ -42,9 +45,55 @@ class KstDataObject;
 KSTCORE_EXPORT double kstInterpolate(double *v, int _size, int in_i, int ns_i);
 KSTCORE_EXPORT double kstInterpolateNoHoles(double *v, int _size, int in_i, int ns_i);
 
+/** Fill out[i - from] with kstInterpolate(v, _size, i, ns_i) for
+    from <= i < to, in one pass. */
+KSTCORE_EXPORT void kstInterpolateRange(const double *v, int _size, int ns_i, int from, int to, double *out);
+
+/** Copy v to out with the holes (NaNs) linearly interpolated over, as
+    kstInterpolateNoHoles(v, _size, i, _size) would.  Returns the number of
+    holes filled. */
+KSTCORE_EXPORT int kstFillHoles(const double *v, int _size, double *out);
+
 class Vector;
 typedef SharedPtr<Vector> VectorPtr;
 
+/** An immutable copy of a vector's data and statistics as of one of its
+    updates.  Copies are cheap (the data is implicitly shared) and reading
+    one needs no lock, so a reader holding a snapshot never waits for, or
+    holds up, the vector's next update.  */
+class KSTCORE_EXPORT VectorSnapshot {
+  public:
+    VectorSnapshot();
+
+    /** Counts the updates published by the vector; 0 for a null snapshot */
+    int version() const { return _version; }
+    bool isNull() const { return _version == 0; }
+
+    int length() const { return _data.size(); }
+    const double *value() const { return _data.constData(); }
+
+    /** V[i], or 0 outside the vector, as Vector::value(i) */
+    double value(int i) const {
+      return (i < 0 || i >= _data.size()) ? 0.0 : _data.at(i);
+    }
+
+    double min() const { return _min; }
+    double max() const { return _max; }
+    double ns_min() const { return _ns_min; }
+    double ns_max() const { return _ns_max; }
+    double mean() const { return _mean; }
+    double minPos() const { return _minPos; }
+    bool isRising() const { return _isRising; }
+
+  private:
+    friend class Vector;
+
+    QVector<double> _data;
+    int _version;
+    double _min, _max, _ns_min, _ns_max, _mean, _minPos;
+    bool _isRising;
+};
+
 /**A class for handling data vectors for kst.
  *@author cbn
  */
@@ -70,6 +119,7 @@ class KSTCORE_EXPORT Vector : public Primitive
   public:
     void change(QByteArray& data);
     void oldChange(QByteArray& data);
+    void change(const double *data, int count);
 
     inline int length() const { return _size; }
 
@@ -138,6 +188,14 @@ class KSTCORE_EXPORT Vector : public Primitive
     /** Return a pointer to the raw vector */
     double *value() const;
 
+    /** The data as of the last update.  The first call takes a read lock to
+        make the snapshot; from then on every update publishes a new one, and
+        this returns it without touching the vector's lock.  Updates stop
+        publishing once no reader holds the last snapshot any more, so a
+        reader which follows the vector keeps its snapshot between reads;
+        one which wants a single value should read it under the lock. */
+    VectorSnapshot snapshot() const;
+
     /** access functions for _isScalarList */
     bool isScalarList() const { return _isScalarList; }
 
@@ -155,8 +213,10 @@ class KSTCORE_EXPORT Vector : public Primitive
 
     virtual void internalUpdate();
 
-    // output primitives: statistics scalars, etc.
+    // output primitives: statistics scalars, etc.  Only the statistics
+    // something has asked for exist as scalars; scalar() creates them.
     ScalarMap scalars() const {return _scalars;}
+    ScalarPtr scalar(const QString &key) { return _stats.scalar(key); }
     StringMap strings() const {return _strings;}
 
     virtual PrimitiveMap metas() const;
@@ -164,6 +224,9 @@ class KSTCORE_EXPORT Vector : public Primitive
 
     virtual ObjectList<Primitive> outputPrimitives() const;
 
+    virtual SharedPtr<Primitive> materializeSlave(const QString &shortName);
+    virtual QStringList unmaterializedSlaveNames() const;
+
     virtual QString propertyString() const;
 
     // this is reimplemented but must not be virtual.
@@ -231,7 +294,53 @@ class KSTCORE_EXPORT Vector : public Primitive
     ObjectMap<Scalar> _scalars;
     ObjectMap<String> _strings;
 
+    /** the statistics, kept as values until someone wants them as scalars */
+    StatScalars _stats;
 
+    /** copy the current data into a new snapshot if a reader still holds
+        the previous one.  Called with the vector write locked at the end of
+        each update. */
+    void publishSnapshot();
+
+  private:
+    VectorSnapshot makeSnapshot() const;
+
+    mutable QMutex _snapshotMutex;
+    mutable VectorSnapshot _snapshot;
+    mutable bool _snapshotsWanted;
+};
+
+
+/** The samples [from, to) of a vector interpolated/decimated to have ns_i
+    total samples, computed in one pass rather than one interpolate() call
+    at a time.  When no resampling is needed it points straight at the
+    vector's data, so keep the vector locked while it is in use.  Samples
+    outside [from, to) fall back to Vector::interpolate(). */
+class KSTCORE_EXPORT ResampledVector {
+  public:
+    ResampledVector(const Vector *v, int ns_i, int from = 0, int to = -1);
+
+    inline double at(int i) const {
+      if (i >= _from && i < _to) {
+        return _data[i - _from];
+      }
+      return _vector->interpolate(i, _ns);
+    }
+
+    /** Sample from() onwards, to() - from() of them */
+    inline const double *data() const { return _data; }
+    inline int from() const { return _from; }
+    inline int to() const { return _to; }
+
+  private:
+    Q_DISABLE_COPY(ResampledVector)
+
+    const Vector *_vector;
+    const double *_data;
+    int _ns;
+    int _from;
+    int _to;
+    QVector<double> _resampled;
 };
 
 
@@ -0,0 +1,516 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "vectorexport.h"
+
+#include <locale.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <QDir>
+#include <QFile>
+#include <QLocale>
+#include <QSet>
+
+#include "math_kst.h"
+#include "parallel.h"
+
+namespace Kst {
+
+static const char ColumnarMagic[8] = { 'K', 'S', 'T', 'C', 'O', 'L', 'S', '1' };
+static const quint32 ByteOrderMark = 0x01020304;
+static const qint64 Alignment = 64;
+
+// the longest text formatDouble() writes, and a column separator
+static const int CellBytes = 25;
+
+// the most a block of rows may take: what a QByteArray holds, with room
+// to spare for its header
+static const qint64 MaxBlockBytes = 0x7fffff00;
+
+
+// Formats the blocks of one batch, each into its own piece, so they can be
+// written out in order once the batch is done.
+class VectorExportJob : public ParallelJob {
+  public:
+    VectorExportJob(const VectorExport *e, int column, qint64 firstRow, int blocks)
+      : pieces(blocks), _export(e), _column(column), _firstRow(firstRow) {}
+
+    void processChunk(int, qint64 begin, qint64 end) {
+      for (qint64 b = begin; b < end; ++b) {
+        const qint64 from = _firstRow + b * VectorExport::BlockRows;
+        const qint64 to = qMin(from + VectorExport::BlockRows, _export->_rows);
+        pieces[int(b)] = _export->formatBlock(_column, from, to);
+      }
+    }
+
+    QVector<QByteArray> pieces;
+
+  private:
+    const VectorExport *_export;
+    int _column;
+    qint64 _firstRow;
+};
+
+
+VectorExport::VectorExport(const QString& fileName, Format format, QObject *parent)
+  : QThread(parent), _fileName(fileName), _format(format), _header(true), _rows(0),
+    _rowsToWrite(0), _rowsWritten(0), _cancelled(0), _percent(0), _succeeded(false) {
+}
+
+
+VectorExport::~VectorExport() {
+  cancel();
+  wait();
+}
+
+
+VectorExport::Format VectorExport::formatFromName(const QString& name, bool *ok) {
+  const int format = formatNames().indexOf(name.toLower());
+  if (ok) {
+    *ok = format >= 0;
+  }
+  return format >= 0 ? Format(format) : Text;
+}
+
+
+QStringList VectorExport::formatNames() {
+  // in the order of Format
+  return QStringList() << "text" << "binary" << "dirfile" << "columnar";
+}
+
+
+void VectorExport::addVector(VectorPtr vector, const QString& name, bool hex) {
+  if (!vector) {
+    return;
+  }
+  Column column;
+  column.data = vector->snapshot();
+  column.name = name.isEmpty() ? vector->descriptiveName() : name;
+  column.hex = hex;
+  _columns.append(column);
+}
+
+
+void VectorExport::cancel() {
+  _cancelled.store(1);
+}
+
+
+bool VectorExport::isCancelled() const {
+  return _cancelled.load() != 0;
+}
+
+
+int VectorExport::percentDone() const {
+  return _percent.load();
+}
+
+
+void VectorExport::run() {
+  exportNow();
+}
+
+
+bool VectorExport::exportNow() {
+  _error.clear();
+  _succeeded = false;
+  _percent.store(0);
+
+  _rows = 0;
+  for (int i = 0; i < _columns.size(); ++i) {
+    _rows = qMax(_rows, qint64(_columns.at(i).data.length()));
+  }
+  if (_columns.isEmpty()) {
+    _error = tr("There are no vectors to export.");
+    return false;
+  }
+
+  _rowsWritten = 0;
+  _rowsToWrite = (_format == Dirfile || _format == Columnar) ? _rows * _columns.size() : _rows;
+
+  bool ok;
+  switch (_format) {
+    case Dirfile:
+      ok = exportDirfile();
+      break;
+    case Columnar:
+      ok = exportColumnar();
+      break;
+    case Binary:
+      ok = exportText(true);
+      break;
+    default:
+      ok = exportText(false);
+      break;
+  }
+
+  if (isCancelled()) {
+    _error = tr("The export to %1 was cancelled.").arg(_fileName);
+    ok = false;
+  }
+  _succeeded = ok;
+  if (ok) {
+    _percent.store(100);
+  }
+  emit progress(100, ok ? tr("Exported %1.").arg(_fileName) : _error);
+  return ok;
+}
+
+
+int VectorExport::formatDouble(double v, char *out) {
+  if (v != v) {
+    memcpy(out, "nan", 3);
+    return 3;
+  }
+  if (v - v != 0.0) {
+    if (v < 0.0) {
+      memcpy(out, "-inf", 4);
+      return 4;
+    }
+    memcpy(out, "inf", 3);
+    return 3;
+  }
+
+  // Whole numbers are common in data and need no search for the precision.
+  if (v == floor(v) && fabs(v) < 1e15) {
+    qint64 n = qint64(v);
+    char digits[20];
+    int count = 0;
+    const bool negative = n < 0;
+    if (negative) {
+      n = -n;
+    }
+    do {
+      digits[count++] = char('0' + n % 10);
+      n /= 10;
+    } while (n > 0);
+
+    int length = 0;
+    if (negative) {
+      out[length++] = '-';
+    }
+    while (count > 0) {
+      out[length++] = digits[--count];
+    }
+    return length;
+  }
+
+#if QT_VERSION >= 0x050700
+  // Qt finds the shortest round trip directly, and always with a '.'
+  const QByteArray text = QByteArray::number(v, 'g', QLocale::FloatingPointShortest);
+  const int length = qMin(text.size(), CellBytes - 1);
+  memcpy(out, text.constData(), length);
+  return length;
+#else
+  // 17 significant digits always read back, but most values are shorter.
+  int length = 0;
+  for (int precision = 15; precision <= 17; ++precision) {
+    length = snprintf(out, CellBytes, "%.*g", precision, v);
+    if (precision == 17 || strtod(out, 0L) == v) {
+      break;
+    }
+  }
+
+  const char point = localeconv()->decimal_point[0];
+  if (point != '.') {
+    for (int i = 0; i < length; ++i) {
+      if (out[i] == point) {
+        out[i] = '.';
+        break;
+      }
+    }
+  }
+  return length;
+#endif
+}
+
+
+QByteArray VectorExport::formatBlock(int column, qint64 from, qint64 to) const {
+  if (isCancelled() || to <= from) {
+    return QByteArray();
+  }
+
+  const int n = int(to - from);
+  const int first = column < 0 ? 0 : column;
+  const int last = column < 0 ? _columns.size() : column + 1;
+
+  // the samples of each column in the block, resampled to _rows
+  QVector<QVector<double> > samples(last - first);
+  for (int c = first; c < last; ++c) {
+    const VectorSnapshot& data = _columns.at(c).data;
+    QVector<double>& s = samples[c - first];
+    s.resize(n);
+    if (data.length() > 0) {
+      kstInterpolateRange(data.value(), data.length(), int(_rows), int(from), int(to), s.data());
+    } else {
+      s.fill(NOPOINT);
+    }
+  }
+
+  QByteArray bytes;
+  if (_format == Text) {
+    const qint64 size = qint64(n) * (last - first) * CellBytes + n;
+    Q_ASSERT(size <= MaxBlockBytes);
+    bytes.resize(int(size));
+    char *out = bytes.data();
+    for (int r = 0; r < n; ++r) {
+      for (int c = first; c < last; ++c) {
+        if (c > first) {
+          *out++ = ' ';
+        }
+        const double v = samples.at(c - first).at(r);
+        if (_columns.at(c).hex) {
+          out += snprintf(out, CellBytes, "%4x", int(v));
+        } else {
+          out += formatDouble(v, out);
+        }
+      }
+      *out++ = '\n';
+    }
+    bytes.resize(int(out - bytes.constData()));
+  } else if (column < 0) {
+    // binary rows: interleave the columns
+    const int width = last - first;
+    const qint64 size = qint64(n) * width * qint64(sizeof(double));
+    Q_ASSERT(size <= MaxBlockBytes);
+    bytes.resize(int(size));
+    double *out = reinterpret_cast<double*>(bytes.data());
+    for (int r = 0; r < n; ++r) {
+      for (int c = 0; c < width; ++c) {
+        *out++ = samples.at(c).at(r);
+      }
+    }
+  } else {
+    bytes = QByteArray(reinterpret_cast<const char*>(samples.at(0).constData()), n * int(sizeof(double)));
+  }
+  return bytes;
+}
+
+
+bool VectorExport::writeTo(QIODevice *out, const QByteArray& bytes) {
+  if (out->write(bytes) != bytes.size()) {
+    _error = tr("Could not write to %1: %2").arg(_fileName).arg(out->errorString());
+    return false;
+  }
+  return true;
+}
+
+
+bool VectorExport::finish(QFile *file) {
+  file->close();
+  if (file->error() != QFile::NoError) {
+    _error = tr("Could not write to %1: %2").arg(file->fileName()).arg(file->errorString());
+    return false;
+  }
+  return true;
+}
+
+
+bool VectorExport::pad(QIODevice *out) {
+  const qint64 padding = (Alignment - out->pos() % Alignment) % Alignment;
+  return padding == 0 || writeTo(out, QByteArray(int(padding), '\0'));
+}
+
+
+bool VectorExport::writeBlocks(QIODevice *out, int column) {
+  const qint64 blocks = (_rows + BlockRows - 1) / BlockRows;
+  // enough blocks to keep every core busy without holding much text at once
+  const int batch = 4 * qMax(QThread::idealThreadCount(), 1);
+
+  for (qint64 first = 0; first < blocks; first += batch) {
+    if (isCancelled()) {
+      return false;
+    }
+    const int count = int(qMin(qint64(batch), blocks - first));
+    VectorExportJob job(this, column, first * BlockRows, count);
+    runParallel(&job, count, 1);
+
+    for (int b = 0; b < count; ++b) {
+      if (isCancelled() || !writeTo(out, job.pieces.at(b))) {
+        return false;
+      }
+    }
+    reportProgress(qMin((first + count) * BlockRows, _rows));
+  }
+  _rowsWritten += _rows;
+  return true;
+}
+
+
+void VectorExport::reportProgress(qint64 rowsDone) {
+  if (_rowsToWrite <= 0) {
+    return;
+  }
+  const int percent = int(100 * (_rowsWritten + rowsDone) / _rowsToWrite);
+  if (percent != _percent.load() && percent < 100) {
+    _percent.store(percent);
+    emit progress(percent, tr("Exporting to %1").arg(_fileName));
+  }
+}
+
+
+bool VectorExport::exportText(bool binary) {
+  // a block holds every column of BlockRows rows
+  const qint64 rowBytes = binary ? qint64(sizeof(double)) : CellBytes;
+  const qint64 maxColumns = (MaxBlockBytes / BlockRows - (binary ? 0 : 1)) / rowBytes;
+  if (_columns.size() > maxColumns) {
+    _error = tr("Cannot export %1 columns to %2: at most %3 fit in this format.").arg(_columns.size()).arg(_fileName).arg(maxColumns);
+    return false;
+  }
+
+  QFile file;
+  bool opened;
+  if (_fileName == "-") {
+    opened = file.open(stdout, QIODevice::WriteOnly);
+  } else {
+    file.setFileName(_fileName);
+    opened = file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  }
+  if (!opened) {
+    _error = tr("Could not open %1 for writing: %2").arg(_fileName).arg(file.errorString());
+    return false;
+  }
+
+  if (!binary && _header) {
+    QByteArray header("#");
+    for (int i = 0; i < _columns.size(); ++i) {
+      header += ' ' + _columns.at(i).name.toUtf8();
+    }
+    header += '\n';
+    if (!writeTo(&file, header)) {
+      return false;
+    }
+  }
+
+  if (!writeBlocks(&file, -1)) {
+    return false;
+  }
+  return finish(&file);
+}
+
+
+QStringList VectorExport::dirfileFieldNames(const QStringList& names) {
+  QStringList fields;
+  QSet<QString> used;
+  used << "format" << "INDEX";
+  for (int i = 0; i < names.size(); ++i) {
+    QString name = names.at(i);
+    for (int j = 0; j < name.length(); ++j) {
+      const QChar c = name.at(j);
+      if (!(c.isLetterOrNumber() && c.unicode() < 128) && c != '_') {
+        name[j] = '_';
+      }
+    }
+    if (name.isEmpty()) {
+      name = QString("column%1").arg(i + 1);
+    }
+
+    QString unique = name;
+    for (int k = 2; used.contains(unique); ++k) {
+      unique = QString("%1_%2").arg(name).arg(k);
+    }
+    used << unique;
+    fields << unique;
+  }
+  return fields;
+}
+
+
+QByteArray VectorExport::dirfileFormat(const QStringList& fields, const QList<int>& samplesPerFrame) {
+  QByteArray spec;
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+  spec += "/ENDIAN little\n";
+#else
+  spec += "/ENDIAN big\n";
+#endif
+  for (int i = 0; i < fields.size(); ++i) {
+    const int spf = i < samplesPerFrame.size() ? samplesPerFrame.at(i) : 1;
+    spec += fields.at(i).toLatin1() + " RAW FLOAT64 " + QByteArray::number(spf) + '\n';
+  }
+  return spec;
+}
+
+
+bool VectorExport::exportDirfile() {
+  QDir dir(_fileName);
+  if (!dir.exists() && !QDir().mkpath(_fileName)) {
+    _error = tr("Could not make the directory %1.").arg(_fileName);
+    return false;
+  }
+
+  QStringList columns;
+  for (int i = 0; i < _columns.size(); ++i) {
+    columns << _columns.at(i).name;
+  }
+  const QStringList names = dirfileFieldNames(columns);
+
+  QFile format(dir.filePath("format"));
+  if (!format.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+    _error = tr("Could not open %1 for writing: %2").arg(format.fileName()).arg(format.errorString());
+    return false;
+  }
+  if (!writeTo(&format, dirfileFormat(names, QList<int>()))) {
+    return false;
+  }
+  format.close();
+
+  for (int i = 0; i < _columns.size(); ++i) {
+    QFile file(dir.filePath(names.at(i)));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      _error = tr("Could not open %1 for writing: %2").arg(file.fileName()).arg(file.errorString());
+      return false;
+    }
+    if (!writeBlocks(&file, i) || !finish(&file)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+bool VectorExport::exportColumnar() {
+  QFile file(_fileName);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    _error = tr("Could not open %1 for writing: %2").arg(_fileName).arg(file.errorString());
+    return false;
+  }
+
+  QByteArray header(ColumnarMagic, sizeof(ColumnarMagic));
+  const quint32 columns = _columns.size();
+  const quint64 rows = _rows;
+  header.append(reinterpret_cast<const char*>(&ByteOrderMark), sizeof(ByteOrderMark));
+  header.append(reinterpret_cast<const char*>(&columns), sizeof(columns));
+  header.append(reinterpret_cast<const char*>(&rows), sizeof(rows));
+  for (int i = 0; i < _columns.size(); ++i) {
+    const QByteArray name = _columns.at(i).name.toUtf8();
+    const quint32 length = name.size();
+    header.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    header.append(name);
+  }
+  if (!writeTo(&file, header) || !pad(&file)) {
+    return false;
+  }
+
+  for (int i = 0; i < _columns.size(); ++i) {
+    if (!writeBlocks(&file, i) || !pad(&file)) {
+      return false;
+    }
+  }
+  return finish(&file);
+}
+
+}
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,153 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef VECTOREXPORT_H
+#define VECTOREXPORT_H
+
+#include <QAtomicInt>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+
+#include "kst_export.h"
+#include "vector.h"
+
+class QFile;
+class QIODevice;
+
+namespace Kst {
+
+/** Writes a set of vectors to a file as columns, every vector resampled to
+    the length of the longest, as ExportVectorsDialog always has.
+
+    The rows are cut into blocks which are formatted on the compute thread
+    pool, a batch at a time, and written in order.  The export reads
+    snapshots of the vectors taken by addVector(), so it holds no locks and
+    can run in its own thread: start() it and watch progress() and
+    finished(), or call exportNow() to run it in the calling thread.
+
+    The formats are:
+      Text      a "#" line of names, then one line of blank separated values
+                per row, each printed with the fewest digits which read back
+                to the same double.
+      Binary    the rows one after the other as native doubles, no header.
+      Dirfile   a directory holding a format file and one FLOAT64 file per
+                vector, which the dirfile reader opens directly.
+      Columnar  one file: the magic "KSTCOLS1", a byte order mark (quint32
+                0x01020304), the number of columns (quint32) and rows
+                (quint64), then per column the length (quint32) and UTF-8
+                bytes of its name; then each column as native doubles.  The
+                header and every column start on a 64 byte boundary.
+    Text and Binary go to standard output if the file name is "-". */
+class KSTCORE_EXPORT VectorExport : public QThread
+{
+  Q_OBJECT
+  public:
+    enum Format { Text, Binary, Dirfile, Columnar };
+
+    VectorExport(const QString& fileName, Format format = Text, QObject *parent = 0L);
+    ~VectorExport();
+
+    /** The format by its name, "text", "binary", "dirfile" or "columnar";
+        ok, if given, is false for any other name. */
+    static Format formatFromName(const QString& name, bool *ok = 0L);
+    static QStringList formatNames();
+
+    /** Adds a column, named name or else by the vector's descriptive name.
+        Hex columns print the integer part in hexadecimal in text. */
+    void addVector(VectorPtr vector, const QString& name = QString(), bool hex = false);
+
+    /** Whether text starts with a line of column names; on by default */
+    void setHeader(bool header) { _header = header; }
+
+    const QString& fileName() const { return _fileName; }
+    Format format() const { return _format; }
+
+    /** Exports in the calling thread.  Returns false if it failed or was
+        cancelled; errorString() says why. */
+    bool exportNow();
+
+    /** Stops the export at the next block.  Safe from any thread. */
+    void cancel();
+    bool isCancelled() const;
+
+    /** The result of the last export */
+    bool succeeded() const { return _succeeded; }
+    const QString& errorString() const { return _error; }
+
+    /** Percentage of the rows written so far */
+    int percentDone() const;
+
+    /** Writes v into out with the fewest significant digits which read back
+        as v, and returns the number of characters, at most 24.  Always uses
+        '.' for the decimal point, whatever the locale. */
+    static int formatDouble(double v, char *out);
+
+    /** Dirfile field names for names: unique, and only letters, digits and
+        '_' */
+    static QStringList dirfileFieldNames(const QStringList& names);
+    /** The format file of a dirfile of FLOAT64 fields, with
+        samplesPerFrame[i] samples per frame in fields[i] (1 if missing) */
+    static QByteArray dirfileFormat(const QStringList& fields, const QList<int>& samplesPerFrame);
+
+  Q_SIGNALS:
+    void progress(int percent, const QString& message);
+
+  protected:
+    void run();
+
+  private:
+    friend class VectorExportJob;
+
+    enum { BlockRows = 16384 };
+
+    struct Column {
+      VectorSnapshot data;
+      QString name;
+      bool hex;
+    };
+
+    // The rows [from, to) of column, or of every column if column < 0, in
+    // the bytes of the format.  Empty if the export was cancelled.
+    QByteArray formatBlock(int column, qint64 from, qint64 to) const;
+
+    // Writes the blocks of rows [0, _rows) of column to out, in order.
+    bool writeBlocks(QIODevice *out, int column);
+    bool writeTo(QIODevice *out, const QByteArray& bytes);
+    bool pad(QIODevice *out);
+    // closes file, checking that everything got written
+    bool finish(QFile *file);
+
+    bool exportText(bool binary);
+    bool exportDirfile();
+    bool exportColumnar();
+
+    void reportProgress(qint64 rowsDone);
+
+    QString _fileName;
+    Format _format;
+    bool _header;
+    QVector<Column> _columns;
+    qint64 _rows;
+    qint64 _rowsToWrite;
+    qint64 _rowsWritten;
+    QAtomicInt _cancelled;
+    QAtomicInt _percent;
+    bool _succeeded;
+    QString _error;
+};
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
@@ -19,6 +19,7 @@
 #include "datavector.h"
 #include "datacollection.h"
 #include "objectstore.h"
+#include "sessiondata.h"
 #include "datasourcepluginmanager.h"
 
 namespace Kst {
@@ -35,6 +36,7 @@ VectorFactory::~VectorFactory() {
 
 PrimitivePtr VectorFactory::generatePrimitive(ObjectStore *store, QXmlStreamReader& xml) {
   QByteArray data;
+  QVector<double> array;
   QString descriptiveName;
   Q_ASSERT(store);
   int saveVer=-1;
@@ -55,6 +57,12 @@ PrimitivePtr VectorFactory::generatePrimitive(ObjectStore *store, QXmlStreamRead
         data = qUncompress(qbca);
         saveVer=(n=="data")?1:2;
 
+      } else if (n == "data_sidecar") {
+        if (!store->sessionData || !store->sessionData->readArray(xml.attributes(), &array)) {
+          Debug::self()->log(QObject::tr("Vector data missing from the session's data file."), Debug::Warning);
+        }
+        saveVer = 3;
+        xml.readElementText();
       } else {
         return 0;
       }
@@ -74,7 +82,9 @@ PrimitivePtr VectorFactory::generatePrimitive(ObjectStore *store, QXmlStreamRead
   }
 
   VectorPtr vector = store->createObject<Vector>();
-  if(saveVer==2) {
+  if (saveVer == 3) {
+      vector->change(array.constData(), array.size());
+  } else if(saveVer==2) {
       vector->change(data);
   } else {
       vector->oldChange(data);
@@ -157,6 +167,7 @@ EditableVectorFactory::~EditableVectorFactory() {
 
 PrimitivePtr EditableVectorFactory::generatePrimitive(ObjectStore *store, QXmlStreamReader& xml) {
   QByteArray data;
+  QVector<double> array;
   QString descriptiveName;
   int dataVer=-1;
 
@@ -174,6 +185,12 @@ PrimitivePtr EditableVectorFactory::generatePrimitive(ObjectStore *store, QXmlSt
         QByteArray qbca = QByteArray::fromBase64(qcs.toLatin1());
         data = qUncompress(qbca);
         dataVer=(n=="data_v2")?2:1;
+      } else if (n == "data_sidecar") {
+        if (!store->sessionData || !store->sessionData->readArray(xml.attributes(), &array)) {
+          Debug::self()->log(QObject::tr("Vector data missing from the session's data file."), Debug::Warning);
+        }
+        dataVer = 3;
+        xml.readElementText();
       } else {
         return 0;
       }
@@ -194,7 +211,9 @@ PrimitivePtr EditableVectorFactory::generatePrimitive(ObjectStore *store, QXmlSt
 
   EditableVectorPtr vector = store->createObject<EditableVector>();
 
-  if(dataVer==2) {
+  if (dataVer == 3) {
+      vector->change(array.constData(), array.size());
+  } else if(dataVer==2) {
       vector->change(data);
   } else {
       vector->oldChange(data);
@@ -53,12 +53,14 @@ ApplicationSettings::ApplicationSettings() :
   _useOpenGL = _settings.value("general/opengl", false).toBool(); //QVariant(QGLPixelBuffer::hasOpenGLPbuffers())).toBool();
 
   _maxUpdate = _settings.value("general/minimumupdateperiod", QVariant(200)).toInt();
+  _demandDrivenUpdates = _settings.value("general/demanddrivenupdates", QVariant(true)).toBool();
 
   _showGrid = _settings.value("grid/showgrid", QVariant(false)).toBool();
   _snapToGrid = _settings.value("grid/snaptogrid", QVariant(false)).toBool();
   _gridHorSpacing = _settings.value("grid/horizontalspacing", 20.0).toDouble();
   _gridVerSpacing = _settings.value("grid/verticalspacing", 20.0).toDouble();
   _antialiasPlots = _settings.value("general/antialiasplots", QVariant(true)).toBool();
+  _sessionDataFile = _settings.value("general/sessiondatafile", QVariant(true)).toBool();
 
   Qt::BrushStyle style = (Qt::BrushStyle)_settings.value("fill/style", "0").toInt();
   if (style < Qt::LinearGradientPattern) {
@@ -179,6 +181,19 @@ void ApplicationSettings::setMinimumUpdatePeriod(const int period) {
 }
 
 
+bool ApplicationSettings::demandDrivenUpdates() const {
+  return _demandDrivenUpdates;
+}
+
+
+void ApplicationSettings::setDemandDrivenUpdates(bool demandDriven) {
+  _demandDrivenUpdates = demandDriven;
+  _settings.setValue("general/demanddrivenupdates", demandDriven);
+
+  UpdateManager::self()->setDemandDriven(demandDriven);
+}
+
+
 bool ApplicationSettings::showGrid() const {
   return _showGrid;
 }
@@ -203,6 +218,17 @@ void ApplicationSettings::setAntialiasPlots(bool antialias) {
 }
 
 
+bool ApplicationSettings::sessionDataFile() const {
+  return _sessionDataFile;
+}
+
+
+void ApplicationSettings::setSessionDataFile(bool sessionDataFile) {
+  _sessionDataFile = sessionDataFile;
+  _settings.setValue("general/sessiondatafile", sessionDataFile);
+}
+
+
 bool ApplicationSettings::snapToGrid() const {
   return _snapToGrid;
 }
@@ -50,6 +50,9 @@ class ApplicationSettings : public QObject
     int minimumUpdatePeriod() const;
     void setMinimumUpdatePeriod(const int period);
 
+    bool demandDrivenUpdates() const;
+    void setDemandDrivenUpdates(bool demandDriven);
+
     bool showGrid() const;
     void setShowGrid(bool showGrid);
 
@@ -73,6 +76,10 @@ class ApplicationSettings : public QObject
     bool antialiasPlots() const;
     void setAntialiasPlots(bool antialias);
 
+    // save large embedded arrays to a binary file next to the session
+    bool sessionDataFile() const;
+    void setSessionDataFile(bool sessionDataFile);
+
   Q_SIGNALS:
     void modified();
 
@@ -89,6 +96,7 @@ class ApplicationSettings : public QObject
     qreal _refViewHeight;
     qreal _minFontSize;
     int _maxUpdate;
+    bool _demandDrivenUpdates;
     bool _showGrid;
     bool _snapToGrid;
     qreal _gridHorSpacing;
@@ -98,6 +106,7 @@ class ApplicationSettings : public QObject
     QSizeF _layoutMargins;
     QSizeF _layoutSpacing;
     bool _antialiasPlots;
+    bool _sessionDataFile;
 
     friend class ApplicationSettingsDialog;
 };
@@ -76,7 +76,9 @@ void ApplicationSettingsDialog::setupGeneral() {
   _generalTab->setUseOpenGL(ApplicationSettings::self()->useOpenGL());
   _generalTab->setTransparentDrag(ApplicationSettings::self()->transparentDrag());
   _generalTab->setMinimumUpdatePeriod(ApplicationSettings::self()->minimumUpdatePeriod());
+  _generalTab->setDemandDrivenUpdates(ApplicationSettings::self()->demandDrivenUpdates());
   _generalTab->setAntialiasPlot(ApplicationSettings::self()->antialiasPlots());
+  _generalTab->setSessionDataFile(ApplicationSettings::self()->sessionDataFile());
 }
 
 
@@ -109,7 +111,9 @@ void ApplicationSettingsDialog::generalChanged() {
   ApplicationSettings::self()->setTransparentDrag(_generalTab->transparentDrag());
   ApplicationSettings::self()->setUseOpenGL(_generalTab->useOpenGL());
   ApplicationSettings::self()->setMinimumUpdatePeriod(_generalTab->minimumUpdatePeriod());
+  ApplicationSettings::self()->setDemandDrivenUpdates(_generalTab->demandDrivenUpdates());
   ApplicationSettings::self()->setAntialiasPlots(_generalTab->antialiasPlot());
+  ApplicationSettings::self()->setSessionDataFile(_generalTab->sessionDataFile());
   ApplicationSettings::self()->blockSignals(false);
 
   emit ApplicationSettings::self()->modified();
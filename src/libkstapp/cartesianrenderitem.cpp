@@ -18,6 +18,7 @@
 
 #include "plotitem.h"
 #include "applicationsettings.h"
+#include "curve.h"
 
 namespace Kst {
 
@@ -40,49 +41,11 @@ void CartesianRenderItem::paintRelations(QPainter *painter) {
   painter->save();
   painter->translate(normalRect.x(), normalRect.y());
 
-  foreach (RelationPtr relation, relationList()) {
-
-    CurveRenderContext context;
-    context.painter = painter;
-    context.window = QRect(); //no idea if this should be floating point
-    context.penWidth = painter->pen().width(); //floating point??
-    context.xLog = plotItem()->xAxis()->axisLog();
-    context.yLog = plotItem()->yAxis()->axisLog();
-    context.xLogBase = 10.0;
-    context.yLogBase = 10.0;
-    context.foregroundColor = painter->pen().color();
-    context.backgroundColor = painter->brush().color();
-
-    //Set the projection box...
-    context.XMin = projectionRect().left();
-    context.XMax = projectionRect().right();
-    context.YMin = projectionRect().top();
-    context.YMax = projectionRect().bottom();
-
-    //Set the log box...
-    context.x_max = plotItem()->xAxis()->axisLog() ? logXHi(context.XMax, context.xLogBase) : context.XMax;
-    context.y_max = plotItem()->yAxis()->axisLog() ? logXHi(context.YMax, context.yLogBase) : context.YMax;
-    context.x_min = plotItem()->xAxis()->axisLog() ? logXLo(context.XMin, context.xLogBase) : context.XMin;
-    context.y_min = plotItem()->yAxis()->axisLog() ? logXLo(context.YMin, context.yLogBase) : context.YMin;
-
-    //These are the bounding box in regular QGV coord
-    context.Lx = plotRect().left();
-    context.Hx = plotRect().right();
-    context.Ly = plotRect().top();
-    context.Hy = plotRect().bottom();
-
-    //To convert between the last two...
-    double m_X = double(plotRect().width())/(context.x_max - context.x_min);
-    double m_Y = -double(plotRect().height())/(context.y_max - context.y_min);
-    double b_X = context.Lx - m_X * context.x_min;
-    double b_Y = context.Ly - m_Y * context.y_max;
-
-    context.m_X = m_X;
-    context.m_Y = m_Y;
-    context.b_X = b_X;
-    context.b_Y = b_Y;
-    context.antialias = ApplicationSettings::self()->antialiasPlots();
+  CurveRenderContext context = renderContext(painter->window(), painter->pen().width(),
+                                             painter->pen().color(), painter->brush().color());
+  context.painter = painter;
 
+  foreach (RelationPtr relation, relationList()) {
     relation->paint(context);
   }
 
@@ -90,6 +53,67 @@ void CartesianRenderItem::paintRelations(QPainter *painter) {
 }
 
 
+void CartesianRenderItem::addPaintContexts(const QRect& window, QList<Relation*>& relations, QList<CurveRenderContext>& contexts) {
+  if (!rect().isValid()) {
+    return;
+  }
+
+  // the pen paint() will be given: see ViewItem::paint()
+  const int penWidth = int(Curve::lineDim(window, storedPen().widthF()));
+  const CurveRenderContext context = renderContext(window, penWidth, storedPen().color(), brush().color());
+  foreach (RelationPtr relation, relationList()) {
+    relations << relation.data();
+    contexts << context;
+  }
+}
+
+
+CurveRenderContext CartesianRenderItem::renderContext(const QRect& window, int penWidth,
+                                                      const QColor& foreground, const QColor& background) const {
+  CurveRenderContext context;
+  context.window = window;
+  context.penWidth = penWidth;
+  context.xLog = plotItem()->xAxis()->axisLog();
+  context.yLog = plotItem()->yAxis()->axisLog();
+  context.xLogBase = 10.0;
+  context.yLogBase = 10.0;
+  context.foregroundColor = foreground;
+  context.backgroundColor = background;
+
+  //Set the projection box...
+  context.XMin = projectionRect().left();
+  context.XMax = projectionRect().right();
+  context.YMin = projectionRect().top();
+  context.YMax = projectionRect().bottom();
+
+  //Set the log box...
+  context.x_max = plotItem()->xAxis()->axisLog() ? logXHi(context.XMax, context.xLogBase) : context.XMax;
+  context.y_max = plotItem()->yAxis()->axisLog() ? logXHi(context.YMax, context.yLogBase) : context.YMax;
+  context.x_min = plotItem()->xAxis()->axisLog() ? logXLo(context.XMin, context.xLogBase) : context.XMin;
+  context.y_min = plotItem()->yAxis()->axisLog() ? logXLo(context.YMin, context.yLogBase) : context.YMin;
+
+  //These are the bounding box in regular QGV coord
+  context.Lx = plotRect().left();
+  context.Hx = plotRect().right();
+  context.Ly = plotRect().top();
+  context.Hy = plotRect().bottom();
+
+  //To convert between the last two...
+  double m_X = double(plotRect().width())/(context.x_max - context.x_min);
+  double m_Y = -double(plotRect().height())/(context.y_max - context.y_min);
+  double b_X = context.Lx - m_X * context.x_min;
+  double b_Y = context.Ly - m_Y * context.y_max;
+
+  context.m_X = m_X;
+  context.m_Y = m_Y;
+  context.b_X = b_X;
+  context.b_Y = b_Y;
+  context.antialias = ApplicationSettings::self()->antialiasPlots();
+
+  return context;
+}
+
+
 void CartesianRenderItem::saveInPlot(QXmlStreamWriter &xml) {
   xml.writeStartElement("cartesianrender");
   PlotRenderItem::saveInPlot(xml);
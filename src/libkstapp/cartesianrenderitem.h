@@ -25,10 +25,15 @@ class CartesianRenderItem : public PlotRenderItem
 
     virtual void saveInPlot(QXmlStreamWriter &xml);
     virtual void paintRelations(QPainter *painter);
+    virtual void addPaintContexts(const QRect& window, QList<Relation*>& relations, QList<CurveRenderContext>& contexts);
 
     bool configureFromXml(QXmlStreamReader &xml, ObjectStore *store);
     const QString defaultsGroupName() const {return QString("plot");}
     virtual bool dataPosLockable() const {return false;}
+
+  private:
+    CurveRenderContext renderContext(const QRect& window, int penWidth,
+                                     const QColor& foreground, const QColor& background) const;
 };
 
 }
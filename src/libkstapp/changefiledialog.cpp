@@ -38,6 +38,39 @@
 
 namespace Kst {
 
+// Record the slaves (statistics, strings, a matrix's z vector) of copy as
+// the duplicates of those of original, matching them by key.  Only the
+// statistics something refers to exist as scalars, so the same ones are
+// created for copy first.
+static void addDuplicatedSlaves(PrimitivePtr original, PrimitivePtr copy,
+                                PrimitiveList &duplicatedList, QMap<PrimitivePtr, PrimitivePtr> &duplicatedMap) {
+  if (VectorPtr vector = kst_cast<Vector>(original)) {
+    if (VectorPtr vectorCopy = kst_cast<Vector>(copy)) {
+      foreach (const QString &key, vector->scalars().keys()) {
+        vectorCopy->scalar(key);
+      }
+    }
+  } else if (MatrixPtr matrix = kst_cast<Matrix>(original)) {
+    if (MatrixPtr matrixCopy = kst_cast<Matrix>(copy)) {
+      foreach (const QString &key, matrix->scalars().keys()) {
+        matrixCopy->scalar(key);
+      }
+    }
+  }
+
+  const PrimitiveMap copySlaves = copy->metas();
+  const PrimitiveMap slaves = original->metas();
+  for (PrimitiveMap::ConstIterator it = slaves.begin(); it != slaves.end(); ++it) {
+    PrimitivePtr slaveCopy = copySlaves.value(it.key());
+    if (slaveCopy) {
+      duplicatedList.append(it.value());
+      duplicatedMap[it.value()] = slaveCopy;
+      addDuplicatedSlaves(it.value(), slaveCopy, duplicatedList, duplicatedMap);
+    }
+  }
+}
+
+
 ChangeFileDialog::ChangeFileDialog(QWidget *parent)
   : QDialog(parent), _dataSource(0), _requestID(0) {
    setupUi(this);
@@ -340,16 +373,8 @@ void ChangeFileDialog::apply() {
           newPrim->unlock();
           duplicatedPrimitiveMap[prim] = newPrim;
           duplicatedPrimitiveList.append(prim);
-          PrimitiveList output_prims = prim->outputPrimitives();
-          PrimitiveList dup_output_prims = newPrim->outputPrimitives();
           // add output primitives to list of primitives that have been duplicated.
-          int n = qMin(output_prims.count(), dup_output_prims.count());
-          for (int i_output=0; i_output<n; i_output++) {
-            if (output_prims.at(i_output)->descriptiveName() == dup_output_prims.at(i_output)->descriptiveName()) {
-              duplicatedPrimitiveList.append(output_prims.at(i_output));
-              duplicatedPrimitiveMap[output_prims.at(i_output)] = dup_output_prims.at(i_output);
-            }
-          }
+          addDuplicatedSlaves(prim, newPrim, duplicatedPrimitiveList, duplicatedPrimitiveMap);
         } else {
           prim->readLock();
           if (!oldSources.contains(dp->dataSource())) {
@@ -394,12 +419,14 @@ void ChangeFileDialog::apply() {
             duplicate_object = dataObjects.at(i_OB)->makeDuplicate();
 
             // put the outputs of the new data object into the list of duplicated primitives.
-            PrimitiveList dup_output_prims = duplicate_object->outputPrimitives();
-            PrimitiveList output_prims = dataObjects.at(i_OB)->outputPrimitives();
-            int n = output_prims.count();
+            PrimitiveList dup_output_prims = duplicate_object->outputPrimitives(false);
+            PrimitiveList output_prims = dataObjects.at(i_OB)->outputPrimitives(false);
+            int n = qMin(output_prims.count(), dup_output_prims.count());
             for (int i_output=0; i_output<n; i_output++) {
               duplicatedPrimitiveList.append(output_prims.at(i_output));
               duplicatedPrimitiveMap[output_prims.at(i_output)] = dup_output_prims.at(i_output);
+              addDuplicatedSlaves(output_prims.at(i_output), dup_output_prims.at(i_output),
+                                  duplicatedPrimitiveList, duplicatedPrimitiveMap);
             }
 
             duplicatedDataObjects[dataObjects.at(i_OB)] = duplicate_object;
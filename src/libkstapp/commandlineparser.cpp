@@ -64,6 +64,8 @@ namespace Kst {
 "      --Letter                 Print to Letter sized paper.\n"
 "      --A4                     Print to A4 sized paper.\n"
 "      --png <filename>         Render to a png image, and exit.\n"
+"      --render-server          Run without a window, rendering tabs to files\n"
+"                               for scripts (pykst Client.renderTab).\n"
 "File Options:\n"
 "      -f <startframe>          default: 'end' counts from end.\n"
 "      -n <numframes>           default: 'end' reads to end of file\n"
@@ -118,6 +120,9 @@ namespace Kst {
 "Get the X vector from data1.dat, and the Y vector from data2.dat.\n"
 "       kst data1.dat -x 1 data2.dat -y 1\n"
 "\n"
+"Plot col 2 of what a program writes to standard output, as it arrives.\n"
+"       producer | kst - -y 2\n"
+"\n"
 "Placement:\n"
 "Plot column 2 and column 3 in plot P1 and column 4 in plot P2\n"
 "       kst data.dat -P P1 -y 2 -y 3 -P P2 -y 4\n";
@@ -498,7 +503,7 @@ bool CommandLineParser::processCommandLine(bool *ok) {
       for (int i_file=0; i_file<_fileNames.size(); i_file++) { 
         QString file = _fileNames.at(i_file);
         QFileInfo info(file);
-        if (!info.exists()) {
+        if (!info.exists() && file != "-" && file != "stdin") {
           printUsage(i18n("file %1 does not exist\n").arg(file));
           *ok = false;
           break;
@@ -541,7 +546,7 @@ bool CommandLineParser::processCommandLine(bool *ok) {
         for (int i_file=0; i_file<_fileNames.size(); i_file++) {
           QString file = _fileNames.at(i_file);
           QFileInfo info(file);
-          if (!info.exists()) {
+          if (!info.exists() && file != "-" && file != "stdin") {
             printUsage(i18n("file %1 does not exist\n").arg(file));
             *ok = false;
             break;
@@ -655,6 +660,8 @@ bool CommandLineParser::processCommandLine(bool *ok) {
       *ok = _setStringArg(_document->objectStore()->override.fileName, i18n("Usage: -F <datafile>\n"));
     } else if (arg == "--png") {
       *ok = _setStringArg(_pngFile, i18n("Usage: --png <filename>\n"));
+    } else if (arg == "--render-server") {
+      // handled before the application starts
 #ifndef KST_NO_PRINTER
     } else if (arg == "--print") {
       *ok = _setStringArg(_printFile, i18n("Usage: --print <filename>\n"));
@@ -19,6 +19,7 @@
 #include "objectstore.h"
 #include "datasourcepluginmanager.h"
 #include "baddatasourcedialog.h"
+#include "document.h"
 
 #include <QObject>
 
@@ -76,15 +77,25 @@ DataSourcePtr DataSourcePluginFactory::generateDataSource(ObjectStore *store, QX
   DataSourcePtr dataSource = 0L;
   QString alternate_filename = fileName;
   do {
-    dataSource = 0L;
-    dataSource = DataSourcePluginManager::loadSource(store, fileName, fileType);
+    // made, with its properties, while the session was preloaded
+    dataSource = DataSourcePluginManager::loadPreloadedSource(store, fileName, fileType, propertyAttributes);
+    const bool preloaded = dataSource;
+    if (!preloaded) {
+      dataSource = DataSourcePluginManager::loadSource(store, fileName, fileType);
+    }
     if (dataSource) {
       QObject::connect(dataSource, SIGNAL(progress(int, QString)), kstApp->mainWindow(), SLOT(updateProgress(int, QString)));
-      dataSource->parseProperties(propertyAttributes);
+      if (!preloaded) {
+        dataSource->parseProperties(propertyAttributes);
+      }
       if (fileName != alternate_filename) {
         dataSource->setAlternateFilename(alternate_filename);
       }
       return dataSource;
+    } else if (kstApp->mainWindow()->isRenderServer()) {
+      // nobody could answer the dialog
+      kstApp->mainWindow()->document()->addLoadError(QObject::tr("The data source %1 could not be loaded.").arg(fileName));
+      return NULL;
     } else {
       alternate_filename = fileName;
       BadDatasourceDialog dialog(&fileName, store);
@@ -22,7 +22,11 @@
 #include <relationfactory.h>
 #include <viewitem.h>
 #include <commandlineparser.h>
+#include "applicationsettings.h"
+#include "dataprimitive.h"
+#include "datasourcepluginmanager.h"
 #include "objectstore.h"
+#include "sessiondata.h"
 #include "updatemanager.h"
 #include "updateserver.h"
 
@@ -125,12 +129,23 @@ bool Document::save(const QString& to) {
 
   _fileName = file;
 
+  // large embedded arrays go to a binary file next to the session
+  SessionData sessionData;
+  const bool sidecar = ApplicationSettings::self()->sessionDataFile();
+  if (sidecar) {
+    sessionData.beginWrite(file);
+    objectStore()->sessionData = &sessionData;
+  }
+
   QXmlStreamWriter xml;
   xml.setDevice(&f);
   xml.setAutoFormatting(true);
   xml.writeStartDocument();
   xml.writeStartElement("kst");
   xml.writeAttribute("version", "2.0");
+  if (sidecar) {
+    sessionData.writeAttributes(xml);
+  }
 
   xml.writeStartElement("data");
   foreach (DataSourcePtr s, objectStore()->dataSourceList()) {
@@ -182,6 +197,12 @@ bool Document::save(const QString& to) {
 
   xml.writeEndDocument();
 
+  objectStore()->sessionData = 0L;
+  if (sidecar && !sessionData.finishWrite()) {
+    _lastError = QObject::tr("The data file %1 could not be written.").arg(SessionData::fileNameFor(file));
+    return false;
+  }
+
   setChanged(false);
   _isOpen = true; // Set _isOpen when saving into a new file so that kst does not ask for the filename again
   return true;
@@ -224,11 +245,46 @@ bool Document::initFromCommandLine(CommandLineParser *P) {
 
 
 #define malformed() \
+  objectStore()->sessionData = 0L; \
+  DataSourcePluginManager::clearPreloadedSources(); \
   return false;
 
 
+// Reads the data sources declared in the <data> section of a session and has
+// their plugins found, and those of thread safe plugins made, in parallel,
+// so that the main pass only makes the others, one by one in order.
+static void preloadDataSources(QIODevice *device, ObjectStore *store) {
+  QStringList files, types;
+  QList<QXmlStreamAttributes> properties;
+
+  QXmlStreamReader xml(device);
+  while (!xml.atEnd()) {
+    xml.readNext();
+    if (xml.isStartElement()) {
+      const QStringRef n = xml.name();
+      if (n == DataSource::staticTypeTag) {
+        const QXmlStreamAttributes attrs = xml.attributes();
+        files << (store->override.fileName.isEmpty() ? DataPrimitive::readFilename(attrs) : store->override.fileName);
+        types << attrs.value("reader").toString();
+        properties << QXmlStreamAttributes();
+      } else if (n == "properties" && !properties.isEmpty()) {
+        properties.last() = xml.attributes();
+      } else if (n == "variables" || n == "objects" || n == "relations" || n == "graphics") {
+        break;
+      }
+    } else if (xml.isEndElement() && xml.name() == "data") {
+      break;
+    }
+  }
+
+  device->seek(0);
+  DataSourcePluginManager::preloadSources(store, files, types, properties);
+}
+
+
 bool Document::open(const QString& file) {
   _isOpen = false;
+  _loadErrors.clear();
   QFile f(file);
   if (!f.open(QIODevice::ReadOnly)) {
     _lastError = QObject::tr("File could not be opened for reading.");
@@ -250,6 +306,10 @@ bool Document::open(const QString& file) {
   QXmlStreamReader xml;
   xml.setDevice(&f);
 
+  SessionData sessionData;
+
+  preloadDataSources(&f, objectStore());
+
   enum State { Unknown=0, Data, Variables, Objects, Relations, Graphics, View };
   State state = Unknown;
 
@@ -257,6 +317,9 @@ bool Document::open(const QString& file) {
     if (xml.isStartElement()) {
       QString n = xml.name().toString();
       if (n == "kst") {
+        // even without its sidecar, so that arrays in it are load errors
+        sessionData.beginRead(file, xml.attributes());
+        objectStore()->sessionData = &sessionData;
       } else if (n == "data") {
         if (state != Unknown) {
           malformed();
@@ -396,6 +459,13 @@ bool Document::open(const QString& file) {
     xml.readNext();
   }
 
+  objectStore()->sessionData = 0L;
+  sessionData.finishRead();
+  DataSourcePluginManager::clearPreloadedSources();
+  foreach (const QString &error, sessionData.errors()) {
+    addLoadError(error);
+  }
+
   if (xml.hasError()) {
     _lastError = QObject::tr("File is malformed and encountered an error while reading.");
     return false;
@@ -419,6 +489,10 @@ bool Document::open(const QString& file) {
   // Restore current app path
   QDir::setCurrent(restorePath);
 
+  if (!_loadErrors.isEmpty()) {
+    _lastError = _loadErrors.join("\n");
+    return false;
+  }
 
   UpdateServer::self()->requestUpdateSignal();
 
@@ -438,6 +512,11 @@ QString Document::lastError() const {
 }
 
 
+void Document::addLoadError(const QString& error) {
+  _loadErrors.append(error);
+}
+
+
 bool Document::isChanged() const {
   return _dirty;
 }
@@ -15,6 +15,7 @@
 
 #include <QPointer>
 #include <QString>
+#include <QStringList>
 
 #include "coredocument.h"
 #include "dataobject.h"
@@ -49,6 +50,11 @@ class Document : public CoreDocument {
 
     QString lastError() const;
 
+    /** Makes open() fail, with error as its lastError(), once it is done:
+        for what can't be asked about, like a missing data file in a render
+        server. */
+    void addLoadError(const QString& error);
+
     void createView();
 
     View *currentView() const;
@@ -62,6 +68,7 @@ class Document : public CoreDocument {
     bool _isOpen;
     QString _fileName;
     QString _lastError;
+    QStringList _loadErrors;
 };
 
 }
@@ -39,6 +39,7 @@ EventMonitorTab::EventMonitorTab(QWidget *parent)
   connect(_emailNotify, SIGNAL(toggled(const bool&)), this, SIGNAL(modified()));
   connect(_ELOGNotify, SIGNAL(toggled(const bool&)), this, SIGNAL(modified()));
   connect(_executeScript, SIGNAL(toggled(const bool&)), this, SIGNAL(modified()));
+  connect(_sparse, SIGNAL(toggled(const bool&)), this, SIGNAL(modified()));
 
   connect(_equation, SIGNAL(textChanged(const QString&)), this, SIGNAL(modified()));
   connect(_description, SIGNAL(textChanged(const QString&)), this, SIGNAL(modified()));
@@ -224,6 +225,21 @@ void EventMonitorTab::setLogELOG(const bool logELOG) {
 }
 
 
+bool EventMonitorTab::sparse() const {
+  return _sparse->isChecked();
+}
+
+
+bool EventMonitorTab::sparseDirty() const {
+  return _sparse->checkState() != Qt::PartiallyChecked;
+}
+
+
+void EventMonitorTab::setSparse(const bool sparse) {
+  return _sparse->setChecked(sparse);
+}
+
+
 void EventMonitorTab::setObjectStore(ObjectStore *store) {
   _vectorSelector->setObjectStore(store);
   _scalarSelector->setObjectStore(store);
@@ -239,6 +255,7 @@ void EventMonitorTab::clearTabValues() {
   _ELOGNotify->setCheckState(Qt::PartiallyChecked);
   _emailNotify->setCheckState(Qt::PartiallyChecked);
   _debugLog->setCheckState(Qt::PartiallyChecked);
+  _sparse->setCheckState(Qt::PartiallyChecked);
   resetLogLevelDirty();
 }
 
@@ -296,6 +313,7 @@ void EventMonitorDialog::configureTab(ObjectPtr object) {
     _eventMonitorTab->setLogEMail(eventMonitorEntry->logEMail());
     _eventMonitorTab->setLogELOG(eventMonitorEntry->logELOG());
     _eventMonitorTab->setEmailRecipients(eventMonitorEntry->eMailRecipients());
+    _eventMonitorTab->setSparse(eventMonitorEntry->sparse());
     if (_editMultipleWidget) {
       EventMonitorEntryList objects = _document->objectStore()->getObjects<EventMonitorEntry>();
       _editMultipleWidget->clearObjects();
@@ -324,6 +342,7 @@ ObjectPtr EventMonitorDialog::createNewDataObject() {
   eventMonitor->setLogEMail(_eventMonitorTab->logEMail());
   eventMonitor->setLogELOG(_eventMonitorTab->logELOG());
   eventMonitor->setEMailRecipients(_eventMonitorTab->emailRecipients());
+  eventMonitor->setSparse(_eventMonitorTab->sparse());
 
   eventMonitor->reparse();
 
@@ -350,6 +369,7 @@ ObjectPtr EventMonitorDialog::editExistingDataObject() const {
           const bool logDebug = _eventMonitorTab->logDebugDirty() ?  _eventMonitorTab->logDebug() : eventMonitor->logDebug();
           const bool logEMail = _eventMonitorTab->logEMailDirty() ?  _eventMonitorTab->logEMail() : eventMonitor->logEMail();
           const bool logELOG = _eventMonitorTab->logELOGDirty() ?  _eventMonitorTab->logELOG() : eventMonitor->logELOG();
+          const bool sparse = _eventMonitorTab->sparseDirty() ?  _eventMonitorTab->sparse() : eventMonitor->sparse();
 
           eventMonitor->writeLock();
           eventMonitor->setScriptCode(script);
@@ -360,6 +380,7 @@ ObjectPtr EventMonitorDialog::editExistingDataObject() const {
           eventMonitor->setLogEMail(logEMail);
           eventMonitor->setLogELOG(logELOG);
           eventMonitor->setEMailRecipients(emailRecipients);
+          eventMonitor->setSparse(sparse);
 
           eventMonitor->reparse();
           eventMonitor->registerChange();
@@ -376,6 +397,7 @@ ObjectPtr EventMonitorDialog::editExistingDataObject() const {
       eventMonitor->setLogEMail(_eventMonitorTab->logEMail());
       eventMonitor->setLogELOG(_eventMonitorTab->logELOG());
       eventMonitor->setEMailRecipients(_eventMonitorTab->emailRecipients());
+      eventMonitor->setSparse(_eventMonitorTab->sparse());
 
       eventMonitor->reparse();
 
@@ -64,6 +64,10 @@ class EventMonitorTab : public DataTab, Ui::EventMonitorTab {
     bool emailRecipientsDirty() const;
     void setEmailRecipients(const QString emailRecipients);
 
+    bool sparse() const;
+    bool sparseDirty() const;
+    void setSparse(const bool sparse);
+
     void clearTabValues();
     void resetLogLevelDirty();
 
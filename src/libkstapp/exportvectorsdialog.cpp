@@ -18,6 +18,9 @@
 #include "objectstore.h"
 #include "mainwindow.h"
 #include "document.h"
+#include "vectorexport.h"
+#include "debug.h"
+#include "updatemanager.h"
 
 #include <QLineEdit>
 
@@ -32,6 +35,7 @@ ExportVectorsDialog::ExportVectorsDialog(QWidget *parent) :
 
      _saveLocationLabel->setBuddy(_saveLocation->_fileEdit);
      _saveLocation->setFile(dialogDefaults().value("vectorexport/filename",QDir::currentPath()).toString());
+     _format->setCurrentIndex(dialogDefaults().value("vectorexport/format", 0).toInt());
 
     if (MainWindow *mw = qobject_cast<MainWindow*>(parent)) {
       _store = mw->document()->objectStore();
@@ -58,6 +62,7 @@ ExportVectorsDialog::ExportVectorsDialog(QWidget *parent) :
 
 ExportVectorsDialog::~ExportVectorsDialog()
 {
+  delete _export;
 }
 
 void ExportVectorsDialog::show() {
@@ -183,7 +188,7 @@ void ExportVectorsDialog::removeAll() {
 }
 
 void ExportVectorsDialog::updateButtons() {
-  bool valid = _selectedVectorList->count();
+  bool valid = _selectedVectorList->count() && !_export;
 
   QFileInfo qfi(_saveLocation->file());
 
@@ -209,51 +214,53 @@ void ExportVectorsDialog::OKClicked() {
 
 
 bool ExportVectorsDialog::apply() {
-  QFile file(_saveLocation->file());
-  VectorList vectors;
-  QList<int> lengths;
-
-  if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+  if (_export) {
     return false;
+  }
 
-  QTextStream out(&file);
-
-  out << "#";
+  VectorExport *exporter = new VectorExport(_saveLocation->file(), VectorExport::Format(_format->currentIndex()));
   int count = _selectedVectorList->count();
   for (int i = 0; i<count; i++) {
     VectorPtr V = kst_cast<Vector>(_store->retrieveObject(_selectedVectorList->item(i)->text()));
     if (V) {
-      vectors.append(V);
-      out << " " << V->descriptiveName();
-      lengths << V->length();
+      // nothing may have wanted it since the last update
+      UpdateManager::self()->bringUpToDate(V);
+      exporter->addVector(V);
     }
   }
 
-  out << "\n";
-
-  int maxLength = 0;
-  for (int i=0; i<lengths.size(); i++) {
-    if (lengths.at(i)>maxLength) {
-      maxLength = lengths.at(i);
-    }
+  if (MainWindow *mw = qobject_cast<MainWindow*>(parent())) {
+    connect(exporter, SIGNAL(progress(int, QString)), mw, SLOT(updateProgress(int, QString)));
   }
+  connect(exporter, SIGNAL(finished()), this, SLOT(exportFinished()));
+  _export = exporter;
+  _export->start();
+  updateButtons();
 
-  out.setRealNumberPrecision(14);
+  dialogDefaults().setValue("vectorexport/filename", _saveLocation->file());
+  dialogDefaults().setValue("vectorexport/format", _format->currentIndex());
 
-  int ncols = vectors.size();
-  for (int row = 0; row < maxLength; row++) {
-    for (int col = 0; col < ncols; col++) {
-      out << " " << vectors.at(col)->interpolate(row, maxLength);
+  return(true);
+}
+
+
+void ExportVectorsDialog::exportFinished() {
+  if (_export) {
+    if (!_export->succeeded() && !_export->isCancelled()) {
+      Debug::self()->log(_export->errorString(), Debug::Warning);
     }
-    out << "\n";
+    _export->deleteLater();
+    _export = 0L;
   }
+  updateButtons();
+}
 
-  out.flush();
-
-  file.close();
-  dialogDefaults().setValue("vectorexport/filename", _saveLocation->file());
 
-  return(true);
+void ExportVectorsDialog::reject() {
+  if (_export) {
+    _export->cancel();
+  }
+  QDialog::reject();
 }
 
 }
@@ -15,12 +15,14 @@
 #define EXPORTVECTORSDIALOG_H
 
 #include <QDialog>
+#include <QPointer>
 
 #include "ui_exportvectorsdialog.h"
 
 namespace Kst {
 
 class ObjectStore;
+class VectorExport;
 
 class ExportVectorsDialog : public QDialog, Ui::ExportVectorsDialog
 {
@@ -32,7 +34,9 @@ public:
 
     void show();
 
-
+public Q_SLOTS:
+    /** Cancels the export if one is running */
+    void reject();
 
 private Q_SLOTS:
     void addButtonClicked();
@@ -44,6 +48,7 @@ private Q_SLOTS:
     void updateButtons();
     void OKClicked();
     bool apply();
+    void exportFinished();
 
 
 private:
@@ -52,6 +57,7 @@ private:
     void updateVectorList();
 
     ObjectStore *_store;
+    QPointer<VectorExport> _export;
 
 };
 
@@ -25,6 +25,8 @@ GeneralTab::GeneralTab(QWidget *parent)
   connect(_maxUpdate, SIGNAL(valueChanged(int)), this, SIGNAL(modified()));
   connect(_transparentDrag, SIGNAL(stateChanged(int)), this, SIGNAL(modified()));
   connect(_antialiasPlots, SIGNAL(stateChanged(int)), this, SIGNAL(modified()));
+  connect(_demandDriven, SIGNAL(stateChanged(int)), this, SIGNAL(modified()));
+  connect(_sessionDataFile, SIGNAL(stateChanged(int)), this, SIGNAL(modified()));
 }
 
 
@@ -73,6 +75,26 @@ void GeneralTab::setMinimumUpdatePeriod(const int period) {
   _maxUpdate->setValue(period);
 }
 
+
+bool GeneralTab::demandDrivenUpdates() const {
+  return _demandDriven->isChecked();
+}
+
+
+void GeneralTab::setDemandDrivenUpdates(bool demandDriven) {
+  _demandDriven->setChecked(demandDriven);
+}
+
+
+bool GeneralTab::sessionDataFile() const {
+  return _sessionDataFile->isChecked();
+}
+
+
+void GeneralTab::setSessionDataFile(bool sessionDataFile) {
+  _sessionDataFile->setChecked(sessionDataFile);
+}
+
 }
 
 // vim: ts=2 sw=2 et
@@ -38,6 +38,12 @@ class GeneralTab : public DialogTab, Ui::GeneralTab {
     int minimumUpdatePeriod() const;
     void setMinimumUpdatePeriod(const int Period);
 
+    bool demandDrivenUpdates() const;
+    void setDemandDrivenUpdates(bool demandDriven);
+
+    bool sessionDataFile() const;
+    void setSessionDataFile(bool sessionDataFile);
+
 };
 
 }
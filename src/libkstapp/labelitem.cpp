@@ -18,6 +18,7 @@
 #include "labelcreator.h"
 
 #include "applicationsettings.h"
+#include "updateserver.h"
 
 #include "debug.h"
 #include "dialogdefaults.h"
@@ -32,19 +33,26 @@
 namespace Kst {
 
 LabelItem::LabelItem(View *parent, const QString& txt)
-  : ViewItem(parent), _labelRc(0), _dirty(true), _text(txt), _height(0), _resized(false),
-    _dataRelativeDimValid(false), _fixleft(false), _serialOfLastChange(0) {
+  : ViewItem(parent), _labelRc(0), _dirty(true), _parsed(0), _layoutFontSize(0), _layoutDpiX(0), _layoutDpiY(0),
+    _text(txt), _height(0), _resized(false), _dataRelativeDimValid(false), _fixleft(false), _serialOfLastChange(0) {
   setTypeName("Label");
   setFixedSize(true);
   setLockAspectRatio(true);
   setAllowedGripModes(Move | Resize | Rotate /*| Scale*/);
 
+  // objects the text names may have been created or deleted
+  connect(UpdateServer::self(), SIGNAL(objectListsChanged()), this, SLOT(clearParsedLabel()));
+
   applyDefaults();
 }
 
 bool LabelItem::inputsChanged(qint64 serial) {
   bool no_change = true;
 
+  if (!_labelRc) {
+    return false;
+  }
+
   foreach (Primitive* primitive, _labelRc->_refObjects) {
     if (primitive->serialOfLastChange() > _serialOfLastChange) {
       no_change = false;
@@ -52,6 +60,7 @@ bool LabelItem::inputsChanged(qint64 serial) {
   }
 
   if (!no_change) {
+    setDirty();
     triggerUpdate();
   }
 
@@ -83,6 +92,15 @@ void LabelItem::saveDialogDefaultsFont(const QFont &F, const QColor &C) {
 
 LabelItem::~LabelItem() {
   delete _labelRc;
+  delete _parsed;
+}
+
+
+void LabelItem::clearParsedLabel() {
+  delete _parsed;
+  _parsed = 0;
+  setDirty();
+  triggerUpdate();
 }
 
 void LabelItem::generateLabel(QPainter *p) {
@@ -90,9 +108,13 @@ void LabelItem::generateLabel(QPainter *p) {
   if (_labelRc) {
     lines = _labelRc->lines;
     delete _labelRc;
+    _labelRc = 0;
   }
 
-  Label::Parsed *parsed = Label::parse(_text);
+  if (!_parsed) {
+    _parsed = Label::parse(_text);
+  }
+  Label::Parsed *parsed = _parsed;
   if (parsed) {
     parsed->chunk->attributes.color = _color;
     _dirty = false;
@@ -105,7 +127,10 @@ void LabelItem::generateLabel(QPainter *p) {
       _scale *= fs_adjust;
       delete tmpRc;
     }
-    font.setPointSizeF(view()->scaledFontSize(_scale, *p->device()));
+    _layoutFontSize = view()->scaledFontSize(_scale, *p->device());
+    _layoutDpiX = p->device()->logicalDpiX();
+    _layoutDpiY = p->device()->logicalDpiY();
+    font.setPointSizeF(_layoutFontSize);
 
     _labelRc = new Label::RenderContext(font, p);
     Label::renderLabel(*_labelRc, parsed->chunk, true, false);
@@ -137,33 +162,44 @@ void LabelItem::generateLabel(QPainter *p) {
         break;
       }
     } else {
-      if (fixLeft()) {
-        setViewRect(QRectF(rect().left(), rect().bottom() - (_labelRc->lines+1) * _height,
-                    _labelRc->xMax, (_labelRc->lines+1) * _height),true);
-      } else {
-        setViewRect(QRectF(rect().right()-_labelRc->xMax, rect().bottom() - (_labelRc->lines+1) * _height,
-                    _labelRc->xMax, (_labelRc->lines+1) * _height),true);
-      }
+      fitRectToLabel();
     }
-    _paintTransform.reset();
-    _paintTransform.translate(rect().x(), rect().y() + _labelRc->fontAscent());
 
     connect(_labelRc, SIGNAL(labelDirty()), this, SLOT(setDirty()));
     connect(_labelRc, SIGNAL(labelDirty()), this, SLOT(triggerUpdate()));
+  }
+}
 
-    delete parsed;
+
+// Keeps the rect the size of the laid out text, anchored at the bottom
+// left or right corner.
+void LabelItem::fitRectToLabel() {
+  if (fixLeft()) {
+    setViewRect(QRectF(rect().left(), rect().bottom() - (_labelRc->lines+1) * _height,
+                _labelRc->xMax, (_labelRc->lines+1) * _height),true);
+  } else {
+    setViewRect(QRectF(rect().right()-_labelRc->xMax, rect().bottom() - (_labelRc->lines+1) * _height,
+                _labelRc->xMax, (_labelRc->lines+1) * _height),true);
   }
 }
 
 
 void LabelItem::paint(QPainter *painter) {
-  // possible optimization: make _dirty actually work to save label
-  // regeneration on 'paint'.  Unlikely to be noticeable though.
-  //if (_dirty || 1) {
-  generateLabel(painter);
-  //}
+  // Only lay the text out again if it, the font or the device changed, or
+  // one of the objects it shows did.
+  QPaintDevice *device = painter->device();
+  if (_dirty || _resized || !_labelRc ||
+      _layoutFontSize != view()->scaledFontSize(_scale, *device) ||
+      _layoutDpiX != device->logicalDpiX() || _layoutDpiY != device->logicalDpiY()) {
+    generateLabel(painter);
+  } else {
+    fitRectToLabel();
+  }
 
   if (_labelRc) {
+    _paintTransform.reset();
+    _paintTransform.translate(rect().x(), rect().y() + _labelRc->fontAscent());
+
     painter->save();
     painter->setTransform(_paintTransform, true);
     Label::paintLabel(*_labelRc, painter);
@@ -198,6 +234,8 @@ QString LabelItem::labelText() {
 
 void LabelItem::setLabelText(const QString &text) {
   _text = text;
+  delete _parsed;
+  _parsed = 0;
   setDirty();
 }
 
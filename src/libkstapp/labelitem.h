@@ -80,11 +80,22 @@ class LabelItem : public ViewItem {
     virtual void creationPolygonChanged(View::CreationEvent event);
     virtual void mouseMoveEvent(QGraphicsSceneMouseEvent *event);
 
+  private Q_SLOTS:
+    void clearParsedLabel();
+
   private:
     void generateLabel(QPainter *p);
+    void fitRectToLabel();
 
     QTransform _paintTransform;
     bool _dirty;
+    // The parsed text, with the objects it refers to resolved.  Kept until
+    // the text or the object lists change.
+    Label::Parsed *_parsed;
+    // What the layout in _labelRc was made for.
+    qreal _layoutFontSize;
+    int _layoutDpiX;
+    int _layoutDpiY;
     QString _text;
     qreal _scale;
     QColor _color;
@@ -35,6 +35,46 @@ const double superscript_raise = 0.44;
 
 namespace Label {
 
+// Looks up the object a scalar or vector chunk names and compiles its
+// equation, once per parsed label.  Objects created later are picked up
+// when the label is parsed again.
+static void resolveChunk(Kst::ObjectStore *store, Label::Chunk *fi) {
+  fi->resolved = true;
+  if (fi->scalar) {
+    if (!fi->text.isEmpty() && fi->text[0] == '=') {
+      const QByteArray eq = fi->text.mid(1).toLatin1();
+      fi->compiled = Equations::compile(store, eq.constData(), eq.length());
+    } else {
+      fi->object = store->retrieveObject(fi->text);
+    }
+  } else if (fi->vector) {
+    fi->object = Kst::kst_cast<Kst::Vector>(store->retrieveObject(fi->text));
+    if (fi->object && !fi->expression.isEmpty()) {
+      const QByteArray eq = fi->expression.toLatin1();
+      fi->compiled = Equations::compile(store, eq.constData(), eq.length());
+    }
+  }
+}
+
+
+// The label has to be redrawn when anything an equation uses changes.
+static void addEquationObjects(RenderContext& rc, Equations::Node *eq) {
+  Kst::VectorMap vectors;
+  Kst::ScalarMap scalars;
+  Kst::StringMap strings;
+  eq->collectObjects(vectors, scalars, strings);
+  foreach (const Kst::VectorPtr &v, vectors) {
+    rc.addObject(v);
+  }
+  foreach (const Kst::ScalarPtr &s, scalars) {
+    rc.addObject(s);
+  }
+  foreach (const Kst::StringPtr &s, strings) {
+    rc.addObject(s);
+  }
+}
+
+
 void renderLabel(RenderContext& rc, Label::Chunk *fi, bool cache, bool draw) {
   // FIXME: RTL support
   int oldSize = rc.size = rc.fontSize();
@@ -105,16 +145,19 @@ void renderLabel(RenderContext& rc, Label::Chunk *fi, bool cache, bool draw) {
       rc.x += rc.fontWidth(txt);
     } else if (fi->scalar) { 
       // do scalar/string/fit substitution
+      if (!fi->resolved) {
+        resolveChunk(store, fi);
+      }
       QString txt;
       if (!fi->text.isEmpty() && fi->text[0] == '=') {
-        // Parse and evaluate as an equation
-        bool ok = false;
-        const QString s = fi->text.mid(1);
-        const double eqResult(Equations::interpret(store, s.toLatin1(), &ok, s.length()));
+        // Evaluate as an equation
+        const double eqResult(fi->compiled ? Equations::evaluate(fi->compiled) : 0.0);
         txt = QString::number(eqResult, 'g', rc.precision);
+        if (cache && fi->compiled) {
+          addEquationObjects(rc, fi->compiled);
+        }
       } else {
-        Kst::ObjectPtr op = store->retrieveObject(fi->text);
-        Kst::ScalarPtr scp = Kst::kst_cast<Kst::Scalar>(op);
+        Kst::ScalarPtr scp = Kst::kst_cast<Kst::Scalar>(fi->object);
         if (scp) {
           KstReadLocker l(scp);
           txt = QString::number(scp->value(), 'g', rc.precision);
@@ -122,7 +165,7 @@ void renderLabel(RenderContext& rc, Label::Chunk *fi, bool cache, bool draw) {
             rc.addObject(scp);
           }
         } else {
-          Kst::StringPtr stp = Kst::kst_cast<Kst::String>(op);
+          Kst::StringPtr stp = Kst::kst_cast<Kst::String>(fi->object);
           if (stp) {
             KstReadLocker l(stp);
             txt = stp->value();
@@ -140,24 +183,24 @@ void renderLabel(RenderContext& rc, Label::Chunk *fi, bool cache, bool draw) {
       }
       rc.x += rc.fontWidth(txt);
     } else if (fi->vector) {
+      if (!fi->resolved) {
+        resolveChunk(store, fi);
+      }
       QString txt;
-      Kst::VectorPtr vp = Kst::kst_cast<Kst::Vector>(store->retrieveObject(fi->text));
+      Kst::VectorPtr vp = Kst::kst_cast<Kst::Vector>(fi->object);
       if (vp) {
         if (!fi->expression.isEmpty()) {
           if (cache) {
             rc.addObject(vp);
           }
-          // Parse and evaluate as an equation
-          bool ok = false;
-          // FIXME: make more efficient: cache the parsed equation
-          const double idx = Equations::interpret(store, fi->expression.toLatin1(), &ok, fi->expression.length());
-          if (ok) {
-            KstReadLocker l(vp);
-            const double vVal(vp->value()[int(idx)]);
-            txt = QString::number(vVal, 'g', rc.precision);
+          if (fi->compiled) {
+            const double idx = Equations::evaluate(fi->compiled);
             if (cache) {
-              rc.addObject(vp);
+              addEquationObjects(rc, fi->compiled);
             }
+            KstReadLocker l(vp);
+            const double vVal(vp->value(int(idx)));
+            txt = QString::number(vVal, 'g', rc.precision);
           } else {
             txt = "NAN";
           }
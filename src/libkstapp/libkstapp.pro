@@ -153,7 +153,8 @@ SOURCES += aboutdialog.cpp \
     viewitemscriptinterface.cpp \
     lineedititem.cpp \
     stringscriptinterface.cpp \
-    scriptserver.cpp
+    scriptserver.cpp \
+    tabrenderer.cpp
 HEADERS += aboutdialog.h \
     application.h \
     applicationsettings.h \
@@ -272,7 +273,8 @@ HEADERS += aboutdialog.h \
     viewitemscriptinterface.h \
     lineedititem.h \
     stringscriptinterface.h \
-    scriptserver.h
+    scriptserver.h \
+    tabrenderer.h
 
 FORMS += aboutdialog.ui \
     arrowpropertiestab.ui \
@@ -95,6 +95,7 @@ MainWindow::MainWindow() :
     _aboutDialog(0),
     _viewVectorDialog(0),
     _highlightPoint(false),
+    _renderServer(false),
     _statusBarTimeout(0)
 #if defined(__QNX__)
   , _qnxToolbarsVisible(true)
@@ -155,6 +156,7 @@ MainWindow::~MainWindow() {
 void MainWindow::performHeavyStartupActions() {
   // Set the timer for the UpdateManager.
   UpdateManager::self()->setMinimumUpdatePeriod(ApplicationSettings::self()->minimumUpdatePeriod());
+  UpdateManager::self()->setDemandDriven(ApplicationSettings::self()->demandDrivenUpdates());
   DataObject::init();
   DataSourcePluginManager::init();
 }
@@ -471,6 +473,8 @@ void MainWindow::openFile(const QString &file) {
 
 
 void MainWindow::exportGraphicsFile(const QString &filename, const QString &format, int width, int height, int display) {
+  updateHiddenViews(_tabWidget->views());
+
   int viewCount = 0;
   int n_views = _tabWidget->views().size();
   for (int i_view = 0; i_view<n_views; i_view++) {
@@ -676,6 +680,7 @@ void MainWindow::printFromCommandLine(const QString &printFileName) {
   setPrinterDefaults(&printer);
 
   printer.setPrintRange(QPrinter::AllPages);
+  updateHiddenViews(_tabWidget->views());
   printToPrinter(&printer);
 }
 
@@ -727,6 +732,7 @@ void MainWindow::print() {
 
   if (pd->exec() == QDialog::Accepted) {
     QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+    updateHiddenViews(_tabWidget->views());
     printToPrinter(&printer);
     QApplication::restoreOverrideCursor();
     savePrinterDefaults(&printer);
@@ -737,6 +743,7 @@ void MainWindow::print() {
 #endif
 
 void MainWindow::currentViewChanged() {
+  updateInterest();
   if(!_tabWidget->currentView())
     return;
   _undoGroup->setActiveStack(_tabWidget->currentView()->undoStack());
@@ -1768,9 +1775,68 @@ void MainWindow::updateViewItems(qint64 serial) {
     kstApp->mainWindow()->updateStatusMessage();
   }
 
+  updateInterest();
+
   QTimer::singleShot(20, UpdateManager::self(), SLOT(viewItemUpdateFinished()));
 }
 
+
+QList<Object*> MainWindow::viewObjects(View *view) const {
+  QList<Object*> shown;
+  foreach (PlotItem *plot, ViewItem::getItems<PlotItem>()) {
+    if (plot->view() == view) {
+      foreach (PlotRenderItem *renderer, plot->renderItems()) {
+        foreach (const RelationPtr &relation, renderer->relationList()) {
+          shown.append(relation);
+        }
+      }
+      foreach (Primitive *primitive, plot->labelObjects()) {
+        shown.append(primitive);
+      }
+    }
+  }
+  foreach (LabelItem *label, ViewItem::getItems<LabelItem>()) {
+    if (label->view() == view && label->_labelRc) {
+      foreach (Primitive *primitive, label->_labelRc->_refObjects) {
+        shown.append(primitive);
+      }
+    }
+  }
+  return shown;
+}
+
+
+// Only what the current view shows needs updating: the plots and labels on
+// other tabs, or of a minimized window, are brought up to date when shown.
+void MainWindow::updateInterest() {
+  QList<Object*> shown;
+
+  View *view = _tabWidget->currentView();
+  if (view && !isMinimized()) {
+    shown = viewObjects(view);
+  }
+
+  UpdateManager::self()->setInterest(this, shown);
+}
+
+
+void MainWindow::updateHiddenViews(const QList<View*>& views) {
+  foreach (View *view, views) {
+    if (view != _tabWidget->currentView() || isMinimized()) {
+      UpdateManager::self()->doUpdates(true);
+      return;
+    }
+  }
+}
+
+
+void MainWindow::changeEvent(QEvent *e) {
+  if (e->type() == QEvent::WindowStateChange) {
+    updateInterest();
+  }
+  QMainWindow::changeEvent(e);
+}
+
 void MainWindow::showVectorEditor() {
     if (!_viewVectorDialog) {
       _viewVectorDialog = new ViewVectorDialog(this, _doc);
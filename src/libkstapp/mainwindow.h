@@ -36,6 +36,7 @@ class Document;
 class ExportGraphicsDialog;
 class ExportVectorsDialog;
 class LogDialog;
+class Object;
 class DifferentiateCurvesDialog;
 class ChooseColorDialog;
 class ChangeDataSampleDialog;
@@ -63,6 +64,11 @@ class MainWindow : public QMainWindow
     QProgressBar *progressBar() const;
     bool initFromCommandLine();
     bool isHighlightPoint() { return _highlightPoint; }
+    // kst --render-server: no window, and nobody to answer dialogs
+    bool isRenderServer() const { return _renderServer; }
+    void setRenderServer(bool renderServer) { _renderServer = renderServer; }
+    // the curves, images and primitives the plots and labels of view show
+    QList<Object*> viewObjects(View *view) const;
     bool isTiedTabs();
     void setStatusMessage(QString message, int timeout=0, bool delayed = false);
     void updateStatusMessage();
@@ -171,6 +177,7 @@ class MainWindow : public QMainWindow
 
   protected:
     void closeEvent(QCloseEvent *e);
+    void changeEvent(QEvent *e);
 
   private:
     void createActions();
@@ -182,6 +189,12 @@ class MainWindow : public QMainWindow
     void writeSettings();
     bool promptSaveDone();
 
+    // tells the UpdateManager what the current view shows
+    void updateInterest();
+    // updates everything before views the UpdateManager was told weren't
+    // shown are rendered
+    void updateHiddenViews(const QList<View*>& views);
+
     QAction* createRecentFileAction(const QString& filename, int idx, const QString& text, const char* openslot);
     void updateRecentFiles(const QString& key, QMenu *menu, QList<QAction*>& actions, QMenu* submenu, const QString& newfilename, const char* openslot);
 
@@ -219,6 +232,7 @@ class MainWindow : public QMainWindow
     QLabel *_messageLabel;
 
     bool _highlightPoint;
+    bool _renderServer;
 
     QMenu *_fileMenu;
     QMenu *_editMenu;
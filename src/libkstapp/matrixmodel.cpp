@@ -21,6 +21,7 @@ namespace Kst {
 MatrixModel::MatrixModel(MatrixPtr m)
 : QAbstractItemModel(), _m(m) {
   assert(m.data());
+  _snapshot = _m->snapshot();
 }
 
 
@@ -46,7 +47,8 @@ QVariant MatrixModel::data(const QModelIndex& index, int role) const {
   if (index.isValid()) {
     switch (role) {
       case Qt::DisplayRole:
-        rc = QVariant(_m->value(index.column(), index.row()));
+        _snapshot = _m->snapshot();
+        rc = QVariant(_snapshot.value(index.column(), index.row()));
         break;
       case Qt::FontRole:
         {
@@ -35,6 +35,8 @@ public:
 
 private:
   MatrixPtr _m;
+  // kept while the model shows the matrix, so that it goes on publishing
+  mutable MatrixSnapshot _snapshot;
 };
 
 }
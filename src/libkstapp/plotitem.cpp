@@ -36,6 +36,7 @@
 
 #include "applicationsettings.h"
 #include "updatemanager.h"
+#include "updateserver.h"
 
 #include "math_kst.h"
 
@@ -146,6 +147,7 @@ PlotItem::PlotItem(View *parent)
   connect(this, SIGNAL(geometryChanged()), this, SLOT(setLabelsDirty()));
   connect(this, SIGNAL(updateAxes()), this, SLOT(setPlotPixmapDirty()));
   connect(this, SIGNAL(geometryChanged()), this, SLOT(setPlotPixmapDirty()));
+  connect(UpdateServer::self(), SIGNAL(objectListsChanged()), this, SLOT(clearParsedLabels()));
 
   applyDefaults();
   applyDialogDefaultsStroke();
@@ -862,6 +864,24 @@ QList<PlotRenderItem*> PlotItem::renderItems() const {
 }
 
 
+QList<Primitive*> PlotItem::labelObjects() const {
+  QList<Primitive*> objects;
+  if (_leftLabel.rc) {
+    objects += _leftLabel.rc->_refObjects;
+  }
+  if (_rightLabel.rc) {
+    objects += _rightLabel.rc->_refObjects;
+  }
+  if (_topLabel.rc) {
+    objects += _topLabel.rc->_refObjects;
+  }
+  if (_bottomLabel.rc) {
+    objects += _bottomLabel.rc->_refObjects;
+  }
+  return objects;
+}
+
+
 PlotRenderItem *PlotItem::renderItem(PlotRenderItem::RenderType type) {
   if ((type == PlotRenderItem::First) && (_renderers.count()>0)) {
     return _renderers.values().at(0);
@@ -2211,13 +2231,25 @@ QRectF PlotItem::rightLabelRect() const {
 }
 
 
+// Objects the labels name may have been created or deleted: look them up
+// again.
+void PlotItem::clearParsedLabels() {
+  _leftLabel.clearParsed();
+  _rightLabel.clearParsed();
+  _topLabel.clearParsed();
+  _bottomLabel.clearParsed();
+  setPlotPixmapDirty();
+  update();
+}
+
+
 void PlotItem::generateLeftLabel(QPainter *p) {
   if (!_leftLabel.dirty) {
     return;
   }
   _leftLabel.valid = false;
   _leftLabel.dirty = false;
-  Label::Parsed *parsed = Label::parse(leftLabel());
+  Label::Parsed *parsed = _leftLabel.parse(leftLabel());
   if (parsed) {
     parsed->chunk->attributes.color = _leftLabelDetails->fontColor();
 
@@ -2239,8 +2271,6 @@ void PlotItem::generateLeftLabel(QPainter *p) {
     _leftLabel.rc = rc;
     _leftLabel.transform = t;
     _leftLabel.valid = true;
-
-    delete parsed;
   }
 }
 
@@ -2291,7 +2321,7 @@ void PlotItem::generateBottomLabel(QPainter *p) {
 
   _bottomLabel.valid = false;
   _bottomLabel.dirty = false;
-  Label::Parsed *parsed = Label::parse(bottomLabel());
+  Label::Parsed *parsed = _bottomLabel.parse(bottomLabel());
   if (parsed) {
     parsed->chunk->attributes.color = _bottomLabelDetails->fontColor();
 
@@ -2312,8 +2342,6 @@ void PlotItem::generateBottomLabel(QPainter *p) {
     _bottomLabel.rc = rc;
     _bottomLabel.transform = t;
     _bottomLabel.valid = true;
-
-    delete parsed;
   }
 }
 
@@ -2361,12 +2389,12 @@ void PlotItem::generateRightLabel(QPainter *p) {
   }
   _rightLabel.valid = false;
   _rightLabel.dirty = false;
-  Label::Parsed *parsed = Label::parse(rightLabel());
+  Label::Parsed *parsed = _rightLabel.parse(rightLabel());
   if (parsed && rightLabelRect().isValid()) {
     parsed->chunk->attributes.color = _rightLabelDetails->fontColor();
 
-    if (_rightLabel.parsed) {
-      delete _rightLabel.parsed;
+    if (_rightLabel.rc) {
+      delete _rightLabel.rc;
     }
 
     Label::RenderContext *rc = new Label::RenderContext(rightLabelDetails()->calculatedFont(*p->device()), p);
@@ -2384,8 +2412,6 @@ void PlotItem::generateRightLabel(QPainter *p) {
     _rightLabel.rc = rc;
     _rightLabel.transform = t;
     _rightLabel.valid = true;
-
-    delete parsed;
   }
 }
 
@@ -2436,7 +2462,7 @@ void PlotItem::generateTopLabel(QPainter *p) {
   }
   _topLabel.valid = false;
   _topLabel.dirty = false;
-  Label::Parsed *parsed = Label::parse(topLabel());
+  Label::Parsed *parsed = _topLabel.parse(topLabel());
   if (parsed && topLabelRect().isValid()) {
     parsed->chunk->attributes.color = _topLabelDetails->fontColor();
 
@@ -2460,8 +2486,6 @@ void PlotItem::generateTopLabel(QPainter *p) {
     _topLabel.rc = rc;
     _topLabel.transform = t;
     _topLabel.valid = true;
-
-    delete parsed;
     }
 }
 
@@ -29,6 +29,7 @@
 #include "legenditem.h"
 #include "curveplacement.h"
 #include "labelrenderer.h"
+#include "labelparser.h"
 
 namespace Kst {
 
@@ -50,8 +51,22 @@ struct CachedLabel {
   CachedLabel() { valid = false; dirty = true; parsed = 0; rc = 0; };
   ~CachedLabel() { delete parsed; delete rc; };
 
+  // The parse of labelText, reused while the text stays the same so that
+  // the objects it refers to are only looked up once.
+  Label::Parsed *parse(const QString &labelText) {
+    if (!parsed || labelText != text) {
+      delete parsed;
+      parsed = Label::parse(labelText);
+      text = labelText;
+    }
+    return parsed;
+  }
+
+  void clearParsed() { delete parsed; parsed = 0; dirty = true; }
+
   bool valid;
   bool dirty;
+  QString text;
   Label::Parsed *parsed;
   Label::RenderContext *rc;
   QTransform transform;
@@ -142,6 +157,9 @@ class PlotItem : public ViewItem, public PlotItemInterface
     QList<PlotRenderItem*> renderItems() const;
     PlotRenderItem *renderItem(PlotRenderItem::RenderType type=PlotRenderItem::First);    
 
+    // The scalars, strings and vectors shown in the axis and title labels
+    QList<Primitive*> labelObjects() const;
+
     virtual void save(QXmlStreamWriter &xml);
 
     virtual void paint(QPainter *painter);
@@ -356,6 +374,7 @@ class PlotItem : public ViewItem, public PlotItemInterface
     void setTopLabelDirty() { _topLabel.dirty = true; setPlotPixmapDirty(); }
     void setBottomLabelDirty() { _bottomLabel.dirty = true; setPlotPixmapDirty(); }
     void setLabelsDirty() { _leftLabel.dirty = true; _rightLabel.dirty = true; _topLabel.dirty = true; _bottomLabel.dirty = true; setPlotPixmapDirty(); }
+    void clearParsedLabels();
 
     void setPlotPixmapDirty(bool dirty = true) {_plotPixmapDirty = dirty; }
     void setAxisLabelsDirty(bool dirty = true) { _axisLabelsDirty = dirty; }
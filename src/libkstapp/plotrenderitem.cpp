@@ -299,6 +299,13 @@ void PlotRenderItem::paint(QPainter *painter) {
 }
 
 
+void PlotRenderItem::addPaintContexts(const QRect& window, QList<Relation*>& relations, QList<CurveRenderContext>& contexts) {
+  Q_UNUSED(window);
+  Q_UNUSED(relations);
+  Q_UNUSED(contexts);
+}
+
+
 void PlotRenderItem::paintReferencePoint(QPainter *painter) {
   if (_referencePointMode && plotItem()->projectionRect().contains(_referencePoint)) {
     QPointF point = plotItem()->mapToPlot(_referencePoint);
@@ -54,6 +54,10 @@ class PlotRenderItem : public ViewItem
     virtual void saveInPlot(QXmlStreamWriter &xml);
     virtual void paint(QPainter *painter);
     virtual void paintRelations(QPainter *painter) = 0;
+    // Lists the relations the next paint will draw, with the contexts they
+    // will get on a device with window, so that the view can prepare them
+    // all at once: see Relation::preparePaint().
+    virtual void addPaintContexts(const QRect& window, QList<Relation*>& relations, QList<CurveRenderContext>& contexts);
     void paintReferencePoint(QPainter *painter);
     void paintHighlightPoint(QPainter *painter);
 
@@ -54,6 +54,9 @@
 #include "basicplugin.h"
 #include "dialog.h"
 #include "editablematrix.h"
+#include "vectorexport.h"
+#include "dirfilerecorder.h"
+#include "tabrenderer.h"
 
 #include <updatemanager.h>
 
@@ -65,7 +68,7 @@
 namespace Kst {
 
 ScriptServer::ScriptServer(ObjectStore *obj) : _server(new QLocalServer(this)), _store(obj),_interface(0), _if(0),
-    _curMac(0) {
+    _curMac(0), _export(0), _recorder(0), _renderer(0) {
 
     QString initial="kstScript";
     QStringList args= qApp->arguments();
@@ -192,6 +195,14 @@ ScriptServer::ScriptServer(ObjectStore *obj) : _server(new QLocalServer(this)),
     _fnMap.insert("setPaused()",&ScriptServer::setPaused);
     _fnMap.insert("unsetPaused()",&ScriptServer::unsetPaused);
 
+    _fnMap.insert("exportVectors()",&ScriptServer::exportVectors);
+    _fnMap.insert("exportProgress()",&ScriptServer::exportProgress);
+    _fnMap.insert("cancelExport()",&ScriptServer::cancelExport);
+    _fnMap.insert("startRecording()",&ScriptServer::startRecording);
+    _fnMap.insert("stopRecording()",&ScriptServer::stopRecording);
+    _fnMap.insert("renderTab()",&ScriptServer::renderTab);
+    _fnMap.insert("finishRendering()",&ScriptServer::finishRendering);
+
     _fnMap.insert("newMacro()",&ScriptServer::newMacro);
     _fnMap.insert("newMacro_()",&ScriptServer::newMacro_);
     _fnMap.insert("delMacro()",&ScriptServer::delMacro);
@@ -230,6 +241,9 @@ ScriptServer::~ScriptServer()
     delete _if;
     delete _curMac;
     delete _interface;
+    delete _export;
+    delete _recorder;
+    delete _renderer;
 
     while(_macroMap.size()) {
         delete _macroMap.take(_macroMap.keys().first());
@@ -374,6 +388,19 @@ void ScriptServer::procConnection() {
     while(_server->hasPendingConnections()) {
         QLocalSocket* s=_server->nextPendingConnection();
         connect(s,SIGNAL(readyRead()),this,SLOT(readSomething()));
+        connect(s,SIGNAL(disconnected()),this,SLOT(unsubscribe()));
+    }
+}
+
+/** Stops updating what the script on a closed connection was reading, if nothing else needs it. */
+void ScriptServer::unsubscribe() {
+    UpdateManager::self()->removeInterest(sender());
+}
+
+void ScriptServer::subscribe(QLocalSocket* s,Object* o) {
+    UpdateManager::self()->bringUpToDate(o);
+    if(s) {
+        UpdateManager::self()->addInterest(s,o);
     }
 }
 
@@ -532,6 +559,7 @@ QByteArray ScriptServer::checkPrimatives(QByteArray &command, QLocalSocket *s)
             ObjectPtr o=_store->retrieveObject(b);
             DataVectorPtr v=kst_cast<DataVector>(o);
             if(v) {
+                subscribe(s,v);
                 return handleResponse(v->scriptInterface(m),s,0,"",0,0);
             } else {
                 return handleResponse("No such object",s,0,"",0,0);
@@ -553,6 +581,7 @@ QByteArray ScriptServer::checkPrimatives(QByteArray &command, QLocalSocket *s)
             ObjectPtr o=_store->retrieveObject(b);
             VectorPtr v=kst_cast<Vector>(o);
             if(v) {
+                subscribe(s,v);
                 return handleResponse(v->scriptInterface(m),s,0,"",0,0);
             } else {
                 return handleResponse("No such object",s,0,"",0,0);
@@ -574,6 +603,7 @@ QByteArray ScriptServer::checkPrimatives(QByteArray &command, QLocalSocket *s)
           ObjectPtr o=_store->retrieveObject(b);
           DataObjectPtr x=kst_cast<DataObject>(o);
           if (x) {
+              subscribe(s,x);
               return handleResponse(x->scriptInterface(m),s,0,"",0,0);
           } else {
               return handleResponse("No such object",s,0,"",0,0);
@@ -1168,6 +1198,194 @@ QByteArray ScriptServer::unsetPaused(QByteArray&, QLocalSocket* s,ObjectStore*,c
 
 }
 
+// The arguments of a command, split at commas and trimmed.  An argument in
+// double quotes, with \" and \\ standing for " and \, may hold commas.
+static QList<QByteArray> splitArguments(const QByteArray& command) {
+    QList<QByteArray> pieces;
+    bool quoted=false;
+    int start=0;
+    for(int i=0;i<command.size();i++) {
+        if(quoted&&command.at(i)=='\\') {
+            i++;
+        } else if(command.at(i)=='"') {
+            quoted=!quoted;
+        } else if(!quoted&&command.at(i)==',') {
+            pieces<<command.mid(start,i-start);
+            start=i+1;
+        }
+    }
+    pieces<<command.mid(start);
+
+    QList<QByteArray> args;
+    foreach(QByteArray piece,pieces) {
+        piece=piece.trimmed();
+        if(piece.size()>=2&&piece.startsWith('"')&&piece.endsWith('"')) {
+            QByteArray unquoted;
+            for(int i=1;i<piece.size()-1;i++) {
+                if(piece.at(i)=='\\'&&i+1<piece.size()-1) {
+                    i++;
+                }
+                unquoted+=piece.at(i);
+            }
+            piece=unquoted;
+        }
+        args<<piece;
+    }
+    return args;
+}
+
+QByteArray ScriptServer::exportVectors(QByteArray&command, QLocalSocket* s,ObjectStore*,const int&ifMode,
+                                      const QByteArray&ifEqual,IfSI*& _if,VarSI*var) {
+    if(_export&&_export->isRunning()) {
+        return handleResponse("An export is already running",s,ifMode,ifEqual,_if,var);
+    }
+    command.replace("exportVectors(","");
+    command.remove(command.lastIndexOf(')'),1);
+    QList<QByteArray> args=splitArguments(command);
+    if(args.size()<3) {
+        return handleResponse("Invalid call to exportVectors(format,file,vector...)",s,ifMode,ifEqual,_if,var);
+    }
+    bool ok;
+    VectorExport::Format format=VectorExport::formatFromName(args.at(0).trimmed(),&ok);
+    if(!ok) {
+        return handleResponse("Unknown format: "+args.at(0).trimmed(),s,ifMode,ifEqual,_if,var);
+    }
+
+    delete _export;
+    _export=new VectorExport(args.at(1).trimmed(),format);
+    for(int i=2;i<args.size();i++) {
+        VectorPtr v=kst_cast<Vector>(_store->retrieveObject(args.at(i).trimmed()));
+        if(!v) {
+            delete _export;
+            _export=0;
+            return handleResponse("No such vector: "+args.at(i).trimmed(),s,ifMode,ifEqual,_if,var);
+        }
+        UpdateManager::self()->bringUpToDate(v);
+        _export->addVector(v);
+    }
+    connect(_export,SIGNAL(progress(int,QString)),kstApp->mainWindow(),SLOT(updateProgress(int,QString)));
+    _export->start();
+    return handleResponse("Done",s,ifMode,ifEqual,_if,var);
+}
+
+QByteArray ScriptServer::exportProgress(QByteArray&, QLocalSocket* s,ObjectStore*,const int&ifMode,
+                                       const QByteArray&ifEqual,IfSI*& _if,VarSI*var) {
+    if(!_export) {
+        return handleResponse("No export",s,ifMode,ifEqual,_if,var);
+    } else if(_export->isRunning()) {
+        return handleResponse(QByteArray::number(_export->percentDone()),s,ifMode,ifEqual,_if,var);
+    } else if(_export->succeeded()) {
+        return handleResponse("Done",s,ifMode,ifEqual,_if,var);
+    }
+    return handleResponse(_export->errorString().toUtf8(),s,ifMode,ifEqual,_if,var);
+}
+
+QByteArray ScriptServer::cancelExport(QByteArray&, QLocalSocket* s,ObjectStore*,const int&ifMode,
+                                     const QByteArray&ifEqual,IfSI*& _if,VarSI*var) {
+    if(_export) {
+        _export->cancel();
+        _export->wait();
+    }
+    return handleResponse("Done",s,ifMode,ifEqual,_if,var);
+}
+
+// The data vector whose frames v lines up with sample for sample: an
+// equation's outputs follow its x vector.
+static DataVectorPtr framesOf(VectorPtr v) {
+    while(v) {
+        if(DataVectorPtr dv=kst_cast<DataVector>(v)) {
+            return dv;
+        }
+        EquationPtr eq=kst_cast<Equation>(v->provider());
+        if(!eq||eq->doInterp()) {
+            break;
+        }
+        v=eq->vXIn();
+    }
+    return DataVectorPtr();
+}
+
+QByteArray ScriptServer::startRecording(QByteArray&command, QLocalSocket* s,ObjectStore*,const int&ifMode,
+                                       const QByteArray&ifEqual,IfSI*& _if,VarSI*var) {
+    if(_recorder&&_recorder->isRecording()) {
+        return handleResponse("Already recording to "+_recorder->dirfile().toUtf8(),s,ifMode,ifEqual,_if,var);
+    }
+    command.replace("startRecording(","");
+    command.remove(command.lastIndexOf(')'),1);
+    QList<QByteArray> args=splitArguments(command);
+    if(args.size()<2) {
+        return handleResponse("Invalid call to startRecording(dirfile,vector...)",s,ifMode,ifEqual,_if,var);
+    }
+
+    delete _recorder;
+    _recorder=new DirfileRecorder(args.at(0).trimmed());
+    for(int i=1;i<args.size();i++) {
+        VectorPtr v=kst_cast<Vector>(_store->retrieveObject(args.at(i).trimmed()));
+        if(!v) {
+            delete _recorder;
+            _recorder=0;
+            return handleResponse("No such vector: "+args.at(i).trimmed(),s,ifMode,ifEqual,_if,var);
+        }
+        _recorder->addVector(v,QString(),0,framesOf(v));
+    }
+    if(!_recorder->start()) {
+        return handleResponse(_recorder->errorString().toUtf8(),s,ifMode,ifEqual,_if,var);
+    }
+    return handleResponse("Done",s,ifMode,ifEqual,_if,var);
+}
+
+QByteArray ScriptServer::stopRecording(QByteArray&, QLocalSocket* s,ObjectStore*,const int&ifMode,
+                                      const QByteArray&ifEqual,IfSI*& _if,VarSI*var) {
+    if(!_recorder) {
+        return handleResponse("Not recording",s,ifMode,ifEqual,_if,var);
+    }
+    _recorder->stop();
+    const QString error=_recorder->errorString();
+    if(!error.isEmpty()) {
+        return handleResponse(error.toUtf8(),s,ifMode,ifEqual,_if,var);
+    }
+    return handleResponse(QByteArray::number(_recorder->samplesRecorded()),s,ifMode,ifEqual,_if,var);
+}
+
+QByteArray ScriptServer::renderTab(QByteArray&command, QLocalSocket* s,ObjectStore*,const int&ifMode,
+                                   const QByteArray&ifEqual,IfSI*& _if,VarSI*var) {
+    command.replace("renderTab(","");
+    command.remove(command.lastIndexOf(')'),1);
+    QList<QByteArray> args=splitArguments(command);
+    bool okTab=false, okWidth=false, okHeight=false;
+    const int tab=args.size()>=4?args.at(0).trimmed().toInt(&okTab):0;
+    const int width=args.size()>=4?args.at(1).trimmed().toInt(&okWidth):0;
+    const int height=args.size()>=4?args.at(2).trimmed().toInt(&okHeight):0;
+    if(!okTab||!okWidth||!okHeight||args.at(3).trimmed().isEmpty()) {
+        return handleResponse("Invalid call to renderTab(tab,width,height,file[,session])",s,ifMode,ifEqual,_if,var);
+    }
+    const QString file=QString::fromUtf8(args.at(3).trimmed());
+    QByteArray session;
+    for(int i=4;i<args.size();i++) {
+        session+=(i>4?",":"")+args.at(i);  // an unquoted session name may hold commas
+    }
+
+    if(!_renderer) {
+        _renderer=new TabRenderer(kstApp->mainWindow());
+    }
+    if(!_renderer->render(QString::fromUtf8(session.trimmed()),tab,QSize(width,height),file)) {
+        return handleResponse(_renderer->errorString().toUtf8(),s,ifMode,ifEqual,_if,var);
+    }
+    return handleResponse("Done",s,ifMode,ifEqual,_if,var);
+}
+
+QByteArray ScriptServer::finishRendering(QByteArray&, QLocalSocket* s,ObjectStore*,const int&ifMode,
+                                         const QByteArray&ifEqual,IfSI*& _if,VarSI*var) {
+    if(!_renderer) {
+        return handleResponse("Done",s,ifMode,ifEqual,_if,var);
+    }
+    const QStringList errors=_renderer->finish();
+    if(!errors.isEmpty()) {
+        return handleResponse(errors.join("\n").toUtf8(),s,ifMode,ifEqual,_if,var);
+    }
+    return handleResponse("Done",s,ifMode,ifEqual,_if,var);
+}
+
 QByteArray ScriptServer::newMacro(QByteArray&command, QLocalSocket* s,ObjectStore*,const int&,
                                   const QByteArray&,IfSI*& _if,VarSI*) {
     if(_curMac) {
@@ -1409,6 +1627,7 @@ QByteArray ScriptServer::editableVectorSetBinaryArray(QByteArray&command, QLocal
     v->writeLock();
     v->change(copy);
     v->unlock();
+    v->registerChange();
     s->write("Done.");
     s->waitForBytesWritten(-1);
     return "Done.";
@@ -1477,6 +1696,7 @@ QByteArray ScriptServer::editableVectorSet(QByteArray&command, QLocalSocket* s,O
         return "No such object.";
     }
     v->setValue(b[1].toInt(),b[2].toDouble());
+    v->registerChange();
     s->write("Done.");
     s->waitForBytesWritten(-1);
     return "Done.";
@@ -1499,6 +1719,7 @@ QByteArray ScriptServer::vectorGetBinaryArray(QByteArray&command, QLocalSocket*
         s->waitForBytesWritten(-1);
         return "No object";
     }
+    subscribe(s,v);
     QByteArray x=v->getBinaryArray();
     const char* d=x.data();
     int pos=-8;
@@ -1532,6 +1753,7 @@ QByteArray ScriptServer::matrixGetBinaryArray(QByteArray&command, QLocalSocket*
         s->waitForBytesWritten(-1);
         return "No object";
     }
+    subscribe(s,m);
     QByteArray x=m->getBinaryArray();
     const char* d=x.data();
     int pos=-8;
@@ -1553,6 +1775,7 @@ QByteArray ScriptServer::stringValue(QByteArray&command, QLocalSocket* s,ObjectS
     ObjectPtr o=_store->retrieveObject(command);
     StringPtr str=kst_cast<String>(o);
     if(str) {
+        subscribe(s,str);
         return handleResponse(str->value().toLatin1(),s,0,"",0,0);
     } else {
         return handleResponse("No such object (variables not supported)",s,0,"",0,0);;
@@ -1591,6 +1814,7 @@ QByteArray ScriptServer::scalarValue(QByteArray&command, QLocalSocket* s,ObjectS
     ObjectPtr o=_store->retrieveObject(command);
     ScalarPtr sca=kst_cast<Scalar>(o);
     if(sca) {
+        subscribe(s,sca);
         return handleResponse(QByteArray::number(sca->value()),s,0,"",0,0);
     } else {
         return handleResponse("No such object (variables not supported)",s,0,"",0,0);;
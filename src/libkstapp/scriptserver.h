@@ -25,6 +25,9 @@
 namespace Kst {
 
 class ViewItem;
+class VectorExport;
+class DirfileRecorder;
+class TabRenderer;
 
 class ScriptServer;
 
@@ -44,6 +47,9 @@ class ScriptServer : public QObject
     QMap<QByteArray,ScriptMemberFn> _fnMap;
     QMap<QByteArray,MacroSI*> _macroMap;
     QMap<QByteArray,VarSI*> _varMap;
+    VectorExport* _export;  // the last export, running or done
+    DirfileRecorder* _recorder;  // the last recording, running or stopped
+    TabRenderer* _renderer;  // made on the first renderTab()
 public:
     ScriptServer(ObjectStore*obj);
     ~ScriptServer();
@@ -52,10 +58,14 @@ public:
 public slots:
     void procConnection();
     void readSomething();
+    void unsubscribe();
     QByteArray procMacro(QByteArray&command,QLocalSocket*s);
     QByteArray exec(QByteArray command,QLocalSocket* s,int ifMode=0, QByteArray ifEqual="");
 
 protected:
+    // Brings o up to date for the script reading it on s, and keeps it updated while s is connected.
+    void subscribe(QLocalSocket* s,Object* o);
+
     QByteArray noSuchFn(QByteArray& , QLocalSocket*,ObjectStore*,const int&, const QByteArray&,IfSI*& ,VarSI*) {return ""; }
 
     //
@@ -170,6 +180,23 @@ protected:
     QByteArray setPaused(QByteArray& command, QLocalSocket* s,ObjectStore*_store,const int&ifMode, const QByteArray&ifString,IfSI*& ifStat,VarSI*var);
     QByteArray unsetPaused(QByteArray& command, QLocalSocket* s,ObjectStore*_store,const int&ifMode, const QByteArray&ifString,IfSI*& ifStat,VarSI*var);
 
+    // Export: exportVectors(format,file,vector1,vector2,...) starts writing the vectors in the background,
+    // exportProgress() returns the percentage written or, once it's over, "Done" or what went wrong.
+    QByteArray exportVectors(QByteArray& command, QLocalSocket* s,ObjectStore*_store,const int&ifMode, const QByteArray&ifString,IfSI*& ifStat,VarSI*var);
+    QByteArray exportProgress(QByteArray& command, QLocalSocket* s,ObjectStore*_store,const int&ifMode, const QByteArray&ifString,IfSI*& ifStat,VarSI*var);
+    QByteArray cancelExport(QByteArray& command, QLocalSocket* s,ObjectStore*_store,const int&ifMode, const QByteArray&ifString,IfSI*& ifStat,VarSI*var);
+
+    // Recording: startRecording(dirfile,vector1,vector2,...) appends the vectors to a dirfile as they grow,
+    // stopRecording() finishes it and returns the number of samples written or what went wrong.
+    QByteArray startRecording(QByteArray& command, QLocalSocket* s,ObjectStore*_store,const int&ifMode, const QByteArray&ifString,IfSI*& ifStat,VarSI*var);
+    QByteArray stopRecording(QByteArray& command, QLocalSocket* s,ObjectStore*_store,const int&ifMode, const QByteArray&ifString,IfSI*& ifStat,VarSI*var);
+
+    // Rendering: renderTab(tab,width,height,file[,session]) renders a tab of the session (or of what is open) into file,
+    // as png, svg, pdf..., keeping the session open for the next call; finishRendering() waits for the images to be
+    // written and returns "Done" or what went wrong.
+    QByteArray renderTab(QByteArray& command, QLocalSocket* s,ObjectStore*_store,const int&ifMode, const QByteArray&ifString,IfSI*& ifStat,VarSI*var);
+    QByteArray finishRendering(QByteArray& command, QLocalSocket* s,ObjectStore*_store,const int&ifMode, const QByteArray&ifString,IfSI*& ifStat,VarSI*var);
+
     // Macros
     QByteArray newMacro(QByteArray& command, QLocalSocket* s,ObjectStore*_store,const int&ifMode, const QByteArray&ifString,IfSI*& ifStat,VarSI*var);
     QByteArray newMacro_(QByteArray& command, QLocalSocket* s,ObjectStore*_store,const int&ifMode, const QByteArray&ifString,IfSI*& ifStat,VarSI*var);
@@ -0,0 +1,190 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "tabrenderer.h"
+
+#include "document.h"
+#include "mainwindow.h"
+#include "tabwidget.h"
+#include "updatemanager.h"
+#include "view.h"
+
+#include <QFileInfo>
+#include <QImage>
+#include <QImageWriter>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QRunnable>
+
+#ifndef KST_NO_SVG
+#include <QSvgGenerator>
+#endif
+
+#ifndef KST_NO_PRINTER
+#include <QPrinter>
+#endif
+
+namespace Kst {
+
+// Encodes and writes one image, then frees its place in the queue.
+class ImageWriteJob : public QRunnable {
+  public:
+    ImageWriteJob(TabRenderer *renderer, const QImage& image, const QString& file, const QByteArray& format)
+      : _renderer(renderer), _image(image), _file(file), _format(format) {}
+
+    void run() {
+      QImageWriter writer(_file, _format);
+      if (!writer.write(_image)) {
+        _renderer->writeFailed(QObject::tr("Could not write %1: %2").arg(_file).arg(writer.errorString()));
+      }
+      _image = QImage();
+      _renderer->_queued.release();
+    }
+
+  private:
+    TabRenderer *_renderer;
+    QImage _image;
+    QString _file;
+    QByteArray _format;
+};
+
+
+// Lays view out at size and paints it as the exports do, then puts it back.
+static void paintView(View *view, QPainter *painter, const QSize& size) {
+  QSize currentSize(view->size());
+  view->resize(size);
+  view->processResize(size);
+  view->setPrinting(true);
+  view->render(painter);
+  view->setPrinting(false);
+  view->resize(currentSize);
+  view->processResize(currentSize);
+}
+
+
+TabRenderer::TabRenderer(MainWindow *mainWindow)
+  : QObject(), _mainWindow(mainWindow), _queued(MaxQueuedImages) {
+}
+
+
+TabRenderer::~TabRenderer() {
+  _writers.waitForDone();
+}
+
+
+bool TabRenderer::openSession(const QString& session) {
+  const QFileInfo info(session);
+  if (!info.exists()) {
+    _error = tr("%1 does not exist.").arg(session);
+    return false;
+  }
+
+  Document *doc = _mainWindow->document();
+  if (doc->fileName() == info.absoluteFilePath() && info.lastModified() == _sessionModified) {
+    return true;
+  }
+
+  _sessionModified = QDateTime();
+  _mainWindow->newDoc(true);
+  doc = _mainWindow->document();
+  if (!doc->open(info.absoluteFilePath())) {
+    _error = tr("Could not open %1: %2").arg(session).arg(doc->lastError());
+    return false;
+  }
+  doc->setChanged(false);
+  _sessionModified = info.lastModified();
+  return true;
+}
+
+
+bool TabRenderer::render(const QString& session, int tab, const QSize& size, const QString& file) {
+  _error.clear();
+
+  if (!session.isEmpty() && !openSession(session)) {
+    return false;
+  }
+
+  const QList<View*> views = _mainWindow->tabWidget()->views();
+  if (tab < 0 || tab >= views.size()) {
+    _error = tr("There is no tab %1.").arg(tab);
+    return false;
+  }
+  if (size.width() < 1 || size.height() < 1) {
+    _error = tr("Can not render at %1x%2.").arg(size.width()).arg(size.height());
+    return false;
+  }
+  View *view = views.at(tab);
+
+  // new data, for what this tab shows only
+  UpdateManager::self()->updateNow(_mainWindow->viewObjects(view));
+
+  const QString format = QFileInfo(file).suffix().toLower();
+  if (format == "svg") {
+#ifndef KST_NO_SVG
+    QSvgGenerator generator;
+    generator.setFileName(file);
+    generator.setResolution(300);
+    generator.setSize(size);
+    generator.setViewBox(QRect(QPoint(0, 0), size));
+
+    QPainter painter(&generator);
+    paintView(view, &painter, size);
+    return true;
+#endif
+  } else if (format == "pdf") {
+#ifndef KST_NO_PRINTER
+    QPrinter printer(QPrinter::ScreenResolution);
+    printer.setOutputFormat(QPrinter::PdfFormat);
+    printer.setOutputFileName(file);
+    printer.setOrientation(QPrinter::Portrait);
+
+    printer.setPrintRange(QPrinter::PageRange);
+    printer.setFromTo(tab + 1, tab + 1);
+
+    printer.setPaperSize(size, QPrinter::DevicePixel);
+    _mainWindow->printToPrinter(&printer);
+    return true;
+#endif
+  } else if (QImageWriter::supportedImageFormats().contains(format.toLatin1())) {
+    QImage image(size, QImage::Format_ARGB32);
+    QPainter painter(&image);
+    paintView(view, &painter, size);
+    painter.end();
+
+    _queued.acquire();
+    _writers.start(new ImageWriteJob(this, image, file, format.toLatin1()));
+    return true;
+  }
+
+  _error = tr("Can not write %1 files.").arg(format);
+  return false;
+}
+
+
+void TabRenderer::writeFailed(const QString& error) {
+  QMutexLocker locker(&_mutex);
+  _writeErrors.append(error);
+}
+
+
+QStringList TabRenderer::finish() {
+  _writers.waitForDone();
+
+  QMutexLocker locker(&_mutex);
+  const QStringList errors = _writeErrors;
+  _writeErrors.clear();
+  return errors;
+}
+
+}
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,86 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TABRENDERER_H
+#define TABRENDERER_H
+
+#include <QDateTime>
+#include <QMutex>
+#include <QObject>
+#include <QSemaphore>
+#include <QSize>
+#include <QStringList>
+#include <QThreadPool>
+
+namespace Kst {
+
+class MainWindow;
+class ImageWriteJob;
+
+/** Renders the tabs of kst sessions into files for scripts.  This is what a
+    render server (kst --render-server) is for: with no window, and on Qt 5
+    the offscreen platform, it turns out the plots of batch reports without
+    a display or a new kst per image.  As nobody could answer a dialog, a
+    data source the session names but which can't be loaded makes the
+    render fail.
+
+    The session rendered last stays open with its data sources, so more of
+    its tabs render without loading anything again; it is only reopened if
+    the file changed, or could not be loaded.  Every render first reads new
+    data and updates what its tab shows, and nothing else.  Views are
+    painted in the GUI thread, as QGraphicsScene requires, with the curves
+    of each view prepared on the compute threads; raster images are then
+    encoded and written by a pool of writer threads while the next job is
+    painted.  SVG and PDF are written as they are painted. */
+class TabRenderer : public QObject
+{
+  Q_OBJECT
+  public:
+    TabRenderer(MainWindow *mainWindow);
+    ~TabRenderer();
+
+    /** Renders tab (counting from 0) of the session file session, or of
+        what is open if session is empty, at size into file, in the format
+        of its suffix: svg, pdf or any image format Qt writes (png, jpg...).
+        Returns false, with errorString() saying why, if it can't.  Raster
+        images may still be being written on return. */
+    bool render(const QString& session, int tab, const QSize& size, const QString& file);
+
+    /** Waits for the images being written, and returns what went wrong
+        writing any of them since the last call */
+    QStringList finish();
+
+    const QString& errorString() const { return _error; }
+
+  private:
+    friend class ImageWriteJob;
+
+    // images painted but not yet written, at most
+    enum { MaxQueuedImages = 8 };
+
+    bool openSession(const QString& session);
+    void writeFailed(const QString& error);
+
+    MainWindow *_mainWindow;
+    QDateTime _sessionModified;
+    QString _error;
+    QThreadPool _writers;
+    QSemaphore _queued;
+    QMutex _mutex;
+    QStringList _writeErrors;
+};
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
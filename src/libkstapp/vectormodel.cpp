@@ -33,6 +33,7 @@ bool VectorModel::addVector(VectorPtr v)
   if (!_vectorList.contains(v)) {
     beginInsertColumns(QModelIndex(), columnCount(), columnCount());
     _vectorList.append(v);
+    _snapshots.append(v->snapshot());
     // Standard nb of digits after comma: 6
     _digitNbList.append(6);
     endInsertColumns();
@@ -47,6 +48,7 @@ bool VectorModel::removeVector(int order)
 {
   beginRemoveColumns(QModelIndex(), order, order);
   _vectorList.removeAt(order);
+  _snapshots.removeAt(order);
   _digitNbList.removeAt(order);
   endRemoveColumns();
   return true;
@@ -71,27 +73,31 @@ QVariant VectorModel::data(const QModelIndex& index, int role) const {
   if (index.isValid() && !_vectorList.isEmpty()) {
     switch (role) {
       case Qt::DisplayRole:
-        // If vector is shorter display nothing
-        if (index.row() >= _vectorList.at(index.column())->length()) {
-          return QVariant();
-        } else {
-            double value = _vectorList.at(index.column())->value(index.row());
-            // Return string depending on number of digits, for 0 try to print as int
-            switch (_digitNbList.at(index.column())) {
-              case 0:
-                // Cast to long int if not too big
-                if (value < (double) LLONG_MAX && value > (double) LLONG_MIN) {
-                  qDebug() << "print as int";
-                  return QVariant(QString::number((qlonglong) value));
-                }
-                else {
-                  return QVariant(value);
-                }
-                break;
-              default:
-                return QVariant(QString::number(value, 'g', _digitNbList.at(index.column())));
-                break;
-            }
+        {
+          // If vector is shorter display nothing
+          _snapshots[index.column()] = _vectorList.at(index.column())->snapshot();
+          const VectorSnapshot& snap = _snapshots.at(index.column());
+          if (index.row() >= snap.length()) {
+            return QVariant();
+          } else {
+              double value = snap.value(index.row());
+              // Return string depending on number of digits, for 0 try to print as int
+              switch (_digitNbList.at(index.column())) {
+                case 0:
+                  // Cast to long int if not too big
+                  if (value < (double) LLONG_MAX && value > (double) LLONG_MIN) {
+                    qDebug() << "print as int";
+                    return QVariant(QString::number((qlonglong) value));
+                  }
+                  else {
+                    return QVariant(value);
+                  }
+                  break;
+                default:
+                  return QVariant(QString::number(value, 'g', _digitNbList.at(index.column())));
+                  break;
+              }
+          }
         }
         break;
       case Qt::FontRole:
@@ -160,6 +166,10 @@ bool VectorModel::setData(const QModelIndex& index, const QVariant& value, int r
 }
 
 void VectorModel::resetIfChanged() {
+  // follow the vectors even while nothing is repainted
+  for (int i = 0; i < _vectorList.length(); ++i) {
+    _snapshots[i] = _vectorList.at(i)->snapshot();
+  }
   if (_rows!=rowCount()) {
     reset();
     _rows = rowCount();
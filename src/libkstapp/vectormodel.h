@@ -38,6 +38,9 @@ public:
   void setDigitNumber(int column, int nbDigits);
 private:
   VectorList _vectorList;
+  // what each vector held as of its last update, kept while the model shows
+  // it so that the vector goes on publishing snapshots
+  mutable QList<VectorSnapshot> _snapshots;
   QList<int> _digitNbList;
   int _rows;
 };
@@ -477,6 +477,8 @@ void View::forceChildResize(QRectF oldRect, QRectF newRect) {
 
 
 void View::drawBackground(QPainter *painter, const QRectF &rect) {
+  preparePlots(painter, rect);
+
   if (isPrinting()) {
     QBrush currentBrush(backgroundBrush());
     setBackgroundBrush(Qt::white);
@@ -527,6 +529,21 @@ void View::drawBackground(QPainter *painter, const QRectF &rect) {
 }
 
 
+void View::preparePlots(QPainter *painter, const QRectF &rect) {
+  QList<Relation*> relations;
+  QList<CurveRenderContext> contexts;
+  foreach (PlotItem *plot, PlotItemManager::self()->plotsForView(this)) {
+    if (!plot->isVisible() || plot->maskedByMaximization() || !plot->sceneBoundingRect().intersects(rect)) {
+      continue;
+    }
+    foreach (PlotRenderItem *renderer, plot->renderItems()) {
+      renderer->addPaintContexts(painter->window(), relations, contexts);
+    }
+  }
+  Relation::preparePaint(relations, contexts);
+}
+
+
 void View::updateSettings() {
   setUseOpenGL(ApplicationSettings::self()->useOpenGL());
   setShowGrid(ApplicationSettings::self()->showGrid());
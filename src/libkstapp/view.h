@@ -167,6 +167,9 @@ class View : public QGraphicsView
 
   private:
     void updateChildGeometry(const QRectF &oldSceneRect);
+    // works out the curves and images of the plots in rect in parallel,
+    // before the scene paints them one by one
+    void preparePlots(QPainter *painter, const QRectF &rect);
 
   private:
     QUndoStack *_undoStack;
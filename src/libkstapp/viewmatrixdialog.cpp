@@ -14,6 +14,7 @@
 
 #include "document.h"
 #include "matrixmodel.h"
+#include "updatemanager.h"
 
 #include <datacollection.h>
 
@@ -28,6 +29,9 @@ ViewMatrixDialog::ViewMatrixDialog(QWidget *parent, Document *doc)
   matrixSelector->setObjectStore(doc->objectStore());
 
   setAttribute(Qt::WA_DeleteOnClose);
+
+  // any matrix can be picked
+  UpdateManager::self()->setInterestInAll(this);
 }
 
 
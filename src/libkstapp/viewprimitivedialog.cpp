@@ -16,6 +16,7 @@
 #include "objectstore.h"
 #include "scalarmodel.h"
 #include "stringmodel.h"
+#include "updatemanager.h"
 
 #include <datacollection.h>
 #include <QHeaderView>
@@ -32,6 +33,9 @@ ViewPrimitiveDialog::ViewPrimitiveDialog(QWidget *parent, Document *doc)
   setupUi(this);
   setAttribute(Qt::WA_DeleteOnClose);
   connect(updateButton, SIGNAL(clicked()), this, SLOT(update()));
+
+  // lists the values of every scalar or string
+  UpdateManager::self()->setInterestInAll(this);
 }
 
 
@@ -16,6 +16,7 @@
 #include "vectormodel.h"
 #include "editmultiplewidget.h"
 #include "updateserver.h"
+#include "updatemanager.h"
 
 #include <datacollection.h>
 #include <objectstore.h>
@@ -100,9 +101,17 @@ ViewVectorDialog::~ViewVectorDialog() {
 
 void ViewVectorDialog::show() {
   // vectorSelected();
+  // any vector may be picked for viewing, so keep them all up to date
+  UpdateManager::self()->setInterestInAll(this);
   QDialog::show();
 }
 
+
+void ViewVectorDialog::hideEvent(QHideEvent *event) {
+  UpdateManager::self()->removeInterest(this);
+  QDialog::hideEvent(event);
+}
+
 void ViewVectorDialog::contextMenu(const QPoint& position) {
   QMenu menu;
   QPoint cursor = QCursor::pos();
@@ -38,6 +38,9 @@ public Q_SLOTS:
   void contextMenu(const QPoint& position);
   void update();
 
+protected:
+  void hideEvent(QHideEvent *event);
+
 private Q_SLOTS:
   void addSelected();
   void removeSelected();
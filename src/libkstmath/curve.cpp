@@ -80,6 +80,7 @@ Curve::Curve(ObjectStore *store)
 
   MaxX = MinX = MeanX = MaxY = MinY = MeanY = MinPosX = MinPosY = 0;
   NS = 0;
+  _paintedCount = 0;
   _typeString = i18n("Curve");
   _type = "Curve";
   _initializeShortName();
@@ -325,6 +326,7 @@ void Curve::setXVector(VectorPtr new_vx) {
   } else {
     _inputVectors.remove(XVECTOR);
   }
+  _paintedCount = 0;
 }
 
 
@@ -334,6 +336,7 @@ void Curve::setYVector(VectorPtr new_vy) {
   } else {
     _inputVectors.remove(YVECTOR);
   }
+  _paintedCount = 0;
 }
 
 
@@ -343,6 +346,7 @@ void Curve::setXError(VectorPtr new_ex) {
   } else {
     _inputVectors.remove(EXVECTOR);
   }
+  _paintedCount = 0;
 }
 
 
@@ -352,6 +356,7 @@ void Curve::setYError(VectorPtr new_ey) {
   } else {
     _inputVectors.remove(EYVECTOR);
   }
+  _paintedCount = 0;
 }
 
 
@@ -361,6 +366,7 @@ void Curve::setXMinusError(VectorPtr new_ex) {
   } else {
     _inputVectors.remove(EXMINUSVECTOR);
   }
+  _paintedCount = 0;
 }
 
 
@@ -370,6 +376,7 @@ void Curve::setYMinusError(VectorPtr new_ey) {
   } else {
     _inputVectors.remove(EYMINUSVECTOR);
   }
+  _paintedCount = 0;
 }
 
 
@@ -550,21 +557,25 @@ int Curve::getIndexNearXY(double x, double dx_per_pix, double y) const {
 
 void Curve::setHasPoints(bool in_HasPoints) {
   HasPoints = in_HasPoints;
+  _paintedCount = 0;
 }
 
 
 void Curve::setHasHead(bool in_HasHead) {
   HasHead = in_HasHead;
+  _paintedCount = 0;
 }
 
 
 void Curve::setHasLines(bool in_HasLines) {
   HasLines = in_HasLines;
+  _paintedCount = 0;
 }
 
 
 void Curve::setHasBars(bool in_HasBars) {
   HasBars = in_HasBars;
+  _paintedCount = 0;
 }
 
 
@@ -575,44 +586,53 @@ void Curve::setLineWidth(int in_LineWidth) {
   }
 #endif
   LineWidth = in_LineWidth;
+  _paintedCount = 0;
 }
 
 
 void Curve::setLineStyle(int in_LineStyle) {
   LineStyle = in_LineStyle;
+  _paintedCount = 0;
 }
 
 
 void Curve::setPointDensity(int in_PointDensity) {
   PointDensity = in_PointDensity;
+  _paintedCount = 0;
 }
 
 
 void Curve::setPointType(int in_PointType) {
   PointType = in_PointType;
+  _paintedCount = 0;
 }
 
 
 void Curve::setPointSize(double in_PointSize) {
   PointSize = in_PointSize;
+  _paintedCount = 0;
 }
 
 
 void Curve::setHeadType(int in_HeadType) {
   HeadType = in_HeadType;
+  _paintedCount = 0;
 }
 
 
 void Curve::setColor(const QColor& new_c) {
   Color = new_c;
+  _paintedCount = 0;
 }
 
 void Curve::setHeadColor(const QColor& new_c) {
   HeadColor = new_c;
+  _paintedCount = 0;
 }
 
 void Curve::setBarFillColor(const QColor &new_c) {
   BarFillColor = new_c;
+  _paintedCount = 0;
 }
 
 double Curve::maxX() const {
@@ -743,7 +763,59 @@ void Curve::updatePaintObjects(const CurveRenderContext& context) {
   _points.clear();
   _filledRects.clear();
   _rects.clear();
+  _paintedCount = 0;
 
+  generatePaintObjects(context, -1);
+}
+
+
+int Curve::paintStyle() const {
+  return (hasLines() ? 1 : 0) | (hasPoints() ? 2 : 0) | (hasHead() ? 4 : 0) | (pointDensity() << 3);
+}
+
+
+static inline bool samePaintedSample(double a, double b) {
+  return a == b || (a != a && b != b);
+}
+
+
+bool Curve::appendPaintObjects(const CurveRenderContext& context) {
+  VectorPtr xv = *_inputVectors.find(XVECTOR);
+  VectorPtr yv = *_inputVectors.find(YVECTOR);
+  if (!xv || !yv || _paintedCount <= 0 || NS <= _paintedCount || paintStyle() != _paintedStyle) {
+    return false;
+  }
+  // bars and error bars depend on every sample; resampled inputs change
+  // everywhere when they grow
+  if (hasBars() || hasXError() || hasYError() || hasXMinusError() || hasYMinusError() ||
+      !xv->isRising() || xv->length() != NS || yv->length() != NS) {
+    return false;
+  }
+  // the old samples have to be where they were, not shifted along or
+  // rewritten
+  if (xv->numShift() != 0 || yv->numShift() != 0 ||
+      NS - xv->numNew() != _paintedCount || NS - yv->numNew() != _paintedCount) {
+    return false;
+  }
+
+  // numNew() isn't reset by everything that rewrites a vector, so make sure
+  // the samples we painted last time still look the same.
+  const int middle = (_paintedCount - 1)/2;
+  const int last = _paintedCount - 1;
+  if (!samePaintedSample(xv->value(0), _paintedX0) || !samePaintedSample(yv->value(0), _paintedY0) ||
+      !samePaintedSample(xv->value(middle), _paintedXM) || !samePaintedSample(yv->value(middle), _paintedYM) ||
+      !samePaintedSample(xv->value(last), _paintedXN) || !samePaintedSample(yv->value(last), _paintedYN)) {
+    return false;
+  }
+
+  generatePaintObjects(context, _paintedLast);
+  return true;
+}
+
+
+// Makes the paint objects of the visible samples, or, from >= 0, adds those
+// of samples from on to the ones already made.
+void Curve::generatePaintObjects(const CurveRenderContext& context, int from) {
   VectorPtr xv = *_inputVectors.find(XVECTOR);
   VectorPtr yv = *_inputVectors.find(YVECTOR);
   if (!xv || !yv) {
@@ -775,12 +847,12 @@ void Curve::updatePaintObjects(const CurveRenderContext& context) {
   int numberOfBarsDrawn = 0;
 #endif
 
-  _width = lineDim(context.painter->window(), lineWidth());
+  _width = lineDim(context.window, lineWidth());
 
   //qDebug() << context.painter->device()->width() << context.painter->device()->logicalDpiX() <<
   //            context.painter->device()->width()/context.painter->device()->logicalDpiX();
 
-  double errorFlagDim = pointDim(context.painter->window());
+  double errorFlagDim = pointDim(context.window);
   if (sampleCount() > 0) {
     int i0, iN;
 
@@ -797,6 +869,14 @@ void Curve::updatePaintObjects(const CurveRenderContext& context) {
       i0 = 0;
       iN = sampleCount() - 1;
     }
+    if (from > i0) {
+      i0 = qMin(from, iN);
+    }
+
+    // resample the inputs over the visible range in one go rather than a
+    // sample at a time.
+    ResampledVector xs(xv, NS, i0, iN + 1);
+    ResampledVector ys(yv, NS, i0, iN + 1);
 
 #ifdef BENCHMARK
     clock_t linesStart = clock();
@@ -814,13 +894,13 @@ void Curve::updatePaintObjects(const CurveRenderContext& context) {
 //            cachegrind backs this up.
 #undef isnan
 #define isnan(x) (x != x)
-      rX = xv->interpolate(i0, NS);
-      rY = yv->interpolate(i0, NS);
+      rX = xs.at(i0);
+      rY = ys.at(i0);
       // if invalid point then look backward for the last valid point.
       while (i0 > 0 && (isnan(rX) || isnan(rY))) {
         --i0;
-        rX = xv->interpolate(i0, NS);
-        rY = yv->interpolate(i0, NS);
+        rX = xs.at(i0);
+        rY = ys.at(i0);
       }
 
       // if invalid point then look forward for the next valid point...
@@ -828,8 +908,8 @@ void Curve::updatePaintObjects(const CurveRenderContext& context) {
         i0 = i0Start;
         while (i0 < iN && (isnan(rX) || isnan(rY))) {
           ++i0;
-          rX = xv->interpolate(i0, NS);
-          rY = yv->interpolate(i0, NS);
+          rX = xs.at(i0);
+          rY = ys.at(i0);
         }
       }
  
@@ -849,8 +929,8 @@ void Curve::updatePaintObjects(const CurveRenderContext& context) {
         Y2 = last_y1;
 
         ++i_pt;
-        rX = xv->interpolate(i_pt, NS);
-        rY = yv->interpolate(i_pt, NS);
+        rX = xs.at(i_pt);
+        rY = ys.at(i_pt);
         bool foundNan = false;
 
         // if necessary continue looking for the first valid point...
@@ -858,8 +938,8 @@ void Curve::updatePaintObjects(const CurveRenderContext& context) {
 #undef isnan
           foundNan = true;
           ++i_pt;
-          rX = xv->interpolate(i_pt, NS);
-          rY = yv->interpolate(i_pt, NS);
+          rX = xs.at(i_pt);
+          rY = ys.at(i_pt);
         }
 
         if (KDE_ISUNLIKELY(foundNan)) {
@@ -1137,6 +1217,10 @@ qDebug() << "y not in bounds"
     VectorPtr eyv = _inputVectors.contains(EYVECTOR) ? *_inputVectors.find(EYVECTOR) : 0;
     VectorPtr exmv = _inputVectors.contains(EXMINUSVECTOR) ? *_inputVectors.find(EXMINUSVECTOR) : 0;
     VectorPtr eymv = _inputVectors.contains(EYMINUSVECTOR) ? *_inputVectors.find(EYMINUSVECTOR) : 0;
+    ResampledVector exs(exv, NS, i0, iN + 1);
+    ResampledVector eys(eyv, NS, i0, iN + 1);
+    ResampledVector exms(exmv, NS, i0, iN + 1);
+    ResampledVector eyms(eymv, NS, i0, iN + 1);
     // draw the bargraph bars, if any...
     if (hasBars()) {
       bool visible = true;
@@ -1153,7 +1237,7 @@ qDebug() << "y not in bounds"
           double oldX = 0.0;
 
           for (i_pt = i0; i_pt <= iN; i_pt++) {
-            rX = xv->interpolate(i_pt, NS);
+            rX = xs.at(i_pt);
             if (i_pt > i0) {
               if (rX - oldX < drX) {
                 drX = rX - oldX;
@@ -1168,10 +1252,10 @@ qDebug() << "y not in bounds"
         visible = true;
 
         if (exv) {
-          drX = exv->interpolate(i_pt, NS);
+          drX = exs.at(i_pt);
         }
-        rX = xv->interpolate(i_pt, NS);
-        rY = yv->interpolate(i_pt, NS);
+        rX = xs.at(i_pt);
+        rY = ys.at(i_pt);
         rX -= drX/2.0;
         rX2 = rX + drX;
         if (xLog) {
@@ -1228,10 +1312,13 @@ qDebug() << "y not in bounds"
 
       QRectF rect(Lx, Ly, w, h);
       QPointF pt, lastPt;
+      if (from >= 0) {
+        lastPt = _lastPoint;
+      }
 
       for (i_pt = i0; i_pt <= iN; ++i_pt) {
-        rX = xv->interpolate(i_pt, NS);
-        rY = yv->interpolate(i_pt, NS);
+        rX = xs.at(i_pt);
+        rY = ys.at(i_pt);
         if (xLog) {
           rX = logXLo(rX, xLogBase);
         }
@@ -1250,6 +1337,7 @@ qDebug() << "y not in bounds"
             _points.append(pt);
         }
       }
+      _lastPoint = lastPt;
     }
 
     _head_valid = false;
@@ -1259,8 +1347,8 @@ qDebug() << "y not in bounds"
 
       QRectF rect(Lx, Ly, w, h);
 
-      rX = xv->interpolate(NS-1, NS);
-      rY = yv->interpolate(NS-1, NS);
+      rX = xs.at(NS-1);
+      rY = ys.at(NS-1);
       if (xLog) {
         rX = logXLo(rX, xLogBase);
       }
@@ -1298,10 +1386,10 @@ qDebug() << "y not in bounds"
         do_low_flag = true;
         do_high_flag = true;
 
-        rX = xv->interpolate(i_pt, NS);
-        rY = yv->interpolate(i_pt, NS);
+        rX = xs.at(i_pt);
+        rY = ys.at(i_pt);
         if (errorSame) {
-          rEX = fabs(exv->interpolate(i_pt, NS));
+          rEX = fabs(exs.at(i_pt));
           if (xLog) {
             rX1 = logXLo(rX - rEX, xLogBase);
             rX2 = logXLo(rX + rEX, xLogBase);
@@ -1310,8 +1398,8 @@ qDebug() << "y not in bounds"
             rX2 = rX + rEX;
           }
         } else if (exv && exmv) {
-          double rEXHi = fabs(exv->interpolate(i_pt, NS));
-          double rEXLo = fabs(exmv->interpolate(i_pt, NS));
+          double rEXHi = fabs(exs.at(i_pt));
+          double rEXLo = fabs(exms.at(i_pt));
           if (xLog) {
             rX1 = logXLo(rX - rEXLo, xLogBase);
             rX2 = logXLo(rX + rEXHi, xLogBase);
@@ -1320,7 +1408,7 @@ qDebug() << "y not in bounds"
             rX2 = rX + rEXHi;
           }
         } else if (exv) {
-          rEX = exv->interpolate(i_pt, NS);
+          rEX = exs.at(i_pt);
           if (xLog) {
             rX1 = logXLo(rX, xLogBase);
             rX2 = logXLo(rX + fabs(rEX), xLogBase);
@@ -1330,7 +1418,7 @@ qDebug() << "y not in bounds"
           }
           do_low_flag = false;
         } else {
-          rEX = fabs(exmv->interpolate(i_pt, NS));
+          rEX = fabs(exms.at(i_pt));
           if (xLog) {
             rX1 = logXLo(rX - rEX, xLogBase);
             rX2 = logXLo(rX, xLogBase);
@@ -1388,10 +1476,10 @@ qDebug() << "y not in bounds"
         do_low_flag = true;
         do_high_flag = true;
 
-        rX = xv->interpolate(i_pt, NS);
-        rY = yv->interpolate(i_pt, NS);
+        rX = xs.at(i_pt);
+        rY = ys.at(i_pt);
         if (errorSame) {
-          rEY = eyv->interpolate(i_pt, NS);
+          rEY = eys.at(i_pt);
           if (yLog) {
             rY1 = logYLo(rY-fabs(rEY), yLogBase);
             rY2 = logYLo(rY+fabs(rEY), yLogBase);
@@ -1400,8 +1488,8 @@ qDebug() << "y not in bounds"
             rY2 = rY+fabs(rEY);
           }
         } else if (eyv && eymv) {
-          double rEYHi = fabs(eyv->interpolate(i_pt, NS));
-          double rEYLo = fabs(eymv->interpolate(i_pt, NS));
+          double rEYHi = fabs(eys.at(i_pt));
+          double rEYLo = fabs(eyms.at(i_pt));
           if (yLog) {
             rY1 = logYLo(rY - rEYLo, yLogBase);
             rY2 = logYLo(rY + rEYHi, yLogBase);
@@ -1410,7 +1498,7 @@ qDebug() << "y not in bounds"
             rY2 = rY + rEYHi;
           }
         } else if (eyv) {
-          rEY = fabs(eyv->interpolate(i_pt, NS));
+          rEY = fabs(eys.at(i_pt));
           if (yLog) {
             rY1 = logYLo(rY, yLogBase);
             rY2 = logYLo(rY + rEY, yLogBase);
@@ -1420,7 +1508,7 @@ qDebug() << "y not in bounds"
           }
           do_low_flag = false;
         } else {
-          rEY = fabs(eymv->interpolate(i_pt, NS));
+          rEY = fabs(eyms.at(i_pt));
           if (yLog) {
             rY1 = logYLo(rY - rEY, yLogBase);
             rY2 = logYLo(rY, yLogBase);
@@ -1459,6 +1547,16 @@ qDebug() << "y not in bounds"
         }
       }
     } // end if (hasYError())
+
+    _paintedCount = NS;
+    _paintedLast = iN;
+    _paintedStyle = paintStyle();
+    _paintedX0 = xv->value(0);
+    _paintedY0 = yv->value(0);
+    _paintedXM = xv->value((NS - 1)/2);
+    _paintedYM = yv->value((NS - 1)/2);
+    _paintedXN = xv->value(NS - 1);
+    _paintedYN = yv->value(NS - 1);
   } // end if (sampleCount() > 0)
 
 #ifdef BENCHMARK
@@ -1507,11 +1605,13 @@ void Curve::yRange(double xFrom, double xTo, double* yMin, double* yMax) {
     iN = sampleCount() - 1;
   }
   // search for min/max
+  ResampledVector xs(xv, NS, i0, iN + 1);
+  ResampledVector ys(yv, NS, i0, iN + 1);
   bool first = true;
   double newYMax = 0, newYMin = 0;
   for (int i_pt = i0; i_pt <= iN; i_pt++) {
-    double rX = xv->interpolate(i_pt, NS);
-    double rY = yv->interpolate(i_pt, NS);
+    double rX = xs.at(i_pt);
+    double rY = ys.at(i_pt);
     // make sure this point is visible
     if (rX >= xFrom && rX <= xTo) {
       // update min/max
@@ -150,6 +150,9 @@ class KSTMATH_EXPORT Curve: public Relation
 
     // Update the curve details.
     void updatePaintObjects(const CurveRenderContext& context);
+    // Only lines, points and heads of a curve with a rising x whose inputs
+    // just grew since the last update are appended.
+    virtual bool appendPaintObjects(const CurveRenderContext& context);
 
     // render the legend symbol for this curve
     virtual QSize legendSymbolSize(QPainter *p);
@@ -215,6 +218,16 @@ class KSTMATH_EXPORT Curve: public Relation
     bool _head_valid;
 
     int _width;
+
+    void generatePaintObjects(const CurveRenderContext& context, int from);
+    int paintStyle() const;
+
+    // what the paint objects were made from, to tell an append
+    int _paintedCount; // samples
+    int _paintedLast; // last sample index made into paint objects
+    int _paintedStyle;
+    double _paintedX0, _paintedY0, _paintedXM, _paintedYM, _paintedXN, _paintedYN;
+    QPointF _lastPoint;
 };
 
 typedef SharedPtr<Curve> CurvePtr;
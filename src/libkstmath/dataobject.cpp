@@ -113,6 +113,8 @@ void DataObject::replaceInput(PrimitivePtr p, PrimitivePtr new_p) {
       }
     }
   }
+  // automatic names follow the inputs
+  touchDescriptiveNames();
 }
 
 PrimitiveList DataObject::inputPrimitives() const {
@@ -142,6 +144,15 @@ PrimitiveList DataObject::inputPrimitives() const {
 }
 
 
+QList<ObjectPtr> DataObject::inputObjects() const {
+  QList<ObjectPtr> inputs;
+  foreach (const PrimitivePtr& primitive, inputPrimitives()) {
+    inputs.append(ObjectPtr(primitive));
+  }
+  return inputs;
+}
+
+
 PrimitiveList DataObject::outputPrimitives(bool include_decendants)  const {
   PrimitiveList primitive_list;
 
@@ -119,6 +119,7 @@ class KSTMATH_EXPORT DataObject : public Object
     virtual void replaceInput(PrimitivePtr p, PrimitivePtr new_p);
 
     virtual bool uses(ObjectPtr p) const;
+    virtual QList<ObjectPtr> inputObjects() const;
 
     //These are generally only valid for plugins...
     const QString& name() const { return _name; }
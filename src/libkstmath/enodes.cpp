@@ -30,8 +30,8 @@
 
 #include "kst_i18n.h"
 
-#include <QMutex>
 #include <QRegExp>
+#include <QVarLengthArray>
 
 #include "datacollection.h"
 #include "debug.h"
@@ -39,64 +39,64 @@
 #include "objectstore.h"
 #include "doublecompare.h"
 
-KSTMATH_EXPORT int yyparse(Kst::ObjectStore *store);
-KSTMATH_EXPORT extern void *ParsedEquation;
-KSTMATH_EXPORT/*"C"*/ struct yy_buffer_state *yy_scan_string(const char*);
-KSTMATH_EXPORT struct yy_buffer_state *yy_scan_bytes(const char*, int);
-typedef struct yy_buffer_state *YY_BUFFER_STATE;
-KSTMATH_EXPORT void yy_delete_buffer(YY_BUFFER_STATE);
+#include "eparse-eh.h"
 
 using namespace Equations;
 using namespace Kst;
 
-static QMutex _mutex;
+Node *Equations::parse(ObjectStore *store, const char *txt, int len, QStringList *errors) {
+  if (!txt || !*txt) {
+    return 0L;
+  }
 
-QMutex& Equations::mutex() {
-  return _mutex;
+  ParseState state(txt, len > 0 ? len : int(strlen(txt)));
+  const int rc = yyparse(store, &state);
+  if (errors) {
+    *errors = state.errors;
+  }
+  return rc == 0 ? static_cast<Equations::Node*>(state.result) : 0L;
 }
 
 
-double Equations::interpret(ObjectStore *store, const char *txt, bool *ok, int len) {
-  if (!txt || !*txt) {
-    if (ok) {
-      *ok = false;
-    }
-    return 0.0;
-  }
-
-  mutex().lock();
-  YY_BUFFER_STATE b;
-  if (len > 0) {
-    b = yy_scan_bytes(txt, len);
-  } else {
-    b = yy_scan_string(txt);
-  }
-  int rc = yyparse(store);
-  yy_delete_buffer(b);
-  if (rc == 0) {
-    Equations::Node *eq = static_cast<Equations::Node*>(ParsedEquation);
-    ParsedEquation = 0L;
-    mutex().unlock();
+Node *Equations::compile(ObjectStore *store, const char *txt, int len) {
+  Equations::Node *eq = parse(store, txt, len);
+  if (eq) {
     Equations::Context ctx;
     ctx.sampleCount = 2;
     ctx.noPoint = Kst::NOPOINT;
     ctx.x = 0.0;
     ctx.xVector = 0L;
     Equations::FoldVisitor vis(&ctx, &eq);
-    double v = eq->value(&ctx);
-    delete eq;
-    if (ok) {
-      *ok = true;
-    }
-    return v;
-  } else {
-    ParsedEquation = 0L;
-    mutex().unlock();
+  }
+  return eq;
+}
+
+
+double Equations::evaluate(Node *eq) {
+  Equations::Context ctx;
+  ctx.sampleCount = 2;
+  ctx.noPoint = Kst::NOPOINT;
+  ctx.x = 0.0;
+  ctx.xVector = 0L;
+  return eq->value(&ctx);
+}
+
+
+double Equations::interpret(ObjectStore *store, const char *txt, bool *ok, int len) {
+  Equations::Node *eq = compile(store, txt, len);
+  if (!eq) {
     if (ok) {
       *ok = false;
     }
     return 0.0;
   }
+
+  double v = evaluate(eq);
+  delete eq;
+  if (ok) {
+    *ok = true;
+  }
+  return v;
 }
 
 
@@ -119,6 +119,15 @@ bool Node::takeVectors(const Kst::VectorMap&) {
 }
 
 
+void Node::values(Context *ctx, int n, double *out) {
+  const long i = ctx->i;
+  for (int k = 0; k < n; ++k, ++ctx->i) {
+    out[k] = value(ctx);
+  }
+  ctx->i = i;
+}
+
+
 void Node::visit(NodeVisitor* v) {
   v->visitNode(this);
 }
@@ -131,6 +140,15 @@ Kst::Object::UpdateType Node::update(Context *ctx) {
 
 
 /////////////////////////////////////////////////////////////////
+// The right operand of a block; blocks up to its size stay on the stack.
+typedef QVarLengthArray<double, 256> BlockOperand;
+
+static inline void blockOperands(Node *left, Node *right, Context *ctx, int n, double *l, double *r) {
+  left->values(ctx, n, l);
+  right->values(ctx, n, r);
+}
+
+
 BinaryNode::BinaryNode(Node *left, Node *right)
 : Node(), _left(left), _right(right) {
 }
@@ -198,6 +216,15 @@ double Addition::value(Context *ctx) {
 }
 
 
+void Addition::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = out[k] + right[k];
+  }
+}
+
+
 bool Addition::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -228,6 +255,15 @@ double Subtraction::value(Context *ctx) {
 }
 
 
+void Subtraction::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = out[k] - right[k];
+  }
+}
+
+
 bool Subtraction::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -258,6 +294,15 @@ double Multiplication::value(Context *ctx) {
 }
 
 
+void Multiplication::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = out[k] * right[k];
+  }
+}
+
+
 bool Multiplication::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -288,6 +333,15 @@ double Division::value(Context *ctx) {
 }
 
 
+void Division::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = out[k] / right[k];
+  }
+}
+
+
 bool Division::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -318,6 +372,15 @@ double Modulo::value(Context *ctx) {
 }
 
 
+void Modulo::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = fmod(out[k], right[k]);
+  }
+}
+
+
 bool Modulo::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -348,6 +411,15 @@ double Power::value(Context *ctx) {
 }
 
 
+void Power::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = pow(out[k], right[k]);
+  }
+}
+
+
 bool Power::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -701,6 +773,14 @@ double Identifier::value(Context *ctx) {
 }
 
 
+void Identifier::values(Context *ctx, int n, double *out) {
+  const double v = value(ctx);
+  for (int k = 0; k < n; ++k) {
+    out[k] = v;
+  }
+}
+
+
 bool Identifier::isConst() {
   return _const != 0L || !(_name[0] == 'x' && _name[1] == 0);
 }
@@ -757,23 +837,9 @@ DataNode::~DataNode() {
 double DataNode::value(Context *ctx) {
   if (_isEquation) {
     if (!_equation) {
-      mutex().lock();
-      YY_BUFFER_STATE b = yy_scan_bytes(_tagName.toLatin1(), _tagName.length());
-      int rc = yyparse(_store);
-      yy_delete_buffer(b);
-      if (rc == 0 && ParsedEquation) {
-        _equation = static_cast<Equations::Node*>(ParsedEquation);
-        ParsedEquation = 0L;
-        mutex().unlock();
-        Equations::Context ctx;
-        ctx.sampleCount = 2;
-        ctx.noPoint = Kst::NOPOINT;
-        ctx.x = 0.0;
-        ctx.xVector = 0L;
-        Equations::FoldVisitor vis(&ctx, &_equation);
-      } else {
-        ParsedEquation = 0L;
-        mutex().unlock();
+      const QByteArray text = _tagName.toLatin1();
+      _equation = compile(_store, text.constData(), text.length());
+      if (!_equation) {
         _isEquation = false;
         return ctx->noPoint;
       }
@@ -781,23 +847,9 @@ double DataNode::value(Context *ctx) {
     return _equation->value(ctx);
   } else if (_vector) {
     if (!_equation && !_vectorIndex.isEmpty()) {
-      mutex().lock();
-      YY_BUFFER_STATE b = yy_scan_bytes(_vectorIndex.toLatin1(), _vectorIndex.length());
-      int rc = yyparse(_store);
-      yy_delete_buffer(b);
-      if (rc == 0 && ParsedEquation) {
-        _equation = static_cast<Equations::Node*>(ParsedEquation);
-        ParsedEquation = 0L;
-        mutex().unlock();
-        Equations::Context ctx;
-        ctx.sampleCount = 2;
-        ctx.noPoint = Kst::NOPOINT;
-        ctx.x = 0.0;
-        ctx.xVector = 0L;
-        Equations::FoldVisitor vis(&ctx, &_equation);
-      } else {
-        ParsedEquation = 0L;
-        mutex().unlock();
+      const QByteArray text = _vectorIndex.toLatin1();
+      _equation = compile(_store, text.constData(), text.length());
+      if (!_equation) {
         _vectorIndex.clear();
         _vector = 0L;
         return ctx->noPoint;
@@ -816,6 +868,20 @@ double DataNode::value(Context *ctx) {
 }
 
 
+void DataNode::values(Context *ctx, int n, double *out) {
+  if (_vector && !_isEquation && _vectorIndex.isEmpty() && _vector->length() > 0) {
+    kstInterpolateRange(_vector->value(), _vector->length(), int(ctx->sampleCount), int(ctx->i), int(ctx->i) + n, out);
+  } else if (_scalar && !_isEquation) {
+    const double v = _scalar->value();
+    for (int k = 0; k < n; ++k) {
+      out[k] = v;
+    }
+  } else {
+    Node::values(ctx, n, out);
+  }
+}
+
+
 bool DataNode::isConst() {
   return (_isEquation && _equation) ? _equation->isConst() : false;
 }
@@ -906,6 +972,13 @@ double Number::value(Context*) {
 }
 
 
+void Number::values(Context*, int n, double *out) {
+  for (int k = 0; k < n; ++k) {
+    out[k] = _n;
+  }
+}
+
+
 bool Number::isConst() {
   return true;
 }
@@ -938,6 +1011,15 @@ double Negation::value(Context *ctx) {
   return (v == v) ? -v : v;
 }
 
+
+void Negation::values(Context *ctx, int n, double *out) {
+  _n->values(ctx, n, out);
+  for (int k = 0; k < n; ++k) {
+    const double v = out[k];
+    out[k] = (v == v) ? -v : v;
+  }
+}
+
 bool Negation::collectObjects(Kst::VectorMap& v, Kst::ScalarMap& s, Kst::StringMap& t) {
   bool ok = _n->collectObjects(v, s, t);
   return ok;
@@ -978,6 +1060,15 @@ double LogicalNot::value(Context *ctx) {
 }
 
 
+void LogicalNot::values(Context *ctx, int n, double *out) {
+  _n->values(ctx, n, out);
+  for (int k = 0; k < n; ++k) {
+    const double v = out[k];
+    out[k] = (v == v) ? (v == 0.0) : 1.0;
+  }
+}
+
+
 bool LogicalNot::isConst() {
   return _n->isConst();
 }
@@ -1008,6 +1099,15 @@ double BitwiseAnd::value(Context *ctx) {
 }
 
 
+void BitwiseAnd::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = long(out[k]) & long(right[k]);
+  }
+}
+
+
 bool BitwiseAnd::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -1038,6 +1138,15 @@ double BitwiseOr::value(Context *ctx) {
 }
 
 
+void BitwiseOr::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = long(out[k]) | long(right[k]);
+  }
+}
+
+
 bool BitwiseOr::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -1068,6 +1177,15 @@ double LogicalAnd::value(Context *ctx) {
 }
 
 
+void LogicalAnd::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = (out[k] && right[k]) ? EQ_TRUE : EQ_FALSE;
+  }
+}
+
+
 bool LogicalAnd::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -1098,6 +1216,15 @@ double LogicalOr::value(Context *ctx) {
 }
 
 
+void LogicalOr::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = (out[k] || right[k]) ? EQ_TRUE : EQ_FALSE;
+  }
+}
+
+
 bool LogicalOr::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -1128,6 +1255,15 @@ double LessThan::value(Context *ctx) {
 }
 
 
+void LessThan::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = doubleLessThan(out[k], right[k]) ? EQ_TRUE : EQ_FALSE;
+  }
+}
+
+
 bool LessThan::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -1158,6 +1294,15 @@ double LessThanEqual::value(Context *ctx) {
 }
 
 
+void LessThanEqual::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = doubleLessThanEqual(out[k], right[k]) ? EQ_TRUE : EQ_FALSE;
+  }
+}
+
+
 bool LessThanEqual::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -1188,6 +1333,15 @@ double GreaterThan::value(Context *ctx) {
 }
 
 
+void GreaterThan::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = doubleGreaterThan(out[k], right[k]) ? EQ_TRUE : EQ_FALSE;
+  }
+}
+
+
 bool GreaterThan::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -1218,6 +1372,15 @@ double GreaterThanEqual::value(Context *ctx) {
 }
 
 
+void GreaterThanEqual::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = doubleGreaterThanEqual(out[k], right[k]) ? EQ_TRUE : EQ_FALSE;
+  }
+}
+
+
 bool GreaterThanEqual::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -1248,6 +1411,15 @@ double EqualTo::value(Context *ctx) {
 }
 
 
+void EqualTo::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = doubleEqual(out[k], right[k]) ? EQ_TRUE : EQ_FALSE;
+  }
+}
+
+
 bool EqualTo::isConst() {
   return _left->isConst() && _right->isConst();
 }
@@ -1278,6 +1450,15 @@ double NotEqualTo::value(Context *ctx) {
 }
 
 
+void NotEqualTo::values(Context *ctx, int n, double *out) {
+  BlockOperand right(n);
+  blockOperands(_left, _right, ctx, n, out, right.data());
+  for (int k = 0; k < n; ++k) {
+    out[k] = (!doubleEqual(out[k], right[k])) ? EQ_TRUE : EQ_FALSE;
+  }
+}
+
+
 bool NotEqualTo::isConst() {
   return _left->isConst() && _right->isConst();
 }
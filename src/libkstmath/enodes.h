@@ -28,14 +28,26 @@
 
 namespace Equations {
 
-  /* Global lock for the parser */
-  KSTMATH_EXPORT QMutex& mutex();
-
   /*    Evaluate the expression @p txt and returns the value as a double.
    *    Returns the value, or 0.0 and sets ok = false on error.
    */
   KSTMATH_EXPORT double interpret(Kst::ObjectStore *store, const char *txt, bool *ok = 0L, int len = -1);
 
+  class Node;
+
+  /*    Parse the expression @p txt.  Returns the tree as written, not folded,
+   *    or 0L if it doesn't parse; then errors, if given, gets the messages.
+   *    The caller owns the tree.  Parses keep no global state, so they can
+   *    run in any number of threads at once.
+   */
+  KSTMATH_EXPORT Node *parse(Kst::ObjectStore *store, const char *txt, int len = -1, QStringList *errors = 0L);
+
+  /*    Parse the expression @p txt once, for evaluating many times with
+   *    evaluate().  Returns 0L if it doesn't parse; the caller owns the tree.
+   */
+  KSTMATH_EXPORT Node *compile(Kst::ObjectStore *store, const char *txt, int len = -1);
+  KSTMATH_EXPORT double evaluate(Node *eq);
+
   class KSTMATH_EXPORT Context 
   {
     public:
@@ -60,6 +72,11 @@ namespace Equations {
       virtual bool collectObjects(Kst::VectorMap& v, Kst::ScalarMap& s, Kst::StringMap& t);
       virtual bool takeVectors(const Kst::VectorMap& c);
       virtual double value(Context*) = 0;
+      /* Evaluates samples ctx->i to ctx->i + n - 1 into out, with ctx->x the
+       * same for all of them, and leaves ctx->i as it was.  The default calls
+       * value() for each sample; the common nodes work through the block.
+       */
+      virtual void values(Context *ctx, int n, double *out);
       virtual void visit(NodeVisitor*);
       virtual Kst::Object::UpdateType update(Context *ctx);
       virtual QString text() const = 0;
@@ -151,6 +168,7 @@ namespace Equations {
 
       bool isConst();
       double value(Context*);
+      void values(Context *ctx, int n, double *out);
       QString text() const;
 
     protected:
@@ -166,6 +184,7 @@ namespace Equations {
 
       bool isConst();
       double value(Context*);
+      void values(Context *ctx, int n, double *out);
       const char *name() const;
       QString text() const;
 
@@ -183,6 +202,7 @@ namespace Equations {
 
       bool isConst();
       double value(Context*);
+      void values(Context *ctx, int n, double *out);
       bool collectObjects(Kst::VectorMap& v, Kst::ScalarMap& s, Kst::StringMap& t);
       bool takeVectors(const Kst::VectorMap& c);
       Kst::Object::UpdateType update(Context *ctx);
@@ -227,6 +247,7 @@ namespace Equations {
       ~Negation();
       bool isConst();
       double value(Context*);
+      void values(Context *ctx, int n, double *out);
       QString text() const;
       bool collectObjects(Kst::VectorMap& v, Kst::ScalarMap& s, Kst::StringMap& t);
 
@@ -240,6 +261,7 @@ namespace Equations {
       ~LogicalNot();
       bool isConst();
       double value(Context*);
+      void values(Context *ctx, int n, double *out);
       QString text() const;
 
     protected:
@@ -253,6 +275,7 @@ namespace Equations {
       ~x();                               \
       bool isConst();                     \
       double value(Context*);             \
+      void values(Context*, int, double*); \
       QString text() const;               \
   };
 
@@ -22,8 +22,10 @@
 #include "kstmath_export.h"
 #include "objectstore.h"
 
-namespace Equations {
-  KSTMATH_EXPORT QStringList errorStack;
+#include "eparse-eh.h"
+
+Equations::ParseState::ParseState(const char *txt, int len)
+  : pos(txt), end(txt + len), result(0L) {
 }
 
 /*extern "C"*/ const char *EParseErrorEmpty = I18N_NOOP("Equations is empty.");
@@ -36,23 +38,13 @@ namespace Equations {
 /*extern "C"*/ const char *EParseErrorToken = I18N_NOOP("Unknown character '%1'.");
 
 
-/*extern "C"*/ void yyClearErrors() {
-  Equations::errorStack.clear();
-}
-
-
-/*extern "C"*/ int yyErrorCount() {
-  return Equations::errorStack.count();
-}
-
-
-/*extern "C"*/ void yyerror(Kst::ObjectStore *store, const char *s) {
+/*extern "C"*/ void yyerror(Kst::ObjectStore *store, Equations::ParseState *state, const char *s) {
   Q_UNUSED(store)
-  Equations::errorStack << i18n(s);
+  state->errors << i18n(s);
 }
 
-/*extern "C"*/ void yyerrortoken(char c) {
-  Equations::errorStack << i18n(EParseErrorToken).arg(c);
+/*extern "C"*/ void yyerrortoken(Equations::ParseState *state, char c) {
+  state->errors << i18n(EParseErrorToken).arg(c);
 }
 
 // vim: ts=2 sw=2 et
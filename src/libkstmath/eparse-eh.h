@@ -15,46 +15,46 @@
  *                                                                         *
  ***************************************************************************/
 
-/* This file must be C-clean */
-
 #ifndef EPARSEEH_H
 #define EPARSEEH_H
 
-#ifdef __cplusplus
-
 #include "kstmath_export.h"
 #include <QStringList>
 
-namespace Equations {
-   KSTMATH_EXPORT extern QStringList errorStack;
-}
-
 namespace Kst {
   class ObjectStore;
 }
 
-#endif
+union YYSTYPE;
 
-#ifdef __cplusplus
-//extern "C" {
-#endif
-  void yyerror(Kst::ObjectStore *store, const char *s);
-  void yyerrortoken(char c);
-
-  void yyClearErrors();
-
-  int yyErrorCount();
-
-  extern const char *EParseErrorEmpty;
-  extern const char *EParseErrorEmptyArg;
-  extern const char *EParseErrorTwoOperands;
-  extern const char *EParseErrorEmptyParentheses;
-  extern const char *EParseErrorMissingClosingParenthesis;
-  extern const char *EParseErrorNoImplicitMultiply;
-  extern const char *EParseErrorRequiresOperand;
-#ifdef __cplusplus
-//}
-#endif
+namespace Equations {
+  /*  The state of one parse: where the scanner is in the text, the errors
+   *  found so far and the tree built.  Every parse has its own, so any
+   *  number of them can run at once.
+   */
+  struct ParseState {
+    ParseState(const char *txt, int len);
+
+    const char *pos;
+    const char *end;
+    QStringList errors;
+    void *result;
+  };
+}
+
+int yylex(YYSTYPE *lval, Kst::ObjectStore *store, Equations::ParseState *state);
+int yyparse(Kst::ObjectStore *store, Equations::ParseState *state);
+
+void yyerror(Kst::ObjectStore *store, Equations::ParseState *state, const char *s);
+void yyerrortoken(Equations::ParseState *state, char c);
+
+extern const char *EParseErrorEmpty;
+extern const char *EParseErrorEmptyArg;
+extern const char *EParseErrorTwoOperands;
+extern const char *EParseErrorEmptyParentheses;
+extern const char *EParseErrorMissingClosingParenthesis;
+extern const char *EParseErrorNoImplicitMultiply;
+extern const char *EParseErrorRequiresOperand;
 
 #endif
 
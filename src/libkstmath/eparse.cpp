@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton implementation for Bison's Yacc-like parsers in C
+/* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -36,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -43,88 +45,29 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "2.3"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
-
-/* Using locations.  */
-#define YYLSP_NEEDED 0
-
-
-
-/* Tokens.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     T_NUMBER = 258,
-     T_IDENTIFIER = 259,
-     T_DATA = 260,
-     T_OPENPAR = 261,
-     T_CLOSEPAR = 262,
-     T_COMMA = 263,
-     T_INVALID = 264,
-     T_LOR = 265,
-     T_LAND = 266,
-     T_OR = 267,
-     T_AND = 268,
-     T_NE = 269,
-     T_EQ = 270,
-     T_GE = 271,
-     T_GT = 272,
-     T_LE = 273,
-     T_LT = 274,
-     T_SUBTRACT = 275,
-     T_ADD = 276,
-     T_MOD = 277,
-     T_DIVIDE = 278,
-     T_MULTIPLY = 279,
-     T_NOT = 280,
-     U_SUBTRACT = 281,
-     T_EXP = 282
-   };
-#endif
-/* Tokens.  */
-#define T_NUMBER 258
-#define T_IDENTIFIER 259
-#define T_DATA 260
-#define T_OPENPAR 261
-#define T_CLOSEPAR 262
-#define T_COMMA 263
-#define T_INVALID 264
-#define T_LOR 265
-#define T_LAND 266
-#define T_OR 267
-#define T_AND 268
-#define T_NE 269
-#define T_EQ 270
-#define T_GE 271
-#define T_GT 272
-#define T_LE 273
-#define T_LT 274
-#define T_SUBTRACT 275
-#define T_ADD 276
-#define T_MOD 277
-#define T_DIVIDE 278
-#define T_MULTIPLY 279
-#define T_NOT 280
-#define U_SUBTRACT 281
-#define T_EXP 282
-
-
-
-
-/* Copy the first part of user declarations.  */
-#line 2 "../../../src/libkstmath/eparse.y"
+#define YYPURE 2
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 2 "eparse.y"
 
 #include <assert.h>
 #include <stdlib.h>
@@ -135,83 +78,172 @@
 #include "enodefactory.h"
 
 #include "eparse-eh.h"
-extern int yylex(Kst::ObjectStore *store);
-KSTMATH_EXPORT void *ParsedEquation = 0L;
 
 
+#line 84 "eparse.cpp"
 
-/* Enabling traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
-
-/* Enabling the token table.  */
-#ifndef YYTOKEN_TABLE
-# define YYTOKEN_TABLE 0
-#endif
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
 
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-#line 20 "../../../src/libkstmath/eparse.y"
+#include "eparse.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-		char *data;
-		double number;
-		void *n; /* tree node */
-		char character;
-	   }
-/* Line 193 of yacc.c.  */
-#line 172 "eparse.tab.c"
-	YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
-# define YYSTYPE_IS_TRIVIAL 1
-#endif
-
-
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_T_NUMBER = 3,                   /* T_NUMBER  */
+  YYSYMBOL_T_IDENTIFIER = 4,               /* T_IDENTIFIER  */
+  YYSYMBOL_T_DATA = 5,                     /* T_DATA  */
+  YYSYMBOL_T_OPENPAR = 6,                  /* T_OPENPAR  */
+  YYSYMBOL_T_CLOSEPAR = 7,                 /* T_CLOSEPAR  */
+  YYSYMBOL_T_COMMA = 8,                    /* T_COMMA  */
+  YYSYMBOL_T_INVALID = 9,                  /* T_INVALID  */
+  YYSYMBOL_T_LOR = 10,                     /* T_LOR  */
+  YYSYMBOL_T_LAND = 11,                    /* T_LAND  */
+  YYSYMBOL_T_OR = 12,                      /* T_OR  */
+  YYSYMBOL_T_AND = 13,                     /* T_AND  */
+  YYSYMBOL_T_EQ = 14,                      /* T_EQ  */
+  YYSYMBOL_T_NE = 15,                      /* T_NE  */
+  YYSYMBOL_T_LT = 16,                      /* T_LT  */
+  YYSYMBOL_T_LE = 17,                      /* T_LE  */
+  YYSYMBOL_T_GT = 18,                      /* T_GT  */
+  YYSYMBOL_T_GE = 19,                      /* T_GE  */
+  YYSYMBOL_T_ADD = 20,                     /* T_ADD  */
+  YYSYMBOL_T_SUBTRACT = 21,                /* T_SUBTRACT  */
+  YYSYMBOL_T_MULTIPLY = 22,                /* T_MULTIPLY  */
+  YYSYMBOL_T_DIVIDE = 23,                  /* T_DIVIDE  */
+  YYSYMBOL_T_MOD = 24,                     /* T_MOD  */
+  YYSYMBOL_T_NOT = 25,                     /* T_NOT  */
+  YYSYMBOL_U_SUBTRACT = 26,                /* U_SUBTRACT  */
+  YYSYMBOL_T_EXP = 27,                     /* T_EXP  */
+  YYSYMBOL_YYACCEPT = 28,                  /* $accept  */
+  YYSYMBOL_WRAPPER = 29,                   /* WRAPPER  */
+  YYSYMBOL_30_1 = 30,                      /* @1  */
+  YYSYMBOL_PRESTART = 31,                  /* PRESTART  */
+  YYSYMBOL_START = 32,                     /* START  */
+  YYSYMBOL_BOOLEAN_OR = 33,                /* BOOLEAN_OR  */
+  YYSYMBOL_BOOLEAN_AND = 34,               /* BOOLEAN_AND  */
+  YYSYMBOL_COMPARISON = 35,                /* COMPARISON  */
+  YYSYMBOL_EQUATION = 36,                  /* EQUATION  */
+  YYSYMBOL_TERM = 37,                      /* TERM  */
+  YYSYMBOL_NEG = 38,                       /* NEG  */
+  YYSYMBOL_EXP = 39,                       /* EXP  */
+  YYSYMBOL_ATOMIC = 40,                    /* ATOMIC  */
+  YYSYMBOL_ARGUMENTS = 41,                 /* ARGUMENTS  */
+  YYSYMBOL_ARGLIST = 42,                   /* ARGLIST  */
+  YYSYMBOL_43_2 = 43,                      /* $@2  */
+  YYSYMBOL_ARGUMENT = 44                   /* ARGUMENT  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-/* Copy the second part of user declarations.  */
 
 
-/* Line 216 of yacc.c.  */
-#line 185 "eparse.tab.c"
 
 #ifdef short
 # undef short
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
-#else
-typedef unsigned char yytype_uint8;
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#elif (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
 typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef short int yytype_int8;
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -219,55 +251,106 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
-# if YYENABLE_NLS
+# if defined YYENABLE_NLS && YYENABLE_NLS
 #  if ENABLE_NLS
 #   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
-#   define YY_(msgid) dgettext ("bison-runtime", msgid)
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
 #  endif
 # endif
 # ifndef YY_
-#  define YY_(msgid) msgid
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(e) ((void) (e))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(e) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-/* Identity function, used to suppress warnings about constant conditions.  */
-#ifndef lint
-# define YYID(n) (n)
-#else
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static int
-YYID (int i)
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
 #else
-static int
-YYID (i)
-    int i;
+# define YY_INITIAL_VALUE(Value) Value
 #endif
-{
-  return i;
-}
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -284,11 +367,11 @@ YYID (i)
 #    define alloca _alloca
 #   else
 #    define YYSTACK_ALLOC alloca
-#    if ! defined _ALLOCA_H && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
 #     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#     ifndef _STDLIB_H
-#      define _STDLIB_H 1
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
 #     endif
 #    endif
 #   endif
@@ -296,8 +379,8 @@ YYID (i)
 # endif
 
 # ifdef YYSTACK_ALLOC
-   /* Pacify GCC's `empty if-body' warning.  */
-#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (YYID (0))
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
     /* The OS might guarantee only one guard page at the bottom of the stack,
        and a page size can be as small as 4096 bytes.  So we cannot safely
@@ -311,92 +394,93 @@ YYID (i)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
 #   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
 #  endif
-#  if (defined __cplusplus && ! defined _STDLIB_H \
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
        && ! ((defined YYMALLOC || defined malloc) \
-	     && (defined YYFREE || defined free)))
+             && (defined YYFREE || defined free)))
 #   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#   ifndef _STDLIB_H
-#    define _STDLIB_H 1
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
 #   endif
 #  endif
 #  ifndef YYMALLOC
 #   define YYMALLOC malloc
-#   if ! defined malloc && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined malloc && ! defined EXIT_SUCCESS
 void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 #  ifndef YYFREE
 #   define YYFREE free
-#   if ! defined free && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined free && ! defined EXIT_SUCCESS
 void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
-	 || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
 
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss;
-  YYSTYPE yyvs;
-  };
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
       + YYSTACK_GAP_MAXIMUM)
 
-/* Copy COUNT objects from FROM to TO.  The source and destination do
-   not overlap.  */
-# ifndef YYCOPY
-#  if defined __GNUC__ && 1 < __GNUC__
-#   define YYCOPY(To, From, Count) \
-      __builtin_memcpy (To, From, (Count) * sizeof (*(From)))
-#  else
-#   define YYCOPY(To, From, Count)		\
-      do					\
-	{					\
-	  YYSIZE_T yyi;				\
-	  for (yyi = 0; yyi < (Count); yyi++)	\
-	    (To)[yyi] = (From)[yyi];		\
-	}					\
-      while (YYID (0))
-#  endif
-# endif
+# define YYCOPY_NEEDED 1
 
 /* Relocate STACK from its old location to the new one.  The
    local variables YYSIZE and YYSTACKSIZE give the old and new number of
    elements in the stack, and YYPTR gives the new location of the
    stack.  Advance YYPTR to a properly aligned location for the next
    stack.  */
-# define YYSTACK_RELOCATE(Stack)					\
-    do									\
-      {									\
-	YYSIZE_T yynewbytes;						\
-	YYCOPY (&yyptr->Stack, Stack, yysize);				\
-	Stack = &yyptr->Stack;						\
-	yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-	yyptr += yynewbytes / sizeof (*yyptr);				\
-      }									\
-    while (YYID (0))
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
 
 #endif
 
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  3
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   360
+#define YYLAST   359
 
 /* YYNTOKENS -- Number of terminals.  */
 #define YYNTOKENS  28
@@ -404,18 +488,23 @@ union yyalloc
 #define YYNNTS  17
 /* YYNRULES -- Number of rules.  */
 #define YYNRULES  68
-/* YYNRULES -- Number of states.  */
+/* YYNSTATES -- Number of states.  */
 #define YYNSTATES  106
 
-/* YYTRANSLATE(YYLEX) -- Bison symbol number corresponding to YYLEX.  */
-#define YYUNDEFTOK  2
+/* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   282
 
-#define YYTRANSLATE(YYX)						\
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
 
-/* YYTRANSLATE[YYLEX] -- Bison symbol number corresponding to YYLEX.  */
-static const yytype_uint8 yytranslate[] =
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -449,164 +538,110 @@ static const yytype_uint8 yytranslate[] =
 };
 
 #if YYDEBUG
-/* YYPRHS[YYN] -- Index of the first RHS symbol of rule number YYN in
-   YYRHS.  */
-static const yytype_uint8 yyprhs[] =
-{
-       0,     0,     3,     4,     7,     9,    10,    12,    16,    19,
-      21,    25,    28,    30,    34,    38,    42,    46,    50,    54,
-      57,    60,    63,    66,    69,    72,    74,    78,    82,    86,
-      90,    92,    95,    98,   102,   106,   110,   113,   116,   119,
-     121,   124,   127,   130,   132,   136,   140,   143,   146,   148,
-     152,   155,   157,   159,   164,   168,   174,   179,   183,   185,
-     188,   190,   193,   195,   199,   201,   205,   206,   210
-};
-
-/* YYRHS -- A `-1'-separated list of the rules' RHS.  */
-static const yytype_int8 yyrhs[] =
-{
-      29,     0,    -1,    -1,    30,    31,    -1,    32,    -1,    -1,
-      33,    -1,    33,    10,    34,    -1,    10,     1,    -1,    34,
-      -1,    34,    11,    35,    -1,    11,     1,    -1,    35,    -1,
-      35,    19,    36,    -1,    35,    18,    36,    -1,    35,    17,
-      36,    -1,    35,    16,    36,    -1,    35,    15,    36,    -1,
-      35,    14,    36,    -1,    19,     1,    -1,    17,     1,    -1,
-      18,     1,    -1,    16,     1,    -1,    15,     1,    -1,    14,
-       1,    -1,    36,    -1,    36,    21,    37,    -1,    36,    20,
-      37,    -1,    36,    12,    37,    -1,    36,    13,    37,    -1,
-      37,    -1,    12,     1,    -1,    13,     1,    -1,    37,    24,
-      38,    -1,    37,    23,    38,    -1,    37,    22,    38,    -1,
-      24,     1,    -1,    23,     1,    -1,    22,     1,    -1,    38,
-      -1,    20,    38,    -1,    25,    38,    -1,    25,     1,    -1,
-      39,    -1,    39,    27,    39,    -1,    39,    27,     1,    -1,
-      39,    27,    -1,    27,     1,    -1,    40,    -1,     6,    33,
-       7,    -1,     6,     1,    -1,     4,    -1,     5,    -1,     4,
-       6,     7,     1,    -1,     4,     6,     7,    -1,     4,     6,
-      41,     7,     1,    -1,     4,     6,    41,     7,    -1,     4,
-       6,     1,    -1,     3,    -1,     3,     1,    -1,     9,    -1,
-       6,     7,    -1,    42,    -1,    42,     8,    44,    -1,    44,
-      -1,    42,     8,     1,    -1,    -1,    43,     8,    44,    -1,
-      32,    -1
-};
-
-/* YYRLINE[YYN] -- source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint8 yyrline[] =
 {
-       0,    46,    46,    46,    57,    60,    63,    67,    69,    71,
-      75,    77,    79,    83,    85,    87,    89,    91,    93,    95,
-      97,    99,   101,   103,   105,   107,   111,   113,   115,   117,
-     119,   121,   123,   127,   129,   131,   133,   135,   137,   139,
-     143,   145,   147,   149,   153,   155,   157,   159,   161,   165,
-     167,   169,   171,   173,   175,   180,   182,   184,   186,   188,
-     190,   192,   196,   200,   202,   204,   206,   206,   210
+       0,    54,    54,    54,    65,    68,    71,    75,    77,    79,
+      83,    85,    87,    91,    93,    95,    97,    99,   101,   103,
+     105,   107,   109,   111,   113,   115,   119,   121,   123,   125,
+     127,   129,   131,   135,   137,   139,   141,   143,   145,   147,
+     151,   153,   155,   157,   161,   163,   165,   167,   169,   173,
+     175,   177,   179,   181,   183,   188,   190,   192,   194,   196,
+     198,   200,   204,   208,   210,   212,   214,   214,   218
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || YYTOKEN_TABLE
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "T_NUMBER", "T_IDENTIFIER", "T_DATA",
-  "T_OPENPAR", "T_CLOSEPAR", "T_COMMA", "T_INVALID", "T_LOR", "T_LAND",
-  "T_OR", "T_AND", "T_NE", "T_EQ", "T_GE", "T_GT", "T_LE", "T_LT",
-  "T_SUBTRACT", "T_ADD", "T_MOD", "T_DIVIDE", "T_MULTIPLY", "T_NOT",
-  "U_SUBTRACT", "T_EXP", "$accept", "WRAPPER", "@1", "PRESTART", "START",
-  "BOOLEAN_OR", "BOOLEAN_AND", "COMPARISON", "EQUATION", "TERM", "NEG",
-  "EXP", "ATOMIC", "ARGUMENTS", "ARGLIST", "@2", "ARGUMENT", 0
+  "\"end of file\"", "error", "\"invalid token\"", "T_NUMBER",
+  "T_IDENTIFIER", "T_DATA", "T_OPENPAR", "T_CLOSEPAR", "T_COMMA",
+  "T_INVALID", "T_LOR", "T_LAND", "T_OR", "T_AND", "T_EQ", "T_NE", "T_LT",
+  "T_LE", "T_GT", "T_GE", "T_ADD", "T_SUBTRACT", "T_MULTIPLY", "T_DIVIDE",
+  "T_MOD", "T_NOT", "U_SUBTRACT", "T_EXP", "$accept", "WRAPPER", "@1",
+  "PRESTART", "START", "BOOLEAN_OR", "BOOLEAN_AND", "COMPARISON",
+  "EQUATION", "TERM", "NEG", "EXP", "ATOMIC", "ARGUMENTS", "ARGLIST",
+  "$@2", "ARGUMENT", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[YYLEX-NUM] -- Internal token number corresponding to
-   token YYLEX-NUM.  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-/* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
-{
-       0,    28,    30,    29,    31,    31,    32,    33,    33,    33,
-      34,    34,    34,    35,    35,    35,    35,    35,    35,    35,
-      35,    35,    35,    35,    35,    35,    36,    36,    36,    36,
-      36,    36,    36,    37,    37,    37,    37,    37,    37,    37,
-      38,    38,    38,    38,    39,    39,    39,    39,    39,    40,
-      40,    40,    40,    40,    40,    40,    40,    40,    40,    40,
-      40,    40,    41,    42,    42,    42,    43,    42,    44
-};
+#define YYPACT_NINF (-58)
 
-/* YYR2[YYN] -- Number of symbols composing right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
-{
-       0,     2,     0,     2,     1,     0,     1,     3,     2,     1,
-       3,     2,     1,     3,     3,     3,     3,     3,     3,     2,
-       2,     2,     2,     2,     2,     1,     3,     3,     3,     3,
-       1,     2,     2,     3,     3,     3,     2,     2,     2,     1,
-       2,     2,     2,     1,     3,     3,     2,     2,     1,     3,
-       2,     1,     1,     4,     3,     5,     4,     3,     1,     2,
-       1,     2,     1,     3,     1,     3,     0,     3,     1
-};
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-/* YYDEFACT[STATE-NAME] -- Default rule to reduce with in state
-   STATE-NUM when YYTABLE doesn't specify something else to do.  Zero
-   means the default is an error.  */
-static const yytype_uint8 yydefact[] =
-{
-       2,     0,     5,     1,     0,    51,    52,     0,    60,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     3,     4,     6,     9,    12,
-      25,    30,    39,    43,    48,    59,     0,    50,    61,     0,
-       8,    11,    31,    32,    24,    23,    22,    20,    21,    19,
-      40,    38,    37,    36,    42,    41,    47,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,    57,     0,    68,     0,    62,     0,    64,
-      49,     7,    10,    18,    17,    16,    15,    14,    13,    28,
-      29,    27,    26,    35,    34,    33,    45,    44,    53,     0,
-       0,     0,    55,    65,    63,    67
-};
+#define YYTABLE_NINF (-67)
 
-/* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int8 yydefgoto[] =
-{
-      -1,     1,     2,    25,    75,    27,    28,    29,    30,    31,
-      32,    33,    34,    76,    77,    78,    79
-};
+#define yytable_value_is_error(Yyn) \
+  0
 
 /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
    STATE-NUM.  */
-#define YYPACT_NINF -58
 static const yytype_int16 yypact[] =
 {
      -58,     1,   221,   -58,    46,    28,   -58,   146,   -58,    48,
-      54,    76,    79,    98,    99,   100,   101,   104,   120,   333,
-     141,   153,   166,   196,   177,   -58,   -58,   169,   181,    23,
+      54,    76,    79,    98,    99,   100,   101,   104,   120,   332,
+     140,   153,   165,   196,   177,   -58,   -58,   169,   180,    23,
       15,    52,   -58,   176,   -58,   -58,   121,   -58,   -58,    38,
      -58,   -58,   -58,   -58,   -58,   -58,   -58,   -58,   -58,   -58,
      -58,   -58,   -58,   -58,   -58,   -58,   -58,   246,   271,   296,
-     296,   296,   296,   296,   296,   308,   308,   308,   308,   333,
-     333,   333,     2,   -58,    71,   -58,   197,   204,   205,   -58,
-     -58,   181,    23,    15,    15,    15,    15,    15,    15,    52,
+     296,   296,   296,   296,   296,   307,   307,   307,   307,   332,
+     332,   332,     2,   -58,    71,   -58,   197,   204,   205,   -58,
+     -58,   180,    23,    15,    15,    15,    15,    15,    15,    52,
       52,    52,    52,   -58,   -58,   -58,   -58,   176,   -58,    96,
      171,   221,   -58,   -58,   -58,   -58
 };
 
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       2,     0,     5,     1,     0,    51,    52,     0,    60,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     3,     4,     6,     9,    12,
+      25,    30,    39,    43,    48,    59,     0,    50,    61,     0,
+       8,    11,    31,    32,    23,    24,    19,    21,    20,    22,
+      40,    36,    37,    38,    42,    41,    47,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,    57,     0,    68,     0,    62,     0,    64,
+      49,     7,    10,    17,    18,    13,    14,    15,    16,    28,
+      29,    26,    27,    33,    34,    35,    45,    44,    53,     0,
+       0,     0,    55,    65,    63,    67
+};
+
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-     -58,   -58,   -58,   -58,   212,   208,   160,   161,   147,   -35,
+     -58,   -58,   -58,   -58,   212,   208,   159,   160,   147,   -35,
      -19,   148,   -58,   -58,   -58,   -58,   -57
 };
 
-/* YYTABLE[YYPACT[STATE-NUM]].  What to do in state STATE-NUM.  If
-   positive, shift that token.  If negative, reduce the rule which
-   number is the opposite.  If zero, do what YYDEFACT says.
-   If YYTABLE_NINF, syntax error.  */
-#define YYTABLE_NINF -67
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int8 yydefgoto[] =
+{
+       0,     1,     2,    25,    75,    27,    28,    29,    30,    31,
+      32,    33,    34,    76,    77,    78,    79
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int8 yytable[] =
 {
       50,     3,   -46,    96,    55,     4,     5,     6,     7,   -46,
@@ -623,29 +658,28 @@ static const yytype_int8 yytable[] =
      -56,   -56,   -56,   -56,   -56,   -56,   -56,   -56,   -56,   -56,
      -56,    49,    73,   -56,     4,     5,     6,     7,    74,   -66,
        8,     9,    10,    11,    12,    13,    14,    15,    16,    17,
-      18,    19,    51,    20,    21,    22,    23,    37,    24,     4,
+      18,    51,    19,    20,    21,    22,    23,    37,    24,     4,
        5,     6,     7,    38,    52,     8,     9,    10,    11,    12,
-      13,    14,    15,    16,    17,    18,    19,    53,    20,    21,
+      13,    14,    15,    16,    17,    18,    53,    19,    20,    21,
       22,    23,   103,    24,     4,     5,     6,     7,    56,    57,
        8,     9,    10,    11,    12,    13,    14,    15,    16,    17,
-      18,    19,    58,    20,    21,    22,    23,    54,    24,     4,
+      18,    58,    19,    20,    21,    22,    23,    54,    24,     4,
        5,     6,     7,    72,    99,     8,    83,    84,    85,    86,
-      87,    88,   100,   101,    26,    39,    19,    81,     0,    82,
+      87,    88,   100,   101,    26,    39,    81,    19,    82,     0,
       97,    23,     0,    24,     4,     5,     6,     7,     0,     0,
        8,     9,    10,    11,    12,    13,    14,    15,    16,    17,
-      18,    19,     0,    20,    21,    22,    23,     0,    24,     4,
+      18,     0,    19,    20,    21,    22,    23,     0,    24,     4,
        5,     6,     7,     0,     0,     8,     0,    10,    11,    12,
-      13,    14,    15,    16,    17,    18,    19,     0,    20,    21,
+      13,    14,    15,    16,    17,    18,     0,    19,    20,    21,
       22,    23,     0,    24,     4,     5,     6,     7,     0,     0,
        8,     0,     0,    11,    12,    13,    14,    15,    16,    17,
-      18,    19,     0,    20,    21,    22,    23,     0,    24,     4,
+      18,     0,    19,    20,    21,    22,    23,     0,    24,     4,
        5,     6,     7,     0,     0,     8,     0,     0,    11,    12,
-       0,     4,     5,     6,     7,     0,    19,     8,    20,    21,
-      22,    23,     0,    24,     0,     0,     0,     0,    19,     0,
-      20,    21,    22,    23,     0,    24,     4,     5,     6,     7,
-       0,     0,     8,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,    19,     0,     0,     0,     0,    23,     0,
-      24
+       4,     5,     6,     7,     0,     0,     8,    19,    20,    21,
+      22,    23,     0,    24,     0,     0,     0,     0,    19,    20,
+      21,    22,    23,     0,    24,     4,     5,     6,     7,     0,
+       0,     8,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,    19,     0,     0,     0,    23,     0,    24
 };
 
 static const yytype_int8 yycheck[] =
@@ -664,37 +698,36 @@ static const yytype_int8 yycheck[] =
       14,    15,    16,    17,    18,    19,    20,    21,    22,    23,
       24,     1,     1,    27,     3,     4,     5,     6,     7,     8,
        9,    10,    11,    12,    13,    14,    15,    16,    17,    18,
-      19,    20,     1,    22,    23,    24,    25,     1,    27,     3,
+      19,     1,    21,    22,    23,    24,    25,     1,    27,     3,
        4,     5,     6,     7,     1,     9,    10,    11,    12,    13,
-      14,    15,    16,    17,    18,    19,    20,     1,    22,    23,
+      14,    15,    16,    17,    18,    19,     1,    21,    22,    23,
       24,    25,     1,    27,     3,     4,     5,     6,     1,    10,
        9,    10,    11,    12,    13,    14,    15,    16,    17,    18,
-      19,    20,    11,    22,    23,    24,    25,     1,    27,     3,
+      19,    11,    21,    22,    23,    24,    25,     1,    27,     3,
        4,     5,     6,    27,     7,     9,    59,    60,    61,    62,
-      63,    64,     8,     8,     2,     7,    20,    57,    -1,    58,
+      63,    64,     8,     8,     2,     7,    57,    21,    58,    -1,
       72,    25,    -1,    27,     3,     4,     5,     6,    -1,    -1,
        9,    10,    11,    12,    13,    14,    15,    16,    17,    18,
-      19,    20,    -1,    22,    23,    24,    25,    -1,    27,     3,
+      19,    -1,    21,    22,    23,    24,    25,    -1,    27,     3,
        4,     5,     6,    -1,    -1,     9,    -1,    11,    12,    13,
-      14,    15,    16,    17,    18,    19,    20,    -1,    22,    23,
+      14,    15,    16,    17,    18,    19,    -1,    21,    22,    23,
       24,    25,    -1,    27,     3,     4,     5,     6,    -1,    -1,
        9,    -1,    -1,    12,    13,    14,    15,    16,    17,    18,
-      19,    20,    -1,    22,    23,    24,    25,    -1,    27,     3,
+      19,    -1,    21,    22,    23,    24,    25,    -1,    27,     3,
        4,     5,     6,    -1,    -1,     9,    -1,    -1,    12,    13,
-      -1,     3,     4,     5,     6,    -1,    20,     9,    22,    23,
-      24,    25,    -1,    27,    -1,    -1,    -1,    -1,    20,    -1,
-      22,    23,    24,    25,    -1,    27,     3,     4,     5,     6,
-      -1,    -1,     9,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,    20,    -1,    -1,    -1,    -1,    25,    -1,
-      27
+       3,     4,     5,     6,    -1,    -1,     9,    21,    22,    23,
+      24,    25,    -1,    27,    -1,    -1,    -1,    -1,    21,    22,
+      23,    24,    25,    -1,    27,     3,     4,     5,     6,    -1,
+      -1,     9,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    21,    -1,    -1,    -1,    25,    -1,    27
 };
 
-/* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-   symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
        0,    29,    30,     0,     3,     4,     5,     6,     9,    10,
-      11,    12,    13,    14,    15,    16,    17,    18,    19,    20,
+      11,    12,    13,    14,    15,    16,    17,    18,    19,    21,
       22,    23,    24,    25,    27,    31,    32,    33,    34,    35,
       36,    37,    38,    39,    40,     1,     6,     1,     7,    33,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
@@ -706,95 +739,65 @@ static const yytype_uint8 yystos[] =
        8,     8,     1,     1,    44,    44
 };
 
-#define yyerrok		(yyerrstatus = 0)
-#define yyclearin	(yychar = YYEMPTY)
-#define YYEMPTY		(-2)
-#define YYEOF		0
-
-#define YYACCEPT	goto yyacceptlab
-#define YYABORT		goto yyabortlab
-#define YYERROR		goto yyerrorlab
-
-
-/* Like YYERROR except do call yyerror.  This remains here temporarily
-   to ease the transition to the new meaning of YYERROR, for GCC.
-   Once GCC version 2 has supplanted version 1, this can go.  */
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    28,    30,    29,    31,    31,    32,    33,    33,    33,
+      34,    34,    34,    35,    35,    35,    35,    35,    35,    35,
+      35,    35,    35,    35,    35,    35,    36,    36,    36,    36,
+      36,    36,    36,    37,    37,    37,    37,    37,    37,    37,
+      38,    38,    38,    38,    39,    39,    39,    39,    39,    40,
+      40,    40,    40,    40,    40,    40,    40,    40,    40,    40,
+      40,    40,    41,    42,    42,    42,    43,    42,    44
+};
 
-#define YYFAIL		goto yyerrlab
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     0,     2,     1,     0,     1,     3,     2,     1,
+       3,     2,     1,     3,     3,     3,     3,     3,     3,     2,
+       2,     2,     2,     2,     2,     1,     3,     3,     3,     3,
+       1,     2,     2,     3,     3,     3,     2,     2,     2,     1,
+       2,     2,     2,     1,     3,     3,     2,     2,     1,     3,
+       2,     1,     1,     4,     3,     5,     4,     3,     1,     2,
+       1,     2,     1,     3,     1,     3,     0,     3,     1
+};
 
-#define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)					\
-do								\
-  if (yychar == YYEMPTY && yylen == 1)				\
-    {								\
-      yychar = (Token);						\
-      yylval = (Value);						\
-      yytoken = YYTRANSLATE (yychar);				\
-      YYPOPSTACK (1);						\
-      goto yybackup;						\
-    }								\
-  else								\
-    {								\
-      yyerror (store, YY_("syntax error: cannot back up")); \
-      YYERROR;							\
-    }								\
-while (YYID (0))
-
-
-#define YYTERROR	1
-#define YYERRCODE	256
-
-
-/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
-   If N is 0, then set CURRENT to the empty location which ends
-   the previous symbol: RHS[0] (always defined).  */
-
-#define YYRHSLOC(Rhs, K) ((Rhs)[K])
-#ifndef YYLLOC_DEFAULT
-# define YYLLOC_DEFAULT(Current, Rhs, N)				\
-    do									\
-      if (YYID (N))                                                    \
-	{								\
-	  (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;	\
-	  (Current).first_column = YYRHSLOC (Rhs, 1).first_column;	\
-	  (Current).last_line    = YYRHSLOC (Rhs, N).last_line;		\
-	  (Current).last_column  = YYRHSLOC (Rhs, N).last_column;	\
-	}								\
-      else								\
-	{								\
-	  (Current).first_line   = (Current).last_line   =		\
-	    YYRHSLOC (Rhs, 0).last_line;				\
-	  (Current).first_column = (Current).last_column =		\
-	    YYRHSLOC (Rhs, 0).last_column;				\
-	}								\
-    while (YYID (0))
-#endif
+enum { YYENOMEM = -2 };
 
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
 
-/* YY_LOCATION_PRINT -- Print the location on the stream.
-   This macro was not mandated originally: define only if we know
-   we won't break user code: when these are the locations we know.  */
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
-#ifndef YY_LOCATION_PRINT
-# if YYLTYPE_IS_TRIVIAL
-#  define YY_LOCATION_PRINT(File, Loc)			\
-     fprintf (File, "%d.%d-%d.%d",			\
-	      (Loc).first_line, (Loc).first_column,	\
-	      (Loc).last_line,  (Loc).last_column)
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
-#endif
 
+#define YYRECOVERING()  (!!yyerrstatus)
 
-/* YYLEX -- calling `yylex' with the right arguments.  */
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (store, state, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
-#ifdef YYLEX_PARAM
-# define YYLEX yylex (YYLEX_PARAM)
-#else
-# define YYLEX yylex (store)
-#endif
 
 /* Enable debugging if requested.  */
 #if YYDEBUG
@@ -804,83 +807,60 @@ while (YYID (0))
 #  define YYFPRINTF fprintf
 # endif
 
-# define YYDPRINTF(Args)			\
-do {						\
-  if (yydebug)					\
-    YYFPRINTF Args;				\
-} while (YYID (0))
-
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)			  \
-do {									  \
-  if (yydebug)								  \
-    {									  \
-      YYFPRINTF (stderr, "%s ", Title);					  \
-      yy_symbol_print (stderr,						  \
-		  Type, Value, store); \
-      YYFPRINTF (stderr, "\n");						  \
-    }									  \
-} while (YYID (0))
-
-
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
-
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, Kst::ObjectStore *store)
-#else
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, store, state); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
 static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep, store)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-    Kst::ObjectStore *store;
-#endif
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, Kst::ObjectStore *store, Equations::ParseState *state)
 {
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (store);
+  YY_USE (state);
   if (!yyvaluep)
     return;
-  YYUSE (store);
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# else
-  YYUSE (yyoutput);
-# endif
-  switch (yytype)
-    {
-      default:
-	break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, Kst::ObjectStore *store)
-#else
 static void
-yy_symbol_print (yyoutput, yytype, yyvaluep, store)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-    Kst::ObjectStore *store;
-#endif
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, Kst::ObjectStore *store, Equations::ParseState *state)
 {
-  if (yytype < YYNTOKENS)
-    YYFPRINTF (yyoutput, "token %s (", yytname[yytype]);
-  else
-    YYFPRINTF (yyoutput, "nterm %s (", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep, store);
-  YYFPRINTF (yyoutput, ")");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, store, state);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -888,81 +868,68 @@ yy_symbol_print (yyoutput, yytype, yyvaluep, store)
 | TOP (included).                                                   |
 `------------------------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_stack_print (yytype_int16 *bottom, yytype_int16 *top)
-#else
 static void
-yy_stack_print (bottom, top)
-    yytype_int16 *bottom;
-    yytype_int16 *top;
-#endif
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
-  for (; bottom <= top; ++bottom)
-    YYFPRINTF (stderr, " %d", *bottom);
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
   YYFPRINTF (stderr, "\n");
 }
 
-# define YY_STACK_PRINT(Bottom, Top)				\
-do {								\
-  if (yydebug)							\
-    yy_stack_print ((Bottom), (Top));				\
-} while (YYID (0))
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
 
 
 /*------------------------------------------------.
 | Report that the YYRULE is going to be reduced.  |
 `------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_reduce_print (YYSTYPE *yyvsp, int yyrule, Kst::ObjectStore *store)
-#else
 static void
-yy_reduce_print (yyvsp, yyrule, store)
-    YYSTYPE *yyvsp;
-    int yyrule;
-    Kst::ObjectStore *store;
-#endif
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, Kst::ObjectStore *store, Equations::ParseState *state)
 {
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  unsigned long int yylno = yyrline[yyrule];
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
-	     yyrule - 1, yylno);
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
-      fprintf (stderr, "   $%d = ", yyi + 1);
-      yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
-		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       		       , store);
-      fprintf (stderr, "\n");
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], store, state);
+      YYFPRINTF (stderr, "\n");
     }
 }
 
-# define YY_REDUCE_PRINT(Rule)		\
-do {					\
-  if (yydebug)				\
-    yy_reduce_print (yyvsp, Rule, store); \
-} while (YYID (0))
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, store, state); \
+} while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
 
 
 /* YYINITDEPTH -- initial size of the parser's stacks.  */
-#ifndef	YYINITDEPTH
+#ifndef YYINITDEPTH
 # define YYINITDEPTH 200
 #endif
 
@@ -977,281 +944,33 @@ int yydebug;
 # define YYMAXDEPTH 10000
 #endif
 
-
-
-#if YYERROR_VERBOSE
-
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
-/* Return the length of YYSTR.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static YYSIZE_T
-yystrlen (const char *yystr)
-#else
-static YYSIZE_T
-yystrlen (yystr)
-    const char *yystr;
-#endif
-{
-  YYSIZE_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-#else
-static char *
-yystpcpy (yydest, yysrc)
-    char *yydest;
-    const char *yysrc;
-#endif
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
-
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
-
-  return yyd - 1;
-}
-#  endif
-# endif
-
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYSIZE_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYSIZE_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-	switch (*++yyp)
-	  {
-	  case '\'':
-	  case ',':
-	    goto do_not_strip_quotes;
-
-	  case '\\':
-	    if (*++yyp != '\\')
-	      goto do_not_strip_quotes;
-	    /* Fall through.  */
-	  default:
-	    if (yyres)
-	      yyres[yyn] = *yyp;
-	    yyn++;
-	    break;
-
-	  case '"':
-	    if (yyres)
-	      yyres[yyn] = '\0';
-	    return yyn;
-	  }
-    do_not_strip_quotes: ;
-    }
 
-  if (! yyres)
-    return yystrlen (yystr);
 
-  return yystpcpy (yyres, yystr) - yyres;
-}
-# endif
 
-/* Copy into YYRESULT an error message about the unexpected token
-   YYCHAR while in state YYSTATE.  Return the number of bytes copied,
-   including the terminating null byte.  If YYRESULT is null, do not
-   copy anything; just return the number of bytes that would be
-   copied.  As a special case, return 0 if an ordinary "syntax error"
-   message will do.  Return YYSIZE_MAXIMUM if overflow occurs during
-   size calculation.  */
-static YYSIZE_T
-yysyntax_error (char *yyresult, int yystate, int yychar)
-{
-  int yyn = yypact[yystate];
 
-  if (! (YYPACT_NINF < yyn && yyn <= YYLAST))
-    return 0;
-  else
-    {
-      int yytype = YYTRANSLATE (yychar);
-      YYSIZE_T yysize0 = yytnamerr (0, yytname[yytype]);
-      YYSIZE_T yysize = yysize0;
-      YYSIZE_T yysize1;
-      int yysize_overflow = 0;
-      enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-      char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-      int yyx;
-
-# if 0
-      /* This is so xgettext sees the translatable formats that are
-	 constructed on the fly.  */
-      YY_("syntax error, unexpected %s");
-      YY_("syntax error, unexpected %s, expecting %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s");
-# endif
-      char *yyfmt;
-      char const *yyf;
-      static char const yyunexpected[] = "syntax error, unexpected %s";
-      static char const yyexpecting[] = ", expecting %s";
-      static char const yyor[] = " or %s";
-      char yyformat[sizeof yyunexpected
-		    + sizeof yyexpecting - 1
-		    + ((YYERROR_VERBOSE_ARGS_MAXIMUM - 2)
-		       * (sizeof yyor - 1))];
-      char const *yyprefix = yyexpecting;
-
-      /* Start YYX at -YYN if negative to avoid negative indexes in
-	 YYCHECK.  */
-      int yyxbegin = yyn < 0 ? -yyn : 0;
-
-      /* Stay within bounds of both yycheck and yytname.  */
-      int yychecklim = YYLAST - yyn + 1;
-      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-      int yycount = 1;
-
-      yyarg[0] = yytname[yytype];
-      yyfmt = yystpcpy (yyformat, yyunexpected);
-
-      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-	if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR)
-	  {
-	    if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-	      {
-		yycount = 1;
-		yysize = yysize0;
-		yyformat[sizeof yyunexpected - 1] = '\0';
-		break;
-	      }
-	    yyarg[yycount++] = yytname[yyx];
-	    yysize1 = yysize + yytnamerr (0, yytname[yyx]);
-	    yysize_overflow |= (yysize1 < yysize);
-	    yysize = yysize1;
-	    yyfmt = yystpcpy (yyfmt, yyprefix);
-	    yyprefix = yyor;
-	  }
-
-      yyf = YY_(yyformat);
-      yysize1 = yysize + yystrlen (yyf);
-      yysize_overflow |= (yysize1 < yysize);
-      yysize = yysize1;
-
-      if (yysize_overflow)
-	return YYSIZE_MAXIMUM;
-
-      if (yyresult)
-	{
-	  /* Avoid sprintf, as that infringes on the user's name space.
-	     Don't have undefined behavior even if the translation
-	     produced a string with the wrong number of "%s"s.  */
-	  char *yyp = yyresult;
-	  int yyi = 0;
-	  while ((*yyp = *yyf) != '\0')
-	    {
-	      if (*yyp == '%' && yyf[1] == 's' && yyi < yycount)
-		{
-		  yyp += yytnamerr (yyp, yyarg[yyi++]);
-		  yyf += 2;
-		}
-	      else
-		{
-		  yyp++;
-		  yyf++;
-		}
-	    }
-	}
-      return yysize;
-    }
-}
-#endif /* YYERROR_VERBOSE */
-
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, Kst::ObjectStore *store)
-#else
-static void
-yydestruct (yymsg, yytype, yyvaluep, store)
-    const char *yymsg;
-    int yytype;
-    YYSTYPE *yyvaluep;
-    Kst::ObjectStore *store;
-#endif
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, Kst::ObjectStore *store, Equations::ParseState *state)
 {
-  YYUSE (yyvaluep);
-  YYUSE (store);
-
+  YY_USE (yyvaluep);
+  YY_USE (store);
+  YY_USE (state);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
-
-  /*
-  switch (yytype)
-    {
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
-      default:
-        break;
-    }
-  */
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
-
-
-/* Prevent warnings from -Wmissing-prototypes.  */
-
-#ifdef YYPARSE_PARAM
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void *YYPARSE_PARAM);
-#else
-int yyparse ();
-#endif
-#else /* ! YYPARSE_PARAM */
-#if defined __STDC__ || defined __cplusplus
-KSTMATH_EXPORT int yyparse (Kst::ObjectStore *store);
-#else
-int yyparse ();
-#endif
-#endif /* ! YYPARSE_PARAM */
 
 
 
-/* The look-ahead symbol.  */
-int yychar;
-
-/* The semantic value of the look-ahead symbol.  */
-YYSTYPE yylval;
-
-/* Number of syntax errors so far.  */
-int yynerrs;
 
 
 
@@ -1259,200 +978,193 @@ int yynerrs;
 | yyparse.  |
 `----------*/
 
-#ifdef YYPARSE_PARAM
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-int
-yyparse (void *YYPARSE_PARAM)
-#else
 int
-yyparse (YYPARSE_PARAM)
-    void *YYPARSE_PARAM;
-#endif
-#else /* ! YYPARSE_PARAM */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-int
-yyparse (Kst::ObjectStore *store)
-#else
-int
-yyparse (store)
-    Kst::ObjectStore *store;
-#endif
-#endif
+yyparse (Kst::ObjectStore *store, Equations::ParseState *state)
 {
-  
-  int yystate;
-  int yyn;
-  int yyresult;
-  /* Number of tokens to shift before error messages enabled.  */
-  int yyerrstatus;
-  /* Look-ahead token as an internal (translated) token number.  */
-  int yytoken = 0;
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+/* Lookahead token kind.  */
+int yychar;
 
-  /* Three stacks and their tools:
-     `yyss': related to states,
-     `yyvs': related to semantic values,
-     `yyls': related to locations.
 
-     Refer to the stacks thru separate pointers, to allow yyoverflow
-     to reallocate them elsewhere.  */
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
 
-  /* The state stack.  */
-  yytype_int16 yyssa[YYINITDEPTH];
-  yytype_int16 *yyss = yyssa;
-  yytype_int16 *yyssp;
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
 
-  /* The semantic value stack.  */
-  YYSTYPE yyvsa[YYINITDEPTH];
-  YYSTYPE *yyvs = yyvsa;
-  YYSTYPE *yyvsp;
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
 
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
 
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
-#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-  YYSIZE_T yystacksize = YYINITDEPTH;
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
 
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
   /* The number of symbols on the RHS of the reduced rule.
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
-  yychar = YYEMPTY;		/* Cause a token to be read.  */
-
-  /* Initialize stack pointers.
-     Waste one element of value and location stack
-     so that they stay on the same level as the state stack.
-     The wasted elements are never initialized.  */
-
-  yyssp = yyss;
-  yyvsp = yyvs;
+  yychar = YYEMPTY; /* Cause a token to be read.  */
 
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
-	/* Give user a chance to reallocate the stack.  Use copies of
-	   these so that the &'s don't force the real ones into
-	   memory.  */
-	YYSTYPE *yyvs1 = yyvs;
-	yytype_int16 *yyss1 = yyss;
-
-
-	/* Each stack pointer address is followed by the size of the
-	   data in use in that stack, in bytes.  This used to be a
-	   conditional around just the two extra args, but that might
-	   be undefined if yyoverflow is a macro.  */
-	yyoverflow (YY_("memory exhausted"),
-		    &yyss1, yysize * sizeof (*yyssp),
-		    &yyvs1, yysize * sizeof (*yyvsp),
-
-		    &yystacksize);
-
-	yyss = yyss1;
-	yyvs = yyvs1;
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-	goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
-	yystacksize = YYMAXDEPTH;
+        yystacksize = YYMAXDEPTH;
 
       {
-	yytype_int16 *yyss1 = yyss;
-	union yyalloc *yyptr =
-	  (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
-	if (! yyptr)
-	  goto yyexhaustedlab;
-	YYSTACK_RELOCATE (yyss);
-	YYSTACK_RELOCATE (yyvs);
-
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
 #  undef YYSTACK_RELOCATE
-	if (yyss1 != yyssa)
-	  YYSTACK_FREE (yyss1);
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
 
-
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-		  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
-	YYABORT;
+        YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
-     look-ahead token if we need one and don't already have one.  */
+     lookahead token if we need one and don't already have one.  */
 
-  /* First try to decide what to do without reference to look-ahead token.  */
+  /* First try to decide what to do without reference to lookahead token.  */
   yyn = yypact[yystate];
-  if (yyn == YYPACT_NINF)
+  if (yypact_value_is_default (yyn))
     goto yydefault;
 
-  /* Not known => get a look-ahead token if don't already have one.  */
+  /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid look-ahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
-      yychar = YYLEX;
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, store, state);
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1467,30 +1179,26 @@ yybackup:
   yyn = yytable[yyn];
   if (yyn <= 0)
     {
-      if (yyn == 0 || yyn == YYTABLE_NINF)
-	goto yyerrlab;
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
       yyn = -yyn;
       goto yyreduce;
     }
 
-  if (yyn == YYFINAL)
-    YYACCEPT;
-
   /* Count tokens shifted since error; after three, turn off error
      status.  */
   if (yyerrstatus)
     yyerrstatus--;
 
-  /* Shift the look-ahead token.  */
+  /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token unless it is eof.  */
-  if (yychar != YYEOF)
-    yychar = YYEMPTY;
-
   yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1505,14 +1213,14 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
   yylen = yyr2[yyn];
 
   /* If YYLEN is nonzero, implement the default value of the action:
-     `$$ = $1'.
+     '$$ = $1'.
 
      Otherwise, the following line sets YYVAL to garbage.
      This behavior is undocumented and Bison
@@ -1525,444 +1233,486 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 2:
-#line 46 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = 0L; yyClearErrors(); ParsedEquation = 0L; }
+  case 2: /* @1: %empty  */
+#line 54 "eparse.y"
+                        { (yyval.n) = 0L; state->errors.clear(); state->result = 0L; }
+#line 1240 "eparse.cpp"
     break;
 
-  case 3:
-#line 47 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = ParsedEquation = (yyvsp[(2) - (2)].n);
-				if (yyErrorCount() > 0) {
+  case 3: /* WRAPPER: @1 PRESTART  */
+#line 55 "eparse.y"
+                        { (yyval.n) = state->result = (yyvsp[0].n);
+				if (state->errors.count() > 0) {
 					DeleteNode((yyval.n));
 					(yyval.n) = 0L;
-					ParsedEquation = 0L;
+					state->result = 0L;
 					YYERROR;
 				}
 			}
+#line 1253 "eparse.cpp"
     break;
 
-  case 4:
-#line 58 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = (yyvsp[(1) - (1)].n); }
+  case 4: /* PRESTART: START  */
+#line 66 "eparse.y"
+                        { (yyval.n) = (yyvsp[0].n); }
+#line 1259 "eparse.cpp"
     break;
 
-  case 5:
-#line 60 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = 0L; yyerror(store, EParseErrorEmpty); }
+  case 5: /* PRESTART: %empty  */
+#line 68 "eparse.y"
+                        { (yyval.n) = 0L; yyerror(store, state, EParseErrorEmpty); }
+#line 1265 "eparse.cpp"
     break;
 
-  case 6:
-#line 64 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = (yyvsp[(1) - (1)].n); }
+  case 6: /* START: BOOLEAN_OR  */
+#line 72 "eparse.y"
+                        { (yyval.n) = (yyvsp[0].n); }
+#line 1271 "eparse.cpp"
     break;
 
-  case 7:
-#line 68 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewLogicalOr((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 7: /* BOOLEAN_OR: BOOLEAN_OR T_LOR BOOLEAN_AND  */
+#line 76 "eparse.y"
+                        { (yyval.n) = NewLogicalOr((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1277 "eparse.cpp"
     break;
 
-  case 8:
-#line 70 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorTwoOperands); (yyval.n) = 0L; }
+  case 8: /* BOOLEAN_OR: T_LOR error  */
+#line 78 "eparse.y"
+                        { yyerror(store, state, EParseErrorTwoOperands); (yyval.n) = 0L; }
+#line 1283 "eparse.cpp"
     break;
 
-  case 9:
-#line 72 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = (yyvsp[(1) - (1)].n); }
+  case 9: /* BOOLEAN_OR: BOOLEAN_AND  */
+#line 80 "eparse.y"
+                        { (yyval.n) = (yyvsp[0].n); }
+#line 1289 "eparse.cpp"
     break;
 
-  case 10:
-#line 76 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewLogicalAnd((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 10: /* BOOLEAN_AND: BOOLEAN_AND T_LAND COMPARISON  */
+#line 84 "eparse.y"
+                        { (yyval.n) = NewLogicalAnd((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1295 "eparse.cpp"
     break;
 
-  case 11:
-#line 78 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorTwoOperands); (yyval.n) = 0L; }
+  case 11: /* BOOLEAN_AND: T_LAND error  */
+#line 86 "eparse.y"
+                        { yyerror(store, state, EParseErrorTwoOperands); (yyval.n) = 0L; }
+#line 1301 "eparse.cpp"
     break;
 
-  case 12:
-#line 80 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = (yyvsp[(1) - (1)].n); }
+  case 12: /* BOOLEAN_AND: COMPARISON  */
+#line 88 "eparse.y"
+                        { (yyval.n) = (yyvsp[0].n); }
+#line 1307 "eparse.cpp"
     break;
 
-  case 13:
-#line 84 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewLessThan((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 13: /* COMPARISON: COMPARISON T_LT EQUATION  */
+#line 92 "eparse.y"
+                        { (yyval.n) = NewLessThan((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1313 "eparse.cpp"
     break;
 
-  case 14:
-#line 86 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewLessThanEqual((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 14: /* COMPARISON: COMPARISON T_LE EQUATION  */
+#line 94 "eparse.y"
+                        { (yyval.n) = NewLessThanEqual((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1319 "eparse.cpp"
     break;
 
-  case 15:
-#line 88 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewGreaterThan((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 15: /* COMPARISON: COMPARISON T_GT EQUATION  */
+#line 96 "eparse.y"
+                        { (yyval.n) = NewGreaterThan((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1325 "eparse.cpp"
     break;
 
-  case 16:
-#line 90 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewGreaterThanEqual((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 16: /* COMPARISON: COMPARISON T_GE EQUATION  */
+#line 98 "eparse.y"
+                        { (yyval.n) = NewGreaterThanEqual((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1331 "eparse.cpp"
     break;
 
-  case 17:
-#line 92 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewEqualTo((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 17: /* COMPARISON: COMPARISON T_EQ EQUATION  */
+#line 100 "eparse.y"
+                        { (yyval.n) = NewEqualTo((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1337 "eparse.cpp"
     break;
 
-  case 18:
-#line 94 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewNotEqualTo((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 18: /* COMPARISON: COMPARISON T_NE EQUATION  */
+#line 102 "eparse.y"
+                        { (yyval.n) = NewNotEqualTo((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1343 "eparse.cpp"
     break;
 
-  case 19:
-#line 96 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorTwoOperands); (yyval.n) = 0L; }
+  case 19: /* COMPARISON: T_LT error  */
+#line 104 "eparse.y"
+                        { yyerror(store, state, EParseErrorTwoOperands); (yyval.n) = 0L; }
+#line 1349 "eparse.cpp"
     break;
 
-  case 20:
-#line 98 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorTwoOperands); (yyval.n) = 0L; }
+  case 20: /* COMPARISON: T_GT error  */
+#line 106 "eparse.y"
+                        { yyerror(store, state, EParseErrorTwoOperands); (yyval.n) = 0L; }
+#line 1355 "eparse.cpp"
     break;
 
-  case 21:
-#line 100 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorTwoOperands); (yyval.n) = 0L; }
+  case 21: /* COMPARISON: T_LE error  */
+#line 108 "eparse.y"
+                        { yyerror(store, state, EParseErrorTwoOperands); (yyval.n) = 0L; }
+#line 1361 "eparse.cpp"
     break;
 
-  case 22:
-#line 102 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorTwoOperands); (yyval.n) = 0L; }
+  case 22: /* COMPARISON: T_GE error  */
+#line 110 "eparse.y"
+                        { yyerror(store, state, EParseErrorTwoOperands); (yyval.n) = 0L; }
+#line 1367 "eparse.cpp"
     break;
 
-  case 23:
-#line 104 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorTwoOperands); (yyval.n) = 0L; }
+  case 23: /* COMPARISON: T_EQ error  */
+#line 112 "eparse.y"
+                        { yyerror(store, state, EParseErrorTwoOperands); (yyval.n) = 0L; }
+#line 1373 "eparse.cpp"
     break;
 
-  case 24:
-#line 106 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorTwoOperands); (yyval.n) = 0L; }
+  case 24: /* COMPARISON: T_NE error  */
+#line 114 "eparse.y"
+                        { yyerror(store, state, EParseErrorTwoOperands); (yyval.n) = 0L; }
+#line 1379 "eparse.cpp"
     break;
 
-  case 25:
-#line 108 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = (yyvsp[(1) - (1)].n); }
+  case 25: /* COMPARISON: EQUATION  */
+#line 116 "eparse.y"
+                        { (yyval.n) = (yyvsp[0].n); }
+#line 1385 "eparse.cpp"
     break;
 
-  case 26:
-#line 112 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewAddition((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 26: /* EQUATION: EQUATION T_ADD TERM  */
+#line 120 "eparse.y"
+                        { (yyval.n) = NewAddition((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1391 "eparse.cpp"
     break;
 
-  case 27:
-#line 114 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewSubtraction((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 27: /* EQUATION: EQUATION T_SUBTRACT TERM  */
+#line 122 "eparse.y"
+                        { (yyval.n) = NewSubtraction((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1397 "eparse.cpp"
     break;
 
-  case 28:
-#line 116 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewBitwiseOr((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 28: /* EQUATION: EQUATION T_OR TERM  */
+#line 124 "eparse.y"
+                        { (yyval.n) = NewBitwiseOr((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1403 "eparse.cpp"
     break;
 
-  case 29:
-#line 118 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewBitwiseAnd((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 29: /* EQUATION: EQUATION T_AND TERM  */
+#line 126 "eparse.y"
+                        { (yyval.n) = NewBitwiseAnd((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1409 "eparse.cpp"
     break;
 
-  case 30:
-#line 120 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = (yyvsp[(1) - (1)].n); }
+  case 30: /* EQUATION: TERM  */
+#line 128 "eparse.y"
+                        { (yyval.n) = (yyvsp[0].n); }
+#line 1415 "eparse.cpp"
     break;
 
-  case 31:
-#line 122 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorTwoOperands); (yyval.n) = 0L; }
+  case 31: /* EQUATION: T_OR error  */
+#line 130 "eparse.y"
+                        { yyerror(store, state, EParseErrorTwoOperands); (yyval.n) = 0L; }
+#line 1421 "eparse.cpp"
     break;
 
-  case 32:
-#line 124 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorTwoOperands); (yyval.n) = 0L; }
+  case 32: /* EQUATION: T_AND error  */
+#line 132 "eparse.y"
+                        { yyerror(store, state, EParseErrorTwoOperands); (yyval.n) = 0L; }
+#line 1427 "eparse.cpp"
     break;
 
-  case 33:
-#line 128 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewMultiplication((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 33: /* TERM: TERM T_MULTIPLY NEG  */
+#line 136 "eparse.y"
+                        { (yyval.n) = NewMultiplication((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1433 "eparse.cpp"
     break;
 
-  case 34:
-#line 130 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewDivision((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 34: /* TERM: TERM T_DIVIDE NEG  */
+#line 138 "eparse.y"
+                        { (yyval.n) = NewDivision((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1439 "eparse.cpp"
     break;
 
-  case 35:
-#line 132 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewModulo((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 35: /* TERM: TERM T_MOD NEG  */
+#line 140 "eparse.y"
+                        { (yyval.n) = NewModulo((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1445 "eparse.cpp"
     break;
 
-  case 36:
-#line 134 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorTwoOperands); (yyval.n) = 0L; }
+  case 36: /* TERM: T_MULTIPLY error  */
+#line 142 "eparse.y"
+                        { yyerror(store, state, EParseErrorTwoOperands); (yyval.n) = 0L; }
+#line 1451 "eparse.cpp"
     break;
 
-  case 37:
-#line 136 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorTwoOperands); (yyval.n) = 0L; }
+  case 37: /* TERM: T_DIVIDE error  */
+#line 144 "eparse.y"
+                        { yyerror(store, state, EParseErrorTwoOperands); (yyval.n) = 0L; }
+#line 1457 "eparse.cpp"
     break;
 
-  case 38:
-#line 138 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorTwoOperands); (yyval.n) = 0L; }
+  case 38: /* TERM: T_MOD error  */
+#line 146 "eparse.y"
+                        { yyerror(store, state, EParseErrorTwoOperands); (yyval.n) = 0L; }
+#line 1463 "eparse.cpp"
     break;
 
-  case 39:
-#line 140 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = (yyvsp[(1) - (1)].n); }
+  case 39: /* TERM: NEG  */
+#line 148 "eparse.y"
+                        { (yyval.n) = (yyvsp[0].n); }
+#line 1469 "eparse.cpp"
     break;
 
-  case 40:
-#line 144 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewNegation((yyvsp[(2) - (2)].n)); }
+  case 40: /* NEG: T_SUBTRACT NEG  */
+#line 152 "eparse.y"
+                        { (yyval.n) = NewNegation((yyvsp[0].n)); }
+#line 1475 "eparse.cpp"
     break;
 
-  case 41:
-#line 146 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewNot((yyvsp[(2) - (2)].n)); }
+  case 41: /* NEG: T_NOT NEG  */
+#line 154 "eparse.y"
+                        { (yyval.n) = NewNot((yyvsp[0].n)); }
+#line 1481 "eparse.cpp"
     break;
 
-  case 42:
-#line 148 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = 0L; yyerror(store, EParseErrorRequiresOperand); }
+  case 42: /* NEG: T_NOT error  */
+#line 156 "eparse.y"
+                        { (yyval.n) = 0L; yyerror(store, state, EParseErrorRequiresOperand); }
+#line 1487 "eparse.cpp"
     break;
 
-  case 43:
-#line 150 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = (yyvsp[(1) - (1)].n); }
+  case 43: /* NEG: EXP  */
+#line 158 "eparse.y"
+                        { (yyval.n) = (yyvsp[0].n); }
+#line 1493 "eparse.cpp"
     break;
 
-  case 44:
-#line 154 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewPower((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); }
+  case 44: /* EXP: EXP T_EXP EXP  */
+#line 162 "eparse.y"
+                        { (yyval.n) = NewPower((yyvsp[-2].n), (yyvsp[0].n)); }
+#line 1499 "eparse.cpp"
     break;
 
-  case 45:
-#line 156 "../../../src/libkstmath/eparse.y"
-    { DeleteNode((yyvsp[(1) - (3)].n)); (yyval.n) = 0L; yyerror(store, EParseErrorTwoOperands); }
+  case 45: /* EXP: EXP T_EXP error  */
+#line 164 "eparse.y"
+                        { DeleteNode((yyvsp[-2].n)); (yyval.n) = 0L; yyerror(store, state, EParseErrorTwoOperands); }
+#line 1505 "eparse.cpp"
     break;
 
-  case 46:
-#line 158 "../../../src/libkstmath/eparse.y"
-    { DeleteNode((yyvsp[(1) - (2)].n)); (yyval.n) = 0L; yyerror(store, EParseErrorTwoOperands); }
+  case 46: /* EXP: EXP T_EXP  */
+#line 166 "eparse.y"
+                        { DeleteNode((yyvsp[-1].n)); (yyval.n) = 0L; yyerror(store, state, EParseErrorTwoOperands); }
+#line 1511 "eparse.cpp"
     break;
 
-  case 47:
-#line 160 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = 0L; yyerror(store, EParseErrorTwoOperands); }
+  case 47: /* EXP: T_EXP error  */
+#line 168 "eparse.y"
+                        { (yyval.n) = 0L; yyerror(store, state, EParseErrorTwoOperands); }
+#line 1517 "eparse.cpp"
     break;
 
-  case 48:
-#line 162 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = (yyvsp[(1) - (1)].n); }
+  case 48: /* EXP: ATOMIC  */
+#line 170 "eparse.y"
+                        { (yyval.n) = (yyvsp[0].n); }
+#line 1523 "eparse.cpp"
     break;
 
-  case 49:
-#line 166 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = (yyvsp[(2) - (3)].n); ParenthesizeNode((yyval.n)); }
+  case 49: /* ATOMIC: T_OPENPAR BOOLEAN_OR T_CLOSEPAR  */
+#line 174 "eparse.y"
+                        { (yyval.n) = (yyvsp[-1].n); ParenthesizeNode((yyval.n)); }
+#line 1529 "eparse.cpp"
     break;
 
-  case 50:
-#line 168 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorMissingClosingParenthesis); (yyval.n) = 0L; }
+  case 50: /* ATOMIC: T_OPENPAR error  */
+#line 176 "eparse.y"
+                        { yyerror(store, state, EParseErrorMissingClosingParenthesis); (yyval.n) = 0L; }
+#line 1535 "eparse.cpp"
     break;
 
-  case 51:
-#line 170 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewIdentifier((yyvsp[(1) - (1)].data)); }
+  case 51: /* ATOMIC: T_IDENTIFIER  */
+#line 178 "eparse.y"
+                        { (yyval.n) = NewIdentifier((yyvsp[0].data)); }
+#line 1541 "eparse.cpp"
     break;
 
-  case 52:
-#line 172 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewData(store, (yyvsp[(1) - (1)].data)); }
+  case 52: /* ATOMIC: T_DATA  */
+#line 180 "eparse.y"
+                        { (yyval.n) = NewData(store, (yyvsp[0].data)); }
+#line 1547 "eparse.cpp"
     break;
 
-  case 53:
-#line 174 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorNoImplicitMultiply); free((yyvsp[(1) - (4)].data)); (yyval.n) = 0L; }
+  case 53: /* ATOMIC: T_IDENTIFIER T_OPENPAR T_CLOSEPAR error  */
+#line 182 "eparse.y"
+                        { yyerror(store, state, EParseErrorNoImplicitMultiply); free((yyvsp[-3].data)); (yyval.n) = 0L; }
+#line 1553 "eparse.cpp"
     break;
 
-  case 54:
-#line 176 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewFunction((yyvsp[(1) - (3)].data), NewArgumentList()); }
+  case 54: /* ATOMIC: T_IDENTIFIER T_OPENPAR T_CLOSEPAR  */
+#line 184 "eparse.y"
+                        { (yyval.n) = NewFunction((yyvsp[-2].data), NewArgumentList()); }
+#line 1559 "eparse.cpp"
     break;
 
-  case 55:
-#line 181 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorNoImplicitMultiply); DeleteNode((yyvsp[(3) - (5)].n)); free((yyvsp[(1) - (5)].data)); (yyval.n) = 0L; }
+  case 55: /* ATOMIC: T_IDENTIFIER T_OPENPAR ARGUMENTS T_CLOSEPAR error  */
+#line 189 "eparse.y"
+                        { yyerror(store, state, EParseErrorNoImplicitMultiply); DeleteNode((yyvsp[-2].n)); free((yyvsp[-4].data)); (yyval.n) = 0L; }
+#line 1565 "eparse.cpp"
     break;
 
-  case 56:
-#line 183 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewFunction((yyvsp[(1) - (4)].data), (yyvsp[(3) - (4)].n)); }
+  case 56: /* ATOMIC: T_IDENTIFIER T_OPENPAR ARGUMENTS T_CLOSEPAR  */
+#line 191 "eparse.y"
+                        { (yyval.n) = NewFunction((yyvsp[-3].data), (yyvsp[-1].n)); }
+#line 1571 "eparse.cpp"
     break;
 
-  case 57:
-#line 185 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorMissingClosingParenthesis); free((yyvsp[(1) - (3)].data)); (yyval.n) = 0L; }
+  case 57: /* ATOMIC: T_IDENTIFIER T_OPENPAR error  */
+#line 193 "eparse.y"
+                        { yyerror(store, state, EParseErrorMissingClosingParenthesis); free((yyvsp[-2].data)); (yyval.n) = 0L; }
+#line 1577 "eparse.cpp"
     break;
 
-  case 58:
-#line 187 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = NewNumber((yyvsp[(1) - (1)].number)); }
+  case 58: /* ATOMIC: T_NUMBER  */
+#line 195 "eparse.y"
+                        { (yyval.n) = NewNumber((yyvsp[0].number)); }
+#line 1583 "eparse.cpp"
     break;
 
-  case 59:
-#line 189 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorNoImplicitMultiply); (yyval.n) = 0L; }
+  case 59: /* ATOMIC: T_NUMBER error  */
+#line 197 "eparse.y"
+                        { yyerror(store, state, EParseErrorNoImplicitMultiply); (yyval.n) = 0L; }
+#line 1589 "eparse.cpp"
     break;
 
-  case 60:
-#line 191 "../../../src/libkstmath/eparse.y"
-    { yyerrortoken((yyvsp[(1) - (1)].character)); (yyval.n) = 0L; }
+  case 60: /* ATOMIC: T_INVALID  */
+#line 199 "eparse.y"
+                        { yyerrortoken(state, (yyvsp[0].character)); (yyval.n) = 0L; }
+#line 1595 "eparse.cpp"
     break;
 
-  case 61:
-#line 193 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorEmptyParentheses); (yyval.n) = 0L; }
+  case 61: /* ATOMIC: T_OPENPAR T_CLOSEPAR  */
+#line 201 "eparse.y"
+                        { yyerror(store, state, EParseErrorEmptyParentheses); (yyval.n) = 0L; }
+#line 1601 "eparse.cpp"
     break;
 
-  case 62:
-#line 197 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = (yyvsp[(1) - (1)].n); }
+  case 62: /* ARGUMENTS: ARGLIST  */
+#line 205 "eparse.y"
+                        { (yyval.n) = (yyvsp[0].n); }
+#line 1607 "eparse.cpp"
     break;
 
-  case 63:
-#line 201 "../../../src/libkstmath/eparse.y"
-    { if ((yyvsp[(1) - (3)].n) && (yyvsp[(3) - (3)].n)) { AppendArgument((yyvsp[(1) - (3)].n), (yyvsp[(3) - (3)].n)); } else { DeleteNode((yyvsp[(1) - (3)].n)); DeleteNode((yyvsp[(3) - (3)].n)); (yyvsp[(1) - (3)].n) = 0L; } (yyval.n) = (yyvsp[(1) - (3)].n); }
+  case 63: /* ARGLIST: ARGLIST T_COMMA ARGUMENT  */
+#line 209 "eparse.y"
+                        { if ((yyvsp[-2].n) && (yyvsp[0].n)) { AppendArgument((yyvsp[-2].n), (yyvsp[0].n)); } else { DeleteNode((yyvsp[-2].n)); DeleteNode((yyvsp[0].n)); (yyvsp[-2].n) = 0L; } (yyval.n) = (yyvsp[-2].n); }
+#line 1613 "eparse.cpp"
     break;
 
-  case 64:
-#line 203 "../../../src/libkstmath/eparse.y"
-    { if ((yyvsp[(1) - (1)].n)) { (yyval.n) = NewArgumentList(); AppendArgument((yyval.n), (yyvsp[(1) - (1)].n)); } else { (yyval.n) = 0L; } }
+  case 64: /* ARGLIST: ARGUMENT  */
+#line 211 "eparse.y"
+                        { if ((yyvsp[0].n)) { (yyval.n) = NewArgumentList(); AppendArgument((yyval.n), (yyvsp[0].n)); } else { (yyval.n) = 0L; } }
+#line 1619 "eparse.cpp"
     break;
 
-  case 65:
-#line 205 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = 0L; DeleteNode((yyvsp[(1) - (3)].n)); yyerror(store, EParseErrorEmptyArg); }
+  case 65: /* ARGLIST: ARGLIST T_COMMA error  */
+#line 213 "eparse.y"
+                        { (yyval.n) = 0L; DeleteNode((yyvsp[-2].n)); yyerror(store, state, EParseErrorEmptyArg); }
+#line 1625 "eparse.cpp"
     break;
 
-  case 66:
-#line 206 "../../../src/libkstmath/eparse.y"
-    {}
+  case 66: /* $@2: %empty  */
+#line 214 "eparse.y"
+                        {}
+#line 1631 "eparse.cpp"
     break;
 
-  case 67:
-#line 207 "../../../src/libkstmath/eparse.y"
-    { yyerror(store, EParseErrorEmptyArg); DeleteNode((yyvsp[(3) - (3)].n)); (yyval.n) = 0L; }
+  case 67: /* ARGLIST: $@2 T_COMMA ARGUMENT  */
+#line 215 "eparse.y"
+                        { yyerror(store, state, EParseErrorEmptyArg); DeleteNode((yyvsp[0].n)); (yyval.n) = 0L; }
+#line 1637 "eparse.cpp"
     break;
 
-  case 68:
-#line 211 "../../../src/libkstmath/eparse.y"
-    { (yyval.n) = (yyvsp[(1) - (1)].n); }
+  case 68: /* ARGUMENT: START  */
+#line 219 "eparse.y"
+                        { (yyval.n) = (yyvsp[0].n); }
+#line 1643 "eparse.cpp"
     break;
 
 
-/* Line 1267 of yacc.c.  */
-#line 1871 "eparse.tab.c"
+#line 1647 "eparse.cpp"
+
       default: break;
     }
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
-
-  /* Now `shift' the result of the reduction.  Determine what state
+  /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
 
-/*------------------------------------.
-| yyerrlab -- here on detecting error |
-`------------------------------------*/
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
 yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
-      yyerror (store, YY_("syntax error"));
-#else
-      {
-	YYSIZE_T yysize = yysyntax_error (0, yystate, yychar);
-	if (yymsg_alloc < yysize && yymsg_alloc < YYSTACK_ALLOC_MAXIMUM)
-	  {
-	    YYSIZE_T yyalloc = 2 * yysize;
-	    if (! (yysize <= yyalloc && yyalloc <= YYSTACK_ALLOC_MAXIMUM))
-	      yyalloc = YYSTACK_ALLOC_MAXIMUM;
-	    if (yymsg != yymsgbuf)
-	      YYSTACK_FREE (yymsg);
-	    yymsg = (char *) YYSTACK_ALLOC (yyalloc);
-	    if (yymsg)
-	      yymsg_alloc = yyalloc;
-	    else
-	      {
-		yymsg = yymsgbuf;
-		yymsg_alloc = sizeof yymsgbuf;
-	      }
-	  }
-
-	if (0 < yysize && yysize <= yymsg_alloc)
-	  {
-	    (void) yysyntax_error (yymsg, yystate, yychar);
-	    yyerror (store, yymsg);
-	  }
-	else
-	  {
-	    yyerror (store, YY_("syntax error"));
-	    if (yysize != 0)
-	      goto yyexhaustedlab;
-	  }
-      }
-#endif
+      yyerror (store, state, YY_("syntax error"));
     }
 
-
-
   if (yyerrstatus == 3)
     {
-      /* If just tried and failed to reuse look-ahead token after an
-	 error, discard it.  */
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
 
       if (yychar <= YYEOF)
-	{
-	  /* Return failure if at end of input.  */
-	  if (yychar == YYEOF)
-	    YYABORT;
-	}
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
       else
-	{
-	  yydestruct ("Error: discarding",
-		      yytoken, &yylval, store);
-	  yychar = YYEMPTY;
-	}
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, store, state);
+          yychar = YYEMPTY;
+        }
     }
 
-  /* Else will try to reuse look-ahead token after shifting the error
+  /* Else will try to reuse lookahead token after shifting the error
      token.  */
   goto yyerrlab1;
 
@@ -1971,14 +1721,13 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
-
-  /* Do not reclaim the symbols of the rule which action triggered
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
   YYPOPSTACK (yylen);
   yylen = 0;
@@ -1991,42 +1740,42 @@ yyerrorlab:
 | yyerrlab1 -- common code for both syntax error and YYERROR.  |
 `-------------------------------------------------------------*/
 yyerrlab1:
-  yyerrstatus = 3;	/* Each real token shifted decrements this.  */
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
-      if (yyn != YYPACT_NINF)
-	{
-	  yyn += YYTERROR;
-	  if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
-	    {
-	      yyn = yytable[yyn];
-	      if (0 < yyn)
-		break;
-	    }
-	}
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
 
       /* Pop the current state because it cannot handle the error token.  */
       if (yyssp == yyss)
-	YYABORT;
+        YYABORT;
 
 
       yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp, store);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, store, state);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
     }
 
-  if (yyn == YYFINAL)
-    YYACCEPT;
-
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2037,53 +1786,56 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
-#ifndef yyoverflow
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (store, YY_("memory exhausted"));
+  yyerror (store, state, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
+
 
-yyreturn:
-  if (yychar != YYEOF && yychar != YYEMPTY)
-     yydestruct ("Cleanup: discarding lookahead",
-		 yytoken, &yylval, store);
-  /* Do not reclaim the symbols of the rule which action triggered
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, store, state);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
   YYPOPSTACK (yylen);
   YY_STACK_PRINT (yyss, yyssp);
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp, store);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, store, state);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
-  /* Make sure YYID is used.  */
-  return YYID (yyresult);
-}
 
+  return yyresult;
+}
 
-#line 214 "../../../src/libkstmath/eparse.y"
-
+#line 222 "eparse.y"
 
 
@@ -9,13 +9,21 @@
 #include "enodefactory.h"
 
 #include "eparse-eh.h"
-extern int yylex(Kst::ObjectStore *store);
-void *ParsedEquation = 0L;
 
 %}
 
-%parse-param { Kst::ObjectStore *store }
-%lex-param { Kst::ObjectStore *store }
+%define api.pure full
+%parse-param { Kst::ObjectStore *store } { Equations::ParseState *state }
+%lex-param { Kst::ObjectStore *store } { Equations::ParseState *state }
+
+%code requires {
+namespace Kst {
+  class ObjectStore;
+}
+namespace Equations {
+  struct ParseState;
+}
+}
 
 %union {
 		char *data;
@@ -43,12 +51,12 @@ void *ParsedEquation = 0L;
 
 %%
 
-WRAPPER		:	{ $<n>$ = 0L; yyClearErrors(); ParsedEquation = 0L; } PRESTART
-			{ $<n>$ = ParsedEquation = $<n>2;
-				if (yyErrorCount() > 0) {
+WRAPPER		:	{ $<n>$ = 0L; state->errors.clear(); state->result = 0L; } PRESTART
+			{ $<n>$ = state->result = $<n>2;
+				if (state->errors.count() > 0) {
 					DeleteNode($<n>$);
 					$<n>$ = 0L;
-					ParsedEquation = 0L;
+					state->result = 0L;
 					YYERROR;
 				}
 			}
@@ -57,7 +65,7 @@ WRAPPER		:	{ $<n>$ = 0L; yyClearErrors(); ParsedEquation = 0L; } PRESTART
 PRESTART	:	START
 			{ $<n>$ = $<n>1; }
 		|	/**/
-			{ $<n>$ = 0L; yyerror(store, EParseErrorEmpty); }
+			{ $<n>$ = 0L; yyerror(store, state, EParseErrorEmpty); }
 		;
 
 START		:	BOOLEAN_OR
@@ -67,7 +75,7 @@ START		:	BOOLEAN_OR
 BOOLEAN_OR	:	BOOLEAN_OR T_LOR BOOLEAN_AND
 			{ $<n>$ = NewLogicalOr($<n>1, $<n>3); }
 		|	T_LOR error
-			{ yyerror(store, EParseErrorTwoOperands); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorTwoOperands); $<n>$ = 0L; }
 		|	BOOLEAN_AND
 			{ $<n>$ = $<n>1; }
 		;
@@ -75,7 +83,7 @@ BOOLEAN_OR	:	BOOLEAN_OR T_LOR BOOLEAN_AND
 BOOLEAN_AND	:	BOOLEAN_AND T_LAND COMPARISON
 			{ $<n>$ = NewLogicalAnd($<n>1, $<n>3); }
 		|	T_LAND error
-			{ yyerror(store, EParseErrorTwoOperands); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorTwoOperands); $<n>$ = 0L; }
 		|	COMPARISON
 			{ $<n>$ = $<n>1; }
 		;
@@ -93,17 +101,17 @@ COMPARISON	:	COMPARISON T_LT EQUATION
 		|	COMPARISON T_NE EQUATION
 			{ $<n>$ = NewNotEqualTo($<n>1, $<n>3); }
 		|	T_LT error
-			{ yyerror(store, EParseErrorTwoOperands); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorTwoOperands); $<n>$ = 0L; }
 		|	T_GT error
-			{ yyerror(store, EParseErrorTwoOperands); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorTwoOperands); $<n>$ = 0L; }
 		|	T_LE error
-			{ yyerror(store, EParseErrorTwoOperands); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorTwoOperands); $<n>$ = 0L; }
 		|	T_GE error
-			{ yyerror(store, EParseErrorTwoOperands); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorTwoOperands); $<n>$ = 0L; }
 		|	T_EQ error
-			{ yyerror(store, EParseErrorTwoOperands); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorTwoOperands); $<n>$ = 0L; }
 		|	T_NE error
-			{ yyerror(store, EParseErrorTwoOperands); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorTwoOperands); $<n>$ = 0L; }
 		|	EQUATION
 			{ $<n>$ = $<n>1; }
 		;
@@ -119,9 +127,9 @@ EQUATION	:	EQUATION T_ADD TERM
 		|	TERM
 			{ $<n>$ = $<n>1; }
 		|	T_OR error
-			{ yyerror(store, EParseErrorTwoOperands); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorTwoOperands); $<n>$ = 0L; }
 		|	T_AND error
-			{ yyerror(store, EParseErrorTwoOperands); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorTwoOperands); $<n>$ = 0L; }
 		;
 
 TERM		:	TERM T_MULTIPLY NEG
@@ -131,11 +139,11 @@ TERM		:	TERM T_MULTIPLY NEG
 		|	TERM T_MOD NEG
 			{ $<n>$ = NewModulo($<n>1, $<n>3); }
 		|	T_MULTIPLY error
-			{ yyerror(store, EParseErrorTwoOperands); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorTwoOperands); $<n>$ = 0L; }
 		|	T_DIVIDE error
-			{ yyerror(store, EParseErrorTwoOperands); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorTwoOperands); $<n>$ = 0L; }
 		|	T_MOD error
-			{ yyerror(store, EParseErrorTwoOperands); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorTwoOperands); $<n>$ = 0L; }
 		|	NEG
 			{ $<n>$ = $<n>1; }
 		;
@@ -145,7 +153,7 @@ NEG		:	T_SUBTRACT NEG %prec U_SUBTRACT
 		|       T_NOT NEG
 			{ $<n>$ = NewNot($<n>2); }
 		|       T_NOT error
-			{ $<n>$ = 0L; yyerror(store, EParseErrorRequiresOperand); }
+			{ $<n>$ = 0L; yyerror(store, state, EParseErrorRequiresOperand); }
 		|	EXP
 			{ $<n>$ = $<n>1; }
 		;
@@ -153,11 +161,11 @@ NEG		:	T_SUBTRACT NEG %prec U_SUBTRACT
 EXP		:	EXP T_EXP EXP
 			{ $<n>$ = NewPower($<n>1, $<n>3); }
 		|	EXP T_EXP error
-			{ DeleteNode($<n>1); $<n>$ = 0L; yyerror(store, EParseErrorTwoOperands); }
+			{ DeleteNode($<n>1); $<n>$ = 0L; yyerror(store, state, EParseErrorTwoOperands); }
 		|	EXP T_EXP /**/
-			{ DeleteNode($<n>1); $<n>$ = 0L; yyerror(store, EParseErrorTwoOperands); }
+			{ DeleteNode($<n>1); $<n>$ = 0L; yyerror(store, state, EParseErrorTwoOperands); }
 		|	T_EXP error
-			{ $<n>$ = 0L; yyerror(store, EParseErrorTwoOperands); }
+			{ $<n>$ = 0L; yyerror(store, state, EParseErrorTwoOperands); }
 		|	ATOMIC
 			{ $<n>$ = $<n>1; }
 		;
@@ -165,32 +173,32 @@ EXP		:	EXP T_EXP EXP
 ATOMIC		:	T_OPENPAR BOOLEAN_OR T_CLOSEPAR
 			{ $<n>$ = $<n>2; ParenthesizeNode($<n>$); }
 		|	T_OPENPAR error
-			{ yyerror(store, EParseErrorMissingClosingParenthesis); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorMissingClosingParenthesis); $<n>$ = 0L; }
 		|	T_IDENTIFIER
 			{ $<n>$ = NewIdentifier($<data>1); }
 		|	T_DATA
 			{ $<n>$ = NewData(store, $<data>1); }
 		|	T_IDENTIFIER T_OPENPAR T_CLOSEPAR error
-			{ yyerror(store, EParseErrorNoImplicitMultiply); free($<data>1); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorNoImplicitMultiply); free($<data>1); $<n>$ = 0L; }
 		|	T_IDENTIFIER T_OPENPAR T_CLOSEPAR
 			{ $<n>$ = NewFunction($<data>1, NewArgumentList()); }
 /*		|	T_IDENTIFIER T_OPENPAR ARGUMENTS error
-			{ yyerror(store, EParseErrorMissingClosingParenthesis); DeleteNode($<n>3); free($<data>1); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorMissingClosingParenthesis); DeleteNode($<n>3); free($<data>1); $<n>$ = 0L; }
 */
 		|	T_IDENTIFIER T_OPENPAR ARGUMENTS T_CLOSEPAR error
-			{ yyerror(store, EParseErrorNoImplicitMultiply); DeleteNode($<n>3); free($<data>1); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorNoImplicitMultiply); DeleteNode($<n>3); free($<data>1); $<n>$ = 0L; }
 		|	T_IDENTIFIER T_OPENPAR ARGUMENTS T_CLOSEPAR
 			{ $<n>$ = NewFunction($<data>1, $<n>3); }
 		|	T_IDENTIFIER T_OPENPAR error
-			{ yyerror(store, EParseErrorMissingClosingParenthesis); free($<data>1); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorMissingClosingParenthesis); free($<data>1); $<n>$ = 0L; }
 		|	T_NUMBER
 			{ $<n>$ = NewNumber($<number>1); }
 		|	T_NUMBER error
-			{ yyerror(store, EParseErrorNoImplicitMultiply); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorNoImplicitMultiply); $<n>$ = 0L; }
 		|	T_INVALID
-			{ yyerrortoken($<character>1); $<n>$ = 0L; }
+			{ yyerrortoken(state, $<character>1); $<n>$ = 0L; }
 		|	T_OPENPAR T_CLOSEPAR
-			{ yyerror(store, EParseErrorEmptyParentheses); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorEmptyParentheses); $<n>$ = 0L; }
 		;
 
 ARGUMENTS	:	ARGLIST
@@ -202,9 +210,9 @@ ARGLIST		:	ARGLIST T_COMMA ARGUMENT
 		|	ARGUMENT
 			{ if ($<n>1) { $<n>$ = NewArgumentList(); AppendArgument($<n>$, $<n>1); } else { $<n>$ = 0L; } }
 		|	ARGLIST T_COMMA error
-			{ $<n>$ = 0L; DeleteNode($<n>1); yyerror(store, EParseErrorEmptyArg); }
+			{ $<n>$ = 0L; DeleteNode($<n>1); yyerror(store, state, EParseErrorEmptyArg); }
 		|	{} /**/ T_COMMA ARGUMENT
-			{ yyerror(store, EParseErrorEmptyArg); DeleteNode($<n>3); $<n>$ = 0L; }
+			{ yyerror(store, state, EParseErrorEmptyArg); DeleteNode($<n>3); $<n>$ = 0L; }
 		;
 
 ARGUMENT	:	START
@@ -30,18 +30,12 @@
 
 #include "dialoglauncher.h"
 #include "enodes.h"
-#include "eparse-eh.h"
 #include "datacollection.h"
 #include "debug.h"
 #include "kst_i18n.h"
 #include "generatedvector.h"
 #include "objectstore.h"
 
-/*extern "C"*/ int yyparse(Kst::ObjectStore *store);
-extern void *ParsedEquation;
-/*extern "C"*/ struct yy_buffer_state *yy_scan_string(const char*);
-int yylex_destroy (void );
-
 namespace Kst {
 
 const QString Equation::staticTypeString = I18N_NOOP("Equation");
@@ -137,25 +131,15 @@ const QString Equation::reparsedEquation() const {
   QString etext;
 
   if (!_equation.isEmpty()) {
-    if (!Equations::mutex().tryLock()) {
-      qDebug() << "Don't reparse equation while it is being reparsed...";
-      return (_equation);
-    }
-
-    yylex_destroy();
-    yy_scan_string(parseableEquation());
-    ParsedEquation = 0L;
-    int rc = yyparse(store());
-    Equations::Node *en = static_cast<Equations::Node*>(ParsedEquation);
-    if (rc == 0 && en) {
+    const QByteArray text = parseableEquation();
+    Equations::Node *en = Equations::parse(store(), text.constData(), text.length());
+    if (en) {
       if (!en->takeVectors(VectorsUsed)) {
         Debug::self()->log(i18n("Equation [%1] failed to find its vectors when reparsing.").arg(_equation), Debug::Warning);
       }
       etext = en->text();
     }
     delete en;
-    ParsedEquation = 0L;
-    Equations::mutex().unlock();
     //etext.replace("atanx(", "atan2(");
     //etext.replace("atanxd(", "atan2d(");
   }
@@ -188,13 +172,9 @@ void Equation::save(QXmlStreamWriter &s) {
   // any vectors or scalars that had name changes, but we don't get affected by
   // the optimizer
   if (!_equation.isEmpty()) {
-    QMutexLocker ml(&Equations::mutex());
-    yylex_destroy();
-    yy_scan_string(parseableEquation());
-    ParsedEquation = 0L;
-    int rc = yyparse(store());
-    Equations::Node *en = static_cast<Equations::Node*>(ParsedEquation);
-    if (rc == 0 && en) {
+    const QByteArray text = parseableEquation();
+    Equations::Node *en = Equations::parse(store(), text.constData(), text.length());
+    if (en) {
       if (!en->takeVectors(VectorsUsed)) {
         Debug::self()->log(i18n("Equation [%1] failed to find its vectors when saving.  Resulting Kst file may have issues.").arg(_equation), Debug::Warning);
       }
@@ -202,7 +182,6 @@ void Equation::save(QXmlStreamWriter &s) {
       s.writeAttribute("expression", etext);
     }
     delete en;
-    ParsedEquation = 0L;
   }
 
   if (_xInVector) {
@@ -229,14 +208,10 @@ void Equation::setEquation(const QString& in_fn) {
   delete _pe;
   _pe = 0L;
   if (!_equation.isEmpty()) {
-    Equations::mutex().lock();
-    yylex_destroy();
-    yy_scan_string(parseableEquation());
-    int rc = yyparse(store()); 
-    _pe = static_cast<Equations::Node*>(ParsedEquation);
-    if (rc == 0 && _pe) {
-      ParsedEquation = 0L;
-      Equations::mutex().unlock();
+    const QByteArray text = parseableEquation();
+    QStringList errors;
+    _pe = Equations::parse(store(), text.constData(), text.length(), &errors);
+    if (_pe) {
       Equations::Context ctx;
       ctx.sampleCount = _ns;
       ctx.xVector = _xInVector;
@@ -248,20 +223,13 @@ void Equation::setEquation(const QString& in_fn) {
       } else {
         //we have bad objects...
         Debug::self()->log(i18n("Equation [%1] references non-existent objects.").arg(_equation), Debug::Error);
-        delete (Equations::Node*)ParsedEquation;
-        ParsedEquation = 0L;
-        //Equations::mutex().unlock();
       }
     } else {
       // Parse error
       Debug::self()->log(i18n("Equation [%1] failed to parse.  Errors follow.").arg(_equation), Debug::Warning);
-      for (QStringList::ConstIterator i = Equations::errorStack.begin(); i != Equations::errorStack.end(); ++i) {
+      for (QStringList::ConstIterator i = errors.begin(); i != errors.end(); ++i) {
         Debug::self()->log(i18n("Parse Error: %1").arg(*i), Debug::Warning);
       }
-      delete (Equations::Node*)ParsedEquation;
-      ParsedEquation = 0L;
-      _pe = 0L;
-      Equations::mutex().unlock();
     }
   }
   _isValid = _pe != 0L;
@@ -331,10 +299,10 @@ qint64 Equation::minInputSerial() const {
 qint64 Equation::maxInputSerialOfLastChange() const {
   qint64 maxSerial = DataObject::maxInputSerialOfLastChange();
 
-  foreach (VectorPtr P, VectorsUsed) {
+  foreach (const VectorPtr &P, VectorsUsed) {
     maxSerial = qMax(maxSerial, P->serialOfLastChange());
   }
-  foreach (ScalarPtr P, ScalarsUsed) {
+  foreach (const ScalarPtr &P, ScalarsUsed) {
     maxSerial = qMax(maxSerial, P->serialOfLastChange());
   }
   return maxSerial;
@@ -475,29 +443,22 @@ bool Equation::FillY(bool force) {
       return true;
     }
 
-    QMutexLocker ml(&Equations::mutex());
-    yylex_destroy();
-    QString eq = _equation;
-    yy_scan_string(parseableEquation());
-    int rc = yyparse(store());
-    _pe = static_cast<Equations::Node*>(ParsedEquation);
-    if (_pe && rc == 0) {
+    const QByteArray text = parseableEquation();
+    _pe = Equations::parse(store(), text.constData(), text.length());
+    if (_pe) {
       Equations::FoldVisitor vis(&ctx, &_pe);
       StringMap sm;
       _pe->collectObjects(VectorsUsed, ScalarsUsed, sm);
-      ParsedEquation = 0L;
     } else {
-      delete (Equations::Node*)ParsedEquation;
-      ParsedEquation = 0L;
-      _pe = 0L;
       unlockInputsAndOutputs();
       return false;
     }
   }
 
+  ResampledVector xs(iv, _ns, i0, _ns);
   for (ctx.i = i0; ctx.i < _ns; ++ctx.i) {
     rawxv[ctx.i] = iv->value(ctx.i);
-    ctx.x = iv->interpolate(ctx.i, _ns);
+    ctx.x = xs.at(ctx.i);
     rawyv[ctx.i] = _pe->value(&ctx);
   }
 
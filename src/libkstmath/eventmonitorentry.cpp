@@ -20,12 +20,15 @@
 #include <qthread.h>
 #include <QEvent>
 #include <QApplication>
+#include <QStringList>
 
 // application specific includes
 #include "enodes.h"
 #include "emailthread.h"
 #include "dialoglauncher.h"
 #include "datacollection.h"
+#include "math_kst.h"
+#include "updatemanager.h"
 
 #include <QXmlStreamWriter>
 
@@ -36,10 +39,6 @@
 #include <unistd.h>
 #endif
 
-extern int yyparse(Kst::ObjectStore *store);
-extern void *ParsedEquation;
-extern struct yy_buffer_state *yy_scan_string(const char*);
-
 namespace Kst {
 
 const QString EventMonitorEntry::staticTypeString = I18N_NOOP("Event Monitor");
@@ -47,6 +46,8 @@ const QString EventMonitorEntry::staticTypeTag = I18N_NOOP("eventmonitor");
 
 namespace {
   const int EventMonitorEventType = int(QEvent::User) + 2931;
+  // samples evaluated at a time
+  const int EvaluationBlock = 4096;
   class EventMonitorEvent : public QEvent {
     public:
       EventMonitorEvent(const QString& msg) : QEvent(QEvent::Type(EventMonitorEventType)), logMessage(msg) {}
@@ -54,10 +55,6 @@ namespace {
   };
 }
 
-//extern "C" int yyparse();
-//extern "C" void *ParsedEquation;
-//extern "C" struct yy_buffer_state *yy_scan_string(const char*);
-
 const QString EventMonitorEntry::OUTXVECTOR('X');
 const QString EventMonitorEntry::OUTYVECTOR('Y');
 
@@ -70,7 +67,9 @@ EventMonitorEntry::EventMonitorEntry(ObjectStore *store) : DataObject(store) {
   const int NS = 1;
 
   _numDone = 0;
+  _intervals = 0;
   _isValid = false;
+  _sparse = false;
   _pExpression = 0L;
 
   _typeString = staticTypeString;
@@ -86,6 +85,10 @@ EventMonitorEntry::EventMonitorEntry(ObjectStore *store) : DataObject(store) {
   yv->resize(NS);
   yv->setProvider(this);
   _yVector = _outputVectors.insert(OUTYVECTOR, yv);
+
+  // the events are looked for at every update, whether or not anything
+  // shows the monitor
+  UpdateManager::self()->addInterest(this, this);
 }
 
 void EventMonitorEntry::_initializeShortName() {
@@ -94,11 +97,9 @@ void EventMonitorEntry::_initializeShortName() {
 bool EventMonitorEntry::reparse() {
   _isValid = false;
   if (!_event.isEmpty()) {
-    Equations::mutex().lock();
-    yy_scan_string(_event.toLatin1());
-    int rc = yyparse(store());
-    if (rc == 0) {
-      _pExpression = static_cast<Equations::Node*>(ParsedEquation);
+    const QByteArray text = _event.toLatin1();
+    _pExpression = Equations::parse(store(), text.constData(), text.length());
+    if (_pExpression) {
       Equations::Context ctx;
       Equations::FoldVisitor vis(&ctx, &_pExpression);
       StringMap stm;
@@ -109,13 +110,8 @@ bool EventMonitorEntry::reparse() {
           (*i)->readLock();
         }
       }
-      Equations::mutex().unlock();
       _isValid = true;
-    } else {
-      delete (Equations::Node*)ParsedEquation;
-      Equations::mutex().unlock();
     }
-    ParsedEquation = 0L;
   }
   return _isValid;
 }
@@ -131,6 +127,7 @@ void EventMonitorEntry::save(QXmlStreamWriter &xml) {
   xml.writeAttribute("logelog", QVariant(_logELOG).toString());
   xml.writeAttribute("emailrecipients", _eMailRecipients);
   xml.writeAttribute("script", _script);
+  xml.writeAttribute("sparse", QVariant(_sparse).toString());
   xml.writeEndElement();
 }
 
@@ -161,12 +158,20 @@ void EventMonitorEntry::internalUpdate() {
   double *rawValuesX = 0L;
   double *rawValuesY = 0L;
   if (xv && yv) {
-    if (xv->resize(ns)) {
-      rawValuesX = xv->value();
-    }
+    if (_sparse) {
+      if (_numDone == 0 && xv->resize(1) && yv->resize(1)) {
+        xv->value()[0] = NOPOINT;
+        yv->value()[0] = NOPOINT;
+        _intervals = 0;
+      }
+    } else {
+      if (xv->resize(ns)) {
+        rawValuesX = xv->value();
+      }
 
-    if (yv->resize(ns)) {
-      rawValuesY = yv->value();
+      if (yv->resize(ns)) {
+        rawValuesY = yv->value();
+      }
     }
   }
 
@@ -176,21 +181,56 @@ void EventMonitorEntry::internalUpdate() {
 
   if (needToEvaluate()) {
     if (_pExpression) {
-      for (ctx.i = _numDone; ctx.i < ns; ++ctx.i) {
-        const double value = _pExpression->value(&ctx);
-        if (value != 0.0) { // The expression evaluates to true
-          log(ctx.i);
-          if (rawValuesX && rawValuesY) {
-            rawValuesX[ctx.i] = ctx.i;
-            rawValuesY[ctx.i] = 1.0;
+      // The runs found by this update.  The first carries on from the last
+      // one already in the outputs, in case the run goes on.
+      QVector<int> runStarts;
+      QVector<int> runEnds;
+      if (_sparse && _intervals > 0 && xv && yv) {
+        runStarts.append(int(xv->value()[_intervals - 1]));
+        runEnds.append(int(yv->value()[_intervals - 1]));
+      }
+
+      QVector<double> block(EvaluationBlock);
+      for (int first = _numDone; first < ns; first += EvaluationBlock) {
+        const int n = qMin(int(EvaluationBlock), ns - first);
+        ctx.i = first;
+        _pExpression->values(&ctx, n, block.data());
+
+        for (int k = 0; k < n; ++k) {
+          const int i = first + k;
+          const bool triggered = block[k] != 0.0; // The expression evaluates to true
+          if (triggered) {
+            log(i);
+            if (_sparse) {
+              if (!runEnds.isEmpty() && runEnds.last() == i - 1) {
+                runEnds.last() = i;
+              } else {
+                runStarts.append(i);
+                runEnds.append(i);
+              }
+            }
           }
-        } else {
           if (rawValuesX && rawValuesY) {
-            rawValuesX[ctx.i] = ctx.i;
-            rawValuesY[ctx.i] = 0.0;
+            rawValuesX[i] = i;
+            rawValuesY[i] = triggered ? 1.0 : 0.0;
+          }
+        }
+      }
+
+      if (_sparse && xv && yv && !runStarts.isEmpty()) {
+        const int base = qMax(_intervals - 1, 0);
+        const int count = base + runStarts.size();
+        if (xv->resize(count) && yv->resize(count)) {
+          rawValuesX = xv->value();
+          rawValuesY = yv->value();
+          for (int j = 0; j < runStarts.size(); ++j) {
+            rawValuesX[base + j] = runStarts.at(j);
+            rawValuesY[base + j] = runEnds.at(j);
           }
+          _intervals = count;
         }
       }
+
       _numDone = ns;
       logImmediately();
     }
@@ -225,33 +265,19 @@ bool EventMonitorEntry::needToEvaluate() {
 
 
 void EventMonitorEntry::logImmediately(bool sendEvent) {
-  const int arraySize = _indexArray.size();
-
-  if (arraySize > 0) {
+  if (!_logRanges.isEmpty()) {
     QString logMessage;
-    QString rangeString;
-    bool makeRange = false;
-    int idx = 0;
-    int idxOld = 0;
-
-    for (int i = 0; i < arraySize; ++i) {
-      idx = _indexArray.at(i);
-      if (i == 0) {
-        rangeString.setNum(idx);
-      } else if (!makeRange && idx == idxOld + 1) {
-        makeRange = true;
-      } else if (makeRange && idx != idxOld + 1) {
-        rangeString = rangeString + QString(" - %1, %2").arg(idxOld).arg(idx);
-        makeRange = false;
-      } else if (idx != idxOld + 1) {
-        rangeString = rangeString + QString(", %1").arg(idx);
+    QStringList ranges;
+
+    for (int i = 0; i < _logRanges.size(); ++i) {
+      const QPair<int, int>& range = _logRanges.at(i);
+      if (range.first == range.second) {
+        ranges.append(QString::number(range.first));
+      } else {
+        ranges.append(QString("%1 - %2").arg(range.first).arg(range.second));
       }
-      idxOld = idx;
-    }
-
-    if (makeRange) {
-        rangeString = rangeString + QString(", %1").arg(idx);
     }
+    const QString rangeString = ranges.join(", ");
 
     if (_description.isEmpty()) {
       logMessage = "Event Monitor: " + _event + ": " + rangeString;
@@ -259,7 +285,7 @@ void EventMonitorEntry::logImmediately(bool sendEvent) {
       logMessage = "Event Monitor: " + _description + ": " + rangeString;
     }
 
-    _indexArray.clear();
+    _logRanges.clear();
 
     if (sendEvent) { // update thread
       QApplication::postEvent(this, new EventMonitorEvent(logMessage));
@@ -305,9 +331,13 @@ void EventMonitorEntry::doLog(const QString& logMessage) const {
 
 
 void EventMonitorEntry::log(int idx) {
-  _indexArray.append(idx);
-  if (_indexArray.size() > 1000) {
-    logImmediately();
+  if (!_logRanges.isEmpty() && _logRanges.last().second == idx - 1) {
+    _logRanges.last().second = idx;
+  } else {
+    _logRanges.append(qMakePair(idx, idx));
+    if (_logRanges.size() > 1000) {
+      logImmediately();
+    }
   }
 }
 
@@ -339,6 +369,15 @@ void EventMonitorEntry::setScriptCode(const QString& script) {
 }
 
 
+void EventMonitorEntry::setSparse(bool sparse) {
+  if (_sparse != sparse) {
+    _sparse = sparse;
+    _numDone = 0;
+    _intervals = 0;
+  }
+}
+
+
 void EventMonitorEntry::setDescription(const QString& str) {
   if (_description != str) {
     _description = str;
@@ -399,6 +438,7 @@ DataObjectPtr EventMonitorEntry::makeDuplicate() const {
   eventMonitor->setLogEMail(_logEMail);
   eventMonitor->setLogELOG(_logELOG);
   eventMonitor->setEMailRecipients(_eMailRecipients);
+  eventMonitor->setSparse(_sparse);
 
   if (descriptiveNameIsManual()) {
     eventMonitor->setDescriptiveName(descriptiveName());
@@ -434,6 +474,15 @@ bool EventMonitorEntry::uses(ObjectPtr p) const {
   return DataObject::uses(p);
 }
 
+
+QList<ObjectPtr> EventMonitorEntry::inputObjects() const {
+  QList<ObjectPtr> inputs = DataObject::inputObjects();
+  for (VectorMap::ConstIterator i = _vectorsUsed.begin(); i != _vectorsUsed.end(); ++i) {
+    inputs.append(ObjectPtr(i.value()));
+  }
+  return inputs;
+}
+
 QString EventMonitorEntry::_automaticDescriptiveName() const {
   return i18n("event");
 }
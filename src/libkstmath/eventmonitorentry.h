@@ -17,6 +17,7 @@
 #define EVENTMONITORENTRY_H
 
 #include <qtimer.h>
+#include <QPair>
 
 #include "dataobject.h"
 #include "debug.h"
@@ -54,6 +55,11 @@ class KSTMATH_EXPORT EventMonitorEntry : public DataObject {
     const QString& eMailRecipients() const { return _eMailRecipients; }
     const QString& scriptCode() const;
 
+    // In sparse mode X and Y hold the first and last sample of each run of
+    // samples where the event is true, instead of a 0/1 flag per sample.
+    bool sparse() const { return _sparse; }
+    void setSparse(bool sparse);
+
     void setScriptCode(const QString& script);
     void setEvent(const QString& str);
     void setDescription(const QString& str);
@@ -69,6 +75,7 @@ class KSTMATH_EXPORT EventMonitorEntry : public DataObject {
     DataObjectPtr makeDuplicate() const;
 
     bool uses(ObjectPtr p) const;
+    QList<ObjectPtr> inputObjects() const;
 
     virtual QString descriptionTip() const;
 
@@ -94,7 +101,7 @@ class KSTMATH_EXPORT EventMonitorEntry : public DataObject {
     static const QString OUTYVECTOR;
 
     VectorMap _vectorsUsed;
-    QVector<int> _indexArray;
+    QVector<QPair<int, int> > _logRanges;
     QString _event;
     QString _description;
     QString _eMailRecipients;
@@ -106,7 +113,9 @@ class KSTMATH_EXPORT EventMonitorEntry : public DataObject {
     bool _logEMail;
     bool _logELOG;
     bool _isValid;
+    bool _sparse;
     int _numDone;
+    int _intervals;
     QString _script;
 };
 
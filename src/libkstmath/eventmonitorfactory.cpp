@@ -33,7 +33,7 @@ DataObjectPtr EventMonitorFactory::generateObject(ObjectStore *store, QXmlStream
   Q_ASSERT(store);
 
   QString equation, description, emailRecipients, script;
-  bool logDebug=false, logEmail=false, logELOG=false;
+  bool logDebug=false, logEmail=false, logELOG=false, sparse=false;
   int logLevel=1;
 
   while (!xml.atEnd()) {
@@ -50,6 +50,7 @@ DataObjectPtr EventMonitorFactory::generateObject(ObjectStore *store, QXmlStream
         logDebug = attrs.value("logdebug").toString() == "true" ? true : false;
         logEmail = attrs.value("logemail").toString() == "true" ? true : false;
         logELOG = attrs.value("logelog").toString() == "true" ? true : false;
+        sparse = attrs.value("sparse").toString() == "true" ? true : false;
       } else {
         return 0;
       }
@@ -79,6 +80,7 @@ DataObjectPtr EventMonitorFactory::generateObject(ObjectStore *store, QXmlStream
   eventMonitor->setLogEMail(logEmail);
   eventMonitor->setLogELOG(logELOG);
   eventMonitor->setEMailRecipients(emailRecipients);
+  eventMonitor->setSparse(sparse);
 
   eventMonitor->reparse();
 
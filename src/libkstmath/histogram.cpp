@@ -23,12 +23,14 @@
 #include <stdlib.h>
 
 #include <QTextDocument>
+#include <QVector>
 #include <QXmlStreamWriter>
 #include "kst_i18n.h"
 
 #include "dialoglauncher.h"
 #include "datacollection.h"
 #include "objectstore.h"
+#include "parallel.h"
 
 namespace Kst {
 
@@ -39,6 +41,62 @@ static const QLatin1String& RAWVECTOR  = QLatin1String("I");
 static const QLatin1String& BINS = QLatin1String("B");
 static const QLatin1String& HIST = QLatin1String("H");
 
+// below this many samples per chunk, threads cost more than they save
+#define BIN_CHUNK 65536
+
+static void binSamples(const double *v, qint64 n, double minX, double maxX, double w, int nBins, unsigned long *bins) {
+  const double top = nBins;
+  for (qint64 i = 0; i < n; ++i) {
+    const double y = v[i];
+    const double f = (y - minX)/w;
+    if (f >= 0.0 && f < top) {
+      ++bins[int(f)];
+    } else if (y == maxX) {
+      // the top boundary of the top bin is included in the top bin.
+      // for all other bins, the top boundary is included in the next bin
+      ++bins[nBins - 1];
+    }
+  }
+}
+
+
+// Bins a stretch of samples with one private set of bins per chunk, so the
+// threads never share a counter; the sets are added up afterwards.
+class BinJob : public ParallelJob {
+  public:
+    BinJob(const double *v, double minX, double maxX, double w, int nBins, int chunks)
+      : _v(v), _minX(minX), _maxX(maxX), _w(w), _nBins(nBins), _chunks(chunks),
+        _bins(chunks * nBins, 0) {
+    }
+
+    void processChunk(int chunk, qint64 begin, qint64 end) {
+      binSamples(_v + begin, end - begin, _minX, _maxX, _w, _nBins, _bins.data() + chunk * _nBins);
+    }
+
+    void merge(unsigned long *bins) const {
+      for (int c = 0; c < _chunks; ++c) {
+        const unsigned long *b = _bins.constData() + c * _nBins;
+        for (int i = 0; i < _nBins; ++i) {
+          bins[i] += b[i];
+        }
+      }
+    }
+
+  private:
+    const double *_v;
+    double _minX;
+    double _maxX;
+    double _w;
+    int _nBins;
+    int _chunks;
+    QVector<unsigned long> _bins;
+};
+
+
+static inline bool sameSample(double a, double b) {
+  return a == b || (a != a && b != b);
+}
+
 Histogram::Histogram(ObjectStore *store)
   : DataObject(store) {
   setRealTimeAutoBin(false);
@@ -50,6 +108,7 @@ Histogram::Histogram(ObjectStore *store)
   // so initialize them as size 2 (where 2 is a small valid number)
   _Bins = new unsigned long[2];
   _NumberOfBins = 0;
+  _binnedSamples = 0;
 
   VectorPtr v = store->createObject<Vector>();
   v->setProvider(this);
@@ -82,6 +141,7 @@ void Histogram::change(VectorPtr in_V,
   _NormalizationMode = in_norm_mode;
   _realTimeAutoBin = realTimeAutoBin;
   _NumberOfBins = 0;
+  _binnedSamples = 0;
 
   _inputVectors[RAWVECTOR] = in_V;
 
@@ -139,21 +199,34 @@ void Histogram::internalUpdate() {
   _NS = 3 * _NumberOfBins + 1;
   _W = (_MaxX - _MinX)/double(_NumberOfBins);
 
-  memset(_Bins, 0, _NumberOfBins*sizeof(*_Bins));
+  VectorPtr rawV = _inputVectors[RAWVECTOR];
+  ns = rawV->length();
+  const double *v = rawV->value();
 
-  ns = _inputVectors[RAWVECTOR]->length();
-  for (i_pt = 0; i_pt < ns ; ++i_pt) {
-    y = _inputVectors[RAWVECTOR]->interpolate(i_pt, ns);
-    i_bin = (int)floor((y-_MinX)/_W);
-    if (i_bin >= 0 && i_bin < _NumberOfBins) {
-      _Bins[i_bin]++;
-    } else {
-      // the top boundary of the top bin is included in the top bin.
-      // for all other bins, the top boundary is included in the next bin
-      if (y == _MaxX) {
-        _Bins[_NumberOfBins-1]++;
-      }
-    }
+  // if samples have only been appended since the last update, and the bins
+  // haven't changed, only the new samples need binning.
+  i_pt = 0;
+  if (onlyAppended(rawV)) {
+    i_pt = _binnedSamples;
+  } else {
+    memset(_Bins, 0, _NumberOfBins*sizeof(*_Bins));
+  }
+
+  const qint64 minChunk = qMax(qint64(BIN_CHUNK), 4 * qint64(_NumberOfBins));
+  const int chunks = parallelChunks(ns - i_pt, minChunk);
+  if (chunks > 1) {
+    BinJob job(v + i_pt, _MinX, _MaxX, _W, _NumberOfBins, chunks);
+    runParallel(&job, ns - i_pt, minChunk);
+    job.merge(_Bins);
+  } else {
+    binSamples(v + i_pt, ns - i_pt, _MinX, _MaxX, _W, _NumberOfBins, _Bins);
+  }
+
+  _binnedSamples = ns;
+  if (ns > 0) {
+    _binnedFirst = v[0];
+    _binnedMiddle = v[(ns - 1)/2];
+    _binnedLast = v[ns - 1];
   }
 
   for (i_bin=0; i_bin<_NumberOfBins; ++i_bin) {
@@ -232,7 +305,26 @@ void Histogram::setXRange(double xmin_in, double xmax_in) {
 }
 
 
+bool Histogram::onlyAppended(VectorPtr v) const {
+  const int ns = v->length();
+  if (_binnedSamples <= 0 || ns < _binnedSamples) {
+    return false;
+  }
+  if (v->numShift() != 0 || ns - v->numNew() != _binnedSamples) {
+    return false;
+  }
+
+  // numNew() isn't reset by everything that rewrites a vector, so make sure
+  // the samples we binned last time still look the same.
+  const double *d = v->value();
+  return sameSample(d[0], _binnedFirst) &&
+         sameSample(d[(_binnedSamples - 1)/2], _binnedMiddle) &&
+         sameSample(d[_binnedSamples - 1], _binnedLast);
+}
+
+
 void Histogram::internalSetXRange(double xmin_in, double xmax_in) {
+  const double oldMin = _MinX, oldMax = _MaxX;
   if (xmax_in > xmin_in) {
     _MaxX = xmax_in;
     _MinX = xmin_in;
@@ -244,6 +336,9 @@ void Histogram::internalSetXRange(double xmin_in, double xmax_in) {
     _MaxX = xmax_in + 1.0;
   }
   _W = (_MaxX - _MinX)/double(_NumberOfBins);
+  if (_MinX != oldMin || _MaxX != oldMax) {
+    _binnedSamples = 0;
+  }
 }
 
 
@@ -253,6 +348,7 @@ void Histogram::internalSetNumberOfBins(int in_n_bins) {
   }
   if (_NumberOfBins != in_n_bins) {
     _NumberOfBins = in_n_bins;
+    _binnedSamples = 0;
 
     delete[] _Bins;
     _Bins = new unsigned long[_NumberOfBins];
@@ -274,6 +370,7 @@ void Histogram::setNumberOfBins(int in_n_bins) {
 void Histogram::setVector(VectorPtr new_v) {
   if (new_v) {
     _inputVectors[RAWVECTOR] = new_v;
+    _binnedSamples = 0;
   }
 }
 
@@ -115,8 +115,16 @@ public:
     double _W;
     bool _realTimeAutoBin;
 
+    // what the bins currently hold, so that samples appended to the input
+    // can be added to them without binning the whole vector again.
+    int _binnedSamples;
+    double _binnedFirst;
+    double _binnedMiddle;
+    double _binnedLast;
+
     void internalSetNumberOfBins(int in_n_bins);
     void internalSetXRange(double xmin_in, double xmax_in);
+    bool onlyAppended(VectorPtr v) const;
 };
 
 typedef SharedPtr<Histogram> HistogramPtr;
@@ -513,11 +513,25 @@ void Image::updatePaintObjects(const CurveRenderContext& context) {
         int iw = _image.width();
         double m_minX = m->minX();
         double m_minY = m->minY();
+        double m_numX = m->xNumSteps();
         double m_numY = m->yNumSteps();
         double m_stepYr = 1.0/m->yStepSize();
         double m_stepXr = 1.0/m->xStepSize();
         int x_index;
         int y_index;
+
+        // when several matrix cells fall on each screen pixel, sample the
+        // pyramid level whose cells are closest to a pixel in size.
+        int level = 0;
+        if (!xLog && !yLog) {
+          const double cellsPerPixel = qMin(fabs(m_stepXr / m_X), fabs(m_stepYr / m_Y));
+          while (level < MatrixPyramid::MaxLevel && cellsPerPixel >= double(2 << level)) {
+            ++level;
+          }
+        }
+        int levelNX, levelNY;
+        const double *zLevel = m->zLevel(level, &levelNX, &levelNY);
+        m_numX = qMin(m_numX, double(levelNX) * (1 << level));
         int palCountMinus1 = _pal.colorCount() - 1;
         double palCountMin1_OverDZ = double(palCountMinus1) / (_zUpper - _zLower);
 
@@ -535,6 +549,7 @@ void Image::updatePaintObjects(const CurveRenderContext& context) {
           if (y_index<0 || y_index>=m_numY) {
             okY = false;
           }
+          const double *zColumn = zLevel + (okY ? (y_index >> level) : 0);
           double A = img_Lx_pix - b_X;
           double B = 1.0/m_X;
           for (int x = 0; x < iw; ++x) {
@@ -546,9 +561,13 @@ void Image::updatePaintObjects(const CurveRenderContext& context) {
               new_x = (x + A)*B;
             }
             x_index = (int)((new_x - m_minX)*m_stepXr);
-            double z = m->Z(x_index * m_numY + y_index);
-
-            okZ = (isfinite(z));
+            double z = 0.0;
+            if (okY && x_index >= 0 && x_index < m_numX) {
+              z = zColumn[qint64(x_index >> level) * levelNY];
+              okZ = isfinite(z);
+            } else {
+              okZ = false;
+            }
 
             if (okZ && okY) {
               scanLine[x] = _pal.rgb((int)(((z - _zLower) * palCountMin1_OverDZ)));
@@ -16,6 +16,7 @@
  ***************************************************************************/
 
 #include "labelparser.h"
+#include "enodes.h"
 
 #include <assert.h>
 #include <stdlib.h>
@@ -35,7 +36,7 @@ using namespace Label;
 #endif
 
 Chunk::Chunk(Chunk *parent, VOffset dir, bool isGroup, bool inherit)
-: next(0L), prev(0L), up(0L), down(0L), group(0L), scalar(false), linebreak(false), tab(false), vector(false), vOffset(dir) {
+: next(0L), prev(0L), up(0L), down(0L), group(0L), scalar(false), linebreak(false), tab(false), vector(false), vOffset(dir), resolved(false), compiled(0L) {
   assert(parent || vOffset == None);
   if (parent) {  // attach and inherit
     switch (vOffset) {
@@ -76,6 +77,8 @@ Chunk::~Chunk() {
   delete down;
   delete group;
   group = 0L;
+  delete compiled;
+  compiled = 0L;
   if (prev) {
     switch (vOffset) {
       case None:
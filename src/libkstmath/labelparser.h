@@ -23,6 +23,10 @@
 
 #include <qcolor.h>
 
+namespace Equations {
+  class Node;
+}
+
 typedef quint16 KstLJustifyType;
 typedef quint8  KstLHJustifyType;
 typedef quint8  KstLVJustifyType;
@@ -71,6 +75,13 @@ namespace Label {
     ChunkAttributes attributes;
     QString text;
     QString expression;
+
+    // What a scalar or vector chunk refers to, looked up by the renderer the
+    // first time it draws the chunk: the object named by text, and the
+    // compiled '=' equation or vector index expression.
+    bool resolved : 1;
+    Kst::ObjectPtr object;
+    Equations::Node *compiled;
   };
 
 
@@ -114,5 +114,4 @@ HEADERS += \
     relation.h \
     relationfactory.h
 
-#LEXSOURCES += escan.l
 #YACCSOURCES += eparse.y
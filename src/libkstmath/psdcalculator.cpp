@@ -186,6 +186,20 @@ int PSDCalculator::calculatePowerSpectrum(
     updateWindowFxn(apodizeFxn, gaussianSigma);
   }
 
+  // fill in the holes once, up front, rather than searching for the
+  // neighbours of every missing sample of every window.
+  if (interpolateHoles) {
+    int i_hole = 0;
+    while (i_hole < inputLen && input[i_hole] == input[i_hole]) {
+      ++i_hole;
+    }
+    if (i_hole < inputLen) {
+      _filled.resize(inputLen);
+      Kst::kstFillHoles(input, inputLen, _filled.data());
+      input = _filled.data();
+    }
+  }
+
   int currentCopyLen, nsamples = 0;
   int i_samp, i_subset, ioffset;
 
@@ -223,22 +237,10 @@ int PSDCalculator::calculatePowerSpectrum(
 
     // apply the PSD options (removeMean, apodize, etc.)
     // separate cases for speed- although this shouldn't really matter- the rdft should be the most time consuming step by far for any large data set.
-    if (removeMean && apodize && interpolateHoles) {
-      for (i_samp = 0; i_samp < currentCopyLen; i_samp++) {
-        _a[i_samp] = (Kst::kstInterpolateNoHoles(input, inputLen, i_samp + ioffset, inputLen) - mean)*_w[i_samp];
-      }
-    } else if (removeMean && apodize) {
+    if (removeMean && apodize) {
       for (i_samp = 0; i_samp < currentCopyLen; i_samp++) {
         _a[i_samp] = (input[i_samp + ioffset] - mean)*_w[i_samp];
       }
-    } else if (removeMean && interpolateHoles) {
-      for (i_samp = 0; i_samp < currentCopyLen; i_samp++) {
-        _a[i_samp] = Kst::kstInterpolateNoHoles(input, inputLen, i_samp + ioffset, inputLen) - mean;
-      }
-    } else if (apodize && interpolateHoles) {
-      for (i_samp = 0; i_samp < currentCopyLen; i_samp++) {
-        _a[i_samp] = Kst::kstInterpolateNoHoles(input, inputLen, i_samp + ioffset, inputLen)*_w[i_samp];
-      }
     } else if (removeMean) {
       for (i_samp = 0; i_samp < currentCopyLen; i_samp++) {
         _a[i_samp] = input[i_samp + ioffset] - mean;
@@ -247,10 +249,6 @@ int PSDCalculator::calculatePowerSpectrum(
       for (i_samp = 0; i_samp < currentCopyLen; i_samp++) {
         _a[i_samp] = input[i_samp + ioffset]*_w[i_samp];
       }
-    } else if (interpolateHoles) {
-      for (i_samp = 0; i_samp < currentCopyLen; i_samp++) {
-        _a[i_samp] = Kst::kstInterpolateNoHoles(input, inputLen, i_samp + ioffset, inputLen);
-      }
     } else {
       for (i_samp = 0; i_samp < currentCopyLen; i_samp++) {
         _a[i_samp] = input[i_samp + ioffset];
@@ -21,6 +21,8 @@
 #ifndef PSDCALCULATOR_H
 #define PSDCALCULATOR_H
 
+#include <QVector>
+
 // the following should reflect the PSD type order in fftoptionswidget.ui
 enum PSDType {
   PSDUndefined = -1,
@@ -65,6 +67,9 @@ class PSDCalculator {
 
     int _awLen; //length of a and w.
 
+    // the input with its holes interpolated over, when it has any.
+    QVector<double> _filled;
+
     // keep track of prevs to avoid redundant regenerations
     ApodizeFunction _prevApodizeFxn;
     double _prevGaussianSigma;
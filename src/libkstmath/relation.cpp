@@ -22,7 +22,9 @@
 #include "kst_i18n.h"
 
 #include "objectstore.h"
+#include "parallel.h"
 
+#include <QSet>
 #include <QXmlStreamWriter>
 
 namespace Kst {
@@ -75,12 +77,59 @@ void Relation::deleteDependents() {
 
 
 void Relation::paint(const CurveRenderContext& context) {
-  if (redrawRequired(context) || _redrawRequired) {
-    updatePaintObjects(context);
+  preparePaint(context);
+  paintObjects(context);
+}
+
+
+void Relation::preparePaint(const CurveRenderContext& context) {
+  const bool contextChanged = redrawRequired(context);
+  if (contextChanged || _redrawRequired) {
+    if (contextChanged || !appendPaintObjects(context)) {
+      updatePaintObjects(context);
+    }
     _redrawRequired = false;
   }
+}
 
-  paintObjects(context);
+
+namespace {
+
+class PreparePaintJob : public ParallelJob {
+  public:
+    PreparePaintJob(const QList<Relation*>& relations, const QList<CurveRenderContext>& contexts)
+      : _relations(relations), _contexts(contexts) {}
+
+    void processChunk(int, qint64 begin, qint64 end) {
+      for (qint64 i = begin; i < end; ++i) {
+        _relations.at(int(i))->preparePaint(_contexts.at(int(i)));
+      }
+    }
+
+  private:
+    const QList<Relation*>& _relations;
+    const QList<CurveRenderContext>& _contexts;
+};
+
+}
+
+
+void Relation::preparePaint(const QList<Relation*>& relations, const QList<CurveRenderContext>& contexts) {
+  // each relation once, so that no two threads ever work on the same one
+  QList<Relation*> unique;
+  QList<CurveRenderContext> uniqueContexts;
+  QSet<Relation*> seen;
+  for (int i = 0; i < relations.size() && i < contexts.size(); ++i) {
+    if (!seen.contains(relations.at(i))) {
+      seen.insert(relations.at(i));
+      unique << relations.at(i);
+      uniqueContexts << contexts.at(i);
+    }
+  }
+
+  // one relation per chunk: a single curve or image can take as long as the rest
+  PreparePaintJob job(unique, uniqueContexts);
+  runParallel(&job, unique.size(), 1);
 }
 
 
@@ -129,16 +178,16 @@ void Relation::setIgnoreAutoScale(bool ignoreAutoScale) {
 qint64 Relation::minInputSerial() const{
   qint64 minSerial = LLONG_MAX;
 
-  foreach (VectorPtr P, _inputVectors) {
+  foreach (const VectorPtr &P, _inputVectors) {
     minSerial = qMin(minSerial, P->serial());
   }
-  foreach (ScalarPtr P, _inputScalars) {
+  foreach (const ScalarPtr &P, _inputScalars) {
     minSerial = qMin(minSerial, P->serial());
   }
-  foreach (MatrixPtr P, _inputMatrices) {
+  foreach (const MatrixPtr &P, _inputMatrices) {
     minSerial = qMin(minSerial, P->serial());
   }
-  foreach (StringPtr P, _inputStrings) {
+  foreach (const StringPtr &P, _inputStrings) {
     minSerial = qMin(minSerial, P->serial());
   }
   return minSerial;
@@ -147,16 +196,16 @@ qint64 Relation::minInputSerial() const{
 qint64 Relation::maxInputSerialOfLastChange() const {
   qint64 maxSerial = NoInputs;
 
-  foreach (VectorPtr P, _inputVectors) {
+  foreach (const VectorPtr &P, _inputVectors) {
     maxSerial = qMax(maxSerial, P->serialOfLastChange());
   }
-  foreach (ScalarPtr P, _inputScalars) {
+  foreach (const ScalarPtr &P, _inputScalars) {
     maxSerial = qMax(maxSerial, P->serialOfLastChange());
   }
-  foreach (MatrixPtr P, _inputMatrices) {
+  foreach (const MatrixPtr &P, _inputMatrices) {
     maxSerial = qMax(maxSerial, P->serialOfLastChange());
   }
-  foreach (StringPtr P, _inputStrings) {
+  foreach (const StringPtr &P, _inputStrings) {
     maxSerial = qMax(maxSerial, P->serialOfLastChange());
   }
   return maxSerial;
@@ -464,6 +513,15 @@ PrimitiveList Relation::inputPrimitives() const {
   return primitive_list;
 }
 
+
+QList<ObjectPtr> Relation::inputObjects() const {
+  QList<ObjectPtr> inputs;
+  foreach (const PrimitivePtr& primitive, inputPrimitives()) {
+    inputs.append(ObjectPtr(primitive));
+  }
+  return inputs;
+}
+
 void Relation::replaceInput(PrimitivePtr p, PrimitivePtr new_p) {
   if (VectorPtr v = kst_cast<Vector>(p) ) {
     if (VectorPtr new_v = kst_cast<Vector>(new_p)) {
@@ -498,6 +556,8 @@ void Relation::replaceInput(PrimitivePtr p, PrimitivePtr new_p) {
       }
     }
   }
+  // automatic names follow the inputs
+  touchDescriptiveNames();
 }
 
 
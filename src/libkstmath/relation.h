@@ -113,6 +113,7 @@ class KSTMATH_EXPORT Relation : public Object {
     virtual void yRange(double xFrom, double xTo, double* yMin, double* yMax) = 0;
 
     virtual bool uses(ObjectPtr p) const;
+    virtual QList<ObjectPtr> inputObjects() const;
 
     // return closest distance to the given point
     // images always return a rating >= 5
@@ -121,8 +122,21 @@ class KSTMATH_EXPORT Relation : public Object {
     // render this curve
     void paint(const CurveRenderContext& context);
 
+    // bring the paint objects up to date for context, as paint() does first
+    void preparePaint(const CurveRenderContext& context);
+
+    // preparePaint() each of relations for the matching context, in parallel.
+    // Only from the GUI thread, while nothing paints: updatePaintObjects() may
+    // use the context but never its painter.  A relation listed twice is
+    // prepared for its first context only.
+    static void preparePaint(const QList<Relation*>& relations, const QList<CurveRenderContext>& contexts);
+
     virtual void paintObjects(const CurveRenderContext& context) = 0;
     virtual void updatePaintObjects(const CurveRenderContext& context) = 0;
+    // Called instead of updatePaintObjects() when the inputs changed but the
+    // context didn't: adds the paint objects of samples appended since and
+    // returns true, or returns false if everything has to be redone.
+    virtual bool appendPaintObjects(const CurveRenderContext& context) { Q_UNUSED(context); return false; }
 
     // render the legend symbol for this curve
     virtual QSize legendSymbolSize(QPainter *p) = 0;
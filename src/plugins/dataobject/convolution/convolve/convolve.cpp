@@ -17,8 +17,7 @@
 #include "objectstore.h"
 #include "ui_convolveconfig.h"
 
-#include <gsl/gsl_fft_real.h>
-#include <gsl/gsl_fft_halfcomplex.h>
+#include "../../../fftcache.h"
 
 
 static const QString& VECTOR_IN_ONE = "Vector One In";
@@ -188,8 +187,12 @@ bool ConvolveSource::algorithm() {
     return false;
   }
 
-  pdResponse = new double[iLength];
-  pdConvolve = new double[iLength];
+  //
+  // the work arrays come from the shared FFT cache and are reused across updates...
+  //
+  Kst::FFTPlanLease plan(iLength);
+  pdResponse = plan->scratch(0);
+  pdConvolve = plan->scratch(1);
   if (pdResponse != NULL && pdConvolve != NULL) {
     //
     // sort the response function into wrap-around order...
@@ -217,8 +220,8 @@ bool ConvolveSource::algorithm() {
     //
     // calculate the FFTs of the two functions...
     //
-    if (gsl_fft_real_radix2_transform( pdResponse, 1, iLength ) == 0) {
-      if (gsl_fft_real_radix2_transform( pdConvolve, 1, iLength ) == 0) {
+    if (plan->radix2Transform( pdResponse ) == 0) {
+      if (plan->radix2Transform( pdConvolve ) == 0) {
         //
         // multiply the FFTs together...
         //
@@ -237,14 +240,10 @@ bool ConvolveSource::algorithm() {
         //
         // do the inverse FFT...
         //
-        if (gsl_fft_halfcomplex_radix2_inverse( pdResponse, 1, iLength) == 0) {
+        if (plan->radix2Inverse( pdResponse ) == 0) {
           pdResult = outputVector->value();
 
           if (pdResult != NULL) {
-            for (int i = 0; i < convolve->length(); ++i) {
-              outputVector->value()[i] = pdResult[i];
-            }
-
             memcpy( pdResult, pdResponse, convolve->length() * sizeof( double ) );
 
             bReturn = true;
@@ -253,9 +252,6 @@ bool ConvolveSource::algorithm() {
       }
     }
   }
-  delete[] pdResponse;
-  delete[] pdConvolve;
-
   return bReturn;
 }
 
@@ -17,8 +17,7 @@
 #include "objectstore.h"
 #include "ui_deconvolveconfig.h"
 
-#include <gsl/gsl_fft_real.h>
-#include <gsl/gsl_fft_halfcomplex.h>
+#include "../../../fftcache.h"
 
 
 static const QString& VECTOR_IN_ONE = "Vector One In";
@@ -189,8 +188,12 @@ bool DeconvolveSource::algorithm() {
     return false;
   }
 
-  pdResponse = new double[iLength];
-  pdConvolve = new double[iLength];
+  //
+  // the work arrays come from the shared FFT cache and are reused across updates...
+  //
+  Kst::FFTPlanLease plan(iLength);
+  pdResponse = plan->scratch(0);
+  pdConvolve = plan->scratch(1);
   if (pdResponse != NULL && pdConvolve != NULL) {
     //
     // sort the response function into wrap-around order...
@@ -219,8 +222,8 @@ bool DeconvolveSource::algorithm() {
     //
     // calculate the FFTs of the two functions...
     //
-    if (gsl_fft_real_radix2_transform( pdResponse, 1, iLength ) == 0) {
-      if (gsl_fft_real_radix2_transform( pdConvolve, 1, iLength ) == 0) {
+    if (plan->radix2Transform( pdResponse ) == 0) {
+      if (plan->radix2Transform( pdConvolve ) == 0) {
         //
         // divide one FFT by the other...
         //
@@ -243,14 +246,10 @@ bool DeconvolveSource::algorithm() {
         //
         // do the inverse FFT...
         //
-        if (gsl_fft_halfcomplex_radix2_inverse( pdResponse, 1, iLength ) == 0) {
+        if (plan->radix2Inverse( pdResponse ) == 0) {
           pdResult = outputVector->value();
 
           if (pdResult != NULL) {
-            for (int i = 0; i < deconvolve->length(); ++i) {
-              outputVector->value()[i] = pdResult[i];
-            }
-
             memcpy( pdResult, pdResponse, deconvolve->length() * sizeof( double ) );
 
             bReturn = true;
@@ -259,9 +258,6 @@ bool DeconvolveSource::algorithm() {
       }
     }
   }
-  delete[] pdResponse;
-  delete[] pdConvolve;
-
   return bReturn;
 }
 
@@ -17,8 +17,7 @@
 #include "objectstore.h"
 #include "ui_autocorrelationconfig.h"
 
-#include <gsl/gsl_fft_real.h>
-#include <gsl/gsl_fft_halfcomplex.h>
+#include "../../../fftcache.h"
 
 static const QString& VECTOR_IN = "Vector In";
 static const QString& VECTOR_OUT_AUTO = "Auto-Correlated";
@@ -167,7 +166,11 @@ bool AutoCorrelationSource::algorithm() {
     return false;
   }
 
-  pdArrayOne = new double[iLength];
+  //
+  // the work array comes from the shared FFT cache and is reused across updates...
+  //
+  Kst::FFTPlanLease plan(iLength);
+  pdArrayOne = plan->scratch(0);
   if (pdArrayOne != NULL) {
     //
     // zero-pad the two arrays...
@@ -178,7 +181,7 @@ bool AutoCorrelationSource::algorithm() {
     //
     // calculate the FFTs of the two functions...
     //
-    if (gsl_fft_real_radix2_transform( pdArrayOne, 1, iLength ) == 0) {
+    if (plan->radix2Transform( pdArrayOne ) == 0) {
       //
       // multiply the FFT by its complex conjugate...
       //
@@ -197,18 +200,11 @@ bool AutoCorrelationSource::algorithm() {
       //
       // do the inverse FFT...
       //
-      if (gsl_fft_halfcomplex_radix2_inverse( pdArrayOne, 1, iLength ) == 0) {
+      if (plan->radix2Inverse( pdArrayOne ) == 0) {
         pdResult = outputVectorStep->value();
         pdCorrelate = outputVectorAuto->value();
 
         if (pdResult != NULL && pdCorrelate != NULL) {
-          for (int i = 0; i < inputVector->length(); ++i) {
-            outputVectorStep->value()[i] = pdResult[i];
-          }
-          for (int i = 0; i < inputVector->length(); ++i) {
-            outputVectorAuto->value()[i] = pdCorrelate[i];
-          }
-
           for (int i = 0; i < inputVector->length(); i++) {
               outputVectorStep->value()[i] = (double)( i - ( inputVector->length() / 2 ) );
           }
@@ -226,8 +222,6 @@ bool AutoCorrelationSource::algorithm() {
       }
     }
   }
-  delete[] pdArrayOne;
-
   return bReturn;
 }
 
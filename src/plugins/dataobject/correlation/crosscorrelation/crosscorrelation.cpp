@@ -17,8 +17,7 @@
 #include "objectstore.h"
 #include "ui_crosscorrelationconfig.h"
 
-#include <gsl/gsl_fft_real.h>
-#include <gsl/gsl_fft_halfcomplex.h>
+#include "../../../fftcache.h"
 
 
 static const QString& VECTOR_IN_ONE = "Vector One In";
@@ -183,8 +182,12 @@ bool CrossCorrelationSource::algorithm() {
     return false;
   }
 
-  pdArrayOne = new double[iLength];
-  pdArrayTwo = new double[iLength];
+  //
+  // the work arrays come from the shared FFT cache and are reused across updates...
+  //
+  Kst::FFTPlanLease plan(iLength);
+  pdArrayOne = plan->scratch(0);
+  pdArrayTwo = plan->scratch(1);
   if (pdArrayOne != NULL && pdArrayTwo != NULL) {
     //
     // zero-pad the two arrays...
@@ -198,8 +201,8 @@ bool CrossCorrelationSource::algorithm() {
     //
     // calculate the FFTs of the two functions...
     //
-    if (gsl_fft_real_radix2_transform( pdArrayOne, 1, iLength ) == 0) {
-      if (gsl_fft_real_radix2_transform( pdArrayTwo, 1, iLength ) == 0) {
+    if (plan->radix2Transform( pdArrayOne ) == 0) {
+      if (plan->radix2Transform( pdArrayTwo ) == 0) {
         //
         // multiply one FFT by the complex conjugate of the other...
         //
@@ -218,18 +221,11 @@ bool CrossCorrelationSource::algorithm() {
         //
         // do the inverse FFT...
         //
-        if (gsl_fft_halfcomplex_radix2_inverse( pdArrayOne, 1, iLength ) == 0) {
+        if (plan->radix2Inverse( pdArrayOne ) == 0) {
           pdResult[0] = outputVectorStep->value();
           pdResult[1] = outputVectorCorrelated->value();
 
           if (pdResult[0] != NULL && pdResult[1] != NULL) {
-            for (int i = 0; i < inputVectorOne->length(); ++i) {
-              outputVectorStep->value()[i] = pdResult[0][i];
-            }
-            for (int i = 0; i < inputVectorTwo->length(); ++i) {
-              outputVectorCorrelated->value()[i] = pdResult[1][i];
-            }
-
             for (int i = 0; i < inputVectorOne->length(); i++) {
                 outputVectorStep->value()[i] = (double)( i - ( inputVectorOne->length() / 2 ) );
             }
@@ -248,9 +244,6 @@ bool CrossCorrelationSource::algorithm() {
       }
     }
   }
-  delete[] pdArrayOne;
-  delete[] pdArrayTwo;
-
   return bReturn;
 }
 
@@ -0,0 +1,390 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "lombscargle.h"
+
+#include "parallel.h"
+
+#include "../../fftcache.h"
+
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+#define TWO_PI  6.2831853071795858696103
+#define MACC    4
+
+// samples per chunk below which spreading isn't worth a thread
+#define SPREAD_CHUNK 16384
+
+namespace {
+
+const int nfac[] = { 0, 1, 1, 2, 6, 24, 120, 720, 5040, 40320, 362880, 39916800, 479001600 };
+
+//
+// extirpolate y onto the m grid points nearest to the fractional position
+//  x of an ndim long grid.  yy only backs the grid from offset on...
+//
+inline void spread(double y, double *yy, int offset, int ndim, double x, int m) {
+  const int ix = (int)x;
+
+  if (x == (double)ix) {
+    yy[ix - offset] += y;
+  } else {
+    int ilo = (int)x + 2 - m/2 - 1;
+    if (ilo < 0) {
+      ilo = 0;
+    }
+    if (ilo > ndim - m) {
+      ilo = ndim - m;
+    }
+    const int ihi = ilo + m - 1;
+    int nden = nfac[m];
+    double fac = x - ilo;
+    for (int j = ilo + 1; j <= ihi; j++) {
+      fac *= x - (double)j;
+    }
+    yy[ihi - offset] += y*fac/(double)(nden*(x - ihi));
+    for (int j = ihi - 1; j >= ilo; j--) {
+      nden = (nden/(j + 1 - ilo))*(j - ihi);
+      yy[j - offset] += y*fac/(double)(nden*(x - j));
+    }
+  }
+}
+
+
+//
+// grid positions of a sample for the frequency-f and frequency-2f sums...
+//
+inline void positions(double x, double xmin, double fac, double fndim, double *ck, double *ckk) {
+  *ck  = fmod((x - xmin) * fac, fndim);
+  *ckk = fmod(2.0 * (*ck), fndim);
+}
+
+
+//
+// spreads y less shift into per-chunk windows of the grid,
+//  which merge() then adds into the full grids.  Each window only covers
+//  the part of the grid its own samples touch, so for time ordered data
+//  the windows barely overlap and the extra memory is small...
+//
+class SpreadJob : public Kst::ParallelJob {
+  public:
+    SpreadJob(const double *x, const double *y, int chunks,
+              double xmin, double fac, int ndim, double shift)
+      : _x(x), _y(y), _xmin(xmin), _fac(fac), _ndim(ndim),
+        _shift(shift), _windows(chunks) {
+    }
+
+    void processChunk(int chunk, qint64 begin, qint64 end) {
+      Window &w = _windows[chunk];
+      const double fndim = _ndim;
+      const int iBegin = (int)begin;
+      const int iEnd = (int)end;
+      double ck;
+      double ckk;
+
+      double minF = fndim;
+      double maxF = 0.0;
+      double minT = fndim;
+      double maxT = 0.0;
+      for (int i = iBegin; i < iEnd; i++) {
+        positions(_x[i], _xmin, _fac, fndim, &ck, &ckk);
+        minF = qMin(minF, ck);
+        maxF = qMax(maxF, ck);
+        minT = qMin(minT, ckk);
+        maxT = qMax(maxT, ckk);
+      }
+
+      w.loF = window(minF, maxF, &w.lengthF);
+      w.loT = window(minT, maxT, &w.lengthT);
+      w.sumY.assign(w.lengthF, 0.0);
+      w.sumTwo.assign(w.lengthT, 0.0);
+
+      double *sumY = &w.sumY[0];
+      double *sumTwo = &w.sumTwo[0];
+      for (int i = iBegin; i < iEnd; i++) {
+        positions(_x[i], _xmin, _fac, fndim, &ck, &ckk);
+        spread(_y[i] - _shift, sumY, w.loF, _ndim, ck, MACC);
+        spread(1.0, sumTwo, w.loT, _ndim, ckk, MACC);
+      }
+    }
+
+    void merge(double *sumY, double *sumTwo) const {
+      for (size_t c = 0; c < _windows.size(); ++c) {
+        const Window &w = _windows[c];
+        for (int i = 0; i < w.lengthF; ++i) {
+          sumY[w.loF + i] += w.sumY[i];
+        }
+        for (int i = 0; i < w.lengthT; ++i) {
+          sumTwo[w.loT + i] += w.sumTwo[i];
+        }
+      }
+    }
+
+  private:
+    struct Window {
+      Window() : loF(0), lengthF(0), loT(0), lengthT(0) {}
+      int loF;
+      int lengthF;
+      int loT;
+      int lengthT;
+      std::vector<double> sumY;
+      std::vector<double> sumTwo;
+    };
+
+    // grid range touched by spreading at positions in [lo, hi]
+    int window(double lo, double hi, int *length) const {
+      if (lo > hi) {
+        *length = 0;
+        return 0;
+      }
+      const int first = qMax(0, qMin((int)lo - MACC, _ndim - MACC));
+      const int last = qMin(_ndim, (int)hi + MACC + 1);
+      *length = last - first;
+      return first;
+    }
+
+    const double *_x;
+    const double *_y;
+    double _xmin;
+    double _fac;
+    int _ndim;
+    double _shift;
+    std::vector<Window> _windows;
+};
+
+}
+
+
+LombScargle::LombScargle() {
+}
+
+
+int LombScargle::outputLength(int n, double ofac, double hifac) {
+  if (n <= 0) {
+    return 0;
+  }
+  return (int)(0.5 * ofac * hifac * n);
+}
+
+
+int LombScargle::gridLength(int n, double ofac, double hifac) {
+  const double freqt = MACC * ofac * hifac * n;
+  qint64 freq = 64;
+
+  while (freq < freqt) {
+    freq *= 2;
+  }
+  if (freq * 2 > INT_MAX) {
+    return 0;
+  }
+  return (int)(freq * 2);
+}
+
+
+void LombScargle::meanAndVariance(const double *y, int n, double *mean, double *variance) {
+  double sum = 0.0;
+  double ep = 0.0;
+  double var = 0.0;
+
+  *mean = 0.0;
+  *variance = 0.0;
+  if (n > 0) {
+    for (int i = 0; i < n; i++) {
+      sum += y[i];
+    }
+    *mean = sum / n;
+
+    if (n > 1) {
+      for (int i = 0; i < n; i++) {
+        const double s = y[i] - *mean;
+        ep += s;
+        var += s*s;
+      }
+      *variance = (var - ep * ep / n) / (n - 1);
+    }
+  }
+}
+
+
+void LombScargle::range(const double *x, int n, double *xmin, double *xmax) {
+  double lo = x[0];
+  double hi = x[0];
+
+  for (int i = 1; i < n; i++) {
+    lo = qMin(lo, x[i]);
+    hi = qMax(hi, x[i]);
+  }
+  *xmin = lo;
+  *xmax = hi;
+}
+
+
+int LombScargle::compute(const double *x, const double *y, int n, double ofac, double hifac, double *freq, double *power) {
+  const int nout = outputLength(n, ofac, hifac);
+  const int ndim = gridLength(n, ofac, hifac);
+
+  if (nout <= 0 || ndim <= 0 || nout >= ndim / 2) {
+    return 0;
+  }
+
+  double ave;
+  double var;
+  double xmin;
+  double xmax;
+  meanAndVariance(y, n, &ave, &var);
+  range(x, n, &xmin, &xmax);
+
+  const double xdif = xmax - xmin;
+  if (xdif <= 0.0) {
+    return 0;
+  }
+  const double fac = ndim / (xdif * ofac);
+
+  Kst::FFTPlanLease plan(ndim);
+  double *wk1 = plan->scratch(0);
+  double *wk2 = plan->scratch(1);
+  if (!wk1 || !wk2) {
+    return 0;
+  }
+
+  memset(wk1, 0, ndim * sizeof(double));
+  memset(wk2, 0, ndim * sizeof(double));
+
+  const int chunks = Kst::parallelChunks(n, SPREAD_CHUNK);
+  SpreadJob job(x, y, chunks, xmin, fac, ndim, ave);
+  Kst::runParallel(&job, n, SPREAD_CHUNK);
+  job.merge(wk1, wk2);
+
+  if (plan->radix2Transform(wk1) != 0 || plan->radix2Transform(wk2) != 0) {
+    return 0;
+  }
+
+  //
+  // the transforms are in GSL's radix 2 halfcomplex order: the real part of
+  //  frequency j is at j and the imaginary part at ndim-j...
+  //
+  const double df = 1.0 / (xdif * ofac);
+  for (int j = 1; j <= nout; j++) {
+    const double re1 = wk1[j];
+    const double im1 = wk1[ndim - j];
+    const double re2 = wk2[j];
+    const double im2 = wk2[ndim - j];
+
+    const double hypo  = sqrt(re2*re2 + im2*im2);
+    const double hc2wt = 0.5 * re2 / hypo;
+    const double hs2wt = 0.5 * im2 / hypo;
+    const double cwt   = sqrt(0.5 + hc2wt);
+    double swt         = fabs(sqrt(0.5 - hc2wt));
+    if (hs2wt < 0.0) {
+      swt *= -1.0;
+    }
+    const double den   = 0.5*n + hc2wt*re2 + hs2wt*im2;
+    const double c     = cwt*re1 + swt*im1;
+    const double s     = cwt*im1 - swt*re1;
+    const double cterm = c*c / den;
+    const double sterm = ((double)n - den == 0.0) ? 0.0 : s*s / ((double)n - den);
+
+    freq[j - 1]  = (double)j * df;
+    power[j - 1] = cterm + sterm;
+    if (var > 0.0) {
+      power[j - 1] /= 2.0 * var;
+    }
+  }
+
+  return nout;
+}
+
+
+int LombScargle::computeDirect(const double *x, const double *y, int n, double ofac, double hifac, double *freq, double *power) {
+  const int nout = outputLength(n, ofac, hifac);
+
+  if (nout <= 0) {
+    return 0;
+  }
+
+  double ave;
+  double var;
+  double xmin;
+  double xmax;
+  meanAndVariance(y, n, &ave, &var);
+  range(x, n, &xmin, &xmax);
+
+  const double xdif = xmax - xmin;
+  if (xdif <= 0.0) {
+    return 0;
+  }
+  const double xave = 0.5 * (xmax + xmin);
+  const double df = 1.0 / (xdif * ofac);
+
+  //
+  // the trigonometric recurrences advance every sample by one frequency
+  //  step per output value...
+  //
+  std::vector<double> wr(n);
+  std::vector<double> wi(n);
+  std::vector<double> wpr(n);
+  std::vector<double> wpi(n);
+  for (int j = 0; j < n; j++) {
+    const double arg = TWO_PI * ((x[j] - xave) * df);
+    const double half = sin(0.5 * arg);
+    wpr[j] = -2.0 * half * half;
+    wpi[j] = sin(arg);
+    wr[j]  = cos(arg);
+    wi[j]  = wpi[j];
+  }
+
+  double pnow = df;
+  for (int i = 0; i < nout; i++) {
+    double sumsh = 0.0;
+    double sumc = 0.0;
+    for (int j = 0; j < n; j++) {
+      const double c = wr[j];
+      const double s = wi[j];
+      sumsh += s*c;
+      sumc  += (c - s)*(c + s);
+    }
+    const double wtau  = 0.5 * atan2(2.0 * sumsh, sumc);
+    const double swtau = sin(wtau);
+    const double cwtau = cos(wtau);
+
+    double sums  = 0.0;
+    double sumsy = 0.0;
+    double sumcy = 0.0;
+    sumc = 0.0;
+    for (int j = 0; j < n; j++) {
+      const double s  = wi[j];
+      const double c  = wr[j];
+      const double ss = s*cwtau - c*swtau;
+      const double cc = c*cwtau + s*swtau;
+      const double yy = y[j] - ave;
+      sums  += ss*ss;
+      sumc  += cc*cc;
+      sumsy += yy*ss;
+      sumcy += yy*cc;
+      wr[j] = (c*wpr[j] - s*wpi[j]) + c;
+      wi[j] = (s*wpr[j] + c*wpi[j]) + s;
+    }
+
+    freq[i]  = pnow;
+    power[i] = sumcy * sumcy / sumc + sumsy * sumsy / sums;
+    if (var > 0.0) {
+      power[i] /= 2.0 * var;
+    }
+    pnow += df;
+  }
+
+  return nout;
+}
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,53 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef LOMBSCARGLE_H
+#define LOMBSCARGLE_H
+
+#include <vector>
+
+/*
+ *  Lomb-Scargle periodogram of unevenly sampled data.
+ *
+ *  The fast method is the Press & Rybicki one: the data are extirpolated
+ *  ("spread") onto a regular grid which is then FFTed.  The spreading is
+ *  done in parallel over chunks of samples and the transforms use the
+ *  cached plans from fftcache.h.
+ *
+ *  Nothing is kept between calls: the grid spacing follows the time span
+ *  and the grid length the number of samples, so appended samples move
+ *  every sample's grid position and the sums have to be spread again.
+ */
+class LombScargle {
+  public:
+    LombScargle();
+
+    // Number of periodogram values compute() produces for n samples.
+    static int outputLength(int n, double ofac, double hifac);
+
+    // Computes the normalized periodogram of (x[i], y[i]), 0 <= i < n, at
+    // outputLength() frequencies.  freq and power must hold that many
+    // values.  Returns the number of values written, 0 on failure.
+    int compute(const double *x, const double *y, int n, double ofac, double hifac, double *freq, double *power);
+
+    // Same, evaluating the sums directly.  O(n * outputLength()), but exact
+    // and better behaved for very short inputs.
+    int computeDirect(const double *x, const double *y, int n, double ofac, double hifac, double *freq, double *power);
+
+  private:
+    static int gridLength(int n, double ofac, double hifac);
+    static void meanAndVariance(const double *y, int n, double *mean, double *variance);
+    static void range(const double *x, int n, double *xmin, double *xmax);
+};
+
+#endif
+// vim: ts=2 sw=2 et
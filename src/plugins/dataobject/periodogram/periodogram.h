@@ -20,6 +20,8 @@
 #include <basicplugin.h>
 #include <dataobjectplugin.h>
 
+#include "lombscargle.h"
+
 class PeriodogramSource : public Kst::BasicPlugin {
   Q_OBJECT
 
@@ -50,40 +52,7 @@ class PeriodogramSource : public Kst::BasicPlugin {
     ~PeriodogramSource();
 
   private:
-    int max(int a, int b);
-    int min(int a, int b);
-    void spread(double y, double yy[], unsigned long n, double x, int m);
-    void four1(double data[], unsigned long nn, int isign);
-    void realft(double data[], unsigned long n, int isign);
-    void avevar(double const  data[], unsigned long n, double* ave, double* var);
-    void FastLombPeriodogram(
-      double const x[],
-      double const y[],
-      unsigned long   n,
-      double          ofac,
-      double          hifac,
-      double          wk1[],
-      double          wk2[],
-      unsigned long   ndim,
-      unsigned long*  nout,
-      unsigned long*  jmax,
-      double*         prob,
-      double*         pvar,
-      int            iIsWindowFunction);
-    void SlowLombPeriodogram(
-      double const    x[],
-      double const    y[],
-      unsigned long   n,
-      double          ofac,
-      double          hifac,
-      double          px[],
-      double          py[],
-      unsigned long   ndim,
-      unsigned long*  nout,
-      unsigned long*  jmax,
-      double*         prob,
-      double*         pvar,
-      int            iIsWindowFunction);
+    LombScargle _engine;
 
   friend class Kst::ObjectStore;
 
@@ -3,9 +3,11 @@ include(../../plugins_sub.pri)
 TARGET = $$kstlib(kstplugin_periodogram)
 
 SOURCES += \
+    lombscargle.cpp \
     periodogram.cpp
 
 HEADERS += \
+    lombscargle.h \
     periodogram.h
 
 FORMS += periodogramconfig.ui
@@ -16,6 +16,9 @@
 #include "statistics.h"
 #include "objectstore.h"
 #include "ui_statisticsconfig.h"
+#include "math_kst.h"
+
+#include <algorithm>
 
 static const QString& VECTOR_IN = "Vector In";
 static const QString& SCALAR_OUT_MEAN = "Mean";
@@ -27,6 +30,11 @@ static const QString& SCALAR_OUT_MEDIAN = "Median";
 static const QString& SCALAR_OUT_ABSOLUTE_DEVIATION = "Absolute deviation";
 static const QString& SCALAR_OUT_SKEWNESS = "Skewness";
 static const QString& SCALAR_OUT_KURTOSIS = "Kurtosis";
+static const QString& SCALAR_OUT_MEDIAN_ABSOLUTE_DEVIATION = "Median absolute deviation";
+static const QString& SCALAR_OUT_PERCENTILE_5 = "5th percentile";
+static const QString& SCALAR_OUT_PERCENTILE_25 = "25th percentile";
+static const QString& SCALAR_OUT_PERCENTILE_75 = "75th percentile";
+static const QString& SCALAR_OUT_PERCENTILE_95 = "95th percentile";
 
 class ConfigWidgetStatisticsPlugin : public Kst::DataObjectConfigWidget, public Ui_StatisticsConfig {
   public:
@@ -130,6 +138,11 @@ void StatisticsSource::setupOutputs() {
   setOutputScalar(SCALAR_OUT_ABSOLUTE_DEVIATION, "");
   setOutputScalar(SCALAR_OUT_SKEWNESS, "");
   setOutputScalar(SCALAR_OUT_KURTOSIS, "");
+  setOutputScalar(SCALAR_OUT_MEDIAN_ABSOLUTE_DEVIATION, "");
+  setOutputScalar(SCALAR_OUT_PERCENTILE_5, "");
+  setOutputScalar(SCALAR_OUT_PERCENTILE_25, "");
+  setOutputScalar(SCALAR_OUT_PERCENTILE_75, "");
+  setOutputScalar(SCALAR_OUT_PERCENTILE_95, "");
 }
 
 
@@ -145,41 +158,76 @@ bool StatisticsSource::algorithm() {
   Kst::ScalarPtr outputScalarSkewness = _outputScalars[SCALAR_OUT_SKEWNESS];
   Kst::ScalarPtr outputScalarKurtosis = _outputScalars[SCALAR_OUT_KURTOSIS];
 
+  // the percentile outputs are newer than the rest: sessions saved before
+  // they existed won't have them, so they are optional.
+  Kst::ScalarPtr outputScalarMAD = outputScalar(SCALAR_OUT_MEDIAN_ABSOLUTE_DEVIATION);
+  Kst::ScalarPtr outputScalarP05 = outputScalar(SCALAR_OUT_PERCENTILE_5);
+  Kst::ScalarPtr outputScalarP25 = outputScalar(SCALAR_OUT_PERCENTILE_25);
+  Kst::ScalarPtr outputScalarP75 = outputScalar(SCALAR_OUT_PERCENTILE_75);
+  Kst::ScalarPtr outputScalarP95 = outputScalar(SCALAR_OUT_PERCENTILE_95);
+
   //Make sure there is at least 1 element in the input vector
   if (inputVector->length() < 1) {
     _errorString = "Error:  Input Vector invalid size";
     return false;
   }
 
-  double* pCopy;
+  const double *pData = inputVector->value();
   double dMean = 0.0;
   double dMedian = 0.0;
   double dStandardDeviation = 0.0;
   double dTotal = 0.0;
-  double dSquaredTotal = 0.0;
-  double dMinimum = 0.0;
-  double dMaximum = 0.0;
+  double dMinimum = pData[0];
+  double dMaximum = pData[0];
   double dVariance = 0.0;
   double dAbsoluteDeviation = 0.0;
   double dSkewness = 0.0;
   double dKurtosis = 0.0;
+  double dSecond = 0.0;
+  double dThird = 0.0;
+  double dFourth = 0.0;
   int iLength = inputVector->length();
+  int iValid = 0;
+
+  //
+  // first pass: extrema and sum, and gather the non-NaN samples into the
+  //  reusable selection buffer...
+  //
+  if ((int)_work.size() < iLength) {
+    _work.resize(iLength);
+  }
+  double *pWork = &_work[0];
 
   for (int i=0; i<iLength; i++) {
-    if (i == 0 || inputVector->value()[i] < dMinimum) {
-      dMinimum = inputVector->value()[i];
+    const double dValue = pData[i];
+    if (dValue < dMinimum) {
+      dMinimum = dValue;
     }
-    if (i == 0 || inputVector->value()[i] > dMaximum) {
-      dMaximum = inputVector->value()[i];
+    if (dValue > dMaximum) {
+      dMaximum = dValue;
+    }
+    dTotal += dValue;
+    if (dValue == dValue) {
+      pWork[iValid++] = dValue;
     }
-    dTotal += inputVector->value()[i];
-    dSquaredTotal += inputVector->value()[i] * inputVector->value()[i];
   }
 
   dMean = dTotal / (double)iLength;
+
+  //
+  // second pass: all central moments at once...
+  //
+  for (int i=0; i<iLength; i++) {
+    const double dDiff = pData[i] - dMean;
+    const double dDiffSquared = dDiff * dDiff;
+    dAbsoluteDeviation += fabs( dDiff );
+    dSecond += dDiffSquared;
+    dThird  += dDiffSquared * dDiff;
+    dFourth += dDiffSquared * dDiffSquared;
+  }
+
   if (iLength > 1) {
-    dVariance  = 1.0 / ( (double)iLength - 1.0 );
-    dVariance *= dSquaredTotal - ( dTotal * dTotal / (double)iLength ); 
+    dVariance = dSecond / ( (double)iLength - 1.0 );
     if (dVariance > 0.0) {
       dStandardDeviation = sqrt( dVariance );
     } else {
@@ -188,26 +236,66 @@ bool StatisticsSource::algorithm() {
     }
   }
 
-  for (int i=0; i<iLength; i++) {
-    dAbsoluteDeviation += fabs( inputVector->value()[i] - dMean );
-    dSkewness               += pow( inputVector->value()[i] - dMean, 3.0 );
-    dKurtosis               += pow( inputVector->value()[i] - dMean, 4.0 );
-  }
+  const double dSDSquared = dStandardDeviation * dStandardDeviation;
   dAbsoluteDeviation /= (double)iLength;
-  dSkewness                 /= (double)iLength * pow( dStandardDeviation, 3.0 );
-  dKurtosis                 /= (double)iLength * pow( dStandardDeviation, 4.0 );
-  dKurtosis                 -= 3.0;
-
-  /*
-  sort by phase...
-  */
-  pCopy = (double*)calloc( iLength, sizeof( double ) );
-  if (pCopy != NULL) {
-    memcpy( pCopy, inputVector->value(), iLength * sizeof( double ) );
-    quicksort( pCopy, 0, iLength-1 );
-    dMedian = pCopy[ iLength / 2 ];
-
-    free( pCopy );
+  dSkewness = dThird / ( (double)iLength * dSDSquared * dStandardDeviation );
+  dKurtosis = dFourth / ( (double)iLength * dSDSquared * dSDSquared );
+  dKurtosis -= 3.0;
+
+  //
+  // median and percentiles by selection rather than sorting: each selection
+  //  partitions the buffer, so the later ones only search the part of the
+  //  buffer on their side of the median...
+  //
+  if (iValid > 0) {
+    const int iMedian = iValid / 2;
+    std::nth_element( pWork, pWork + iMedian, pWork + iValid );
+    dMedian = pWork[iMedian];
+
+    if (outputScalarP05 || outputScalarP25) {
+      const double dP25 = select( pWork, 0, iMedian, percentileIndex( 0.25, iValid ) );
+      if (outputScalarP25) {
+        outputScalarP25->setValue(dP25);
+      }
+      if (outputScalarP05) {
+        outputScalarP05->setValue(select( pWork, 0, percentileIndex( 0.25, iValid ), percentileIndex( 0.05, iValid ) ));
+      }
+    }
+
+    if (outputScalarP75 || outputScalarP95) {
+      const double dP75 = select( pWork, iMedian, iValid, percentileIndex( 0.75, iValid ) );
+      if (outputScalarP75) {
+        outputScalarP75->setValue(dP75);
+      }
+      if (outputScalarP95) {
+        outputScalarP95->setValue(select( pWork, percentileIndex( 0.75, iValid ), iValid, percentileIndex( 0.95, iValid ) ));
+      }
+    }
+
+    if (outputScalarMAD) {
+      for (int i=0; i<iValid; i++) {
+        pWork[i] = fabs( pWork[i] - dMedian );
+      }
+      std::nth_element( pWork, pWork + iMedian, pWork + iValid );
+      outputScalarMAD->setValue(pWork[iMedian]);
+    }
+  } else {
+    dMedian = NAN;
+    if (outputScalarP05) {
+      outputScalarP05->setValue(NAN);
+    }
+    if (outputScalarP25) {
+      outputScalarP25->setValue(NAN);
+    }
+    if (outputScalarP75) {
+      outputScalarP75->setValue(NAN);
+    }
+    if (outputScalarP95) {
+      outputScalarP95->setValue(NAN);
+    }
+    if (outputScalarMAD) {
+      outputScalarMAD->setValue(NAN);
+    }
   }
 
   outputScalarMean->setValue(dMean);
@@ -224,42 +312,26 @@ bool StatisticsSource::algorithm() {
 }
 
 
-void StatisticsSource::swap( double* pData, int iOne, int iTwo) {
-  double dTemp;
-
-  dTemp = pData[iOne];
-  pData[iOne] = pData[iTwo];
-  pData[iTwo] = dTemp;
-}
+int StatisticsSource::percentileIndex( double dFraction, int iLength ) {
+  int iIndex = (int)( dFraction * (double)iLength );
 
-
-void StatisticsSource::quicksort( double* pData, int iLeft, int iRight) {
-
-  double dVal = pData[iRight];
-  int i = iLeft - 1;
-  int j = iRight;
-
-  if (iRight <= iLeft) {
-    return;
+  if (iIndex >= iLength) {
+    iIndex = iLength - 1;
   }
+  return iIndex;
+}
 
-  while (1) {
-    while (pData[++i] < dVal) {
-    }
 
-    while(dVal < pData[--j]) {
-      if (j == iLeft) {
-        break;
-      }
-    }
-    if (i >= j) {
-      break;
-    }
-    swap( pData, i, j );
+double StatisticsSource::select( double* pData, int iLeft, int iRight, int iIndex ) {
+  //
+  // pData is already partitioned around iLeft and iRight, so selecting
+  //  within that range is enough.  An index on the right boundary is
+  //  already in its sorted position...
+  //
+  if (iIndex < iRight) {
+    std::nth_element( pData + iLeft, pData + iIndex, pData + iRight );
   }
-  swap( pData, i, iRight );
-  quicksort( pData, iLeft, i-1 );
-  quicksort( pData, i+1, iRight );
+  return pData[iIndex];
 }
 
 
@@ -298,6 +370,11 @@ QStringList StatisticsSource::outputScalarList() const {
   scalars += SCALAR_OUT_ABSOLUTE_DEVIATION;
   scalars += SCALAR_OUT_SKEWNESS;
   scalars += SCALAR_OUT_KURTOSIS;
+  scalars += SCALAR_OUT_MEDIAN_ABSOLUTE_DEVIATION;
+  scalars += SCALAR_OUT_PERCENTILE_5;
+  scalars += SCALAR_OUT_PERCENTILE_25;
+  scalars += SCALAR_OUT_PERCENTILE_75;
+  scalars += SCALAR_OUT_PERCENTILE_95;
   return scalars;
 }
 
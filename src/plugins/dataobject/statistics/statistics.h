@@ -17,6 +17,8 @@
 
 #include <QFile>
 
+#include <vector>
+
 #include <basicplugin.h>
 #include <dataobjectplugin.h>
 
@@ -47,8 +49,11 @@ class StatisticsSource : public Kst::BasicPlugin {
     ~StatisticsSource();
 
   private:
-    void swap( double* pData, int iOne, int iTwo );
-    void quicksort( double* pData, int iLeft, int iRight );
+    static int percentileIndex( double dFraction, int iLength );
+    static double select( double* pData, int iLeft, int iRight, int iIndex );
+
+    // selection buffer, kept between updates to avoid reallocating it
+    std::vector<double> _work;
 
   friend class Kst::ObjectStore;
 
@@ -0,0 +1,228 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*
+ *  FFT plan and scratch buffer cache shared by the GSL based plugins.
+ *
+ *  Every FFT based plugin used to allocate its padded work arrays, and for
+ *  the mixed radix transforms also the GSL wavetables and workspace, on
+ *  every update.  FFTPlanCache keeps that state around keyed by transform
+ *  length: a plugin takes an FFTPlanLease for the length it needs, uses the
+ *  plan's scratch buffers and transforms, and the plan goes back into the
+ *  cache when the lease goes out of scope.  The cache is protected by a
+ *  mutex, so concurrently updating objects each get their own plan.
+ */
+
+#ifndef FFTCACHE_H
+#define FFTCACHE_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_fft_real.h>
+#include <gsl/gsl_fft_halfcomplex.h>
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace Kst {
+
+class FFTPlan {
+  public:
+    enum { ScratchBuffers = 2, Alignment = 64 };
+
+    explicit FFTPlan(int length) : _length(length), _real(0L), _hc(0L), _work(0L) {
+      for (int i = 0; i < ScratchBuffers; ++i) {
+        _raw[i] = 0L;
+        _scratch[i] = 0L;
+      }
+    }
+
+    ~FFTPlan() {
+      if (_real) {
+        gsl_fft_real_wavetable_free(_real);
+      }
+      if (_hc) {
+        gsl_fft_halfcomplex_wavetable_free(_hc);
+      }
+      if (_work) {
+        gsl_fft_real_workspace_free(_work);
+      }
+      for (int i = 0; i < ScratchBuffers; ++i) {
+        free(_raw[i]);
+      }
+    }
+
+    int length() const { return _length; }
+
+    // Returns a cache line aligned buffer of length() doubles.  Its contents
+    // are whatever the previous user left in it.
+    double *scratch(int i) {
+      Q_ASSERT(i >= 0 && i < ScratchBuffers);
+      if (!_scratch[i]) {
+        _raw[i] = malloc(_length * sizeof(double) + Alignment);
+        if (_raw[i]) {
+          size_t addr = (size_t)_raw[i];
+          addr = (addr + Alignment - 1) & ~(size_t)(Alignment - 1);
+          _scratch[i] = (double*)addr;
+        }
+      }
+      return _scratch[i];
+    }
+
+    // Mixed radix real transforms.  The wavetables and workspace are created
+    // on first use and kept for the lifetime of the plan.
+    int realTransform(double *data) {
+      if (!_real) {
+        _real = gsl_fft_real_wavetable_alloc(_length);
+      }
+      if (!_work) {
+        _work = gsl_fft_real_workspace_alloc(_length);
+      }
+      if (!_real || !_work) {
+        return GSL_ENOMEM;
+      }
+      return gsl_fft_real_transform(data, 1, _length, _real, _work);
+    }
+
+    int halfcomplexInverse(double *data) {
+      if (!_hc) {
+        _hc = gsl_fft_halfcomplex_wavetable_alloc(_length);
+      }
+      if (!_work) {
+        _work = gsl_fft_real_workspace_alloc(_length);
+      }
+      if (!_hc || !_work) {
+        return GSL_ENOMEM;
+      }
+      return gsl_fft_halfcomplex_inverse(data, 1, _length, _hc, _work);
+    }
+
+    // Radix 2 transforms need no tables; they are here so that callers only
+    // deal with one object.  length() must be a power of two.
+    int radix2Transform(double *data) {
+      return gsl_fft_real_radix2_transform(data, 1, _length);
+    }
+
+    int radix2Inverse(double *data) {
+      return gsl_fft_halfcomplex_radix2_inverse(data, 1, _length);
+    }
+
+  private:
+    Q_DISABLE_COPY(FFTPlan)
+
+    int _length;
+    gsl_fft_real_wavetable *_real;
+    gsl_fft_halfcomplex_wavetable *_hc;
+    gsl_fft_real_workspace *_work;
+    void *_raw[ScratchBuffers];
+    double *_scratch[ScratchBuffers];
+};
+
+
+class FFTPlanCache {
+  public:
+    // Idle plans kept per length, and the total number of doubles of idle
+    // scratch memory kept before old plans are released.  Every plugin
+    // module has its own cache, so this is per plugin: 8 MB.  Plans for
+    // longer transforms are not kept at all.
+    enum { MaxIdlePerLength = 4 };
+    static const int MaxIdleDoubles = 1024 * 1024;
+
+    static FFTPlanCache& self() {
+      static FFTPlanCache cache;
+      return cache;
+    }
+
+    FFTPlan *acquire(int length) {
+      {
+        QMutexLocker locker(&_mutex);
+        QHash<int, QList<FFTPlan*> >::iterator it = _idle.find(length);
+        if (it != _idle.end() && !it.value().isEmpty()) {
+          FFTPlan *plan = it.value().takeLast();
+          _idleDoubles -= idleCost(plan);
+          return plan;
+        }
+      }
+      return new FFTPlan(length);
+    }
+
+    void release(FFTPlan *plan) {
+      if (!plan) {
+        return;
+      }
+      QMutexLocker locker(&_mutex);
+      QList<FFTPlan*> &plans = _idle[plan->length()];
+      if (plans.count() >= MaxIdlePerLength || idleCost(plan) > MaxIdleDoubles) {
+        locker.unlock();
+        delete plan;
+        return;
+      }
+      plans.append(plan);
+      _idleDoubles += idleCost(plan);
+      _recent.removeAll(plan->length());
+      _recent.append(plan->length());
+
+      // Trim the least recently released lengths until we're within budget.
+      while (_idleDoubles > MaxIdleDoubles && !_recent.isEmpty()) {
+        const int victim = _recent.takeFirst();
+        QList<FFTPlan*> doomed = _idle.take(victim);
+        foreach (FFTPlan *p, doomed) {
+          _idleDoubles -= idleCost(p);
+          delete p;
+        }
+      }
+    }
+
+    ~FFTPlanCache() {
+      for (QHash<int, QList<FFTPlan*> >::iterator it = _idle.begin(); it != _idle.end(); ++it) {
+        qDeleteAll(it.value());
+      }
+    }
+
+  private:
+    FFTPlanCache() : _idleDoubles(0) {}
+    Q_DISABLE_COPY(FFTPlanCache)
+
+    static qint64 idleCost(const FFTPlan *plan) {
+      return qint64(plan->length()) * FFTPlan::ScratchBuffers;
+    }
+
+    QMutex _mutex;
+    QHash<int, QList<FFTPlan*> > _idle;
+    QList<int> _recent;
+    qint64 _idleDoubles;
+};
+
+
+// Scoped ownership of a cached plan.
+class FFTPlanLease {
+  public:
+    explicit FFTPlanLease(int length) : _plan(FFTPlanCache::self().acquire(length)) {}
+    ~FFTPlanLease() { FFTPlanCache::self().release(_plan); }
+
+    FFTPlan *operator->() const { return _plan; }
+    FFTPlan *plan() const { return _plan; }
+
+  private:
+    Q_DISABLE_COPY(FFTPlanLease)
+
+    FFTPlan *_plan;
+};
+
+}
+
+#endif
+
+// vim: ts=2 sw=2 et
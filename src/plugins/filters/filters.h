@@ -20,13 +20,12 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
-#include <gsl/gsl_errno.h>
-#include <gsl/gsl_fft_real.h>
-#include <gsl/gsl_fft_halfcomplex.h>
 
 #include "vector.h"
 #include "scalar.h"
 
+#include "../fftcache.h"
+
 double filter_calculate( double dFreqValue, Kst::ScalarList scalars );
 
 bool kst_pass_filter(
@@ -34,9 +33,6 @@ bool kst_pass_filter(
   Kst::ScalarList scalars,
   Kst::VectorPtr outVector) {
 
-  gsl_fft_real_wavetable* real;
-  gsl_fft_real_workspace* work;
-  gsl_fft_halfcomplex_wavetable* hc;
   double* pPadded;
   double dFreqValue;
   int iLengthData;
@@ -53,55 +49,47 @@ bool kst_pass_filter(
       // round up to the nearest power of 2...
       //
       iLengthDataPadded = (int)pow( 2.0, ceil( log10( (double)iLengthData ) / log10( 2.0 ) ) );
-      pPadded = (double*)malloc( iLengthDataPadded * sizeof( double ) );
+
+      //
+      // the padded buffer, wavetables and workspace are reused across updates...
+      //
+      Kst::FFTPlanLease plan( iLengthDataPadded );
+      pPadded = plan->scratch( 0 );
       if( pPadded != 0L ) {
         outVector->resize(iLengthData);
 
-        real = gsl_fft_real_wavetable_alloc( iLengthDataPadded );
-        if( real != NULL ) {
-          work = gsl_fft_real_workspace_alloc( iLengthDataPadded );
-          if( work != NULL ) {
-            memcpy( pPadded, vector->value(), iLengthData * sizeof( double ) );
+        memcpy( pPadded, vector->value(), iLengthData * sizeof( double ) );
 
-            //
-            // linear extrapolation on the padded values...
-            //
-            for( i=iLengthData; i<iLengthDataPadded; i++ ) {
-              pPadded[i] = vector->value()[iLengthData-1] - (double)( i - iLengthData + 1 ) * ( vector->value()[iLengthData-1] - vector->value()[0] ) / (double)( iLengthDataPadded - iLengthData );
-            }
-            
-            //
-            // calculate the FFT...
-            //
-            iStatus = gsl_fft_real_transform( pPadded, 1, iLengthDataPadded, real, work );
+        //
+        // linear extrapolation on the padded values...
+        //
+        for( i=iLengthData; i<iLengthDataPadded; i++ ) {
+          pPadded[i] = vector->value()[iLengthData-1] - (double)( i - iLengthData + 1 ) * ( vector->value()[iLengthData-1] - vector->value()[0] ) / (double)( iLengthDataPadded - iLengthData );
+        }
+
+        //
+        // calculate the FFT...
+        //
+        iStatus = plan->realTransform( pPadded );
 
-            if( !iStatus ) {
-              //
-              // apply the filter...
-              //
-              for( i=0; i<iLengthDataPadded; i++ ) {
-                dFreqValue = 0.5 * (double)i / (double)iLengthDataPadded;
-                pPadded[i] *= filter_calculate( dFreqValue, scalars );
-              }
+        if( !iStatus ) {
+          //
+          // apply the filter...
+          //
+          for( i=0; i<iLengthDataPadded; i++ ) {
+            dFreqValue = 0.5 * (double)i / (double)iLengthDataPadded;
+            pPadded[i] *= filter_calculate( dFreqValue, scalars );
+          }
 
-              hc = gsl_fft_halfcomplex_wavetable_alloc( iLengthDataPadded );
-              if( hc != NULL ) {
-                //
-                // calculate the inverse FFT...
-                //
-                iStatus = gsl_fft_halfcomplex_inverse( pPadded, 1, iLengthDataPadded, hc, work );
-                if( !iStatus ) {
-                  memcpy( outVector->value(), pPadded, iLengthData * sizeof( double ) );
-                  bReturn = true;
-                }
-                gsl_fft_halfcomplex_wavetable_free( hc );
-              }
-            }
-            gsl_fft_real_workspace_free( work );
+          //
+          // calculate the inverse FFT...
+          //
+          iStatus = plan->halfcomplexInverse( pPadded );
+          if( !iStatus ) {
+            memcpy( outVector->value(), pPadded, iLengthData * sizeof( double ) );
+            bReturn = true;
           }
-          gsl_fft_real_wavetable_free( real );
         }
-        free( pPadded );
       }
     }
   }
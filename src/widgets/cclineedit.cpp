@@ -636,6 +636,15 @@ void SVCCLineEdit::fillKstObjects()
         scalar->unlock();
     }
 
+    // vector and matrix statistics that don't exist as scalars yet.  They
+    // are created when the equation or label is parsed.
+    foreach (const PrimitivePtr &primitive, _store->getObjects<Primitive>()) {
+        foreach (const QString &name, primitive->unmaterializedSlaveNames()) {
+            _svData->back()[0].push_back(name+"]");
+            _svData->front()[0].push_back("["+name+"]");
+        }
+    }
+
     VectorList::ConstIterator vectorIt = vectorList.begin();
     for (; vectorIt != vectorList.end(); ++vectorIt) {
         VectorPtr vector = (*vectorIt);
@@ -680,6 +689,12 @@ void SVCCTextEdit::fillKstObjects()
             scalar->unlock();
         }
 
+        foreach (const PrimitivePtr &primitive, _store->getObjects<Primitive>()) {
+            foreach (const QString &name, primitive->unmaterializedSlaveNames()) {
+                _svData->back()[0].push_back(name+"]");
+            }
+        }
+
     _svData->back().push_back(Category("Strings"));
 
     StringList::ConstIterator stringIt = stringList.begin();
@@ -99,6 +99,13 @@ ScalarPtr ScalarSelector::selectedScalar() {
   }
 
   if (!existingScalar) {
+    // A vector or matrix statistic nobody has used yet: asking the store
+    // for it creates it.
+    ScalarPtr statistic = kst_cast<Scalar>(_store->retrieveObject(_scalar->currentText()));
+    if (statistic) {
+      return statistic;
+    }
+
      // Create the Scalar.
     bool ok = false;
     double value = _scalar->currentText().toDouble(&ok);
@@ -235,6 +242,13 @@ void ScalarSelector::fillScalars() {
     scalar->unlock();
   }
 
+  // statistics which don't exist as scalars yet; selectedScalar() creates them.
+  foreach (const PrimitivePtr &primitive, _store->getObjects<Primitive>()) {
+    foreach (const QString &name, primitive->unmaterializedSlaveNames()) {
+      scalars.insert(name, ScalarPtr());
+    }
+  }
+
   QStringList list = scalars.keys();
 
   qSort(list);
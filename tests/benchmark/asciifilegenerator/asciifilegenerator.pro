@@ -0,0 +1,13 @@
+TOPOUT_REL=../../..
+include($$PWD/$$TOPOUT_REL/kst.pri)
+
+TEMPLATE = app
+TARGET = asciifilegenerator
+DESTDIR = $$OUTPUT_DIR/bin
+CONFIG -= precompile_header windows app_bundle
+CONFIG += console
+!win32:OBJECTS_DIR = tmp
+
+QT -= xml gui
+
+SOURCES += $$TOPLEVELDIR/tests/datasources/ascii/asciifilegenerator.cpp
@@ -0,0 +1,33 @@
+TOPOUT_REL=../..
+include($$PWD/$$TOPOUT_REL/kst.pri)
+
+QT += gui network svg xml opengl
+
+macx:CONFIG -= app_bundle
+TEMPLATE = app
+!win32:OBJECTS_DIR = tmp
+!win32:MOC_DIR = tmp
+TARGET = kstbench
+DESTDIR = $$OUTPUT_DIR/bin
+
+INCLUDEPATH += \
+    tmp \
+    $$TOPLEVELDIR/src/libkst \
+    $$TOPLEVELDIR/src/libkstmath \
+    $$TOPLEVELDIR/src/widgets \
+    $$TOPLEVELDIR/src/libkstapp \
+    $$OUTPUT_DIR/src/kst/tmp
+
+LIBS += \
+		-L$$OUTPUT_DIR/lib \
+		-l$$kstlib(kst2app) \
+		-l$$kstlib(kst2widgets) \
+		-l$$kstlib(kst2math) \
+		-l$$kstlib(kst2lib)
+
+SOURCES += \
+    benchmarkresults.cpp \
+    kstbench.cpp
+
+HEADERS += \
+    benchmarkresults.h
@@ -0,0 +1,173 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "benchmarkresults.h"
+
+#include "config.h"
+
+#include <QDateTime>
+#include <QStringList>
+#include <QThread>
+
+#include <math.h>
+
+
+static QByteArray jsonString(const QString& s) {
+  QByteArray json("\"");
+  foreach (const QChar& c, s) {
+    switch (c.unicode()) {
+      case '"':  json += "\\\""; break;
+      case '\\': json += "\\\\"; break;
+      case '\n': json += "\\n"; break;
+      case '\r': json += "\\r"; break;
+      case '\t': json += "\\t"; break;
+      default:
+        if (c.unicode() < 0x20) {
+          json += "\\u" + QByteArray::number(c.unicode(), 16).rightJustified(4, '0');
+        } else {
+          json += QString(c).toUtf8();
+        }
+    }
+  }
+  return json + "\"";
+}
+
+
+// JSON has no NaN or infinity
+static QByteArray jsonNumber(double value) {
+  if (value != value || fabs(value) > 1.7e308) {
+    return "null";
+  }
+  return QByteArray::number(value, 'g', 10);
+}
+
+
+static QByteArray jsonValue(const QVariant& value) {
+  switch (value.type()) {
+    case QVariant::Bool:
+      return value.toBool() ? "true" : "false";
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+      return QByteArray::number(value.toLongLong());
+    case QVariant::Double:
+      return jsonNumber(value.toDouble());
+    default:
+      return jsonString(value.toString());
+  }
+}
+
+
+BenchmarkResults::BenchmarkResults() {
+}
+
+
+void BenchmarkResults::begin(const QString& scenario) {
+  Result result;
+  result.scenario = scenario;
+  _results.append(result);
+}
+
+
+void BenchmarkResults::setParameter(const QString& name, const QVariant& value) {
+  Q_ASSERT(!_results.isEmpty());
+  _results.last().parameters.append(qMakePair(name, value));
+}
+
+
+void BenchmarkResults::addRun(double seconds) {
+  Q_ASSERT(!_results.isEmpty());
+  _results.last().runs.append(seconds);
+}
+
+
+void BenchmarkResults::setMetric(const QString& name, double value) {
+  Q_ASSERT(!_results.isEmpty());
+  _results.last().metrics.append(qMakePair(name, value));
+}
+
+
+void BenchmarkResults::skip(const QString& reason) {
+  Q_ASSERT(!_results.isEmpty());
+  _results.last().skipped = reason;
+}
+
+
+double BenchmarkResults::median() const {
+  return _results.isEmpty() ? 0.0 : median(_results.last().runs);
+}
+
+
+double BenchmarkResults::median(QList<double> values) {
+  if (values.isEmpty()) {
+    return 0.0;
+  }
+  qSort(values);
+  const int n = values.size();
+  return n % 2 ? values.at(n / 2) : 0.5 * (values.at(n / 2 - 1) + values.at(n / 2));
+}
+
+
+QByteArray BenchmarkResults::toJson() const {
+  QByteArray json;
+  json += "{\n";
+  json += "  \"format\": 1,\n";
+  json += "  \"kst\": " + jsonString(KSTVERSION) + ",\n";
+  json += "  \"qt\": " + jsonString(qVersion()) + ",\n";
+  json += "  \"threads\": " + QByteArray::number(QThread::idealThreadCount()) + ",\n";
+  json += "  \"date\": " + jsonString(QDateTime::currentDateTime().toUTC().toString(Qt::ISODate)) + ",\n";
+  json += "  \"results\": [";
+
+  for (int i = 0; i < _results.size(); ++i) {
+    const Result& result = _results.at(i);
+    json += i ? ",\n    {\n" : "\n    {\n";
+    json += "      \"scenario\": " + jsonString(result.scenario) + ",\n";
+
+    json += "      \"parameters\": {";
+    for (int j = 0; j < result.parameters.size(); ++j) {
+      json += j ? ", " : " ";
+      json += jsonString(result.parameters.at(j).first) + ": " + jsonValue(result.parameters.at(j).second);
+    }
+    json += result.parameters.isEmpty() ? "}" : " }";
+
+    if (!result.skipped.isEmpty()) {
+      json += ",\n      \"skipped\": " + jsonString(result.skipped) + "\n    }";
+      continue;
+    }
+
+    QStringList runs;
+    double sum = 0.0, min = 0.0;
+    for (int j = 0; j < result.runs.size(); ++j) {
+      const double seconds = result.runs.at(j);
+      runs << jsonNumber(seconds);
+      sum += seconds;
+      min = j ? qMin(min, seconds) : seconds;
+    }
+    json += ",\n      \"runs\": [" + runs.join(", ").toLatin1() + "],\n";
+    json += "      \"min\": " + jsonNumber(min) + ",\n";
+    json += "      \"median\": " + jsonNumber(median(result.runs)) + ",\n";
+    json += "      \"mean\": " + jsonNumber(result.runs.isEmpty() ? 0.0 : sum / result.runs.size());
+
+    json += ",\n      \"metrics\": {";
+    for (int j = 0; j < result.metrics.size(); ++j) {
+      json += j ? ", " : " ";
+      json += jsonString(result.metrics.at(j).first) + ": " + jsonNumber(result.metrics.at(j).second);
+    }
+    json += result.metrics.isEmpty() ? "}\n    }" : " }\n    }";
+  }
+
+  json += _results.isEmpty() ? "]\n}\n" : "\n  ]\n}\n";
+  return json;
+}
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,61 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef BENCHMARKRESULTS_H
+#define BENCHMARKRESULTS_H
+
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVariant>
+
+/** What the kstbench scenarios measured, written out as JSON so that runs
+    on different builds can be compared by scripts.
+
+    Each result is one scenario at one set of parameters: the seconds of
+    each timed run (after an untimed warm up), their minimum, median and
+    mean, and any metrics the scenario adds (rates, sizes...).  A scenario
+    which can't run here is kept with the reason it was skipped. */
+class BenchmarkResults
+{
+  public:
+    BenchmarkResults();
+
+    /** Starts a result: what follows goes into it */
+    void begin(const QString& scenario);
+    void setParameter(const QString& name, const QVariant& value);
+    void addRun(double seconds);
+    void setMetric(const QString& name, double value);
+    void skip(const QString& reason);
+
+    /** The median of the runs of the current result, 0 if none */
+    double median() const;
+
+    QByteArray toJson() const;
+
+    static double median(QList<double> values);
+
+  private:
+    struct Result {
+      QString scenario;
+      QList<QPair<QString, QVariant> > parameters;
+      QList<double> runs;
+      QList<QPair<QString, double> > metrics;
+      QString skipped;
+    };
+
+    QList<Result> _results;
+};
+
+#endif
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,15 @@
+TOPOUT_REL=../../..
+include($$PWD/$$TOPOUT_REL/kst.pri)
+
+TEMPLATE = app
+TARGET = dirfile_replay
+DESTDIR = $$OUTPUT_DIR/bin
+CONFIG -= precompile_header windows app_bundle
+CONFIG += console
+!win32:OBJECTS_DIR = tmp
+
+QT -= core xml gui
+
+LIBS += -lgetdata -lm
+
+SOURCES += $$TOPLEVELDIR/tests/dirfile_replay/replay.c
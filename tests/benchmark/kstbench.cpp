@@ -0,0 +1,798 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+// kstbench: scenario benchmarks of the data, math and render pipelines.
+// Every scenario builds what it measures from fixed sizes and a fixed seed,
+// so two builds run the same work, and the results are written as JSON
+// (see BenchmarkResults).  Run "kstbench --help" for the options.
+
+#include "benchmarkresults.h"
+
+#include "application.h"
+#include "document.h"
+#include "mainwindow.h"
+#include "plotitem.h"
+#include "plotrenderitem.h"
+#include "view.h"
+
+#include "curve.h"
+#include "datasourcepluginmanager.h"
+#include "datavector.h"
+#include "editablevector.h"
+#include "equation.h"
+#include "generatedmatrix.h"
+#include "generatedvector.h"
+#include "histogram.h"
+#include "image.h"
+#include "objectstore.h"
+#include "palette.h"
+#include "psd.h"
+#include "updatemanager.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QPainter>
+#include <QProcess>
+#include <QTimer>
+#include <QVector>
+
+#include <stdio.h>
+
+using namespace Kst;
+
+struct Options {
+  Options() : repeat(5), quick(false), replayRate(100.0) {}
+
+  QString output;
+  int repeat;
+  bool quick;
+  QStringList scenarios; // all if empty
+  QString replaySource;
+  double replayRate;
+};
+
+
+static const char *const scenarioNames[] = {
+  "ascii_ingest", "dirfile_live", "update_cycle", "curve_paint", "image_paint", "session", 0L
+};
+
+
+static void printHelp() {
+  fprintf(stderr,
+    "Usage: kstbench [options]\n"
+    "\n"
+    "Runs the benchmark scenarios and writes their timings as JSON.\n"
+    "\n"
+    "  --output <file>          Write the results to file instead of standard output.\n"
+    "  --repeat <n>             Timed runs of each measurement, after one warm up (5).\n"
+    "  --quick                  Smaller data, for a quick check.\n"
+    "  --scenario <name>        Only run this scenario; may be repeated:\n"
+    "                           ascii_ingest, dirfile_live, update_cycle,\n"
+    "                           curve_paint, image_paint, session.\n"
+    "  --replay <dirfile>       Feed dirfile_live by replaying this dirfile with\n"
+    "                           dirfile_replay, rather than with dirfile_maker_new.\n"
+    "  --replay-rate <Hz>       Frame rate of the replay (100).\n");
+}
+
+
+// the same noise on every machine and every run
+class Noise {
+  public:
+    Noise(quint32 seed = 1) : _state(seed) {}
+
+    // uniform in [-0.5, 0.5)
+    double next() {
+      _state = _state * 1664525u + 1013904223u;
+      return double(_state) / 4294967296.0 - 0.5;
+    }
+
+  private:
+    quint32 _state;
+};
+
+
+static double secondsOf(const QElapsedTimer& timer) {
+  return double(timer.nsecsElapsed()) * 1.0e-9;
+}
+
+
+// lets the event loop run for ms
+static void runEventsFor(int ms) {
+  QEventLoop loop;
+  QTimer::singleShot(ms, &loop, SLOT(quit()));
+  loop.exec();
+}
+
+
+static void removeDirectory(const QString& path) {
+  QDir dir(path);
+  foreach (const QFileInfo& info, dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::System | QDir::Hidden)) {
+    if (info.isDir() && !info.isSymLink()) {
+      removeDirectory(info.absoluteFilePath());
+    } else {
+      dir.remove(info.fileName());
+    }
+  }
+  dir.rmdir(dir.absolutePath());
+}
+
+
+class Bench {
+  public:
+    Bench(MainWindow *mainWindow, const Options& options, BenchmarkResults *results);
+    ~Bench();
+
+    void asciiIngest();
+    void dirfileLive();
+    void updateCycle();
+    void curvePaint();
+    void imagePaint();
+    void session();
+
+  private:
+    ObjectStore *store() const { return _mainWindow->document()->objectStore(); }
+    void newSession() { _mainWindow->newDoc(true); }
+
+    // a forced update of everything, as after a change in a dialog
+    void update();
+
+    // the path of one of the programs built with kstbench, or empty
+    QString helper(const QString& name) const;
+    bool hasPlugin(const QString& name) const;
+    // the ASCII file asciifilegenerator writes for these, or empty
+    QString asciiFile(int columns, int megabytes);
+
+    DataVectorPtr readVector(DataSourcePtr ds, const QString& field);
+    EditableVectorPtr noiseVector(int length, Noise& noise);
+    // as a random walk if walk, which looks more like data
+    void setNoise(EditableVectorPtr vector, Noise& noise, int length, bool walk = false);
+    void paintRelation(RelationPtr relation, const QSize& size);
+
+    MainWindow *_mainWindow;
+    Options _options;
+    BenchmarkResults *_results;
+    QString _dir; // scratch files, removed at the end
+    QString _error;
+};
+
+
+Bench::Bench(MainWindow *mainWindow, const Options& options, BenchmarkResults *results)
+  : _mainWindow(mainWindow), _options(options), _results(results) {
+  _dir = QDir::temp().absoluteFilePath(QString("kstbench-%1").arg(QCoreApplication::applicationPid()));
+  QDir().mkpath(_dir);
+}
+
+
+Bench::~Bench() {
+  newSession(); // let go of the files
+  removeDirectory(_dir);
+}
+
+
+void Bench::update() {
+  UpdateManager::self()->doUpdates(true);
+  UpdateManager::self()->viewItemUpdateFinished();
+}
+
+
+QString Bench::helper(const QString& name) const {
+  const QDir dir(QCoreApplication::applicationDirPath());
+  foreach (const QString& file, QStringList() << name << name + ".exe") {
+    if (dir.exists(file)) {
+      return dir.absoluteFilePath(file);
+    }
+  }
+  return QString();
+}
+
+
+bool Bench::hasPlugin(const QString& name) const {
+  return DataSourcePluginManager::pluginList().contains(name);
+}
+
+
+QString Bench::asciiFile(int columns, int megabytes) {
+  const QString file = QDir(_dir).absoluteFilePath(QString("ascii-%1-%2.txt").arg(columns).arg(megabytes));
+  if (QFile::exists(file)) {
+    return file;
+  }
+
+  const QString generator = helper("asciifilegenerator");
+  if (generator.isEmpty()) {
+    _error = "asciifilegenerator was not built";
+    return QString();
+  }
+  QProcess process;
+  process.setStandardOutputFile(QDir(_dir).absoluteFilePath("asciifilegenerator.log"));
+  process.start(generator, QStringList() << file << QString::number(columns) << QString::number(megabytes));
+  if (!process.waitForFinished(-1) || process.exitCode() != 0 || !QFile::exists(file)) {
+    _error = "asciifilegenerator failed";
+    return QString();
+  }
+  return file;
+}
+
+
+DataVectorPtr Bench::readVector(DataSourcePtr ds, const QString& field) {
+  DataVectorPtr vector = store()->createObject<DataVector>();
+  vector->writeLock();
+  vector->change(ds, field, 0, -1, 0, false, false);
+  vector->registerChange();
+  vector->unlock();
+  return vector;
+}
+
+
+EditableVectorPtr Bench::noiseVector(int length, Noise& noise) {
+  EditableVectorPtr vector = store()->createObject<EditableVector>();
+  setNoise(vector, noise, length);
+  return vector;
+}
+
+
+void Bench::setNoise(EditableVectorPtr vector, Noise& noise, int length, bool walk) {
+  QVector<double> data(length);
+  for (int i = 0; i < length; ++i) {
+    data[i] = noise.next() + (walk && i > 0 ? data.at(i - 1) : 0.0);
+  }
+  vector->writeLock();
+  vector->change(data.constData(), length);
+  vector->registerChange();
+  vector->unlock();
+}
+
+
+// ASCII files of columns of numbers, as asciifilegenerator writes them, read
+// into a vector per column: from the opening of the file to the data.
+void Bench::asciiIngest() {
+  const int columns = 10;
+  const int megabytes = _options.quick ? 5 : 50;
+
+  _results->begin("ascii_ingest");
+  _results->setParameter("columns", columns);
+  _results->setParameter("megabytes", megabytes);
+
+  if (!hasPlugin("ASCII File Reader")) {
+    _results->skip("no ASCII data source plugin");
+    return;
+  }
+  const QString file = asciiFile(columns, megabytes);
+  if (file.isEmpty()) {
+    _results->skip(_error);
+    return;
+  }
+
+  int rows = 0;
+  for (int run = -1; run < _options.repeat; ++run) {
+    newSession();
+
+    QElapsedTimer timer;
+    timer.start();
+    DataSourcePtr ds = DataSourcePluginManager::loadSource(store(), file);
+    if (!ds || !ds->isValid()) {
+      _results->skip("could not read " + file);
+      return;
+    }
+    QList<DataVectorPtr> vectors;
+    foreach (const QString& field, ds->vector().list()) {
+      if (field != "INDEX") {
+        vectors << readVector(ds, field);
+      }
+    }
+    update();
+    const double seconds = secondsOf(timer);
+
+    if (run >= 0) {
+      _results->addRun(seconds);
+    }
+    rows = vectors.isEmpty() ? 0 : vectors.first()->length();
+  }
+
+  _results->setMetric("rows", rows);
+  _results->setMetric("megabytes_per_second", megabytes / _results->median());
+}
+
+
+// A dirfile growing while kst follows it: dirfile_maker_new appending frames
+// as fast as it can, or dirfile_replay replaying a dirfile at a frame rate.
+// The runs are the updates, one every 100 ms as with the default minimum
+// update period.
+void Bench::dirfileLive() {
+  const int duration = _options.quick ? 3 : 10;
+  const int period = 100;
+  const bool replay = !_options.replaySource.isEmpty();
+
+  _results->begin("dirfile_live");
+  _results->setParameter("seconds", duration);
+  _results->setParameter("update_period_ms", period);
+  _results->setParameter("writer", replay ? "dirfile_replay" : "dirfile_maker_new");
+
+  if (!hasPlugin("DirFile Reader")) {
+    _results->skip("no dirfile data source plugin");
+    return;
+  }
+
+  const QString dir = QDir(_dir).absoluteFilePath("live");
+  removeDirectory(dir);
+  QDir().mkpath(dir);
+
+  QProcess writer;
+  writer.setWorkingDirectory(dir);
+  writer.setStandardOutputFile(QDir(dir).absoluteFilePath("writer.log"));
+  QString dirfile;
+  if (replay) {
+    const QString program = helper("dirfile_replay");
+    if (program.isEmpty()) {
+      _results->skip("dirfile_replay was not built");
+      return;
+    }
+    _results->setParameter("source", _options.replaySource);
+    _results->setParameter("frame_rate", _options.replayRate);
+    dirfile = QDir(dir).absoluteFilePath("replay.dm");
+    writer.start(program, QStringList() << "-r" << QString::number(_options.replayRate)
+                                        << _options.replaySource << dirfile);
+  } else {
+    const QString program = helper("dirfile_maker_new");
+    if (program.isEmpty()) {
+      _results->skip("dirfile_maker_new was not built");
+      return;
+    }
+    // 20 fields of 1 sample per frame, a frame every millisecond
+    _results->setParameter("fields", 20);
+    writer.start(program, QStringList() << "20" << "-1" << "1");
+  }
+
+  // wait for the writer to have made the dirfile and a few frames
+  for (int i = 0; i < 100 && dirfile.isEmpty(); ++i) {
+    runEventsFor(100);
+    QFile current(QDir(dir).absoluteFilePath("dm.cur"));
+    if (current.open(QIODevice::ReadOnly)) {
+      dirfile = QDir(dir).absoluteFilePath(QString::fromLocal8Bit(current.readAll().trimmed()));
+    }
+  }
+  for (int i = 0; i < 100 && !QFile::exists(dirfile + "/format"); ++i) {
+    runEventsFor(100);
+  }
+  runEventsFor(500);
+  if (dirfile.isEmpty() || !QFile::exists(dirfile + "/format")) {
+    writer.kill();
+    writer.waitForFinished();
+    _results->skip("the writer made no dirfile");
+    return;
+  }
+
+  newSession();
+  DataSourcePtr ds = DataSourcePluginManager::loadSource(store(), dirfile);
+  if (!ds || !ds->isValid()) {
+    writer.kill();
+    writer.waitForFinished();
+    _results->skip("could not read " + dirfile);
+    return;
+  }
+  QList<DataVectorPtr> vectors;
+  foreach (const QString& field, ds->vector().list()) {
+    if (field != "INDEX") {
+      vectors << readVector(ds, field);
+    }
+  }
+  update();
+  const int firstFrames = vectors.isEmpty() ? 0 : vectors.first()->numFrames();
+
+  // how many frames the first field is behind the writer, after an update:
+  // fields of dirfile_maker_new are floats, one per frame
+  QList<double> behind;
+  const QString firstFile = vectors.isEmpty() ? QString() : dirfile + '/' + vectors.first()->field();
+
+  QElapsedTimer clock;
+  clock.start();
+  while (clock.elapsed() < duration * 1000) {
+    runEventsFor(period);
+
+    QElapsedTimer timer;
+    timer.start();
+    update();
+    _results->addRun(secondsOf(timer));
+
+    if (!replay && !vectors.isEmpty()) {
+      const qint64 written = QFileInfo(firstFile).size() / qint64(sizeof(float));
+      behind << double(written - vectors.first()->startFrame() - vectors.first()->numFrames());
+    }
+  }
+  const double elapsed = secondsOf(clock);
+
+  writer.kill();
+  writer.waitForFinished();
+
+  const int frames = vectors.isEmpty() ? 0 : vectors.first()->numFrames();
+  _results->setMetric("fields_read", vectors.size());
+  _results->setMetric("frames_read", frames - firstFrames);
+  _results->setMetric("frames_per_second", (frames - firstFrames) / elapsed);
+  if (!behind.isEmpty()) {
+    _results->setMetric("frames_behind_median", BenchmarkResults::median(behind));
+  }
+}
+
+
+// One forced update of N PSDs, N equations and N histograms of a vector of
+// noise which changes before every run: the work of each update of a
+// session doing analysis on live data.
+void Bench::updateCycle() {
+  const int length = _options.quick ? 10000 : 100000;
+  QList<int> counts;
+  counts << 10;
+  if (!_options.quick) {
+    counts << 50 << 200;
+  }
+
+  foreach (int count, counts) {
+    _results->begin("update_cycle");
+    _results->setParameter("psds", count);
+    _results->setParameter("equations", count);
+    _results->setParameter("histograms", count);
+    _results->setParameter("samples", length);
+
+    newSession();
+    Noise noise;
+
+    GeneratedVectorPtr x = store()->createObject<GeneratedVector>();
+    x->writeLock();
+    x->changeRange(0, length - 1, length);
+    x->registerChange();
+    x->unlock();
+
+    EditableVectorPtr y = noiseVector(length, noise);
+
+    for (int i = 0; i < count; ++i) {
+      PSDPtr psd = store()->createObject<PSD>();
+      psd->writeLock();
+      psd->change(y, 100.0, true, 12, true, true, "V", "V/Hz^{1/2}");
+      psd->registerChange();
+      psd->unlock();
+
+      EquationPtr equation = store()->createObject<Equation>();
+      equation->writeLock();
+      equation->setEquation(QString("sin(x*%1)+[%2]").arg(i + 1).arg(y->Name()));
+      equation->setExistingXVector(x, false);
+      equation->registerChange();
+      equation->unlock();
+
+      HistogramPtr histogram = store()->createObject<Histogram>();
+      histogram->writeLock();
+      histogram->change(y, -0.5, 0.5, 100, Histogram::Number);
+      histogram->registerChange();
+      histogram->unlock();
+    }
+    update();
+
+    for (int run = -1; run < _options.repeat; ++run) {
+      setNoise(y, noise, length);
+
+      QElapsedTimer timer;
+      timer.start();
+      update();
+      if (run >= 0) {
+        _results->addRun(secondsOf(timer));
+      }
+    }
+
+    _results->setMetric("objects_per_second", 3 * count / _results->median());
+  }
+}
+
+
+// Paints relation over all of an image of size, as a plot would with no
+// margins.  The runs are the preparation of the paint objects, with the
+// cache made useless, and the painting; the preparation is also given alone.
+void Bench::paintRelation(RelationPtr relation, const QSize& size) {
+  CurveRenderContext context;
+  context.window = QRect(QPoint(0, 0), size);
+  context.penWidth = 1;
+  context.foregroundColor = Qt::black;
+  context.backgroundColor = Qt::white;
+  context.xLogBase = 10.0;
+  context.yLogBase = 10.0;
+
+  context.XMin = context.x_min = relation->minX();
+  context.XMax = context.x_max = relation->maxX() > relation->minX() ? relation->maxX() : relation->minX() + 1.0;
+  context.YMin = context.y_min = relation->minY();
+  context.YMax = context.y_max = relation->maxY() > relation->minY() ? relation->maxY() : relation->minY() + 1.0;
+
+  context.Lx = 0.0;
+  context.Hx = size.width();
+  context.Ly = 0.0;
+  context.Hy = size.height();
+  context.m_X = double(size.width()) / (context.x_max - context.x_min);
+  context.m_Y = -double(size.height()) / (context.y_max - context.y_min);
+  context.b_X = context.Lx - context.m_X * context.x_min;
+  context.b_Y = context.Ly - context.m_Y * context.y_max;
+
+  QImage image(size, QImage::Format_ARGB32_Premultiplied);
+  QList<double> prepare;
+  for (int run = -1; run < _options.repeat; ++run) {
+    image.fill(0xffffffff);
+    QPainter painter(&image);
+    context.painter = &painter;
+
+    QElapsedTimer timer;
+    timer.start();
+    relation->updatePaintObjects(context);
+    const double prepared = secondsOf(timer);
+    relation->paintObjects(context);
+    painter.end();
+    const double seconds = secondsOf(timer);
+
+    if (run >= 0) {
+      _results->addRun(seconds);
+      prepare << prepared;
+    }
+  }
+  _results->setMetric("prepare_median", BenchmarkResults::median(prepare));
+}
+
+
+static QList<QSize> paintSizes() {
+  return QList<QSize>() << QSize(640, 480) << QSize(1280, 1024) << QSize(2560, 1600);
+}
+
+
+void Bench::curvePaint() {
+  const int points = _options.quick ? 100000 : 1000000;
+
+  newSession();
+  Noise noise;
+
+  GeneratedVectorPtr x = store()->createObject<GeneratedVector>();
+  x->writeLock();
+  x->changeRange(0, points - 1, points);
+  x->registerChange();
+  x->unlock();
+
+  EditableVectorPtr y = store()->createObject<EditableVector>();
+  setNoise(y, noise, points, true);
+
+  CurvePtr curve = store()->createObject<Curve>();
+  curve->writeLock();
+  curve->setXVector(x);
+  curve->setYVector(y);
+  curve->registerChange();
+  curve->unlock();
+  update();
+
+  foreach (const QSize& size, paintSizes()) {
+    _results->begin("curve_paint");
+    _results->setParameter("width", size.width());
+    _results->setParameter("height", size.height());
+    _results->setParameter("points", points);
+    paintRelation(curve, size);
+  }
+}
+
+
+void Bench::imagePaint() {
+  const int side = _options.quick ? 300 : 1000;
+
+  newSession();
+
+  GeneratedMatrixPtr matrix = store()->createObject<GeneratedMatrix>();
+  matrix->writeLock();
+  matrix->change(side, side, 0.0, 0.0, 1.0, 1.0, 0.0, 1.0, true);
+  matrix->registerChange();
+  matrix->unlock();
+
+  ImagePtr image = store()->createObject<Image>();
+  image->writeLock();
+  image->changeToColorOnly(matrix, 0.0, 1.0, false, DefaultPalette);
+  image->registerChange();
+  image->unlock();
+  update();
+
+  foreach (const QSize& size, paintSizes()) {
+    _results->begin("image_paint");
+    _results->setParameter("width", size.width());
+    _results->setParameter("height", size.height());
+    _results->setParameter("matrix_side", side);
+    paintRelation(image, size);
+  }
+}
+
+
+// A session of an ASCII file with a plot of the curve and one of the PSD of
+// each column: saving it, then opening it again up to the first update.
+void Bench::session() {
+  const int columns = 10;
+  const int megabytes = _options.quick ? 2 : 10;
+
+  _results->begin("session_save");
+  _results->setParameter("columns", columns);
+  _results->setParameter("megabytes", megabytes);
+
+  if (!hasPlugin("ASCII File Reader")) {
+    _results->skip("no ASCII data source plugin");
+    return;
+  }
+  const QString file = asciiFile(columns, megabytes);
+  if (file.isEmpty()) {
+    _results->skip(_error);
+    return;
+  }
+
+  newSession();
+  DataSourcePtr ds = DataSourcePluginManager::loadSource(store(), file);
+  if (!ds || !ds->isValid()) {
+    _results->skip("could not read " + file);
+    return;
+  }
+  DataVectorPtr index = readVector(ds, "INDEX");
+  int plots = 0;
+  foreach (const QString& field, ds->vector().list()) {
+    if (field == "INDEX") {
+      continue;
+    }
+    DataVectorPtr vector = readVector(ds, field);
+
+    PSDPtr psd = store()->createObject<PSD>();
+    psd->writeLock();
+    psd->change(vector, 100.0, true, 12, true, true, "V", "V/Hz^{1/2}");
+    psd->registerChange();
+    psd->unlock();
+
+    QList<RelationPtr> relations;
+    for (int i = 0; i < 2; ++i) {
+      CurvePtr curve = store()->createObject<Curve>();
+      curve->writeLock();
+      curve->setXVector(i ? psd->vX() : VectorPtr(index));
+      curve->setYVector(i ? psd->vY() : VectorPtr(vector));
+      curve->registerChange();
+      curve->unlock();
+      relations << kst_cast<Relation>(curve);
+    }
+
+    foreach (const RelationPtr& relation, relations) {
+      CreatePlotForCurve *cmd = new CreatePlotForCurve();
+      cmd->createItem();
+      PlotItem *plot = static_cast<PlotItem*>(cmd->item());
+      plot->view()->appendToLayout(CurvePlacement::Auto, plot);
+      plot->renderItem(PlotRenderItem::Cartesian)->addRelation(relation);
+      plot->update();
+      ++plots;
+    }
+  }
+  update();
+
+  const QString sessionFile = QDir(_dir).absoluteFilePath("session.kst");
+  for (int run = -1; run < _options.repeat; ++run) {
+    QElapsedTimer timer;
+    timer.start();
+    if (!_mainWindow->document()->save(sessionFile)) {
+      _results->skip("could not save " + sessionFile + ": " + _mainWindow->document()->lastError());
+      return;
+    }
+    if (run >= 0) {
+      _results->addRun(secondsOf(timer));
+    }
+  }
+  _results->setMetric("plots", plots);
+  _results->setMetric("session_bytes", QFileInfo(sessionFile).size());
+
+  _results->begin("session_open");
+  _results->setParameter("columns", columns);
+  _results->setParameter("megabytes", megabytes);
+  for (int run = -1; run < _options.repeat; ++run) {
+    newSession();
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!_mainWindow->document()->open(sessionFile)) {
+      _results->skip("could not open " + sessionFile + ": " + _mainWindow->document()->lastError());
+      return;
+    }
+    update();
+    if (run >= 0) {
+      _results->addRun(secondsOf(timer));
+    }
+  }
+  _results->setMetric("plots", plots);
+}
+
+
+static bool parseArguments(const QStringList& args, Options *options) {
+  for (int i = 1; i < args.size(); ++i) {
+    const QString& arg = args.at(i);
+    const bool hasValue = i + 1 < args.size();
+    bool ok = true;
+    if (arg == "--output" && hasValue) {
+      options->output = args.at(++i);
+    } else if (arg == "--repeat" && hasValue) {
+      options->repeat = args.at(++i).toInt(&ok);
+      ok = ok && options->repeat > 0;
+    } else if (arg == "--quick") {
+      options->quick = true;
+    } else if (arg == "--scenario" && hasValue) {
+      options->scenarios << args.at(++i);
+      ok = false;
+      for (int j = 0; scenarioNames[j]; ++j) {
+        ok = ok || options->scenarios.last() == scenarioNames[j];
+      }
+    } else if (arg == "--replay" && hasValue) {
+      options->replaySource = QFileInfo(args.at(++i)).absoluteFilePath();
+    } else if (arg == "--replay-rate" && hasValue) {
+      options->replayRate = args.at(++i).toDouble(&ok);
+      ok = ok && options->replayRate > 0.0;
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+int main(int argc, char *argv[]) {
+#ifdef QT5
+  // the scenarios paint into images: no display is needed
+  if (qgetenv("QT_QPA_PLATFORM").isEmpty()) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+#endif
+
+  Kst::Application app(argc, argv);
+
+  Options options;
+  if (!parseArguments(app.arguments(), &options)) {
+    printHelp();
+    return 1;
+  }
+
+  BenchmarkResults results;
+  {
+    Bench bench(app.mainWindow(), options, &results);
+    const bool all = options.scenarios.isEmpty();
+    if (all || options.scenarios.contains("ascii_ingest")) {
+      bench.asciiIngest();
+    }
+    if (all || options.scenarios.contains("dirfile_live")) {
+      bench.dirfileLive();
+    }
+    if (all || options.scenarios.contains("update_cycle")) {
+      bench.updateCycle();
+    }
+    if (all || options.scenarios.contains("curve_paint")) {
+      bench.curvePaint();
+    }
+    if (all || options.scenarios.contains("image_paint")) {
+      bench.imagePaint();
+    }
+    if (all || options.scenarios.contains("session")) {
+      bench.session();
+    }
+  }
+
+  const QByteArray json = results.toJson();
+  if (options.output.isEmpty()) {
+    fwrite(json.constData(), 1, json.size(), stdout);
+    return 0;
+  }
+  QFile file(options.output);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+    fprintf(stderr, "kstbench: could not write %s\n", qPrintable(options.output));
+    return 1;
+  }
+  return 0;
+}
+
+// vim: ts=2 sw=2 et
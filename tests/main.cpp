@@ -22,10 +22,13 @@
 #include "testcsd.h"
 #include "testpsd.h"
 #include "testhistogram.h"
+#include "testcurve.h"
+#include "testscriptserver.h"
 #include "testeditablematrix.h"
 #include "testlabelparser.h"
 #include "testeqparser.h"
 #include "testobjectstore.h"
+#include "testsharedptr.h"
 
 int main(int argc, char *argv[]) {
   QCoreApplication app(argc, argv);
@@ -69,6 +72,15 @@ int main(int argc, char *argv[]) {
   TestObjectStore test11;
   QTest::qExec(&test11, argc, argv);
 
+  TestSharedPtr test12;
+  QTest::qExec(&test12, argc, argv);
+
+  TestCurve curveTest;
+  QTest::qExec(&curveTest, argc, argv);
+
+  TestScriptServer scriptServerTest;
+  QTest::qExec(&scriptServerTest, argc, argv);
+
   return 0;
 }
 
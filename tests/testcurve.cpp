@@ -0,0 +1,148 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "testcurve.h"
+
+#include <QtTest>
+#include <QImage>
+#include <QPainter>
+
+#include <objectstore.h>
+#include <vector.h>
+
+#include <curve.h>
+
+
+static Kst::ObjectStore _store;
+
+void TestCurve::cleanupTestCase() {
+  _store.clear();
+}
+
+
+static void update(Kst::ObjectPtr o) {
+  o->writeLock();
+  o->internalUpdate();
+  o->unlock();
+}
+
+
+// grows x and y to n samples the way a data vector does when its file grows
+static void append(Kst::VectorPtr xv, Kst::VectorPtr yv, int n) {
+  const int old = xv->length();
+  xv->resize(n);
+  yv->resize(n);
+  for (int i = old; i < n; ++i) {
+    xv->value()[i] = i;
+    yv->value()[i] = i % 7;
+  }
+  xv->setNewAndShift(n - old, 0);
+  yv->setNewAndShift(n - old, 0);
+  update(xv);
+  update(yv);
+}
+
+
+static Kst::CurvePtr makeCurve(Kst::VectorPtr xv, Kst::VectorPtr yv) {
+  Kst::CurvePtr c = Kst::kst_cast<Kst::Curve>(_store.createObject<Kst::Curve>());
+  Q_ASSERT(c);
+  c->setXVector(xv);
+  c->setYVector(yv);
+  c->setColor(Qt::black);
+  update(c);
+  return c;
+}
+
+
+// 2 pixels a sample over the first 200 samples
+static Kst::CurveRenderContext renderContext() {
+  Kst::CurveRenderContext context;
+  context.window = QRect(0, 0, 400, 200);
+  context.Lx = 0.0;
+  context.Hx = 400.0;
+  context.Ly = 0.0;
+  context.Hy = 200.0;
+  context.m_X = 2.0;
+  context.b_X = 0.0;
+  context.m_Y = -20.0;
+  context.b_Y = 190.0;
+  context.XMin = 0.0;
+  context.XMax = 199.0;
+  return context;
+}
+
+
+static QImage render(Kst::CurvePtr c) {
+  QImage image(400, 200, QImage::Format_ARGB32_Premultiplied);
+  image.fill(0xffffffff);
+  QPainter p(&image);
+  Kst::CurveRenderContext context = renderContext();
+  context.painter = &p;
+  c->paintObjects(context);
+  p.end();
+  return image;
+}
+
+
+void TestCurve::testAppend() {
+  Kst::VectorPtr xv = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  Kst::VectorPtr yv = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  Q_ASSERT(xv && yv);
+  append(xv, yv, 100);
+
+  const Kst::CurveRenderContext context = renderContext();
+  Kst::CurvePtr c1 = makeCurve(xv, yv);
+  c1->preparePaint(context);
+  QVERIFY(!c1->appendPaintObjects(context));
+
+  // append samples: only the new ones get painted, the result must be the
+  // same as painting everything.
+  append(xv, yv, 150);
+  update(c1);
+  QVERIFY(c1->appendPaintObjects(context));
+
+  Kst::CurvePtr c2 = makeCurve(xv, yv);
+  c2->preparePaint(context);
+  QVERIFY(render(c1) == render(c2));
+
+  // changing the style paints everything again.
+  append(xv, yv, 160);
+  update(c1);
+  c1->setLineWidth(c1->lineWidth());
+  QVERIFY(!c1->appendPaintObjects(context));
+  c1->preparePaint(context);
+
+  // so does shifting or rewriting old samples.
+  append(xv, yv, 170);
+  xv->setNewAndShift(10, 10);
+  update(c1);
+  QVERIFY(!c1->appendPaintObjects(context));
+  c1->preparePaint(context);
+
+  append(xv, yv, 180);
+  yv->value()[10] = 6.0;
+  yv->setNewAndShift(180, 0);
+  update(yv);
+  update(c1);
+  QVERIFY(!c1->appendPaintObjects(context));
+  c1->preparePaint(context);
+
+  Kst::CurvePtr c3 = makeCurve(xv, yv);
+  c3->preparePaint(context);
+  QVERIFY(render(c1) == render(c3));
+}
+
+#ifdef KST_USE_QTEST_MAIN
+QTEST_MAIN(TestCurve)
+#endif
+
+// vim: ts=2 sw=2 et
@@ -90,6 +90,61 @@ void TestDataMatrix::testDataMatrix() {
   QVERIFY(ok);
 }
 
+
+void TestDataMatrix::testDecimation() {
+  QStringList _plugins = Kst::DataSourcePluginManager::pluginList();
+  if (!_plugins.contains("QImage Source Reader"))
+    QSKIP("...couldn't find plugin.", SkipAll);
+
+  QString imageFile = QDir::currentPath() + QDir::separator() + QString("src") +
+                      QDir::separator() + QString("images") + QDir::separator() + QString("kst.png");
+  if (!QFile::exists(imageFile)) {
+    QSKIP("...unable to perform test.  Image file missing.", SkipAll);
+  }
+
+  Kst::DataSourcePtr dsp = Kst::DataSourcePluginManager::loadSource(&_store, imageFile);
+  dsp->internalUpdate();
+  QVERIFY(dsp);
+  QVERIFY(dsp->isValid());
+
+  Kst::DataMatrixPtr full = Kst::kst_cast<Kst::DataMatrix>(_store.createObject<Kst::DataMatrix>());
+  full->change(dsp, "GRAY", 0, 0, -1, -1, false, false, 1, 0, 0, 1, 1);
+  full->writeLock();
+  full->internalUpdate();
+  full->unlock();
+
+  Kst::DataMatrixPtr skipped = Kst::kst_cast<Kst::DataMatrix>(_store.createObject<Kst::DataMatrix>());
+  skipped->change(dsp, "GRAY", 0, 0, -1, -1, false, true, 4, 0, 0, 1, 1);
+  skipped->writeLock();
+  skipped->internalUpdate();
+  skipped->unlock();
+
+  Kst::DataMatrixPtr averaged = Kst::kst_cast<Kst::DataMatrix>(_store.createObject<Kst::DataMatrix>());
+  averaged->change(dsp, "GRAY", 0, 0, -1, -1, true, true, 4, 0, 0, 1, 1);
+  averaged->writeLock();
+  averaged->internalUpdate();
+  averaged->unlock();
+
+  QCOMPARE(skipped->xNumSteps(), 8);
+  QCOMPARE(skipped->yNumSteps(), 8);
+  QCOMPARE(skipped->xStepSize(), 4.0);
+  QCOMPARE(averaged->sampleCount(), 64);
+
+  bool ok = true;
+  for (int i = 0; i < 8; ++i) {
+    for (int j = 0; j < 8; ++j) {
+      QCOMPARE(skipped->valueRaw(i, j, &ok), full->valueRaw(4*i, 4*j, &ok));
+      double sum = 0.0;
+      for (int a = 0; a < 4; ++a) {
+        for (int b = 0; b < 4; ++b) {
+          sum += full->valueRaw(4*i + a, 4*j + b, &ok);
+        }
+      }
+      QCOMPARE(averaged->valueRaw(i, j, &ok), sum / 16.0);
+    }
+  }
+}
+
 #ifdef KST_USE_QTEST_MAIN
 QTEST_MAIN(TestDataMatrix)
 #endif
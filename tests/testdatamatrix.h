@@ -21,6 +21,7 @@ class TestDataMatrix : public QObject
     void cleanupTestCase();
 
     void testDataMatrix();
+    void testDecimation();
 };
 
 #endif
@@ -17,6 +17,7 @@
 #include <QFile>
 #include <QSettings>
 #include <QTemporaryFile>
+#include <QThread>
 
 #include "math_kst.h"
 #include "kst_inf.h"
@@ -25,11 +26,19 @@
 #include "objectstore.h"
 
 #include "datavector.h"
+#include "editablevector.h"
 #include "datamatrix.h"
 #include "datasourcepluginmanager.h"
+#include "dirfilerecorder.h"
 
 #include "colorsequence.h"
 
+#ifndef Q_OS_WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #define STRINGIFY(x) #x
 #define TOSTRING(x) STRINGIFY(x)
 
@@ -324,6 +333,97 @@ void TestDataSource::testAscii() {
 }
 
 
+void TestDataSource::testProbeCache() {
+  if (!_plugins.contains("ASCII File Reader"))
+    QSKIP("...couldn't find plugin.", SkipAll);
+
+  Kst::DataSourcePluginManager::clearProbeCache();
+
+  QTemporaryFile tf;
+  tf.open();
+  QTextStream ts(&tf);
+  ts << "1 2" << endl;
+  ts << "3 4" << endl;
+  ts.flush();
+
+  QVERIFY(!Kst::DataSourcePluginManager::hasCachedProbe(tf.fileName()));
+  QVERIFY(Kst::DataSourcePluginManager::validSource(tf.fileName()));
+  QVERIFY(Kst::DataSourcePluginManager::hasCachedProbe(tf.fileName()));
+  // answered from the cache
+  QVERIFY(Kst::DataSourcePluginManager::validSource(tf.fileName()));
+
+  // a file of another size is probed again
+  ts << "5 6" << endl;
+  ts.flush();
+  QVERIFY(!Kst::DataSourcePluginManager::hasCachedProbe(tf.fileName()));
+  QVERIFY(Kst::DataSourcePluginManager::validSource(tf.fileName()));
+  QVERIFY(Kst::DataSourcePluginManager::hasCachedProbe(tf.fileName()));
+
+  Kst::DataSourcePluginManager::clearProbeCache();
+  QVERIFY(!Kst::DataSourcePluginManager::hasCachedProbe(tf.fileName()));
+  QVERIFY(Kst::DataSourcePluginManager::validSource(tf.fileName()));
+  QVERIFY(Kst::DataSourcePluginManager::hasCachedProbe(tf.fileName()));
+
+  // a full cache drops the probe used least recently
+  QList<QTemporaryFile*> files;
+  for (int i = 1; i < 256; ++i) {
+    QTemporaryFile *f = new QTemporaryFile;
+    f->open();
+    f->write("1 2\n");
+    f->flush();
+    files << f;
+    QVERIFY(Kst::DataSourcePluginManager::validSource(f->fileName()));
+  }
+  QVERIFY(Kst::DataSourcePluginManager::validSource(tf.fileName()));
+  QTemporaryFile last;
+  last.open();
+  last.write("1 2\n");
+  last.flush();
+  QVERIFY(Kst::DataSourcePluginManager::validSource(last.fileName()));
+  QVERIFY(Kst::DataSourcePluginManager::hasCachedProbe(last.fileName()));
+  QVERIFY(Kst::DataSourcePluginManager::hasCachedProbe(tf.fileName()));
+  QVERIFY(!Kst::DataSourcePluginManager::hasCachedProbe(files.first()->fileName()));
+  QVERIFY(Kst::DataSourcePluginManager::hasCachedProbe(files.last()->fileName()));
+  qDeleteAll(files);
+
+  Kst::DataSourcePluginManager::clearProbeCache();
+}
+
+
+void TestDataSource::testPreload() {
+  if (!_plugins.contains("ASCII File Reader"))
+    QSKIP("...couldn't find plugin.", SkipAll);
+
+  QTemporaryFile tf;
+  tf.open();
+  QTextStream ts(&tf);
+  for (int i = 0; i < 100; ++i) {
+    ts << i << " " << 2 * i << endl;
+  }
+  ts.flush();
+
+  // the ASCII plugin is thread safe: its source is made and indexed ahead
+  Kst::DataSourcePluginManager::preloadSources(&_store, QStringList() << tf.fileName(), QStringList() << QString(),
+                                               QList<QXmlStreamAttributes>() << QXmlStreamAttributes());
+
+  // only the same file, reader and properties get it
+  QVERIFY(!Kst::DataSourcePluginManager::loadPreloadedSource(&_store, tf.fileName(), "netCDF", QXmlStreamAttributes()));
+
+  Kst::DataSourcePtr dsp = Kst::DataSourcePluginManager::loadPreloadedSource(&_store, tf.fileName(), QString(), QXmlStreamAttributes());
+  QVERIFY(dsp);
+  QVERIFY(dsp->isValid());
+  QCOMPARE(dsp->thread(), QThread::currentThread());
+  QVERIFY(!dsp->shortName().isEmpty());
+  QCOMPARE(dsp->vector().dataInfo("2").frameCount, 100);
+
+  // handed out once; the next source is named after it
+  QVERIFY(!Kst::DataSourcePluginManager::loadPreloadedSource(&_store, tf.fileName(), QString(), QXmlStreamAttributes()));
+  Kst::DataSourcePtr next = Kst::DataSourcePluginManager::loadSource(&_store, tf.fileName());
+  QVERIFY(next);
+  QVERIFY(next->shortName() != dsp->shortName());
+}
+
+
 void TestDataSource::testDirfile() {
   if (!_plugins.contains("DirFile Reader"))
     QSKIP("...couldn't find plugin.", SkipAll);
@@ -515,6 +615,181 @@ void TestDataSource::testPlanck() {
 
 
 void TestDataSource::testStdin() {
+#ifdef Q_OS_WIN32
+  QSKIP("...no named pipes here.", SkipAll);
+#else
+  // the source reads a named pipe just as it reads standard input
+  const QString fifo = QDir::temp().filePath("testdatasource-stdin");
+  QFile::remove(fifo);
+  QVERIFY(mkfifo(QFile::encodeName(fifo).constData(), 0600) == 0);
+  // opened for reading too, so it doesn't wait for the source
+  const int fd = ::open(QFile::encodeName(fifo).constData(), O_RDWR);
+  QVERIFY(fd >= 0);
+  const QByteArray lines = "# time value\n0 1.5\n\n1 -2e3, 7\n2\n3\t4.25\n";
+  QCOMPARE(int(::write(fd, lines.constData(), lines.size())), lines.size());
+
+  Kst::DataSourcePtr dsp = Kst::DataSourcePluginManager::loadSource(&_store, fifo);
+  QVERIFY(dsp);
+  QVERIFY(dsp->isValid());
+  QCOMPARE(dsp->fileType(), QLatin1String("stdin"));
+  QVERIFY(dsp->vector().isValid("INDEX"));
+
+  // the fields show up at the first update after the first line
+  for (int i = 0; i < 100 && dsp->vector().dataInfo("value").frameCount < 4; ++i) {
+    QTest::qWait(20);
+    dsp->internalDataSourceUpdate();
+  }
+  QVERIFY(dsp->vector().isValid("time"));
+  QVERIFY(dsp->vector().isValid("value"));
+  QVERIFY(dsp->vector().isValid("2"));
+  QVERIFY(!dsp->vector().isValid("3"));
+  QCOMPARE(dsp->vector().list().count(), 3);
+  QCOMPARE(dsp->vector().dataInfo("value").frameCount, 4);
+
+  double v[4];
+  Kst::DataVector::ReadInfo p;
+  p.data = v;
+  p.startingFrame = 0;
+  p.numberOfFrames = 4;
+  p.skipFrame = -1;
+  QCOMPARE(dsp->vector().read("value", p), 4);
+  QCOMPARE(v[0], 1.5);
+  QCOMPARE(v[1], -2000.0);
+  QVERIFY(KST_ISNAN(v[2]));
+  QCOMPARE(v[3], 4.25);
+  QCOMPARE(dsp->vector().read("time", p), 4);
+  QCOMPARE(v[3], 3.0);
+
+  ::close(fd);
+  QFile::remove(fifo);
+
+  // a pipe which can't be opened makes an invalid source
+  QVERIFY(mkfifo(QFile::encodeName(fifo).constData(), 0200) == 0);
+  if (::access(QFile::encodeName(fifo).constData(), R_OK) != 0) {
+    dsp = Kst::DataSourcePluginManager::loadSource(&_store, fifo);
+    QVERIFY(dsp);
+    QVERIFY(!dsp->isValid());
+  }
+  QFile::remove(fifo);
+#endif
+}
+
+void TestDataSource::testRecorder() {
+  if (!_plugins.contains("ASCII File Reader"))
+    QSKIP("...couldn't find plugin.", SkipAll);
+
+  QTemporaryFile tf;
+  tf.open();
+  QTextStream ts(&tf);
+  for (int i = 0; i < 40; ++i) {
+    ts << i * 0.5 << endl;
+  }
+  ts.flush();
+
+  Kst::DataSourcePtr dsp = Kst::DataSourcePluginManager::loadSource(&_store, tf.fileName());
+  QVERIFY(dsp);
+
+  // frames 5 to 9, and every fourth frame of 0 to 19
+  Kst::DataVectorPtr dv = Kst::kst_cast<Kst::DataVector>(_store.createObject<Kst::DataVector>());
+  dv->writeLock();
+  dv->change(dsp, "1", 5, 5, 0, false, false);
+  dv->internalUpdate();
+  dv->unlock();
+  QCOMPARE(dv->length(), 5);
+
+  Kst::DataVectorPtr sv = Kst::kst_cast<Kst::DataVector>(_store.createObject<Kst::DataVector>());
+  sv->writeLock();
+  sv->change(dsp, "1", 0, 20, 4, true, false);
+  sv->internalUpdate();
+  sv->unlock();
+  QCOMPARE(sv->length(), 5);
+
+  // three samples which a script rewrites without growing them
+  const double before[] = { 1.0, 2.0, 3.0 };
+  const double after[] = { 4.0, 5.0, 6.0 };
+  Kst::EditableVectorPtr ev = Kst::kst_cast<Kst::EditableVector>(_store.createObject<Kst::EditableVector>());
+  ev->writeLock();
+  ev->change(before, 3);
+  ev->unlock();
+
+  const QString dirfile = QDir::temp().filePath("testdatasource-recorder");
+  Kst::DirfileRecorder recorder(dirfile);
+  recorder.addVector(dv, "dv");
+  recorder.addVector(sv, "sv");
+  recorder.addVector(Kst::VectorPtr(ev), "ev");
+  QVERIFY(recorder.start());
+
+  // both move on: the frames dv skips over are NaN, and sv only adds the
+  // samples it hadn't held yet
+  dv->writeLock();
+  dv->change(dsp, "1", 15, 5, 0, false, false);
+  dv->internalUpdate();
+  dv->unlock();
+  sv->writeLock();
+  sv->change(dsp, "1", 8, 20, 4, true, false);
+  sv->internalUpdate();
+  sv->unlock();
+  recorder.record();
+
+  // nothing changed, so nothing more is recorded
+  recorder.record();
+
+  // the rewrite is recorded after what ev held before
+  ev->writeLock();
+  ev->change(after, 3);
+  ev->unlock();
+  ev->registerChange();
+  ev->objectUpdate(100);
+  recorder.record();
+  recorder.stop();
+  QVERIFY(recorder.errorString().isEmpty());
+  QCOMPARE(recorder.samplesRecorded(), qint64(20 + 25 + 6));
+
+  // dv is placed by frame, counting from frame 0, the first either held
+  QFile field(QDir(dirfile).filePath("dv"));
+  QVERIFY(field.open(QIODevice::ReadOnly));
+  QByteArray data = field.readAll();
+  field.close();
+  QCOMPARE(data.size(), 20 * int(sizeof(double)));
+  const double *samples = reinterpret_cast<const double*>(data.constData());
+  for (int i = 0; i < 20; ++i) {
+    if (i < 5 || (i >= 10 && i < 15)) {
+      QVERIFY(KST_ISNAN(samples[i]));
+    } else {
+      QCOMPARE(samples[i], i * 0.5);
+    }
+  }
+  QFile::remove(field.fileName());
+
+  // sv holds frames 0, 4, ... 24 in place, with NaN in the frames it skips
+  field.setFileName(QDir(dirfile).filePath("sv"));
+  QVERIFY(field.open(QIODevice::ReadOnly));
+  data = field.readAll();
+  field.close();
+  QCOMPARE(data.size(), 25 * int(sizeof(double)));
+  samples = reinterpret_cast<const double*>(data.constData());
+  for (int i = 0; i < 25; ++i) {
+    if (i % 4) {
+      QVERIFY(KST_ISNAN(samples[i]));
+    } else {
+      QCOMPARE(samples[i], i * 0.5);
+    }
+  }
+  QFile::remove(field.fileName());
+
+  field.setFileName(QDir(dirfile).filePath("ev"));
+  QVERIFY(field.open(QIODevice::ReadOnly));
+  data = field.readAll();
+  field.close();
+  QCOMPARE(data.size(), 6 * int(sizeof(double)));
+  samples = reinterpret_cast<const double*>(data.constData());
+  for (int i = 0; i < 6; ++i) {
+    QCOMPARE(samples[i], double(i + 1));
+  }
+  QFile::remove(field.fileName());
+
+  QFile::remove(QDir(dirfile).filePath("format"));
+  QDir().rmdir(dirfile);
 }
 
 void TestDataSource::testQImageSource() {
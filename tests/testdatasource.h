@@ -23,6 +23,8 @@ class TestDataSource : public QObject
     void cleanupTestCase();
 
     void testAscii();
+    void testProbeCache();
+    void testPreload();
     void testDirfile();
     void testCDF();
     void testFrame();
@@ -30,6 +32,7 @@ class TestDataSource : public QObject
     void testLFI();
     void testPlanck();
     void testStdin();
+    void testRecorder();
     void testQImageSource();
     void testFITSImage();
 
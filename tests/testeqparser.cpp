@@ -19,10 +19,8 @@
 #include <eparse-eh.h>
 #include <objectstore.h>
 #include <generatedvector.h>
-
-KSTMATH_EXPORT extern /*"C"*/ int yyparse(Kst::ObjectStore *store);
-KSTMATH_EXPORT extern /*"C"*/ void *ParsedEquation;
-KSTMATH_EXPORT extern /*"C"*/ struct yy_buffer_state *yy_scan_string(const char*);
+#include <parallel.h>
+#include <eventmonitorentry.h>
 
 bool optimizerFailed = false;
 
@@ -46,29 +44,23 @@ void TestEqParser::cleanupTestCase() {
 bool TestEqParser::validateText(const char *equation, const char *expect) {
   bool failure = false;
   QString txt;
-  yy_scan_string(equation);
-  int rc = yyparse(&_store);
-  if (rc == 0) {
+  QStringList errors;
+  Equations::Node *eq = Equations::parse(&_store, equation, -1, &errors);
+  if (eq) {
     vectorsUsed.clear();
-    Equations::Node *eq = static_cast<Equations::Node*>(ParsedEquation);
-    if (!eq)
-      return false;
-    ParsedEquation = 0L;
     //eq->collectVectors(vectorsUsed);
     txt = eq->text();
     failure = txt != expect;
     delete eq;
   } else {
     // Parse error
-    delete (Equations::Node*)ParsedEquation;
-    ParsedEquation = 0L;
     failure = true;
   }
 
   if (failure) {
-    if (!Equations::errorStack.isEmpty()) {
+    if (!errors.isEmpty()) {
       printf("Failures on [%s] -------------------------\n", equation);
-      for (QStringList::ConstIterator i = Equations::errorStack.constBegin(); i != Equations::errorStack.constEnd(); ++i) {
+      for (QStringList::ConstIterator i = errors.constBegin(); i != errors.constEnd(); ++i) {
         printf("%s\n", (*i).toLatin1().data());
       }
       printf("------------------------------------------\n");
@@ -81,14 +73,10 @@ bool TestEqParser::validateText(const char *equation, const char *expect) {
 
 
 bool TestEqParser::validateEquation(const char *equation, double x, double result, const double tol) {
-  yy_scan_string(equation);
-  int rc = yyparse(&_store);
-  if (rc == 0) {
+  QStringList errors;
+  Equations::Node *eq = Equations::parse(&_store, equation, -1, &errors);
+  if (eq) {
     vectorsUsed.clear();
-    Equations::Node *eq = static_cast<Equations::Node*>(ParsedEquation);
-    if (!eq)
-      return false;
-    ParsedEquation = 0L;
     Equations::Context ctx;
     ctx.sampleCount = 2;
     ctx.noPoint = _NOPOINT;
@@ -122,12 +110,10 @@ bool TestEqParser::validateEquation(const char *equation, double x, double resul
   } else {
     // Parse error
     printf("Failures on [%s] -------------------------\n", equation);
-    for (QStringList::ConstIterator i = Equations::errorStack.constBegin(); i != Equations::errorStack.constEnd(); ++i) {
+    for (QStringList::ConstIterator i = errors.constBegin(); i != errors.constEnd(); ++i) {
       printf("%s\n", (*i).toLatin1().data());
     }
     printf("------------------------------------------\n");
-    delete (Equations::Node*)ParsedEquation;
-    ParsedEquation = 0L;
     return false;
   }
 }
@@ -135,18 +121,20 @@ bool TestEqParser::validateEquation(const char *equation, double x, double resul
 
 bool TestEqParser::validateParserFailures(const char *equation) {
   bool success = true;
-  yy_scan_string(equation);
-  if (0 == yyparse(&_store)) {
+  QStringList errors;
+  Equations::Node *eq = Equations::parse(&_store, equation, -1, &errors);
+  if (eq) {
     printf("Test of (%s) parsing passed, but should have failed.\n", equation);
+    delete eq;
     success = false;
   } else {
-    if (Equations::errorStack.count() == 1 && (Equations::errorStack.first() == "parse error" || Equations::errorStack.first() == "syntax error")) {
+    if (errors.count() == 1 && (errors.first() == "parse error" || errors.first() == "syntax error")) {
       printf("ERROR: [%s] doesn't have error handling yet!\n", equation);
       success = false;
 #ifdef DUMP_FAIL_MSGS
     } else {
       printf("Failures on [%s] -------------------------\n", equation);
-      for (QStringList::ConstIterator i = Equations::errorStack.constBegin(); i != Equations::errorStack.constEnd(); ++i) {
+      for (QStringList::ConstIterator i = errors.constBegin(); i != errors.constEnd(); ++i) {
         printf("%s\n", (*i).toLatin1().data());
       }
       printf("------------------------------------------\n");
@@ -634,6 +622,153 @@ void TestEqParser::testEqParser() {
   QVERIFY(validateParserFailures("2*sin(x)()"));
 }
 
+
+void TestEqParser::testCompiledEquation() {
+  Kst::ScalarPtr s = Kst::kst_cast<Kst::Scalar>(_store.createObject<Kst::Scalar>());
+  s->setValue(2.0);
+  s->setOrphan(true);
+  s->setDescriptiveName("compiled");
+
+  Equations::Node *eq = Equations::compile(&_store, "[compiled]*3+1");
+  QVERIFY(eq);
+  QCOMPARE(Equations::evaluate(eq), 7.0);
+
+  // the tree reads the scalar each time it's evaluated
+  s->setValue(-1.0);
+  QCOMPARE(Equations::evaluate(eq), -2.0);
+
+  Kst::VectorMap vectors;
+  Kst::ScalarMap scalars;
+  Kst::StringMap strings;
+  eq->collectObjects(vectors, scalars, strings);
+  QCOMPARE(scalars.count(), 1);
+  QVERIFY(scalars.values().first() == s);
+  delete eq;
+
+  QVERIFY(!Equations::compile(&_store, "2*sin(x"));
+  QVERIFY(!Equations::compile(&_store, ""));
+}
+
+
+// Parses and evaluates the same equations in every chunk, counting the
+// results which come out wrong.
+class ParseJob : public Kst::ParallelJob {
+  public:
+    ParseJob(int chunks) : failures(chunks, 0) {}
+
+    void processChunk(int chunk, qint64 begin, qint64 end) {
+      for (qint64 i = begin; i < end; ++i) {
+        const QByteArray equation = QByteArray::number(i) + "*2+sin(0)";
+        Equations::Node *eq = Equations::compile(&_store, equation.constData());
+        if (!eq || Equations::evaluate(eq) != double(2 * i)) {
+          ++failures[chunk];
+        }
+        delete eq;
+
+        QStringList errors;
+        if (Equations::parse(&_store, "2*(3", -1, &errors) || errors.isEmpty()) {
+          ++failures[chunk];
+        }
+      }
+    }
+
+    QVector<int> failures;
+};
+
+
+void TestEqParser::testConcurrentParse() {
+  const int count = 4000;
+  ParseJob job(Kst::parallelChunks(count, 1));
+  Kst::runParallel(&job, count, 1);
+  foreach (int failures, job.failures) {
+    QCOMPARE(failures, 0);
+  }
+}
+
+
+void TestEqParser::testBlockValues() {
+  Kst::GeneratedVectorPtr gv = Kst::kst_cast<Kst::GeneratedVector>(_store.createObject<Kst::GeneratedVector>());
+  gv->changeRange(-1.0, 1.0, 1000);
+  gv->setDescriptiveName("blockA");
+  gv = Kst::kst_cast<Kst::GeneratedVector>(_store.createObject<Kst::GeneratedVector>());
+  gv->changeRange(0.0, 1.0, 10);
+  gv->setDescriptiveName("blockB");
+
+  const char *equations[] = {
+    "[blockA]*2+[blockB]",
+    "-[blockA]^2%0.3/[blockB]",
+    "[blockA]>0.5&&![blockB]<0.3||[blockA]==0",
+    "sin([blockA])>=[blockB]",
+    "[blockA[3]]-([blockA]*8|3)",
+    0L
+  };
+
+  for (int e = 0; equations[e]; ++e) {
+    Equations::Node *eq = Equations::compile(&_store, equations[e]);
+    QVERIFY(eq);
+
+    Equations::Context ctx;
+    ctx.sampleCount = 1000;
+    ctx.noPoint = _NOPOINT;
+    ctx.i = 100;
+    QVector<double> block(700);
+    eq->values(&ctx, block.size(), block.data());
+    QCOMPARE(ctx.i, 100L);
+
+    for (int k = 0; k < block.size(); ++k) {
+      ctx.i = 100 + k;
+      const double v = eq->value(&ctx);
+      QVERIFY(v == block[k] || (v != v && block[k] != block[k]));
+    }
+    delete eq;
+  }
+}
+
+void TestEqParser::testSparseEventMonitor() {
+  const double head[] = { 0, 0, 1, 1, 1, 0, 0, 0, 1, 1 };
+  const double tail[] = { 1, 0, 0, 0, 1, 0 };
+
+  Kst::VectorPtr v = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  v->setDescriptiveName("sparseEvents");
+  v->resize(10);
+  memcpy(v->value(), head, sizeof(head));
+
+  Kst::EventMonitorEntryPtr em = _store.createObject<Kst::EventMonitorEntry>();
+  em->setEvent("[sparseEvents]>0.5");
+  em->setSparse(true);
+  QVERIFY(em->reparse());
+  em->internalUpdate();
+
+  Kst::VectorPtr x = em->outputVectors()[Kst::EventMonitorEntry::OUTXVECTOR];
+  Kst::VectorPtr y = em->outputVectors()[Kst::EventMonitorEntry::OUTYVECTOR];
+  QCOMPARE(x->length(), 2);
+  QCOMPARE(x->value(0), 2.0);
+  QCOMPARE(y->value(0), 4.0);
+  QCOMPARE(x->value(1), 8.0);
+  QCOMPARE(y->value(1), 9.0);
+
+  // the run open at the end carries on into the next update
+  v->resize(16);
+  memcpy(v->value() + 10, tail, sizeof(tail));
+  em->internalUpdate();
+
+  QCOMPARE(x->length(), 3);
+  QCOMPARE(x->value(0), 2.0);
+  QCOMPARE(y->value(0), 4.0);
+  QCOMPARE(x->value(1), 8.0);
+  QCOMPARE(y->value(1), 10.0);
+  QCOMPARE(x->value(2), 14.0);
+  QCOMPARE(y->value(2), 14.0);
+
+  // an update which finds nothing new leaves the intervals alone
+  em->internalUpdate();
+  QCOMPARE(x->length(), 3);
+  QCOMPARE(y->value(1), 10.0);
+
+  _store.removeObject(em);
+  _store.removeObject(v);
+}
+
 #ifdef KST_USE_QTEST_MAIN
 QTEST_MAIN(TestEqParser)
 #endif
@@ -25,6 +25,10 @@ class TestEqParser : public QObject
     void cleanupTestCase();
 
     void testEqParser();
+    void testCompiledEquation();
+    void testConcurrentParse();
+    void testBlockValues();
+    void testSparseEventMonitor();
 };
 
 #endif
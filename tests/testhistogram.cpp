@@ -143,6 +143,46 @@ void TestHistogram::testHistogram() {
   QCOMPARE(h1->xMax(), 10.0);
 }
 
+
+void TestHistogram::testAppend() {
+  Kst::VectorPtr vp = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  Q_ASSERT(vp);
+  vp->resize(100);
+  for (int i = 0; i < 100; ++i) {
+    vp->value()[i] = i % 10;
+  }
+
+  Kst::HistogramPtr h1 = Kst::kst_cast<Kst::Histogram>(_store.createObject<Kst::Histogram>());
+  h1->change(vp, 0, 10, 10, Kst::Histogram::Number);
+  h1->writeLock();
+  h1->internalUpdate();
+  h1->unlock();
+  for (int i = 0; i < 10; ++i) {
+    QCOMPARE(h1->vY()->value(i), 10.0);
+  }
+
+  // append samples: only the new ones get binned, the result must be the
+  // same as binning everything.
+  vp->resize(150);
+  for (int i = 100; i < 150; ++i) {
+    vp->value()[i] = 2.5;
+  }
+  h1->writeLock();
+  h1->internalUpdate();
+  h1->unlock();
+  QCOMPARE(h1->vY()->value(2), 60.0);
+  QCOMPARE(h1->vY()->value(3), 10.0);
+
+  // rewrite old samples: everything gets binned again.
+  vp->zero();
+  vp->setNewAndShift(150, 0);
+  h1->writeLock();
+  h1->internalUpdate();
+  h1->unlock();
+  QCOMPARE(h1->vY()->value(0), 150.0);
+  QCOMPARE(h1->vY()->value(2), 0.0);
+}
+
 #ifdef KST_USE_QTEST_MAIN
 QTEST_MAIN(TestHistogram)
 #endif
@@ -177,6 +177,51 @@ void TestMatrix::testMatrix() {
   QVERIFY(sm->maxValueNoSpike() <= -1E+300);
 }
 
+
+void TestMatrix::testPyramid() {
+  // several tiles each way, with the last ones partly filled
+  Kst::MatrixPtr m = Kst::kst_cast<Kst::Matrix>(_store.createObject<Kst::Matrix>());
+  m->change(300, 200, 0, 0, 1, 1);
+  for (int x = 0; x < 300; ++x) {
+    for (int y = 0; y < 200; ++y) {
+      QVERIFY(m->setValueRaw(x, y, x * 200 + y));
+    }
+  }
+  m->internalUpdate();
+  QCOMPARE(m->minValue(), 0.0);
+  QCOMPARE(m->maxValue(), 59999.0);
+  QCOMPARE(m->minValuePositive(), 1.0);
+  QCOMPARE(m->meanValue(), 29999.5);
+
+  m->calcNoSpikeRange(0.01);
+  QCOMPARE(m->minValueNoSpike(), 599.0);
+  QCOMPARE(m->maxValueNoSpike(), 59400.0);
+
+  int nX, nY;
+  const double *z = m->zLevel(1, &nX, &nY);
+  QCOMPARE(nX, 150);
+  QCOMPARE(nY, 100);
+  QCOMPARE(z[0], 100.5);
+  QCOMPARE(z[75 * 100 + 50], 30200.5);
+
+  // a spike: only its tile and the cells above it change
+  QVERIFY(m->setValueRaw(150, 100, 1.0E9));
+  m->internalUpdate();
+  QCOMPARE(m->maxValue(), 1.0E9);
+
+  m->calcNoSpikeRange(0.01);
+  QCOMPARE(m->minValueNoSpike(), 599.0);
+  QCOMPARE(m->maxValueNoSpike(), 59401.0);
+
+  z = m->zLevel(1, &nX, &nY);
+  QCOMPARE(z[0], 100.5);
+  QCOMPARE(z[75 * 100 + 50], (1.0E9 + 30101.0 + 30300.0 + 30301.0) / 4.0);
+
+  z = m->zLevel(3, &nX, &nY);
+  QCOMPARE(nX, 38);
+  QCOMPARE(nY, 25);
+}
+
 #ifdef KST_USE_QTEST_MAIN
 QTEST_MAIN(TestMatrix)
 #endif
@@ -21,6 +21,8 @@ class TestMatrix : public QObject
     void cleanupTestCase();
 
     void testMatrix();
+
+    void testPyramid();
 };
 
 #endif
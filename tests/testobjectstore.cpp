@@ -39,7 +39,7 @@ void TestObjectStore::testObjectStore() {
 
   VectorPtr vec = kst_cast<Vector>(store.createObject<Vector>());
   QVERIFY(vec);
-  QVERIFY(store.getObjects<Scalar>().count() > 2);  // to account for the vector's stats scalars
+  QCOMPARE(store.getObjects<Scalar>().count(), 2);  // the vector's stats scalars are made on demand
   QCOMPARE(store.getObjects<Vector>().count(), 1);
 
   QCOMPARE(store.getObjects<DataSource>().count(), 0);
@@ -60,6 +60,141 @@ void TestObjectStore::testObjectStore() {
   QVERIFY(!p);  // make sure object gets deleted when last reference is gone
 }
 
+void TestObjectStore::testLazyStatistics() {
+  ObjectStore store;
+
+  VectorPtr vec = kst_cast<Vector>(store.createObject<Vector>());
+  QVERIFY(vec);
+  vec->resize(3);
+  vec->value()[0] = 1.0;
+  vec->value()[1] = 5.0;
+  vec->value()[2] = 3.0;
+  vec->internalUpdate();
+  QCOMPARE(store.getObjects<Scalar>().count(), 0);
+
+  const QStringList names = vec->unmaterializedSlaveNames();
+  QCOMPARE(names.count(), 11);
+
+  // asking the store for one by name creates it, with the reserved short name
+  QString maxName;
+  foreach (const QString &name, names) {
+    if (name.contains(":Max (")) {
+      maxName = name;
+    }
+  }
+  ScalarPtr max = kst_cast<Scalar>(store.retrieveObject(maxName));
+  QVERIFY(max);
+  QCOMPARE(max->Name(), maxName);
+  QCOMPARE(max->value(), 5.0);
+  QVERIFY(max->provider() == ObjectPtr(vec));
+  QCOMPARE(store.getObjects<Scalar>().count(), 1);
+  QCOMPARE(vec->unmaterializedSlaveNames().count(), 10);
+  QVERIFY(max == kst_cast<Scalar>(store.retrieveObject(maxName)));
+  QVERIFY(max == kst_cast<Scalar>(store.retrieveObject(max->shortName())));
+
+  // and once it exists it follows the vector
+  vec->value()[2] = 7.0;
+  vec->internalUpdate();
+  QCOMPARE(max->value(), 7.0);
+
+  ScalarPtr mean = vec->scalar("mean");
+  QVERIFY(mean);
+  QCOMPARE(mean->value(), 13.0/3.0);
+  QVERIFY(mean == vec->scalar("mean"));
+  QCOMPARE(vec->scalars().count(), 2);
+  QCOMPARE(store.getObjects<Scalar>().count(), 2);
+  QVERIFY(!vec->scalar("nonsense"));
+}
+
+void TestObjectStore::testLookup() {
+  ObjectStore store;
+
+  ScalarPtr s1 = store.createObject<Scalar>();
+  VectorPtr v1 = store.createObject<Vector>();
+  DataVectorPtr dv = store.createObject<DataVector>();
+  ScalarPtr s2 = store.createObject<Scalar>();
+  VectorPtr v2 = store.createObject<Vector>();
+
+  // by type, subclasses included, in the order the objects were added
+  VectorList vectors = store.getObjects<Vector>();
+  QCOMPARE(vectors.count(), 3);
+  QVERIFY(vectors.at(0) == v1);
+  QVERIFY(vectors.at(1) == kst_cast<Vector>(dv));
+  QVERIFY(vectors.at(2) == v2);
+  QCOMPARE(store.getObjects<DataVector>().count(), 1);
+  QCOMPARE(store.getObjects<Scalar>().count(), 2);
+  QCOMPARE(store.getObjects<Primitive>().count(), 5);
+
+  // by short name, alone or at the end of the full name
+  QVERIFY(store.retrieveObject(v2->shortName()) == ObjectPtr(v2));
+  QVERIFY(store.retrieveObject(v2->Name()) == ObjectPtr(v2));
+  QVERIFY(store.retrieveObject("nonsense (" + s1->shortName() + ')') == ObjectPtr(s1));
+  QVERIFY(!store.retrieveObject("x" + s1->shortName()));
+
+  // by descriptive name, which must be unique, following renames
+  s1->setDescriptiveName("alpha");
+  s2->setDescriptiveName("beta");
+  QVERIFY(store.retrieveObject("alpha") == ObjectPtr(s1));
+  QVERIFY(store.retrieveObject("beta") == ObjectPtr(s2));
+  s2->setDescriptiveName("alpha");
+  QVERIFY(!store.retrieveObject("alpha"));
+  QVERIFY(!store.retrieveObject("beta"));
+  s1->setDescriptiveName("gamma");
+  QVERIFY(store.retrieveObject("alpha") == ObjectPtr(s2));
+
+  // removed objects are gone from every index
+  const QString shortName = s2->shortName();
+  store.removeObject(s2);
+  QVERIFY(!store.retrieveObject(shortName));
+  QVERIFY(!store.retrieveObject("alpha"));
+  QCOMPARE(store.getObjects<Scalar>().count(), 1);
+  store.removeObject(dv);
+  QCOMPARE(store.getObjects<DataVector>().count(), 0);
+  QCOMPARE(store.getObjects<Vector>().count(), 2);
+}
+
+void TestObjectStore::testNameIndex() {
+  ObjectStore store;
+
+  // an orphan scalar is named by its value, and is found by it once edited
+  ScalarPtr s = store.createObject<Scalar>();
+  s->setOrphan(true);
+  s->setValue(2.5);
+  QVERIFY(store.retrieveObject("2.5") == ObjectPtr(s));
+  QVERIFY(!store.retrieveObject("3.5"));
+  s->setValue(3.5);
+  QVERIFY(store.retrieveObject("3.5") == ObjectPtr(s));
+  QVERIFY(!store.retrieveObject("2.5"));
+
+  // statistics nobody has asked for yet, by descriptive and by short name
+  VectorPtr vec = store.createObject<Vector>();
+  vec->resize(2);
+  vec->value()[0] = 1.0;
+  vec->value()[1] = 3.0;
+  vec->internalUpdate();
+  vec->setDescriptiveName("delta");
+  QString meanShortName;
+  foreach (const QString &name, vec->unmaterializedSlaveNames()) {
+    if (name.startsWith("delta:Mean (")) {
+      meanShortName = name.mid(12, name.length() - 13);
+    }
+  }
+  QVERIFY(!meanShortName.isEmpty());
+  ScalarPtr mean = kst_cast<Scalar>(store.retrieveObject(meanShortName));
+  QVERIFY(mean);
+  QCOMPARE(mean->shortName(), meanShortName);
+  QCOMPARE(mean->value(), 2.0);
+  QVERIFY(!store.retrieveObject("delta:Nonsense"));
+
+  // renaming the vector renames its statistics
+  vec->setDescriptiveName("epsilon");
+  ScalarPtr max = kst_cast<Scalar>(store.retrieveObject("epsilon:Max"));
+  QVERIFY(max);
+  QCOMPARE(max->value(), 3.0);
+  QVERIFY(!store.retrieveObject("delta:Max"));
+  QVERIFY(store.retrieveObject("epsilon:Mean") == ObjectPtr(mean));
+}
+
 #ifdef KST_USE_QTEST_MAIN
 QTEST_MAIN(TestObjectStore)
 #endif
@@ -22,6 +22,9 @@ class TestObjectStore : public QObject
     void cleanupTestCase();
 
     void testObjectStore();
+    void testLazyStatistics();
+    void testLookup();
+    void testNameIndex();
 };
 
 #endif
@@ -30,6 +30,7 @@ SOURCES += \
     main.cpp \
     testeditablematrix.cpp \
     testcsd.cpp \
+    testcurve.cpp \
     testdatamatrix.cpp \
     testdatasource.cpp \
     testeqparser.cpp \
@@ -37,14 +38,17 @@ SOURCES += \
     testhistogram.cpp \
     testlabelparser.cpp \
     testscalar.cpp \
+    testscriptserver.cpp \
     testmatrix.cpp \
     testpsd.cpp \
     testobjectstore.cpp \
+    testsharedptr.cpp \
     testvector.cpp
 
 HEADERS += \
     testeditablematrix.h \
     testcsd.h \
+    testcurve.h \
     testdatamatrix.h \
     testdatasource.h \
     testhistogram.h \
@@ -52,7 +56,9 @@ HEADERS += \
     testgeneratedmatrix.h \
     testlabelparser.h \
     testscalar.h \
+    testscriptserver.h \
     testmatrix.h \
     testpsd.h \
     testobjectstore.h \
+    testsharedptr.h \
     testvector.h
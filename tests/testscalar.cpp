@@ -145,6 +145,78 @@ void TestScalar::testScalar() {
   delete listener;
 }
 
+
+void TestScalar::testDemandDriven() {
+  Kst::UpdateManager *um = Kst::UpdateManager::self();
+  um->setStore(&_store);
+  um->setMinimumUpdatePeriod(0);
+
+  Kst::ScalarPtr shown = Kst::kst_cast<Kst::Scalar>(_store.createObject<Kst::Scalar>());
+  Kst::ScalarPtr hidden = Kst::kst_cast<Kst::Scalar>(_store.createObject<Kst::Scalar>());
+
+  {
+    QObject consumer;
+    um->setInterest(&consumer, QList<Kst::Object*>() << shown);
+
+    // only what the consumer wants is updated
+    um->viewItemUpdateFinished();
+    um->doUpdates();
+    QVERIFY(shown->serial() > 0);
+    QVERIFY(hidden->serial() < shown->serial());
+
+    um->bringUpToDate(hidden);
+    QCOMPARE(hidden->serial(), shown->serial());
+
+    // forced updates still do everything
+    um->doUpdates(true);
+    QCOMPARE(hidden->serial(), shown->serial());
+  }
+
+  // with the consumer gone, nobody has said what they need
+  um->viewItemUpdateFinished();
+  um->doUpdates();
+  QCOMPARE(hidden->serial(), shown->serial());
+
+  {
+    QObject consumer;
+    um->setInterest(&consumer, QList<Kst::Object*>() << shown);
+    um->viewItemUpdateFinished();
+    um->doUpdates();
+    QVERIFY(hidden->serial() < shown->serial());
+
+    // taking an interest in an object left behind catches it up, but not
+    // while the views are still taking in the last update
+    QSignalSpy updates(um, SIGNAL(objectsUpdated(qint64)));
+    um->setInterest(&consumer, QList<Kst::Object*>() << shown << hidden);
+    QTest::qWait(50);
+    QCOMPARE(updates.count(), 0);
+    um->viewItemUpdateFinished();
+    QTest::qWait(50);
+    QCOMPARE(updates.count(), 1);
+    QCOMPARE(hidden->serial(), shown->serial());
+
+    // saying the same again after the update doesn't
+    um->viewItemUpdateFinished();
+    um->setInterest(&consumer, QList<Kst::Object*>() << shown << hidden);
+    QTest::qWait(50);
+    QCOMPARE(updates.count(), 1);
+
+    // a consumer of everything catches up once, not after every update
+    QObject dialog;
+    um->setInterestInAll(&dialog);
+    QTest::qWait(50);
+    QCOMPARE(updates.count(), 2);
+    um->viewItemUpdateFinished();
+    um->setInterest(&consumer, QList<Kst::Object*>() << shown << hidden);
+    um->doUpdates();
+    um->viewItemUpdateFinished();
+    um->setInterest(&consumer, QList<Kst::Object*>() << shown << hidden);
+    QTest::qWait(50);
+    QCOMPARE(updates.count(), 3);
+  }
+  um->viewItemUpdateFinished();
+}
+
 #ifdef KST_USE_QTEST_MAIN
 QTEST_MAIN(TestScalar)
 #endif
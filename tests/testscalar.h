@@ -39,6 +39,7 @@ class TestScalar : public QObject
     void cleanupTestCase();
 
     void testScalar();
+    void testDemandDriven();
 };
 
 #endif
@@ -0,0 +1,72 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                   netterfield@astro.utoronto.ca                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "testscriptserver.h"
+
+#include <QtTest>
+
+#include <objectstore.h>
+#include <updatemanager.h>
+#include <vector.h>
+
+#include <scriptserver.h>
+
+
+static Kst::ObjectStore _store;
+
+void TestScriptServer::cleanupTestCase() {
+  _store.clear();
+}
+
+
+void TestScriptServer::testReadUnwanted() {
+  Kst::UpdateManager *um = Kst::UpdateManager::self();
+  um->setStore(&_store);
+  um->setMinimumUpdatePeriod(0);
+
+  Kst::VectorPtr shown = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  Kst::VectorPtr unwanted = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  Q_ASSERT(shown && unwanted);
+  unwanted->resize(10);
+
+  Kst::ScriptServer server(&_store);
+
+  // the main window always says what it shows: nothing else is updated
+  QObject mainWindow;
+  um->setInterest(&mainWindow, QList<Kst::Object*>() << shown);
+  um->viewItemUpdateFinished();
+  um->doUpdates();
+  QVERIFY(unwanted->serial() < shown->serial());
+
+  // reading it through Vector:: brings it up to date first
+  QByteArray command = "Vector::length(" + unwanted->Name().toUtf8() + ")";
+  QCOMPARE(server.checkPrimatives(command, 0), QByteArray("10"));
+  QCOMPARE(unwanted->serial(), shown->serial());
+
+  // with no connection keeping it wanted, the next update leaves it behind
+  // again, and the next read catches it up again
+  um->viewItemUpdateFinished();
+  um->doUpdates();
+  QVERIFY(unwanted->serial() < shown->serial());
+  command = "Vector::mean(" + unwanted->Name().toUtf8() + ")";
+  server.checkPrimatives(command, 0);
+  QCOMPARE(unwanted->serial(), shown->serial());
+
+  um->removeInterest(&mainWindow);
+  um->viewItemUpdateFinished();
+}
+
+#ifdef KST_USE_QTEST_MAIN
+QTEST_MAIN(TestScriptServer)
+#endif
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,141 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "testsharedptr.h"
+
+#include <QtTest>
+#include <QThread>
+
+#include <objectstore.h>
+#include <scalar.h>
+
+using namespace Kst;
+
+#define SESSION_OBJECTS 10000
+
+static ObjectStore _store;
+
+static void fillStore() {
+  if (_store.getObjects<Scalar>().count() < SESSION_OBJECTS) {
+    for (int i = 0; i < SESSION_OBJECTS; ++i) {
+      _store.createObject<Scalar>();
+    }
+  }
+}
+
+
+static void hammer(const ScalarPtr &sc) {
+  for (int i = 0; i < 100000; ++i) {
+    ScalarPtr copy = sc;
+    copy = 0L;
+  }
+}
+
+
+class HammerThread : public QThread {
+  public:
+    explicit HammerThread(const ScalarPtr &sc) : _sc(sc) {}
+    void run() { hammer(_sc); }
+
+  private:
+    ScalarPtr _sc;
+};
+
+
+void TestSharedPtr::cleanupTestCase() {
+  _store.clear();
+}
+
+
+void TestSharedPtr::testRefCount() {
+  ObjectStore store;
+  ScalarPtr sc = store.createObject<Scalar>();
+  QCOMPARE(sc.count(), 2); // the store and us
+
+  ObjectPtr obj = sc;
+  QCOMPARE(sc.count(), 3);
+
+  ScalarPtr cast = kst_cast<Scalar>(obj);
+  QCOMPARE(sc.count(), 4);
+  cast = 0L;
+  QCOMPARE(sc.count(), 3);
+
+#ifdef Q_COMPILER_RVALUE_REFS
+  ObjectPtr moved(std::move(obj));
+  QVERIFY(!obj);
+  QCOMPARE(sc.count(), 3);
+  obj = std::move(moved);
+  QVERIFY(!moved);
+  QCOMPARE(sc.count(), 3);
+#endif
+
+  obj = 0L;
+  store.clear();
+  QCOMPARE(sc.count(), 1);
+
+  QPointer<Scalar> p(sc);
+  sc = 0L;
+  QVERIFY(!p);  // the last reference deletes the object
+}
+
+
+void TestSharedPtr::testThreadedRefCount() {
+  ObjectStore store;
+  ScalarPtr sc = store.createObject<Scalar>();
+  const int before = sc.count();
+
+  HammerThread *a = new HammerThread(sc);
+  HammerThread *b = new HammerThread(sc);
+  a->start();
+  b->start();
+  hammer(sc);
+  a->wait();
+  b->wait();
+  delete a;
+  delete b;
+
+  QCOMPARE(sc.count(), before);
+}
+
+
+void TestSharedPtr::benchmarkCycleByValue() {
+  fillStore();
+  int n = 0;
+  QBENCHMARK {
+    foreach (ObjectPtr p, _store.objectList()) {
+      ScalarPtr sc = kst_cast<Scalar>(p);
+      if (sc) {
+        ++n;
+      }
+    }
+  }
+  QVERIFY(n > 0);
+}
+
+
+void TestSharedPtr::benchmarkCycleByReference() {
+  fillStore();
+  int n = 0;
+  QBENCHMARK {
+    foreach (const ObjectPtr &p, _store.objectList()) {
+      if (qobject_cast<Scalar*>(static_cast<Object*>(p))) {
+        ++n;
+      }
+    }
+  }
+  QVERIFY(n > 0);
+}
+
+#ifdef KST_USE_QTEST_MAIN
+QTEST_MAIN(TestSharedPtr)
+#endif
+
+// vim: ts=2 sw=2 et
@@ -0,0 +1,35 @@
+/***************************************************************************
+ *                                                                         *
+ *   copyright : (C) 2014 The University of Toronto                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TESTSHAREDPTR_H
+#define TESTSHAREDPTR_H
+
+#include <QObject>
+
+class TestSharedPtr : public QObject
+{
+  Q_OBJECT
+
+  private Q_SLOTS:
+    void cleanupTestCase();
+
+    void testRefCount();
+    void testThreadedRefCount();
+
+    // the SharedPtr traffic of one update cycle over a 10k object session,
+    // iterating by value (a ref/unref per object) and by reference.
+    void benchmarkCycleByValue();
+    void benchmarkCycleByReference();
+};
+
+#endif
+
+// vim: ts=2 sw=2 et
@@ -14,6 +14,18 @@
 #include <vector.h>
 #include <datacollection.h>
 #include <objectstore.h>
+#include <sessiondata.h>
+#include <vectorexport.h>
+#include <dirfilerecorder.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 #include "ksttest.h"
 
@@ -67,6 +79,303 @@ void TestVector::testVector()
   QCOMPARE(v2->interpolate(4, 5), 3.0);
 }
 
+
+void TestVector::testResample()
+{
+  Kst::VectorPtr v = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  Q_ASSERT(v);
+  v->resize(7);
+  double *data = v->value();
+  for (int i = 0; i < 7; ++i) {
+    data[i] = i * i;
+  }
+  data[3] = Kst::NOPOINT;
+
+  for (int ns = 1; ns < 20; ++ns) {
+    Kst::ResampledVector r(v, ns);
+    for (int i = 0; i < ns; ++i) {
+      double expected = v->interpolate(i, ns);
+      if (expected != expected) {
+        QVERIFY(r.at(i) != r.at(i));
+      } else {
+        QCOMPARE(r.at(i), expected);
+      }
+    }
+  }
+
+  Kst::ResampledVector part(v, 13, 4, 9);
+  QCOMPARE(part.from(), 4);
+  QCOMPARE(part.to(), 9);
+  QCOMPARE(part.data()[0], v->interpolate(4, 13));
+  QCOMPARE(part.at(12), v->interpolate(12, 13));
+
+  double filled[7];
+  QCOMPARE(Kst::kstFillHoles(data, 7, filled), 1);
+  for (int i = 0; i < 7; ++i) {
+    QCOMPARE(filled[i], v->interpolateNoHoles(i, 7));
+  }
+  QCOMPARE(filled[3], 10.0);
+}
+
+
+void TestVector::testSnapshot()
+{
+  Kst::VectorPtr v = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  Q_ASSERT(v);
+  v->resize(3);
+  v->value()[0] = 1;
+  v->value()[1] = 2;
+  v->value()[2] = 3;
+  v->internalUpdate();
+
+  Kst::VectorSnapshot s1 = v->snapshot();
+  QVERIFY(!s1.isNull());
+  QCOMPARE(s1.length(), 3);
+  QCOMPARE(s1.value(1), 2.0);
+  QCOMPARE(s1.max(), 3.0);
+  QCOMPARE(s1.value(5), 0.0);
+
+  // the snapshot doesn't change under the reader...
+  v->resize(4);
+  v->value()[1] = 20;
+  v->value()[3] = 4;
+  QCOMPARE(v->snapshot().version(), s1.version());
+  QCOMPARE(s1.value(1), 2.0);
+
+  // ...and the next update publishes a new one.
+  v->internalUpdate();
+  Kst::VectorSnapshot s2 = v->snapshot();
+  QVERIFY(s2.version() > s1.version());
+  QCOMPARE(s2.length(), 4);
+  QCOMPARE(s2.value(1), 20.0);
+  QCOMPARE(s2.max(), 20.0);
+  QCOMPARE(s1.length(), 3);
+
+  // with no reader left updates stop copying, but the next reader still
+  // gets the current data.
+  const int version = s2.version();
+  s1 = s2 = Kst::VectorSnapshot();
+  v->value()[0] = 7;
+  v->internalUpdate();
+  v->internalUpdate();
+  Kst::VectorSnapshot s3 = v->snapshot();
+  QVERIFY(s3.version() > version);
+  QCOMPARE(s3.value(0), 7.0);
+}
+
+void TestVector::testSidecar() {
+  const QString session = QDir::temp().filePath("testvector-sidecar.kst");
+  const int n = 2 * Kst::SessionData::MinSamples;
+  QVector<double> ramp(n), noise(n);
+  for (int i = 0; i < n; ++i) {
+    ramp[i] = i;
+    noise[i] = sin(i * 12.9898) * 43758.5453;
+  }
+
+  QBuffer buffer;
+  buffer.open(QIODevice::WriteOnly);
+  {
+    Kst::SessionData out;
+    out.beginWrite(session);
+    QXmlStreamWriter xml(&buffer);
+    xml.writeStartElement("kst");
+    out.writeAttributes(xml);
+    QVERIFY(!out.writeArray(xml, ramp.constData(), 10)); // small: stays in the XML
+    QVERIFY(!QFile::exists(Kst::SessionData::fileNameFor(session)));
+    QVERIFY(out.writeArray(xml, ramp.constData(), n));
+    QVERIFY(out.writeArray(xml, noise.constData(), n));
+    xml.writeEndElement();
+    QVERIFY(out.finishWrite());
+  }
+
+  Kst::SessionData in;
+  QList<QVector<double> > arrays;
+  QXmlStreamReader xml(buffer.data());
+  while (!xml.atEnd()) {
+    if (xml.isStartElement()) {
+      if (xml.name() == "kst") {
+        QVERIFY(in.beginRead(session, xml.attributes()));
+      } else if (xml.name() == "data_sidecar") {
+        QVector<double> array;
+        QVERIFY(in.readArray(xml.attributes(), &array));
+        arrays << array;
+      }
+    }
+    xml.readNext();
+  }
+  in.finishRead();
+  QVERIFY(in.errors().isEmpty());
+
+  QCOMPARE(arrays.size(), 2);
+  QVERIFY(arrays[0] == ramp);
+  QVERIFY(arrays[1] == noise);
+
+  // a later save of the session with nothing for the sidecar removes it,
+  // and the arrays of the earlier save are then load errors
+  {
+    Kst::SessionData out;
+    out.beginWrite(session);
+    QBuffer small;
+    small.open(QIODevice::WriteOnly);
+    QXmlStreamWriter xml(&small);
+    xml.writeStartElement("kst");
+    out.writeAttributes(xml);
+    QVERIFY(!out.writeArray(xml, ramp.constData(), 10));
+    xml.writeEndElement();
+    QVERIFY(out.finishWrite());
+  }
+  QVERIFY(!QFile::exists(Kst::SessionData::fileNameFor(session)));
+
+  Kst::SessionData missing;
+  QXmlStreamReader again(buffer.data());
+  while (!again.atEnd()) {
+    if (again.isStartElement()) {
+      if (again.name() == "kst") {
+        QVERIFY(!missing.beginRead(session, again.attributes()));
+      } else if (again.name() == "data_sidecar") {
+        QVector<double> array;
+        QVERIFY(!missing.readArray(again.attributes(), &array));
+        QVERIFY(array.isEmpty());
+      }
+    }
+    again.readNext();
+  }
+  missing.finishRead();
+  QCOMPARE(missing.errors().size(), 1);
+}
+
+void TestVector::testExport() {
+  const double values[] = { 0.0, 1.0, -17.0, 0.1, 1.0 / 3.0, -2.5e-17, 1e-300, 6.02214076e23, 123456789012345678.0 };
+  for (unsigned i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+    char text[32];
+    const int length = Kst::VectorExport::formatDouble(values[i], text);
+    text[length] = 0;
+    QCOMPARE(strtod(text, 0L), values[i]);
+  }
+  char text[32];
+  text[Kst::VectorExport::formatDouble(0.1, text)] = 0;
+  QCOMPARE(QByteArray(text), QByteArray("0.1"));
+  text[Kst::VectorExport::formatDouble(Kst::NOPOINT, text)] = 0;
+  QCOMPARE(QByteArray(text), QByteArray("nan"));
+
+  // long enough for several blocks, and one to resample
+  const int n = 40000;
+  Kst::VectorPtr a = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  Kst::VectorPtr b = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  a->resize(n);
+  b->resize(n / 4);
+  for (int i = 0; i < n; ++i) {
+    a->value()[i] = sin(i * 0.001) * 1000.0;
+  }
+  for (int i = 0; i < n / 4; ++i) {
+    b->value()[i] = i;
+  }
+
+  const QString textFile = QDir::temp().filePath("testvector-export.txt");
+  {
+    Kst::VectorExport e(textFile, Kst::VectorExport::Text);
+    e.addVector(a, "a");
+    e.addVector(b, "b");
+    QVERIFY(e.exportNow());
+  }
+  QFile file(textFile);
+  QVERIFY(file.open(QIODevice::ReadOnly));
+  QCOMPARE(file.readLine(), QByteArray("# a b\n"));
+  for (int i = 0; i < n; ++i) {
+    const QList<QByteArray> row = file.readLine().trimmed().split(' ');
+    QCOMPARE(row.size(), 2);
+    QCOMPARE(row[0].toDouble(), a->value(i));
+    QCOMPARE(row[1].toDouble(), b->interpolate(i, n));
+  }
+  QVERIFY(file.atEnd());
+  file.close();
+  QFile::remove(textFile);
+
+  const QString columnFile = QDir::temp().filePath("testvector-export.cols");
+  {
+    Kst::VectorExport e(columnFile, Kst::VectorExport::Columnar);
+    e.addVector(a, "a");
+    e.addVector(b, "b");
+    QVERIFY(e.exportNow());
+  }
+  file.setFileName(columnFile);
+  QVERIFY(file.open(QIODevice::ReadOnly));
+  const QByteArray columns = file.readAll();
+  file.close();
+  QFile::remove(columnFile);
+
+  QVERIFY(columns.startsWith("KSTCOLS1"));
+  quint64 rows;
+  memcpy(&rows, columns.constData() + 16, sizeof(rows));
+  QCOMPARE(rows, quint64(n));
+  // the header pads to 64 bytes, the first column to a multiple of 64 too
+  const double *first = reinterpret_cast<const double*>(columns.constData() + 64);
+  const double *second = first + n;
+  QCOMPARE(columns.size(), 64 + 2 * n * int(sizeof(double)));
+  for (int i = 0; i < n; ++i) {
+    QCOMPARE(first[i], a->value(i));
+    QCOMPARE(second[i], b->interpolate(i, n));
+  }
+
+  // more columns than a block of text rows holds are refused up front
+  const QString wideFile = QDir::temp().filePath("testvector-export-wide.txt");
+  QFile::remove(wideFile);
+  {
+    Kst::VectorExport e(wideFile, Kst::VectorExport::Text);
+    for (int i = 0; i < 6000; ++i) {
+      e.addVector(b);
+    }
+    QVERIFY(!e.exportNow());
+    QVERIFY(!e.errorString().isEmpty());
+  }
+  QVERIFY(!QFile::exists(wideFile));
+}
+
+
+void TestVector::testRecorder() {
+  Kst::VectorPtr v = Kst::kst_cast<Kst::Vector>(_store.createObject<Kst::Vector>());
+  v->resize(100);
+  for (int i = 0; i < 100; ++i) {
+    v->value()[i] = i * 0.5;
+  }
+
+  const QString dirfile = QDir::temp().filePath("testvector-recorder");
+  Kst::DirfileRecorder recorder(dirfile);
+  recorder.addVector(v, "v");
+  QVERIFY(recorder.start());
+  QVERIFY(recorder.isRecording());
+
+  // the vector grows; only the new samples get appended
+  v->resize(250);
+  for (int i = 100; i < 250; ++i) {
+    v->value()[i] = i * 0.5;
+  }
+  recorder.record();
+  recorder.stop();
+  QVERIFY(!recorder.isRecording());
+  QVERIFY(recorder.errorString().isEmpty());
+  QCOMPARE(recorder.samplesRecorded(), qint64(250));
+
+  QFile format(QDir(dirfile).filePath("format"));
+  QVERIFY(format.open(QIODevice::ReadOnly));
+  QVERIFY(format.readAll().contains("v RAW FLOAT64 1"));
+  format.close();
+
+  QFile field(QDir(dirfile).filePath("v"));
+  QVERIFY(field.open(QIODevice::ReadOnly));
+  const QByteArray data = field.readAll();
+  field.close();
+  QCOMPARE(data.size(), 250 * int(sizeof(double)));
+  const double *samples = reinterpret_cast<const double*>(data.constData());
+  for (int i = 0; i < 250; ++i) {
+    QCOMPARE(samples[i], i * 0.5);
+  }
+
+  QFile::remove(format.fileName());
+  QFile::remove(field.fileName());
+  QDir().rmdir(dirfile);
+}
+
 #ifdef KST_USE_QTEST_MAIN
 QTEST_MAIN(TestVector)
 #endif
@@ -21,6 +21,15 @@ class TestVector : public QObject
     void cleanupTestCase();
 
     void testVector();
+
+    void testResample();
+
+    void testSnapshot();
+
+    void testSidecar();
+
+    void testExport();
+    void testRecorder();
 };
 
 #endif